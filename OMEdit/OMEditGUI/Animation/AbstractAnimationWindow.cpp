@@ -230,7 +230,7 @@ void AbstractAnimationWindow::updateControlPanelValues()
   if (getVisualizer()) {
     VisualizerFMU* FMUvis = dynamic_cast<VisualizerFMU*>(mpVisualizer);
     for (int stateIdx = 0; stateIdx < mSpinBoxVector.size(); stateIdx++) {
-      mStateLabels.at(stateIdx)->setText(QString::number(FMUvis->getFMU()->getFMUData()->_states[stateIdx]));
+      mStateLabels.at(stateIdx)->setText(QString::number(FMUvis->getFrameState(stateIdx)));
     }
   }
 }
@@ -255,13 +255,13 @@ void AbstractAnimationWindow::initInteractiveControlPanel()
     for (unsigned int stateIdx = 0; stateIdx < FMUvis->getFMU()->getFMUData()->_nStates; stateIdx++)
     {
       DoubleSpinBoxIndexed* spinBox = new DoubleSpinBoxIndexed(this, stateIdx);
-      spinBox->setValue(FMUvis->getFMU()->getFMUData()->_states[stateIdx]);
+      spinBox->setValue(FMUvis->getFrameState(stateIdx));
       spinBox->setMaximum(DBL_MAX);
       spinBox->setMinimum(-DBL_MAX);
       spinBox->setSingleStep(0.1);
       mSpinBoxVector.push_back(spinBox);
 
-      QLabel* stateLabel = new QLabel(QString::number(FMUvis->getFMU()->getFMUData()->_states[stateIdx]), this);
+      QLabel* stateLabel = new QLabel(QString::number(FMUvis->getFrameState(stateIdx)), this);
       stateLabel->setMargin(0);
       mStateLabels.push_back(stateLabel);
 
@@ -328,9 +328,8 @@ void AbstractAnimationWindow::setStateSolveSystem(double val, int idx)
   if (idx>=0) {
     VisualizerFMU* FMUvis = dynamic_cast<VisualizerFMU*>(mpVisualizer);
     if (FMUvis) {
-      FMUvis->getFMU()->getFMUData()->_states[idx] = val;
+      FMUvis->setState(idx, val);
     }
-    FMUvis->updateSystem();
     mpViewerWidget->update();
   }
 }
@@ -338,6 +337,7 @@ void AbstractAnimationWindow::setStateSolveSystem(double val, int idx)
 
 /*!
  * \brief AbstractAnimationWindow::clearView
+ * Removes the scene from the view and releases the cached textures.
  */
 void AbstractAnimationWindow::clearView()
 {
@@ -346,6 +346,7 @@ void AbstractAnimationWindow::clearView()
     popView();
     mpViewerWidget->update();
   }
+  TextureCache::instance()->clear();
 }
 
 void AbstractAnimationWindow::stashView()
@@ -59,6 +59,8 @@ AnimationWindow::~AnimationWindow()
   if (mpVisualizer) {
     delete mpVisualizer;
   }
+  // release the cached textures. The textures still used by other windows are kept alive by their scenes.
+  TextureCache::instance()->clear();
 }
 
 /*!
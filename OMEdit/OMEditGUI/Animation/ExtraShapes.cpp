@@ -66,7 +66,8 @@ osg::Vec3f normalizeVec(osg::Vec3f vec) {
  * creates a pipe or pipecylinder geometry
  */
 Pipecylinder::Pipecylinder(float rI, float rO, float l) :
-  osg::Geometry()
+  osg::Geometry(),
+  mInnerRadius(rI)
 {
   const int nEdges = 16;
   double phi = 2 * M_PI/nEdges;
@@ -367,33 +368,86 @@ osg::Vec3f Spring::rotateArbitraryAxis(osg::Vec3f vec, osg::Vec3f axis, float ph
  * creates an osg spring geometry
  */
 Spring::Spring(float r, float rWire, float nWindings, float l) :
-  osg::Geometry()
+  osg::Geometry(),
+  mElementsWinding(10),
+  mElementsContour(6),
+  mRadius(r),
+  mWireRadius(rWire),
+  mWindings(nWindings),
+  mLength(l)
 {
-  float R = r;
-  float L = l;
-  float RWIRE = rWire;
-  float NWIND = nWindings;
-
-  const int ELEMENTS_WINDING = 10;
-  const int ELEMENTS_CONTOUR = 6;
+  // the vertices are rewritten when the length changes so keep them in a buffer object instead of a display list
+  setDataVariance(osg::Object::DYNAMIC);
+  setUseDisplayList(false);
+  setUseVertexBufferObjects(true);
 
   this->getPrimitiveSetList().clear();
 
   //the inner line points
-  int numSegments = (ELEMENTS_WINDING * NWIND) + 1;
+  int numSegments = (mElementsWinding * mWindings) + 1;
   mpSplineVertices = new osg::Vec3Array(numSegments);
 
+  //the outer points for the facettes
+  int numVertices = (numSegments + 1)*mElementsContour;
+  mpOuterVertices = new osg::Vec3Array(numVertices);
+  updateVertices();
+
+  // pass the created vertex array to the points geometry object.
+  this->setVertexArray(mpOuterVertices);
+
+  //PLANES
+  // base plane bottom
+  osg::DrawElementsUInt* basePlane = new osg::DrawElementsUInt(osg::PrimitiveSet::QUADS, 0);
+  int numFacettes = mElementsContour * (numSegments - 2);
+  for (int i = 0; i < numFacettes; i++) {
+    basePlane = new osg::DrawElementsUInt(osg::PrimitiveSet::QUADS, 0);
+    basePlane->push_back(i);
+    basePlane->push_back(i + 1);
+    basePlane->push_back(i + mElementsContour);
+    basePlane->push_back(i + mElementsContour-1);
+    this->addPrimitiveSet(basePlane);
+  }
+  //std::cout << "NUM " << mpOuterVertices->size() << std::endl;
+  //this->addPrimitiveSet(new osg::DrawArrays(osg::PrimitiveSet::POINTS, 0, mpOuterVertices->size()));
+}
+
+/*!
+ * \brief Spring::setLength
+ * Sets the length of the spring. The vertices are rewritten in place, the number of vertices and the facettes stay the same.
+ * \param l
+ */
+void Spring::setLength(float l)
+{
+  if (l == mLength) {
+    return;
+  }
+  mLength = l;
+  updateVertices();
+  mpOuterVertices->dirty();
+  dirtyBound();
+}
+
+/*!
+ * \brief Spring::updateVertices
+ * Computes the points of the inner line and the outer points of the facettes for the current size of the spring.
+ */
+void Spring::updateVertices()
+{
+  float R = mRadius;
+  float L = mLength;
+  float RWIRE = mWireRadius;
+
+  //the inner line points
+  int numSegments = mpSplineVertices->size();
   for (int segIdx = 0; segIdx < numSegments; segIdx++)
   {
-    float x = std::sin(2 * M_PI / ELEMENTS_WINDING * segIdx) * R;
-    float y = std::cos(2 * M_PI / ELEMENTS_WINDING * segIdx) * R;
+    float x = std::sin(2 * M_PI / mElementsWinding * segIdx) * R;
+    float y = std::cos(2 * M_PI / mElementsWinding * segIdx) * R;
     float z = L / numSegments * segIdx;
     (*mpSplineVertices)[segIdx].set(osg::Vec3(x,y,z));
   }
 
   //the outer points for the facettes
-  int numVertices = (numSegments + 1)*ELEMENTS_CONTOUR;
-  mpOuterVertices = new osg::Vec3Array(numVertices);
   osg::Vec3f normal;
   osg::Vec3f v1;
   osg::Vec3f v2;
@@ -405,32 +459,14 @@ Spring::Spring(float r, float rWire, float nWindings, float l) :
     normal = osg::Vec3f(v2[0] - v1[0], v2[1] - v1[1], v2[2] - v1[2]);
     osg::Vec3f vec0 = normal;
     normal = getNormal(normal, RWIRE);
-    for (int i1 = 0; i1 < ELEMENTS_CONTOUR; i1++)
+    for (int i1 = 0; i1 < mElementsContour; i1++)
     {
-      float angle = M_PI * 2 / ELEMENTS_CONTOUR * i1;
+      float angle = M_PI * 2 / mElementsContour * i1;
       osg::Vec3f a1 = rotateArbitraryAxis(normal, vec0, angle);
       (*mpOuterVertices)[vertIdx].set(osg::Vec3f((v1[0] + a1[0]), (v1[1] + a1[1]), (v1[2] + a1[2])));
       vertIdx++;
     }
   }
-
-  // pass the created vertex array to the points geometry object.
-  this->setVertexArray(mpOuterVertices);
-
-  //PLANES
-  // base plane bottom
-  osg::DrawElementsUInt* basePlane = new osg::DrawElementsUInt(osg::PrimitiveSet::QUADS, 0);
-  int numFacettes = ELEMENTS_CONTOUR * (numSegments - 2);
-  for (int i = 0; i < numFacettes; i++) {
-    basePlane = new osg::DrawElementsUInt(osg::PrimitiveSet::QUADS, 0);
-    basePlane->push_back(i);
-    basePlane->push_back(i + 1);
-    basePlane->push_back(i + ELEMENTS_CONTOUR);
-    basePlane->push_back(i + ELEMENTS_CONTOUR-1);
-    this->addPrimitiveSet(basePlane);
-  }
-  //std::cout << "NUM " << mpOuterVertices->size() << std::endl;
-  //this->addPrimitiveSet(new osg::DrawArrays(osg::PrimitiveSet::POINTS, 0, mpOuterVertices->size()));
 }
 
 
@@ -616,100 +652,75 @@ osg::Vec3f DXF3dFace::calcNormals()
 DXFile::DXFile(std::string filename)
   : osg::Geometry()
 {
-  // parse dxf file and fill 3dface objects
+  // parse dxf file and fill 3dface objects in a single pass
   fileName = filename;
-  QFile* dxfFile = new QFile(QString::fromStdString(filename));
-  if (dxfFile->open(QIODevice::ReadOnly))
+  QFile dxfFile(QString::fromStdString(filename));
+  if (dxfFile.open(QIODevice::ReadOnly))
   {
-    QTextStream* in = new QTextStream(dxfFile);
-    //count all 3d faces
-    int num3dFaces = in->readAll().count(QString("3DFACE"));
-
-    //reset textstream
-    in->seek(0);
+    QTextStream in(&dxfFile);
 
     // prepare drawing objects
-    osg::ref_ptr<osg::Vec3Array> vertices = new osg::Vec3Array(num3dFaces * 4);
-    osg::ref_ptr<osg::Vec4Array> colors = new osg::Vec4Array(num3dFaces * 4);
-    osg::ref_ptr<osg::Vec3Array> normals = new osg::Vec3Array(num3dFaces * 4);
+    osg::ref_ptr<osg::Vec3Array> vertices = new osg::Vec3Array();
+    osg::ref_ptr<osg::Vec4Array> colors = new osg::Vec4Array();
+    osg::ref_ptr<osg::Vec3Array> normals = new osg::Vec3Array();
+    osg::ref_ptr<osg::DrawElementsUInt> triangles = new osg::DrawElementsUInt(osg::PrimitiveSet::TRIANGLES, 0);
+    osg::ref_ptr<osg::DrawElementsUInt> quads = new osg::DrawElementsUInt(osg::PrimitiveSet::QUADS, 0);
 
     // fill face objects
-    DXF3dFace* faces = new DXF3dFace[num3dFaces];
-    QString line = in->readLine();
-    int faceIdx = 0;
-
+    QString line = in.readLine();
     int done = 0;
     while (!done)
     {
       if (!line.compare("SECTION")) {
-        int secID = in->readLine().toInt();
-        //std::cout << "enter section" << secID << std::endl;
-        line = in->readLine();
+        in.readLine();
+        line = in.readLine();
       }
       else if (!line.compare("ENTITIES")) {
-        int entityID = in->readLine().toInt();
-        //std::cout << "enter entity" << entityID << std::endl;
-        line = in->readLine();
+        in.readLine();
+        line = in.readLine();
       }
       else if (!line.compare("3DFACE")) {
-        //std::cout << "fill face entity" << std::endl;
-
+        DXF3dFace face;
+        line = face.fill3dFace(&in);
+        unsigned int vertIdx = vertices->size();
         //add vertices
-        line = faces[faceIdx].fill3dFace(in);
-        (*vertices)[(faceIdx*4) + 0] = faces[faceIdx].vec1;
-        (*vertices)[(faceIdx * 4) + 1] = faces[faceIdx].vec2;
-        (*vertices)[(faceIdx * 4) + 2] = faces[faceIdx].vec3;
-        (*vertices)[(faceIdx * 4) + 3] = faces[faceIdx].vec4;
+        vertices->push_back(face.vec1);
+        vertices->push_back(face.vec2);
+        vertices->push_back(face.vec3);
+        vertices->push_back(face.vec4);
         //add colors
-        (*colors)[(faceIdx * 4) + 0] = faces[faceIdx].color;
-        (*colors)[(faceIdx * 4) + 1] = faces[faceIdx].color;
-        (*colors)[(faceIdx * 4) + 2] = faces[faceIdx].color;
-        (*colors)[(faceIdx * 4) + 3] = faces[faceIdx].color;
+        colors->insert(colors->end(), 4, face.color);
         //add normals
-        (*normals)[(faceIdx * 4) + 0] = faces[faceIdx].calcNormals();
-        (*normals)[(faceIdx * 4) + 1] = faces[faceIdx].calcNormals();
-        (*normals)[(faceIdx * 4) + 2] = faces[faceIdx].calcNormals();
-        (*normals)[(faceIdx * 4) + 3] = faces[faceIdx].calcNormals();
-
-        faceIdx = faceIdx + 1;
+        normals->insert(normals->end(), 4, face.calcNormals());
+        //add planes
+        if (face.vec1 == face.vec4) {
+          triangles->push_back(vertIdx + 0);
+          triangles->push_back(vertIdx + 1);
+          triangles->push_back(vertIdx + 2);
+        } else {
+          quads->push_back(vertIdx + 0);
+          quads->push_back(vertIdx + 1);
+          quads->push_back(vertIdx + 2);
+          quads->push_back(vertIdx + 3);
+        }
       }
       else if (!line.compare("ENDSEC")) {
-        //std::cout << "close section" << std::endl;
-        line = in->readLine();
+        line = in.readLine();
       }
-      else if (!line.compare("EOF")) {
+      else if (!line.compare("EOF") || in.atEnd()) {
         done = 1;
       }
       else {
-        line = in->readLine();
+        line = in.readLine();
       }
     }
-    dxfFile->close();
+    dxfFile.close();
 
-    //add planes
     this->setVertexArray(vertices);
-    for (int i = 0; i < num3dFaces; i++)
-    {
-      if (faces[i].vec1 == faces[i].vec4) {
-        //std::cout << "its a triangle" << std::endl;
-        //faces[i].dumpDXF3DFace();
-        osg::ref_ptr<osg::DrawElementsUInt> facette = new osg::DrawElementsUInt(osg::PrimitiveSet::TRIANGLES, 3);
-        (*facette)[0] = (i * 4) + 0;
-        (*facette)[1] = (i * 4) + 1;
-        (*facette)[2] = (i * 4) + 2;
-        this->addPrimitiveSet(facette);
-      }
-      else
-      {
-        //std::cout << "its a quad" << std::endl;
-        osg::ref_ptr<osg::DrawElementsUInt> facette = new osg::DrawElementsUInt(osg::PrimitiveSet::QUADS, 4);
-        (*facette)[0] = (i * 4) + 0;
-        (*facette)[1] = (i * 4) + 1;
-        (*facette)[2] = (i * 4) + 2;
-        (*facette)[3] = (i * 4) + 3;
-        this->addPrimitiveSet(facette);
-      }
-    }
+    if (triangles->size() > 0)
+      this->addPrimitiveSet(triangles);
+    if (quads->size() > 0)
+      this->addPrimitiveSet(quads);
     //add normals
     this->setNormalArray(normals);
     this->setNormalBinding(osg::Geometry::BIND_PER_VERTEX);
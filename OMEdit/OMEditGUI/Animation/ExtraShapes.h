@@ -51,6 +51,9 @@ class Pipecylinder : public osg::Geometry
 public:
   Pipecylinder(float rI, float rO, float l);
   ~Pipecylinder() {};
+  float getInnerRadius() const {return mInnerRadius;}
+private:
+  float mInnerRadius;
 };
 
 
@@ -59,7 +62,13 @@ class Spring : public osg::Geometry
 public:
   Spring(float r, float rCoil, float nWindings,  float l);
   ~Spring() {};
+  float getRadius() const {return mRadius;}
+  float getWireRadius() const {return mWireRadius;}
+  float getWindings() const {return mWindings;}
+  float getLength() const {return mLength;}
+  void setLength(float l);
 private:
+  void updateVertices();
   osg::Vec3f getNormal(osg::Vec3f vec, float length = 1);
   osg::Vec3f rotateX(osg::Vec3f vec, float phi);
   osg::Vec3f rotateY(osg::Vec3f vec, float phi);
@@ -70,6 +79,12 @@ private:
 
   osg::Vec3Array* mpOuterVertices;
   osg::Vec3Array* mpSplineVertices;
+  int mElementsWinding;
+  int mElementsContour;
+  float mRadius;
+  float mWireRadius;
+  float mWindings;
+  float mLength;
 };
 
 class DXF3dFace
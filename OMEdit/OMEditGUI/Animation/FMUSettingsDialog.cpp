@@ -58,6 +58,9 @@ FMUSettingsDialog::FMUSettingsDialog(QWidget *pParent, VisualizerFMU* pVisualize
   QLabel *solverLabel = new QLabel(tr("Solver"));
   mpSolverComboBox = new QComboBox();
   mpSolverComboBox->addItem(QString("Explicit Euler"), QVariant((int)Solver::EULER_FORWARD));
+  mpSolverComboBox->addItem(QString("Runge-Kutta 4"), QVariant((int)Solver::RUNGE_KUTTA_4));
+  mpSolverComboBox->addItem(QString("Dormand-Prince 5(4)"), QVariant((int)Solver::DORMAND_PRINCE));
+  mpSolverComboBox->addItem(QString("Implicit Euler"), QVariant((int)Solver::EULER_BACKWARD));
   Label *stepsizeLabel = new Label(tr("Step Size [s]"));
   mpStepSizeLineEdit = new QLineEdit(QString::number(mStepSize));
   Label *handleEventsLabel = new Label(tr("Process Events in FMU"));
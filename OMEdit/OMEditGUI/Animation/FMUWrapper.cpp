@@ -37,6 +37,9 @@
 #include "Modeling/MessagesWidget.h"
 #include "Util/Helper.h"
 
+#include <algorithm>
+#include <cmath>
+
 SimSettingsFMU::SimSettingsFMU()
                 : _callEventUpdate(fmi1_false),
                   _toleranceControlled(fmi1_true),
@@ -100,6 +103,11 @@ void SimSettingsFMU::setSolver(const Solver& solver)
   _solver = solver;
 }
 
+Solver SimSettingsFMU::getSolver() const
+{
+  return _solver;
+}
+
 int* SimSettingsFMU::getCallEventUpdate()
 {
   return &_callEventUpdate;
@@ -124,7 +132,228 @@ bool SimSettingsFMU::getIterateEvents()
 //-------------------------------
 
 
-FMUWrapperAbstract::FMUWrapperAbstract(){
+FMUWrapperAbstract::FMUWrapperAbstract()
+  : mDormandPrinceStepSize(0.0)
+{
+}
+
+/*!
+ * \brief FMUWrapperAbstract::integrateStep
+ * Integrates the continuous states from _tcur - _hcur to _tcur with the given solver.
+ * Expects _statesDer to hold the derivatives at the beginning of the step, i.e. solveSystem() was called before.
+ * \param solver
+ * \param relativeTolerance Used by the step size control of the Dormand-Prince solver.
+ */
+void FMUWrapperAbstract::integrateStep(const Solver solver, const double relativeTolerance)
+{
+  if (getFMUData()->_nStates == 0) {
+    return;
+  }
+  switch (solver) {
+    case Solver::RUNGE_KUTTA_4:
+      doRungeKuttaStep();
+      break;
+    case Solver::DORMAND_PRINCE:
+      doDormandPrinceStep(relativeTolerance);
+      break;
+    case Solver::EULER_BACKWARD:
+      doImplicitEulerStep();
+      break;
+    case Solver::EULER_FORWARD:
+    default:
+      doEulerStep();
+      break;
+  }
+}
+
+void FMUWrapperAbstract::resizeWorkspace(const size_t nStates)
+{
+  if (mX0.size() != nStates) {
+    mX0.assign(nStates, 0.0);
+    mXs.assign(nStates, 0.0);
+    mXn.assign(nStates, 0.0);
+    for (int i = 0; i < 7; ++i) {
+      mK[i].assign(nStates, 0.0);
+    }
+    mJacobian.assign(nStates * nStates, 0.0);
+    mDormandPrinceStepSize = 0.0;
+  }
+}
+
+/*!
+ * \brief FMUWrapperAbstract::doRungeKuttaStep
+ * Classical 4th order Runge-Kutta step.
+ */
+void FMUWrapperAbstract::doRungeKuttaStep()
+{
+  const FMUData* data = getFMUData();
+  const size_t n = data->_nStates;
+  const double h = data->_hcur;
+  const double t0 = data->_tcur - h;
+  resizeWorkspace(n);
+
+  double* x = data->_states;
+  const double* k1 = data->_statesDer;
+  for (size_t k = 0; k < n; ++k)
+    mXs[k] = x[k] + 0.5 * h * k1[k];
+  computeDerivatives(t0 + 0.5 * h, mXs.data(), mK[1].data());
+  for (size_t k = 0; k < n; ++k)
+    mXs[k] = x[k] + 0.5 * h * mK[1][k];
+  computeDerivatives(t0 + 0.5 * h, mXs.data(), mK[2].data());
+  for (size_t k = 0; k < n; ++k)
+    mXs[k] = x[k] + h * mK[2][k];
+  computeDerivatives(t0 + h, mXs.data(), mK[3].data());
+  for (size_t k = 0; k < n; ++k)
+    x[k] = x[k] + h / 6.0 * (k1[k] + 2.0 * mK[1][k] + 2.0 * mK[2][k] + mK[3][k]);
+}
+
+/*!
+ * \brief FMUWrapperAbstract::doDormandPrinceStep
+ * Dormand-Prince 5(4) with embedded error estimation. The step from _tcur - _hcur to _tcur is divided into
+ * adaptive substeps, the last accepted substep size is reused as initial guess for the next call.
+ * \param relativeTolerance
+ */
+void FMUWrapperAbstract::doDormandPrinceStep(const double relativeTolerance)
+{
+  static const double c2 = 1.0/5.0, c3 = 3.0/10.0, c4 = 4.0/5.0, c5 = 8.0/9.0;
+  static const double a21 = 1.0/5.0;
+  static const double a31 = 3.0/40.0, a32 = 9.0/40.0;
+  static const double a41 = 44.0/45.0, a42 = -56.0/15.0, a43 = 32.0/9.0;
+  static const double a51 = 19372.0/6561.0, a52 = -25360.0/2187.0, a53 = 64448.0/6561.0, a54 = -212.0/729.0;
+  static const double a61 = 9017.0/3168.0, a62 = -355.0/33.0, a63 = 46732.0/5247.0, a64 = 49.0/176.0, a65 = -5103.0/18656.0;
+  static const double a71 = 35.0/384.0, a73 = 500.0/1113.0, a74 = 125.0/192.0, a75 = -2187.0/6784.0, a76 = 11.0/84.0;
+  static const double e1 = 71.0/57600.0, e3 = -71.0/16695.0, e4 = 71.0/1920.0, e5 = -17253.0/339200.0, e6 = 22.0/525.0, e7 = -1.0/40.0;
+
+  const FMUData* data = getFMUData();
+  const size_t n = data->_nStates;
+  const double tEnd = data->_tcur;
+  const double hMin = data->_hcur * 1e-6;
+  double t = data->_tcur - data->_hcur;
+  resizeWorkspace(n);
+
+  std::copy(data->_states, data->_states + n, mX0.begin());
+  std::copy(data->_statesDer, data->_statesDer + n, mK[0].begin());
+  double h = (mDormandPrinceStepSize > 0.0) ? std::min(mDormandPrinceStepSize, data->_hcur) : data->_hcur;
+  const double tolerance = relativeTolerance > 0.0 ? relativeTolerance : 1e-3;
+
+  while (tEnd - t > hMin) {
+    bool lastStep = (h >= tEnd - t);
+    if (lastStep) {
+      h = tEnd - t;
+    }
+    for (size_t k = 0; k < n; ++k)
+      mXs[k] = mX0[k] + h * a21 * mK[0][k];
+    computeDerivatives(t + c2 * h, mXs.data(), mK[1].data());
+    for (size_t k = 0; k < n; ++k)
+      mXs[k] = mX0[k] + h * (a31 * mK[0][k] + a32 * mK[1][k]);
+    computeDerivatives(t + c3 * h, mXs.data(), mK[2].data());
+    for (size_t k = 0; k < n; ++k)
+      mXs[k] = mX0[k] + h * (a41 * mK[0][k] + a42 * mK[1][k] + a43 * mK[2][k]);
+    computeDerivatives(t + c4 * h, mXs.data(), mK[3].data());
+    for (size_t k = 0; k < n; ++k)
+      mXs[k] = mX0[k] + h * (a51 * mK[0][k] + a52 * mK[1][k] + a53 * mK[2][k] + a54 * mK[3][k]);
+    computeDerivatives(t + c5 * h, mXs.data(), mK[4].data());
+    for (size_t k = 0; k < n; ++k)
+      mXs[k] = mX0[k] + h * (a61 * mK[0][k] + a62 * mK[1][k] + a63 * mK[2][k] + a64 * mK[3][k] + a65 * mK[4][k]);
+    computeDerivatives(t + h, mXs.data(), mK[5].data());
+    for (size_t k = 0; k < n; ++k)
+      mXn[k] = mX0[k] + h * (a71 * mK[0][k] + a73 * mK[2][k] + a74 * mK[3][k] + a75 * mK[4][k] + a76 * mK[5][k]);
+    computeDerivatives(t + h, mXn.data(), mK[6].data());
+
+    // error estimate from the embedded 4th order solution
+    double error = 0.0;
+    for (size_t k = 0; k < n; ++k) {
+      double scale = tolerance * (1.0 + std::max(std::fabs(mX0[k]), std::fabs(mXn[k])));
+      double e = h * (e1 * mK[0][k] + e3 * mK[2][k] + e4 * mK[3][k] + e5 * mK[4][k] + e6 * mK[5][k] + e7 * mK[6][k]) / scale;
+      error += e * e;
+    }
+    error = std::sqrt(error / n);
+
+    double factor = (error > 0.0) ? 0.9 * std::pow(error, -0.2) : 5.0;
+    factor = std::min(5.0, std::max(0.2, factor));
+    if (error <= 1.0 || h <= hMin) {
+      // accept the step, first same as last
+      t = lastStep ? tEnd : t + h;
+      mX0.swap(mXn);
+      mK[0].swap(mK[6]);
+      if (!lastStep || factor < 1.0) {
+        mDormandPrinceStepSize = h * factor;
+      }
+      h *= factor;
+    } else {
+      h = std::max(hMin, h * factor);
+    }
+  }
+  std::copy(mX0.begin(), mX0.end(), data->_states);
+}
+
+/*!
+ * \brief FMUWrapperAbstract::doImplicitEulerStep
+ * Linearly implicit Euler step: solves (I - h*J)*dx = h*f(t+h, x) with a finite difference Jacobian.
+ * Falls back to an explicit Euler step if the iteration matrix is singular.
+ */
+void FMUWrapperAbstract::doImplicitEulerStep()
+{
+  const FMUData* data = getFMUData();
+  const size_t n = data->_nStates;
+  const double h = data->_hcur;
+  const double t1 = data->_tcur;
+  resizeWorkspace(n);
+
+  double* x = data->_states;
+  std::copy(x, x + n, mX0.begin());
+  std::copy(x, x + n, mXs.begin());
+  computeDerivatives(t1, mX0.data(), mK[0].data());
+  // finite difference Jacobian, column by column
+  for (size_t j = 0; j < n; ++j) {
+    double delta = 1.5e-8 * std::max(std::fabs(mX0[j]), 1.0);
+    mXs[j] = mX0[j] + delta;
+    computeDerivatives(t1, mXs.data(), mK[1].data());
+    mXs[j] = mX0[j];
+    for (size_t i = 0; i < n; ++i) {
+      mJacobian[i * n + j] = -h * (mK[1][i] - mK[0][i]) / delta;
+    }
+    mJacobian[j * n + j] += 1.0;
+  }
+  for (size_t i = 0; i < n; ++i) {
+    mXn[i] = h * mK[0][i];
+  }
+  // gaussian elimination with partial pivoting
+  for (size_t c = 0; c < n; ++c) {
+    size_t pivot = c;
+    for (size_t r = c + 1; r < n; ++r) {
+      if (std::fabs(mJacobian[r * n + c]) > std::fabs(mJacobian[pivot * n + c])) {
+        pivot = r;
+      }
+    }
+    if (std::fabs(mJacobian[pivot * n + c]) < 1e-300) {
+      doEulerStep();
+      return;
+    }
+    if (pivot != c) {
+      std::swap_ranges(mJacobian.begin() + c * n, mJacobian.begin() + (c + 1) * n, mJacobian.begin() + pivot * n);
+      std::swap(mXn[c], mXn[pivot]);
+    }
+    for (size_t r = c + 1; r < n; ++r) {
+      double f = mJacobian[r * n + c] / mJacobian[c * n + c];
+      if (f != 0.0) {
+        for (size_t k = c; k < n; ++k) {
+          mJacobian[r * n + k] -= f * mJacobian[c * n + k];
+        }
+        mXn[r] -= f * mXn[c];
+      }
+    }
+  }
+  for (size_t c = n; c-- > 0;) {
+    double sum = mXn[c];
+    for (size_t k = c + 1; k < n; ++k) {
+      sum -= mJacobian[c * n + k] * mXn[k];
+    }
+    mXn[c] = sum / mJacobian[c * n + c];
+  }
+  for (size_t k = 0; k < n; ++k) {
+    x[k] = mX0[k] + mXn[k];
+  }
 }
 
 //-------------------------------
@@ -160,6 +389,11 @@ void FMUWrapper_ME_1::fmi_get_real(unsigned int* valueRef, double* res)
   fmi1_import_get_real(mpFMU, valueRef, 1, res);
 }
 
+void FMUWrapper_ME_1::fmi_get_reals(const unsigned int* valueRefs, const size_t n, double* res)
+{
+  fmi1_import_get_real(mpFMU, valueRefs, n, res);
+}
+
 unsigned int FMUWrapper_ME_1::fmi_get_variable_by_name(const char* name)
 {
     fmi1_import_variable_t* var = fmi1_import_get_variable_by_name(mpFMU, name);
@@ -345,6 +579,18 @@ void FMUWrapper_ME_1::completedIntegratorStep(int* callEventUpdate)
   mFMUdata._fmiStatus = fmi1_import_completed_integrator_step(mpFMU, (char*)callEventUpdate);
 }
 
+void FMUWrapper_ME_1::computeDerivatives(const double time, const double* states, double* derivatives)
+{
+  mFMUdata._fmiStatus = fmi1_import_set_time(mpFMU, time);
+  mFMUdata._fmiStatus = fmi1_import_set_continuous_states(mpFMU, states, mFMUdata._nStates);
+  mFMUdata._fmiStatus = fmi1_import_get_derivatives(mpFMU, derivatives, mFMUdata._nStates);
+}
+
+void FMUWrapper_ME_1::setCurrentTime(const double time)
+{
+  mFMUdata._tcur = time;
+}
+
 //-------------------------------
 // FMU Model Exchange Version 2.0
 //-------------------------------
@@ -379,6 +625,11 @@ void FMUWrapper_ME_2::fmi_get_real(unsigned int* valueRef, double* res)
   fmi2_import_get_real(mpFMU, valueRef, 1, res);
 }
 
+void FMUWrapper_ME_2::fmi_get_reals(const unsigned int* valueRefs, const size_t n, double* res)
+{
+  fmi2_import_get_real(mpFMU, valueRefs, n, res);
+}
+
 void FMUWrapper_ME_2::load(const std::string& modelFile, const std::string& path, fmi_import_context_t* context)
 {
   //Callbackfunctions
@@ -586,6 +837,18 @@ void FMUWrapper_ME_2::completedIntegratorStep(int* callEventUpdate)
   mFMUdata.fmiStatus2 = fmi2_import_completed_integrator_step(mpFMU, fmi2_true, (fmi2_boolean_t*)callEventUpdate, &mFMUdata.terminateSimulation);
 }
 
+void FMUWrapper_ME_2::computeDerivatives(const double time, const double* states, double* derivatives)
+{
+  mFMUdata.fmiStatus2 = fmi2_import_set_time(mpFMU, time);
+  mFMUdata.fmiStatus2 = fmi2_import_set_continuous_states(mpFMU, states, mFMUdata._nStates);
+  mFMUdata.fmiStatus2 = fmi2_import_get_derivatives(mpFMU, derivatives, mFMUdata._nStates);
+}
+
+void FMUWrapper_ME_2::setCurrentTime(const double time)
+{
+  mFMUdata._tcur = time;
+}
+
 unsigned int FMUWrapper_ME_2::fmi_get_variable_by_name(const char* name)
 {
     fmi2_import_variable_t* var = fmi2_import_get_variable_by_name(mpFMU, name);
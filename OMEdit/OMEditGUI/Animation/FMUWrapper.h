@@ -42,6 +42,7 @@
 #include <iostream>
 #include <memory>
 #include <map>
+#include <vector>
 
 
 typedef struct
@@ -69,7 +70,10 @@ typedef struct
 enum class Solver
 {
   NONE = 0,
-  EULER_FORWARD = 1
+  EULER_FORWARD = 1,
+  RUNGE_KUTTA_4 = 2,
+  DORMAND_PRINCE = 3,
+  EULER_BACKWARD = 4
 };
 
 class SimSettingsFMU
@@ -89,6 +93,7 @@ class SimSettingsFMU
   double getRelativeTolerance();
   int getToleranceControlled() const;
   void setSolver(const Solver& solver);
+  Solver getSolver() const;
   int* getCallEventUpdate();
   int getIntermediateResults();
   void setIterateEvents(bool iE);
@@ -126,10 +131,27 @@ class FMUWrapperAbstract
   virtual void doEulerStep() = 0;
   virtual void setContinuousStates() = 0;
   virtual void completedIntegratorStep(int* callEventUpdate) = 0;
+  virtual void computeDerivatives(const double time, const double* states, double* derivatives) = 0;
+  virtual void setCurrentTime(const double time) = 0;
+  void integrateStep(const Solver solver, const double relativeTolerance);
 
   virtual const FMUData* getFMUData()  = 0;
   virtual void fmi_get_real(unsigned int* valueRef, double* res) = 0;
+  virtual void fmi_get_reals(const unsigned int* valueRefs, const size_t n, double* res) = 0;
   virtual unsigned int fmi_get_variable_by_name(const char* name) = 0;
+
+ private:
+  void resizeWorkspace(const size_t nStates);
+  void doRungeKuttaStep();
+  void doDormandPrinceStep(const double relativeTolerance);
+  void doImplicitEulerStep();
+
+  std::vector<double> mX0;
+  std::vector<double> mXs;
+  std::vector<double> mXn;
+  std::vector<double> mK[7];
+  std::vector<double> mJacobian;
+  double mDormandPrinceStepSize;
 };
 
 class FMUWrapper_ME_1 : public FMUWrapperAbstract
@@ -152,10 +174,13 @@ class FMUWrapper_ME_1 : public FMUWrapperAbstract
   void doEulerStep();
   void setContinuousStates();
   void completedIntegratorStep(int* callEventUpdate);
+  void computeDerivatives(const double time, const double* states, double* derivatives);
+  void setCurrentTime(const double time);
 
   const FMUData* getFMUData();
   fmi1_import_t* getFMU();
   void fmi_get_real(unsigned int* valueRef, double* res);
+  void fmi_get_reals(const unsigned int* valueRefs, const size_t n, double* res);
   unsigned int fmi_get_variable_by_name(const char* name);
 
  private:
@@ -184,11 +209,14 @@ class FMUWrapper_ME_2 : public FMUWrapperAbstract
   void solveSystem();
   void doEulerStep();
   void completedIntegratorStep(int* callEventUpdate);
+  void computeDerivatives(const double time, const double* states, double* derivatives);
+  void setCurrentTime(const double time);
   void do_event_iteration(fmi2_import_t *fmu, fmi2_event_info_t *eventInfo);
 
   const FMUData* getFMUData();
   fmi2_import_t* getFMU();
   void fmi_get_real(unsigned int* valueRef, double* res);
+  void fmi_get_reals(const unsigned int* valueRefs, const size_t n, double* res);
   unsigned int fmi_get_variable_by_name(const char* name);
 
  private:
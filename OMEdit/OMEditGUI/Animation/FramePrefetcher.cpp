@@ -0,0 +1,244 @@
+/*
+ * This file is part of OpenModelica.
+ *
+ * Copyright (c) 1998-CurrentYear, Open Source Modelica Consortium (OSMC),
+ * c/o Linköpings universitet, Department of Computer and Information Science,
+ * SE-58183 Linköping, Sweden.
+ *
+ * All rights reserved.
+ *
+ * THIS PROGRAM IS PROVIDED UNDER THE TERMS OF GPL VERSION 3 LICENSE OR
+ * THIS OSMC PUBLIC LICENSE (OSMC-PL) VERSION 1.2.
+ * ANY USE, REPRODUCTION OR DISTRIBUTION OF THIS PROGRAM CONSTITUTES
+ * RECIPIENT'S ACCEPTANCE OF THE OSMC PUBLIC LICENSE OR THE GPL VERSION 3,
+ * ACCORDING TO RECIPIENTS CHOICE.
+ *
+ * The OpenModelica software and the Open Source Modelica
+ * Consortium (OSMC) Public License (OSMC-PL) are obtained
+ * from OSMC, either from the above address,
+ * from the URLs: http://www.ida.liu.se/projects/OpenModelica or
+ * http://www.openmodelica.org, and in the OpenModelica distribution.
+ * GNU version 3 is obtained from: http://www.gnu.org/copyleft/gpl.html.
+ *
+ * This program is distributed WITHOUT ANY WARRANTY; without
+ * even the implied warranty of  MERCHANTABILITY or FITNESS
+ * FOR A PARTICULAR PURPOSE, EXCEPT AS EXPRESSLY SET FORTH
+ * IN THE BY RECIPIENT SELECTED SUBSIDIARY LICENSE CONDITIONS OF OSMC-PL.
+ *
+ * See the full OSMC Public License conditions for more details.
+ *
+ */
+
+#include "FramePrefetcher.h"
+
+#include <algorithm>
+#include <cmath>
+
+/*!
+ * \brief FramePrefetcher::FramePrefetcher
+ * \param sampler Returns the value of a variable attribute at a point of time. Must be safe to call from the worker thread.
+ * \param queueSize The number of frames computed ahead.
+ */
+FramePrefetcher::FramePrefetcher(const Sampler& sampler, const size_t queueSize)
+  : mSampler(sampler),
+    mQueueSize(queueSize),
+    mShapes(),
+    mWorkerShapes(),
+    mTransforms(),
+    mWorkerTransforms(),
+    mThread(),
+    mMutex(),
+    mCondition(),
+    mQueue(),
+    mGeneration(0),
+    mNextTime(0.0),
+    mStep(0.0),
+    mStartTime(0.0),
+    mEndTime(0.0),
+    mStop(true)
+{
+}
+
+FramePrefetcher::~FramePrefetcher()
+{
+  stop();
+}
+
+/*!
+ * \brief FramePrefetcher::setShapes
+ * Sets the shapes whose frames are computed. Stops the worker, it is started again by the next prefetch().
+ * \param shapes
+ */
+void FramePrefetcher::setShapes(const std::vector<ShapeObject>& shapes)
+{
+  stop();
+  mShapes = shapes;
+  mWorkerShapes = shapes;
+  mTransforms.resize(shapes.size());
+  for (size_t i = 0; i < shapes.size(); ++i) {
+    mTransforms.setType(i, shapes[i]._type);
+  }
+  mWorkerTransforms = mTransforms;
+  mQueue.clear();
+  mStep = 0.0;
+}
+
+/*!
+ * \brief FramePrefetcher::computeFrame
+ * Computes a frame synchronously on the calling thread, e.g. after seeking.
+ * \param time
+ * \param frame
+ */
+void FramePrefetcher::computeFrame(const double time, AnimationFrame& frame)
+{
+  computeFrame(time, mShapes, mTransforms, frame);
+}
+
+/*!
+ * \brief FramePrefetcher::takeFrame
+ * Takes the prefetched frame for the time. Frames that were passed already are dropped.
+ * \param time
+ * \param frame
+ * \return false if the frame is not ready.
+ */
+bool FramePrefetcher::takeFrame(const double time, AnimationFrame& frame)
+{
+  const double eps = 1e-9 * std::max(1.0, std::fabs(time));
+  std::lock_guard<std::mutex> lock(mMutex);
+  while (!mQueue.empty() && (mStep >= 0.0 ? mQueue.front().time < time - eps : mQueue.front().time > time + eps)) {
+    mQueue.pop_front();
+  }
+  if (mQueue.empty() || std::fabs(mQueue.front().time - time) > eps) {
+    return false;
+  }
+  std::swap(frame, mQueue.front());
+  mQueue.pop_front();
+  mCondition.notify_one();
+  return true;
+}
+
+/*!
+ * \brief FramePrefetcher::prefetch
+ * Lets the worker compute the frames time, time + step, ... up to the start or end time.
+ * If the worker is busy with another sequence, e.g. after seeking or changing the speed, the stale frames are discarded.
+ * \param time
+ * \param step The visualization step, negative when playing backwards.
+ * \param startTime
+ * \param endTime
+ */
+void FramePrefetcher::prefetch(const double time, const double step, const double startTime, const double endTime)
+{
+  std::unique_lock<std::mutex> lock(mMutex);
+  const double eps = 1e-9 * std::max(1.0, std::fabs(time));
+  double expectedTime = mQueue.empty() ? mNextTime : mQueue.front().time;
+  if (!mStop && step == mStep && startTime == mStartTime && endTime == mEndTime && std::fabs(expectedTime - time) <= eps) {
+    return;
+  }
+  ++mGeneration;
+  mQueue.clear();
+  mNextTime = time;
+  mStep = step;
+  mStartTime = startTime;
+  mEndTime = endTime;
+  if (mStop) {
+    mStop = false;
+    lock.unlock();
+    if (mThread.joinable()) {
+      mThread.join();
+    }
+    mThread = std::thread(&FramePrefetcher::run, this);
+  } else {
+    mCondition.notify_one();
+  }
+}
+
+/*!
+ * \brief FramePrefetcher::stop
+ * Stops the worker and discards the prefetched frames.
+ */
+void FramePrefetcher::stop()
+{
+  {
+    std::lock_guard<std::mutex> lock(mMutex);
+    mStop = true;
+    ++mGeneration;
+    mQueue.clear();
+  }
+  mCondition.notify_one();
+  if (mThread.joinable()) {
+    mThread.join();
+  }
+}
+
+/*!
+ * \brief FramePrefetcher::getAttributes
+ * Collects the attributes of a shape that are read per frame, in frame order.
+ * \param shape
+ * \param attributes Array of at least maxAttributes entries.
+ * \return the number of attributes.
+ */
+size_t FramePrefetcher::getAttributes(ShapeObject& shape, ShapeObjectAttribute* attributes[])
+{
+  ShapeObjectAttribute* all[ShapeObject::numAttributes];
+  shape.getAttributes(all);
+  size_t n = 0;
+  for (size_t i = 0; i < maxAttributes; ++i) {
+    if (!all[i]->isConst) {
+      attributes[n++] = all[i];
+    }
+  }
+  return n;
+}
+
+void FramePrefetcher::computeFrame(const double time, std::vector<ShapeObject>& shapes, ShapeTransforms& transforms, AnimationFrame& frame) const
+{
+  ShapeObjectAttribute* attributes[maxAttributes];
+  frame.time = time;
+  frame.values.clear();
+  frame.matrices.resize(shapes.size());
+  size_t shapeIdx = 0;
+  for (ShapeObject& shape : shapes) {
+    size_t n = getAttributes(shape, attributes);
+    for (size_t i = 0; i < n; ++i) {
+      attributes[i]->exp = mSampler(*attributes[i], time);
+      frame.values.push_back(attributes[i]->exp);
+    }
+    transforms.setValues(shapeIdx, shape);
+    ++shapeIdx;
+  }
+  transforms.compute();
+  for (size_t i = 0; i < shapes.size(); ++i) {
+    transforms.getMatrix(i, frame.matrices[i]);
+  }
+}
+
+/*!
+ * \brief FramePrefetcher::run
+ * The worker loop. Fills the queue and drops frames that became stale while they were computed.
+ */
+void FramePrefetcher::run()
+{
+  AnimationFrame frame;
+  std::unique_lock<std::mutex> lock(mMutex);
+  while (!mStop) {
+    double time = mNextTime;
+    bool finished = (mStep == 0.0) || (mStep > 0.0 && time > mEndTime) || (mStep < 0.0 && time < mStartTime);
+    if (finished || mQueue.size() >= mQueueSize) {
+      mCondition.wait(lock);
+      continue;
+    }
+    unsigned int generation = mGeneration;
+    lock.unlock();
+    computeFrame(time, mWorkerShapes, mWorkerTransforms, frame);
+    lock.lock();
+    if (generation == mGeneration && !mStop) {
+      mQueue.push_back(frame);
+      // same stepping as VisualizerAbstract::sceneUpdate, clamped to the end of the result
+      if (mStep > 0.0) {
+        mNextTime = (time < mEndTime && time + mStep > mEndTime) ? mEndTime : time + mStep;
+      } else {
+        mNextTime = (time > mStartTime && time + mStep < mStartTime) ? mStartTime : time + mStep;
+      }
+    }
+  }
+}
@@ -0,0 +1,101 @@
+/*
+ * This file is part of OpenModelica.
+ *
+ * Copyright (c) 1998-CurrentYear, Open Source Modelica Consortium (OSMC),
+ * c/o Linköpings universitet, Department of Computer and Information Science,
+ * SE-58183 Linköping, Sweden.
+ *
+ * All rights reserved.
+ *
+ * THIS PROGRAM IS PROVIDED UNDER THE TERMS OF GPL VERSION 3 LICENSE OR
+ * THIS OSMC PUBLIC LICENSE (OSMC-PL) VERSION 1.2.
+ * ANY USE, REPRODUCTION OR DISTRIBUTION OF THIS PROGRAM CONSTITUTES
+ * RECIPIENT'S ACCEPTANCE OF THE OSMC PUBLIC LICENSE OR THE GPL VERSION 3,
+ * ACCORDING TO RECIPIENTS CHOICE.
+ *
+ * The OpenModelica software and the Open Source Modelica
+ * Consortium (OSMC) Public License (OSMC-PL) are obtained
+ * from OSMC, either from the above address,
+ * from the URLs: http://www.ida.liu.se/projects/OpenModelica or
+ * http://www.openmodelica.org, and in the OpenModelica distribution.
+ * GNU version 3 is obtained from: http://www.gnu.org/copyleft/gpl.html.
+ *
+ * This program is distributed WITHOUT ANY WARRANTY; without
+ * even the implied warranty of  MERCHANTABILITY or FITNESS
+ * FOR A PARTICULAR PURPOSE, EXCEPT AS EXPRESSLY SET FORTH
+ * IN THE BY RECIPIENT SELECTED SUBSIDIARY LICENSE CONDITIONS OF OSMC-PL.
+ *
+ * See the full OSMC Public License conditions for more details.
+ *
+ */
+
+#ifndef FRAMEPREFETCHER_H
+#define FRAMEPREFETCHER_H
+
+#include <condition_variable>
+#include <deque>
+#include <functional>
+#include <mutex>
+#include <thread>
+#include <vector>
+
+#include "Shapes.h"
+#include "ShapeTransforms.h"
+
+/*!
+ * \brief The AnimationFrame struct
+ * The values of all variable shape attributes at one point of time and the resulting transformation of each shape.
+ */
+struct AnimationFrame
+{
+  AnimationFrame() : time(0.0) {}
+  double time;
+  std::vector<float> values;
+  std::vector<osg::Matrix> matrices;
+};
+
+/*!
+ * \brief The FramePrefetcher class
+ * Computes the frames of a result file animation ahead of the playback on a worker thread.\n
+ * The worker reads the attribute values through the sampler and calculates the shape transformations,
+ * the GUI thread only takes the ready frames and applies them to the scene graph.
+ */
+class FramePrefetcher
+{
+public:
+  typedef std::function<double(const ShapeObjectAttribute& attribute, const double time)> Sampler;
+
+  FramePrefetcher(const Sampler& sampler, const size_t queueSize = 8);
+  ~FramePrefetcher();
+  FramePrefetcher(const FramePrefetcher& fp) = delete;
+  FramePrefetcher& operator=(const FramePrefetcher& fp) = delete;
+  void setShapes(const std::vector<ShapeObject>& shapes);
+  void computeFrame(const double time, AnimationFrame& frame);
+  bool takeFrame(const double time, AnimationFrame& frame);
+  void prefetch(const double time, const double step, const double startTime, const double endTime);
+  void stop();
+  static size_t getAttributes(ShapeObject& shape, ShapeObjectAttribute* attributes[]);
+  static const size_t maxAttributes = ShapeObject::numAttributes;
+private:
+  void computeFrame(const double time, std::vector<ShapeObject>& shapes, ShapeTransforms& transforms, AnimationFrame& frame) const;
+  void run();
+
+  Sampler mSampler;
+  size_t mQueueSize;
+  std::vector<ShapeObject> mShapes;
+  std::vector<ShapeObject> mWorkerShapes;
+  ShapeTransforms mTransforms;
+  ShapeTransforms mWorkerTransforms;
+  std::thread mThread;
+  std::mutex mMutex;
+  std::condition_variable mCondition;
+  std::deque<AnimationFrame> mQueue;
+  unsigned int mGeneration;
+  double mNextTime;
+  double mStep;
+  double mStartTime;
+  double mEndTime;
+  bool mStop;
+};
+
+#endif // FRAMEPREFETCHER_H
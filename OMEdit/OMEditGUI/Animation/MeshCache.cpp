@@ -0,0 +1,181 @@
+/*
+ * This file is part of OpenModelica.
+ *
+ * Copyright (c) 1998-CurrentYear, Open Source Modelica Consortium (OSMC),
+ * c/o Linköpings universitet, Department of Computer and Information Science,
+ * SE-58183 Linköping, Sweden.
+ *
+ * All rights reserved.
+ *
+ * THIS PROGRAM IS PROVIDED UNDER THE TERMS OF GPL VERSION 3 LICENSE OR
+ * THIS OSMC PUBLIC LICENSE (OSMC-PL) VERSION 1.2.
+ * ANY USE, REPRODUCTION OR DISTRIBUTION OF THIS PROGRAM CONSTITUTES
+ * RECIPIENT'S ACCEPTANCE OF THE OSMC PUBLIC LICENSE OR THE GPL VERSION 3,
+ * ACCORDING TO RECIPIENTS CHOICE.
+ *
+ * The OpenModelica software and the Open Source Modelica
+ * Consortium (OSMC) Public License (OSMC-PL) are obtained
+ * from OSMC, either from the above address,
+ * from the URLs: http://www.ida.liu.se/projects/OpenModelica or
+ * http://www.openmodelica.org, and in the OpenModelica distribution.
+ * GNU version 3 is obtained from: http://www.gnu.org/copyleft/gpl.html.
+ *
+ * This program is distributed WITHOUT ANY WARRANTY; without
+ * even the implied warranty of  MERCHANTABILITY or FITNESS
+ * FOR A PARTICULAR PURPOSE, EXCEPT AS EXPRESSLY SET FORTH
+ * IN THE BY RECIPIENT SELECTED SUBSIDIARY LICENSE CONDITIONS OF OSMC-PL.
+ *
+ * See the full OSMC Public License conditions for more details.
+ *
+ */
+
+#include "MeshCache.h"
+#include "ExtraShapes.h"
+#include "Util/Utilities.h"
+
+#include <iostream>
+
+#include <QCryptographicHash>
+#include <QDir>
+#include <QFileInfo>
+#include <osg/NodeVisitor>
+#include <osgDB/ReadFile>
+#include <osgDB/WriteFile>
+
+/*!
+ * \brief The DrawableCollector class
+ * Collects all the drawables of a loaded CAD node into one geode.
+ */
+class DrawableCollector : public osg::NodeVisitor
+{
+public:
+  DrawableCollector()
+    : osg::NodeVisitor(osg::NodeVisitor::TRAVERSE_ALL_CHILDREN),
+      mpGeode(new osg::Geode())
+  {
+  }
+  virtual void apply(osg::Geode& node)
+  {
+    for (unsigned int i = 0; i < node.getNumDrawables(); ++i)
+      mpGeode->addDrawable(node.getDrawable(i));
+    traverse(node);
+  }
+  osg::ref_ptr<osg::Geode> mpGeode;
+};
+
+/*!
+ * \brief MeshCache::instance
+ * Returns the MeshCache instance.
+ */
+MeshCache* MeshCache::instance()
+{
+  static MeshCache meshCache;
+  return &meshCache;
+}
+
+/*!
+ * \brief MeshCache::createGeode
+ * Creates a new geode for a shape that shares the drawables of the cached mesh.\n
+ * Every shape gets its own geode so that it can have its own color, texture and transparency.
+ * \param fileName - the CAD file.
+ * \param type - stl or dxf.
+ * \return the geode or nullptr if the file could not be read.
+ */
+osg::ref_ptr<osg::Geode> MeshCache::createGeode(const std::string& fileName, const std::string& type)
+{
+  QFileInfo fileInfo(QString::fromStdString(fileName));
+  QString absoluteFileName = fileInfo.absoluteFilePath();
+  QDateTime lastModified = fileInfo.lastModified();
+  Mesh& mesh = mMeshes[absoluteFileName];
+  if (!mesh.geode.valid() || mesh.lastModified != lastModified)
+  {
+    mesh.lastModified = lastModified;
+    mesh.geode = loadMesh(absoluteFileName, type, lastModified);
+    if (!mesh.geode.valid())
+    {
+      mMeshes.erase(absoluteFileName);
+      return nullptr;
+    }
+  }
+  osg::ref_ptr<osg::Geode> geode = new osg::Geode();
+  for (unsigned int i = 0; i < mesh.geode->getNumDrawables(); ++i)
+    geode->addDrawable(mesh.geode->getDrawable(i));
+  return geode;
+}
+
+/*!
+ * \brief MeshCache::clear
+ * Releases all the meshes kept in memory.
+ */
+void MeshCache::clear()
+{
+  mMeshes.clear();
+}
+
+/*!
+ * \brief MeshCache::loadMesh
+ * Reads the mesh from the binary cache file if it is up to date, otherwise parses the CAD file and writes the cache file.
+ * \param fileName
+ * \param type
+ * \param lastModified
+ * \return
+ */
+osg::ref_ptr<osg::Geode> MeshCache::loadMesh(const QString& fileName, const std::string& type, const QDateTime& lastModified)
+{
+  QString cacheFilePrefix = getCacheFilePrefix(fileName);
+  QString cacheFileName = QString("%1%2.osgb").arg(cacheFilePrefix).arg(lastModified.toMSecsSinceEpoch());
+  osg::ref_ptr<osg::Node> node = nullptr;
+  if (QFile::exists(cacheFileName))
+    node = osgDB::readNodeFile(cacheFileName.toStdString());
+  bool readFromCache = node.valid();
+  if (!readFromCache)
+  {
+    if (type == "dxf")
+    {
+      osg::ref_ptr<osg::Geode> geode = new osg::Geode();
+      geode->addDrawable(new DXFile(fileName.toStdString()));
+      node = geode;
+    }
+    else
+    {
+      node = osgDB::readNodeFile(fileName.toStdString());
+    }
+  }
+  if (!node.valid())
+    return nullptr;
+  DrawableCollector drawableCollector;
+  node->accept(drawableCollector);
+  if (!readFromCache)
+  {
+    // remove the cache files of the older versions of the CAD file
+    QFileInfo cacheFilePrefixInfo(cacheFilePrefix);
+    QDir cacheDirectory = cacheFilePrefixInfo.absoluteDir();
+    foreach (QString staleCacheFile, cacheDirectory.entryList(QStringList() << cacheFilePrefixInfo.fileName() + "*.osgb", QDir::Files))
+      cacheDirectory.remove(staleCacheFile);
+    if (!osgDB::writeNodeFile(*drawableCollector.mpGeode, cacheFileName.toStdString()))
+      std::cout<<"Could not write the mesh cache file "<<cacheFileName.toStdString()<<std::endl;
+  }
+  return drawableCollector.mpGeode;
+}
+
+/*!
+ * \brief MeshCache::getCacheDirectory
+ * Returns the directory of the binary cache files.
+ */
+QString MeshCache::getCacheDirectory() const
+{
+  QString cacheDirectory = QString("%1/mesh-cache").arg(Utilities::tempDirectory());
+  QDir().mkpath(cacheDirectory);
+  return cacheDirectory;
+}
+
+/*!
+ * \brief MeshCache::getCacheFilePrefix
+ * Returns the prefix of the cache files of a CAD file. The modification time is appended to it.
+ * \param fileName
+ */
+QString MeshCache::getCacheFilePrefix(const QString& fileName) const
+{
+  QString hash = QString(QCryptographicHash::hash(fileName.toUtf8(), QCryptographicHash::Md5).toHex());
+  return QString("%1/%2_").arg(getCacheDirectory(), hash);
+}
@@ -0,0 +1,71 @@
+/*
+ * This file is part of OpenModelica.
+ *
+ * Copyright (c) 1998-CurrentYear, Open Source Modelica Consortium (OSMC),
+ * c/o Linköpings universitet, Department of Computer and Information Science,
+ * SE-58183 Linköping, Sweden.
+ *
+ * All rights reserved.
+ *
+ * THIS PROGRAM IS PROVIDED UNDER THE TERMS OF GPL VERSION 3 LICENSE OR
+ * THIS OSMC PUBLIC LICENSE (OSMC-PL) VERSION 1.2.
+ * ANY USE, REPRODUCTION OR DISTRIBUTION OF THIS PROGRAM CONSTITUTES
+ * RECIPIENT'S ACCEPTANCE OF THE OSMC PUBLIC LICENSE OR THE GPL VERSION 3,
+ * ACCORDING TO RECIPIENTS CHOICE.
+ *
+ * The OpenModelica software and the Open Source Modelica
+ * Consortium (OSMC) Public License (OSMC-PL) are obtained
+ * from OSMC, either from the above address,
+ * from the URLs: http://www.ida.liu.se/projects/OpenModelica or
+ * http://www.openmodelica.org, and in the OpenModelica distribution.
+ * GNU version 3 is obtained from: http://www.gnu.org/copyleft/gpl.html.
+ *
+ * This program is distributed WITHOUT ANY WARRANTY; without
+ * even the implied warranty of  MERCHANTABILITY or FITNESS
+ * FOR A PARTICULAR PURPOSE, EXCEPT AS EXPRESSLY SET FORTH
+ * IN THE BY RECIPIENT SELECTED SUBSIDIARY LICENSE CONDITIONS OF OSMC-PL.
+ *
+ * See the full OSMC Public License conditions for more details.
+ *
+ */
+
+#ifndef MESHCACHE_H
+#define MESHCACHE_H
+
+#include <map>
+#include <string>
+
+#include <QDateTime>
+#include <QString>
+#include <osg/Geode>
+
+/*!
+ * \brief The MeshCache class
+ * Shares the geometry of the CAD files (stl and dxf) between all the shapes that use them.\n
+ * The meshes are kept in memory by path and modification time and are also stored in the binary osg format
+ * in the temporary directory so that opening an animation again doesn't parse the CAD files again.
+ */
+class MeshCache
+{
+public:
+  static MeshCache* instance();
+  osg::ref_ptr<osg::Geode> createGeode(const std::string& fileName, const std::string& type);
+  void clear();
+private:
+  MeshCache() = default;
+  ~MeshCache() = default;
+  MeshCache(const MeshCache& mc) = delete;
+  MeshCache& operator=(const MeshCache& mc) = delete;
+  osg::ref_ptr<osg::Geode> loadMesh(const QString& fileName, const std::string& type, const QDateTime& lastModified);
+  QString getCacheDirectory() const;
+  QString getCacheFilePrefix(const QString& fileName) const;
+
+  struct Mesh
+  {
+    QDateTime lastModified;
+    osg::ref_ptr<osg::Geode> geode;
+  };
+  std::map<QString, Mesh> mMeshes;
+};
+
+#endif // MESHCACHE_H
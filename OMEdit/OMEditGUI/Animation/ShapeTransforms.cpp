@@ -0,0 +1,198 @@
+/*
+ * This file is part of OpenModelica.
+ *
+ * Copyright (c) 1998-CurrentYear, Open Source Modelica Consortium (OSMC),
+ * c/o Linköpings universitet, Department of Computer and Information Science,
+ * SE-58183 Linköping, Sweden.
+ *
+ * All rights reserved.
+ *
+ * THIS PROGRAM IS PROVIDED UNDER THE TERMS OF GPL VERSION 3 LICENSE OR
+ * THIS OSMC PUBLIC LICENSE (OSMC-PL) VERSION 1.2.
+ * ANY USE, REPRODUCTION OR DISTRIBUTION OF THIS PROGRAM CONSTITUTES
+ * RECIPIENT'S ACCEPTANCE OF THE OSMC PUBLIC LICENSE OR THE GPL VERSION 3,
+ * ACCORDING TO RECIPIENTS CHOICE.
+ *
+ * The OpenModelica software and the Open Source Modelica
+ * Consortium (OSMC) Public License (OSMC-PL) are obtained
+ * from OSMC, either from the above address,
+ * from the URLs: http://www.ida.liu.se/projects/OpenModelica or
+ * http://www.openmodelica.org, and in the OpenModelica distribution.
+ * GNU version 3 is obtained from: http://www.gnu.org/copyleft/gpl.html.
+ *
+ * This program is distributed WITHOUT ANY WARRANTY; without
+ * even the implied warranty of  MERCHANTABILITY or FITNESS
+ * FOR A PARTICULAR PURPOSE, EXCEPT AS EXPRESSLY SET FORTH
+ * IN THE BY RECIPIENT SELECTED SUBSIDIARY LICENSE CONDITIONS OF OSMC-PL.
+ *
+ * See the full OSMC Public License conditions for more details.
+ *
+ */
+
+#include "ShapeTransforms.h"
+
+#include <cmath>
+
+ShapeTransforms::ShapeTransforms()
+{
+}
+
+/*!
+ * \brief ShapeTransforms::resize
+ * \param n The number of shapes.
+ */
+void ShapeTransforms::resize(const size_t n)
+{
+  for (int k = 0; k < 3; ++k) {
+    mR[k].assign(n, 0.0f);
+    mRShape[k].assign(n, 0.0f);
+    mLDir[k].assign(n, 0.0f);
+    mWDir[k].assign(n, 0.0f);
+    mResultR[k].assign(n, 0.0f);
+  }
+  for (int k = 0; k < 9; ++k) {
+    mT[k].assign(n, 0.0f);
+    mResultT[k].assign(n, 0.0f);
+  }
+  mLength.assign(n, 0.0f);
+  mOffset.assign(n, 0.5f);
+  mLengthAlongX.assign(n, 0.0f);
+}
+
+/*!
+ * \brief ShapeTransforms::setType
+ * Sets how the shape is aligned, see rotateModelica2OSG. The type doesn't change per frame.
+ * \param i
+ * \param type
+ */
+void ShapeTransforms::setType(const size_t i, const std::string& type)
+{
+  if ((type == "stl") || (type == "dxf")) {
+    mOffset[i] = 0.0f;
+    mLengthAlongX[i] = 1.0f;
+  } else if (type == "sphere") {
+    mOffset[i] = 0.5f;
+    mLengthAlongX[i] = 1.0f;
+  } else if ((type == "spring") || (type == "pipecylinder") || (type == "cone") || (type == "pipe")) {
+    mOffset[i] = 0.0f;
+    mLengthAlongX[i] = 0.0f;
+  } else {
+    mOffset[i] = 0.5f;
+    mLengthAlongX[i] = 0.0f;
+  }
+}
+
+/*!
+ * \brief ShapeTransforms::setValues
+ * Copies the current attribute values of the shape.
+ * \param i
+ * \param shape
+ */
+void ShapeTransforms::setValues(const size_t i, const ShapeObject& shape)
+{
+  for (int k = 0; k < 3; ++k) {
+    mR[k][i] = shape._r[k].exp;
+    mRShape[k][i] = shape._rShape[k].exp;
+    mLDir[k][i] = shape._lDir[k].exp;
+    mWDir[k][i] = shape._wDir[k].exp;
+  }
+  for (int k = 0; k < 9; ++k) {
+    mT[k][i] = shape._T[k].exp;
+  }
+  mLength[i] = shape._length.exp;
+}
+
+/*!
+ * \brief ShapeTransforms::compute
+ * Computes the transformations of all shapes.
+ * The loop body has no calls and no branches, only selects, so that the compiler can vectorize it.
+ */
+void ShapeTransforms::compute()
+{
+  const size_t n = size();
+  const float *rx = mR[0].data(), *ry = mR[1].data(), *rz = mR[2].data();
+  const float *sx = mRShape[0].data(), *sy = mRShape[1].data(), *sz = mRShape[2].data();
+  const float *lx = mLDir[0].data(), *ly = mLDir[1].data(), *lz = mLDir[2].data();
+  const float *wx = mWDir[0].data(), *wy = mWDir[1].data(), *wz = mWDir[2].data();
+  const float *T0 = mT[0].data(), *T1 = mT[1].data(), *T2 = mT[2].data();
+  const float *T3 = mT[3].data(), *T4 = mT[4].data(), *T5 = mT[5].data();
+  const float *T6 = mT[6].data(), *T7 = mT[7].data(), *T8 = mT[8].data();
+  const float *length = mLength.data(), *offset = mOffset.data(), *alongX = mLengthAlongX.data();
+  float *ox = mResultR[0].data(), *oy = mResultR[1].data(), *oz = mResultR[2].data();
+  float *M0 = mResultT[0].data(), *M1 = mResultT[1].data(), *M2 = mResultT[2].data();
+  float *M3 = mResultT[3].data(), *M4 = mResultT[4].data(), *M5 = mResultT[5].data();
+  float *M6 = mResultT[6].data(), *M7 = mResultT[7].data(), *M8 = mResultT[8].data();
+
+  for (size_t i = 0; i < n; ++i) {
+    // length direction, see fixDirections
+    float lNorm = std::sqrt(lx[i] * lx[i] + ly[i] * ly[i] + lz[i] * lz[i]);
+    bool lZero = lNorm < 1e-10f;
+    float lInv = 1.0f / (lZero ? 1.0f : lNorm);
+    float ex = lZero ? 1.0f : lx[i] * lInv;
+    float ey = lZero ? 0.0f : ly[i] * lInv;
+    float ez = lZero ? 0.0f : lz[i] * lInv;
+    // width direction
+    float nx = ey * wz[i] - ez * wy[i];
+    float ny = ez * wx[i] - ex * wz[i];
+    float nz = ex * wy[i] - ey * wx[i];
+    bool useW = (nx * nx + ny * ny + nz * nz) > 1e-6f;
+    bool exX = std::fabs(ex) > 1e-6f;
+    float ax = useW ? wx[i] : (exX ? 0.0f : 1.0f);
+    float ay = useW ? wy[i] : (exX ? 1.0f : 0.0f);
+    float az = useW ? wz[i] : 0.0f;
+    float cx = ey * az - ez * ay;
+    float cy = ez * ax - ex * az;
+    float cz = ex * ay - ey * ax;
+    float cNorm = std::sqrt(cx * cx + cy * cy + cz * cz);
+    bool cValid = cNorm >= 1e-13f;
+    float cInv = cValid ? 1.0f / (cValid ? cNorm : 1.0f) : 0.0f;
+    cx *= cInv;
+    cy *= cInv;
+    cz *= cInv;
+    float yx = cy * ez - cz * ey;
+    float yy = cz * ex - cx * ez;
+    float yz = cx * ey - cy * ex;
+    // height direction
+    float hx = ey * yz - ez * yy;
+    float hy = ez * yx - ex * yz;
+    float hz = ex * yy - ey * yx;
+    // rows of the shape rotation, (l, w, h) or (w, h, l)
+    float s = alongX[i];
+    float u = 1.0f - s;
+    float a0 = s * ex + u * yx, a1 = s * ey + u * yy, a2 = s * ez + u * yz;
+    float b0 = s * yx + u * hx, b1 = s * yy + u * hy, b2 = s * yz + u * hz;
+    float c0 = s * hx + u * ex, c1 = s * hy + u * ey, c2 = s * hz + u * ez;
+    // position
+    float o = offset[i] * length[i];
+    float px = sx[i] + ex * o;
+    float py = sy[i] + ey * o;
+    float pz = sz[i] + ez * o;
+    ox[i] = T0[i] * px + T3[i] * py + T6[i] * pz + rx[i];
+    oy[i] = T1[i] * px + T4[i] * py + T7[i] * pz + ry[i];
+    oz[i] = T2[i] * px + T5[i] * py + T8[i] * pz + rz[i];
+    // orientation
+    M0[i] = a0 * T0[i] + a1 * T3[i] + a2 * T6[i];
+    M1[i] = a0 * T1[i] + a1 * T4[i] + a2 * T7[i];
+    M2[i] = a0 * T2[i] + a1 * T5[i] + a2 * T8[i];
+    M3[i] = b0 * T0[i] + b1 * T3[i] + b2 * T6[i];
+    M4[i] = b0 * T1[i] + b1 * T4[i] + b2 * T7[i];
+    M5[i] = b0 * T2[i] + b1 * T5[i] + b2 * T8[i];
+    M6[i] = c0 * T0[i] + c1 * T3[i] + c2 * T6[i];
+    M7[i] = c0 * T1[i] + c1 * T4[i] + c2 * T7[i];
+    M8[i] = c0 * T2[i] + c1 * T5[i] + c2 * T8[i];
+  }
+}
+
+/*!
+ * \brief ShapeTransforms::getMatrix
+ * Returns the transformation of a shape, laid out like assemblePokeMatrix does.
+ * \param i
+ * \param M
+ */
+void ShapeTransforms::getMatrix(const size_t i, osg::Matrix& M) const
+{
+  M.set(mResultT[0][i], mResultT[1][i], mResultT[2][i], 0.0,
+        mResultT[3][i], mResultT[4][i], mResultT[5][i], 0.0,
+        mResultT[6][i], mResultT[7][i], mResultT[8][i], 0.0,
+        mResultR[0][i], mResultR[1][i], mResultR[2][i], 1.0);
+}
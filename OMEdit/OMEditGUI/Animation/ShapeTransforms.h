@@ -0,0 +1,73 @@
+/*
+ * This file is part of OpenModelica.
+ *
+ * Copyright (c) 1998-CurrentYear, Open Source Modelica Consortium (OSMC),
+ * c/o Linköpings universitet, Department of Computer and Information Science,
+ * SE-58183 Linköping, Sweden.
+ *
+ * All rights reserved.
+ *
+ * THIS PROGRAM IS PROVIDED UNDER THE TERMS OF GPL VERSION 3 LICENSE OR
+ * THIS OSMC PUBLIC LICENSE (OSMC-PL) VERSION 1.2.
+ * ANY USE, REPRODUCTION OR DISTRIBUTION OF THIS PROGRAM CONSTITUTES
+ * RECIPIENT'S ACCEPTANCE OF THE OSMC PUBLIC LICENSE OR THE GPL VERSION 3,
+ * ACCORDING TO RECIPIENTS CHOICE.
+ *
+ * The OpenModelica software and the Open Source Modelica
+ * Consortium (OSMC) Public License (OSMC-PL) are obtained
+ * from OSMC, either from the above address,
+ * from the URLs: http://www.ida.liu.se/projects/OpenModelica or
+ * http://www.openmodelica.org, and in the OpenModelica distribution.
+ * GNU version 3 is obtained from: http://www.gnu.org/copyleft/gpl.html.
+ *
+ * This program is distributed WITHOUT ANY WARRANTY; without
+ * even the implied warranty of  MERCHANTABILITY or FITNESS
+ * FOR A PARTICULAR PURPOSE, EXCEPT AS EXPRESSLY SET FORTH
+ * IN THE BY RECIPIENT SELECTED SUBSIDIARY LICENSE CONDITIONS OF OSMC-PL.
+ *
+ * See the full OSMC Public License conditions for more details.
+ *
+ */
+
+#ifndef SHAPETRANSFORMS_H
+#define SHAPETRANSFORMS_H
+
+#include <string>
+#include <vector>
+
+#include "Shapes.h"
+
+/*!
+ * \brief The ShapeTransforms class
+ * Holds the numeric state of all shapes that changes per frame as structure of arrays and
+ * computes the transformations of all shapes in one batch.\n
+ * It produces the same result as calling rotateModelica2OSG and assemblePokeMatrix for each shape.
+ */
+class ShapeTransforms
+{
+public:
+  ShapeTransforms();
+  void resize(const size_t n);
+  size_t size() const {return mLength.size();}
+  void setType(const size_t i, const std::string& type);
+  void setValues(const size_t i, const ShapeObject& shape);
+  void compute();
+  void getMatrix(const size_t i, osg::Matrix& M) const;
+private:
+  // input
+  std::vector<float> mR[3];
+  std::vector<float> mRShape[3];
+  std::vector<float> mT[9];
+  std::vector<float> mLDir[3];
+  std::vector<float> mWDir[3];
+  std::vector<float> mLength;
+  // 0.5 for the shapes that rotate about their centre, 0.0 otherwise
+  std::vector<float> mOffset;
+  // 1.0 for the shapes that have their length along the x axis, 0.0 for the ones along the z axis
+  std::vector<float> mLengthAlongX;
+  // output
+  std::vector<float> mResultR[3];
+  std::vector<float> mResultT[9];
+};
+
+#endif // SHAPETRANSFORMS_H
@@ -34,6 +34,8 @@
 
 #include "Shapes.h"
 
+#include <algorithm>
+
 ShapeObjectAttribute::ShapeObjectAttribute()
     : isConst(true),
       exp(0.0),
@@ -97,6 +99,53 @@ ShapeObject::ShapeObject()
   _T[8] = ShapeObjectAttribute(0.0);
 }
 
+/*!
+ * \brief ShapeObject::isStatic
+ * Returns true if all attributes are constant, i.e. the shape never changes during the animation.
+ */
+bool ShapeObject::isStatic() const
+{
+  const ShapeObjectAttribute* attributes[numAttributes];
+  getAttributes(attributes);
+  for (const ShapeObjectAttribute* attribute : attributes) {
+    if (!attribute->isConst) {
+      return false;
+    }
+  }
+  return true;
+}
+
+/*!
+ * \brief ShapeObject::getAttributes
+ * Collects all the attributes of the shape in frame order so that they can be modified.
+ * \param attributes Array of numAttributes entries.
+ * \sa ShapeObject::getAttributes(const ShapeObjectAttribute* attributes[]) const
+ */
+void ShapeObject::getAttributes(ShapeObjectAttribute* attributes[])
+{
+  static_cast<const ShapeObject*>(this)->getAttributes(const_cast<const ShapeObjectAttribute**>(attributes));
+}
+
+/*!
+ * \brief ShapeObject::getAttributes
+ * Collects all the attributes of the shape in frame order.
+ * \param attributes Array of numAttributes entries.
+ */
+void ShapeObject::getAttributes(const ShapeObjectAttribute* attributes[]) const
+{
+  const ShapeObjectAttribute* all[numAttributes] = {&_length, &_width, &_height,
+                                                    &_lDir[0], &_lDir[1], &_lDir[2],
+                                                    &_wDir[0], &_wDir[1], &_wDir[2],
+                                                    &_r[0], &_r[1], &_r[2],
+                                                    &_rShape[0], &_rShape[1], &_rShape[2],
+                                                    &_T[0], &_T[1], &_T[2],
+                                                    &_T[3], &_T[4], &_T[5],
+                                                    &_T[6], &_T[7], &_T[8],
+                                                    &_color[0], &_color[1], &_color[2],
+                                                    &_specCoeff, &_extra};
+  std::copy(all, all + numAttributes, attributes);
+}
+
 void ShapeObject::dumpVisAttributes() const
 {
   std::cout << "id " << _id << std::endl;
@@ -70,6 +70,9 @@ class ShapeObject
   ShapeObject(const ShapeObject&) = default;
   ShapeObject& operator=(const ShapeObject&) = default;
   void dumpVisAttributes() const;
+  bool isStatic() const;
+  void getAttributes(ShapeObjectAttribute* attributes[]);
+  void getAttributes(const ShapeObjectAttribute* attributes[]) const;
   void setTransparency(float transp) {mTransparent = transp;}
   float getTransparency() {return mTransparent;}
   void setTextureImagePath(std::string imagePath) {mTextureImagePath = imagePath;}
@@ -81,6 +84,7 @@ class ShapeObject
   void setStateSetAction(stateSetAction action) {mStateSetAction = action;}
   stateSetAction getStateSetAction() {return mStateSetAction;}
  public:
+  static const size_t numAttributes = 29;
   std::string _id;
   std::string _type;
   std::string _fileName;
@@ -0,0 +1,138 @@
+/*
+ * This file is part of OpenModelica.
+ *
+ * Copyright (c) 1998-CurrentYear, Open Source Modelica Consortium (OSMC),
+ * c/o Linköpings universitet, Department of Computer and Information Science,
+ * SE-58183 Linköping, Sweden.
+ *
+ * All rights reserved.
+ *
+ * THIS PROGRAM IS PROVIDED UNDER THE TERMS OF GPL VERSION 3 LICENSE OR
+ * THIS OSMC PUBLIC LICENSE (OSMC-PL) VERSION 1.2.
+ * ANY USE, REPRODUCTION OR DISTRIBUTION OF THIS PROGRAM CONSTITUTES
+ * RECIPIENT'S ACCEPTANCE OF THE OSMC PUBLIC LICENSE OR THE GPL VERSION 3,
+ * ACCORDING TO RECIPIENTS CHOICE.
+ *
+ * The OpenModelica software and the Open Source Modelica
+ * Consortium (OSMC) Public License (OSMC-PL) are obtained
+ * from OSMC, either from the above address,
+ * from the URLs: http://www.ida.liu.se/projects/OpenModelica or
+ * http://www.openmodelica.org, and in the OpenModelica distribution.
+ * GNU version 3 is obtained from: http://www.gnu.org/copyleft/gpl.html.
+ *
+ * This program is distributed WITHOUT ANY WARRANTY; without
+ * even the implied warranty of  MERCHANTABILITY or FITNESS
+ * FOR A PARTICULAR PURPOSE, EXCEPT AS EXPRESSLY SET FORTH
+ * IN THE BY RECIPIENT SELECTED SUBSIDIARY LICENSE CONDITIONS OF OSMC-PL.
+ *
+ * See the full OSMC Public License conditions for more details.
+ *
+ */
+
+#include "TextureCache.h"
+
+#include <cstring>
+
+#include <QFileInfo>
+#include <QGLWidget>
+#include <osgDB/ReadFile>
+
+/*!
+ * \brief TextureCache::instance
+ * Returns the TextureCache instance.
+ */
+TextureCache* TextureCache::instance()
+{
+  static TextureCache textureCache;
+  return &textureCache;
+}
+
+/*!
+ * \brief TextureCache::getTexture
+ * Returns the shared texture of the image. The image is only loaded the first time it is used.
+ * \param imagePath - a Qt resource path or a file path.
+ * \return the texture or nullptr if the image could not be read.
+ */
+osg::ref_ptr<osg::Texture2D> TextureCache::getTexture(const std::string& imagePath)
+{
+  QDateTime lastModified;
+  std::string resIdent = ":/Resources";
+  if (imagePath.compare(0, resIdent.length(), resIdent)) {
+    lastModified = QFileInfo(QString::fromStdString(imagePath)).lastModified();
+  }
+  Texture& texture = mTextures[imagePath];
+  if (!texture.texture.valid() || texture.lastModified != lastModified)
+  {
+    osg::ref_ptr<osg::Image> image = loadImage(imagePath);
+    if (!image.valid())
+    {
+      mTextures.erase(imagePath);
+      return nullptr;
+    }
+    texture.lastModified = lastModified;
+    texture.texture = new osg::Texture2D;
+    texture.texture->setDataVariance(osg::Object::STATIC);
+    texture.texture->setFilter(osg::Texture::MIN_FILTER, osg::Texture::LINEAR_MIPMAP_LINEAR);
+    texture.texture->setFilter(osg::Texture::MAG_FILTER, osg::Texture::LINEAR);
+    texture.texture->setWrap(osg::Texture::WRAP_S, osg::Texture::CLAMP);
+    texture.texture->setImage(image.get());
+    texture.texture->setResizeNonPowerOfTwoHint(false);// dont output console message about scaling
+  }
+  return texture.texture;
+}
+
+/*!
+ * \brief TextureCache::clear
+ * Releases all the textures kept in memory.
+ */
+void TextureCache::clear()
+{
+  mTextures.clear();
+}
+
+/*!
+ * \brief TextureCache::convertImage
+ * Converts a QImage to an RGBA osg::Image.
+ * \param iImage
+ * \return
+ */
+osg::ref_ptr<osg::Image> TextureCache::convertImage(const QImage& iImage)
+{
+  osg::ref_ptr<osg::Image> osgImage = new osg::Image();
+  if (false == iImage.isNull()) {
+#if (QT_VERSION >= QT_VERSION_CHECK(5, 2, 0))
+    QImage glImage = iImage.convertToFormat(QImage::Format_RGBA8888_Premultiplied);
+#else
+    QImage glImage = QGLWidget::convertToGLFormat(iImage);
+#endif
+    if (false == glImage.isNull()) {
+      // the rows of a 32 bit QImage are not padded, so the whole buffer can be copied at once
+      unsigned char* data = new unsigned char[glImage.byteCount()];
+      std::memcpy(data, glImage.constBits(), glImage.byteCount());
+      osgImage->setImage(glImage.width(), glImage.height(), 1, 4, GL_RGBA, GL_UNSIGNED_BYTE, data, osg::Image::USE_NEW_DELETE, 1);
+    }
+  }
+  return osgImage;
+}
+
+/*!
+ * \brief TextureCache::loadImage
+ * Loads the image from the Qt resources or from the file system.
+ * \param imagePath
+ * \return
+ */
+osg::ref_ptr<osg::Image> TextureCache::loadImage(const std::string& imagePath) const
+{
+  osg::ref_ptr<osg::Image> image = nullptr;
+  std::string resIdent = ":/Resources";
+  if (!imagePath.compare(0, resIdent.length(), resIdent))
+  {
+    image = convertImage(QImage(QString::fromStdString(imagePath)));
+    image->setInternalTextureFormat(GL_RGBA);
+  }
+  else
+  {
+    image = osgDB::readImageFile(imagePath);
+  }
+  return image;
+}
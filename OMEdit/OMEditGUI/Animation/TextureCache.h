@@ -0,0 +1,71 @@
+/*
+ * This file is part of OpenModelica.
+ *
+ * Copyright (c) 1998-CurrentYear, Open Source Modelica Consortium (OSMC),
+ * c/o Linköpings universitet, Department of Computer and Information Science,
+ * SE-58183 Linköping, Sweden.
+ *
+ * All rights reserved.
+ *
+ * THIS PROGRAM IS PROVIDED UNDER THE TERMS OF GPL VERSION 3 LICENSE OR
+ * THIS OSMC PUBLIC LICENSE (OSMC-PL) VERSION 1.2.
+ * ANY USE, REPRODUCTION OR DISTRIBUTION OF THIS PROGRAM CONSTITUTES
+ * RECIPIENT'S ACCEPTANCE OF THE OSMC PUBLIC LICENSE OR THE GPL VERSION 3,
+ * ACCORDING TO RECIPIENTS CHOICE.
+ *
+ * The OpenModelica software and the Open Source Modelica
+ * Consortium (OSMC) Public License (OSMC-PL) are obtained
+ * from OSMC, either from the above address,
+ * from the URLs: http://www.ida.liu.se/projects/OpenModelica or
+ * http://www.openmodelica.org, and in the OpenModelica distribution.
+ * GNU version 3 is obtained from: http://www.gnu.org/copyleft/gpl.html.
+ *
+ * This program is distributed WITHOUT ANY WARRANTY; without
+ * even the implied warranty of  MERCHANTABILITY or FITNESS
+ * FOR A PARTICULAR PURPOSE, EXCEPT AS EXPRESSLY SET FORTH
+ * IN THE BY RECIPIENT SELECTED SUBSIDIARY LICENSE CONDITIONS OF OSMC-PL.
+ *
+ * See the full OSMC Public License conditions for more details.
+ *
+ */
+
+#ifndef TEXTURECACHE_H
+#define TEXTURECACHE_H
+
+#include <map>
+#include <string>
+
+#include <QDateTime>
+#include <QImage>
+#include <QString>
+#include <osg/Image>
+#include <osg/Texture2D>
+
+/*!
+ * \brief The TextureCache class
+ * Shares one texture between all the shapes that use the same image.\n
+ * The textures are kept by image path, images from the file system are reloaded when they are modified.
+ */
+class TextureCache
+{
+public:
+  static TextureCache* instance();
+  osg::ref_ptr<osg::Texture2D> getTexture(const std::string& imagePath);
+  void clear();
+  static osg::ref_ptr<osg::Image> convertImage(const QImage& iImage);
+private:
+  TextureCache() = default;
+  ~TextureCache() = default;
+  TextureCache(const TextureCache& tc) = delete;
+  TextureCache& operator=(const TextureCache& tc) = delete;
+  osg::ref_ptr<osg::Image> loadImage(const std::string& imagePath) const;
+
+  struct Texture
+  {
+    QDateTime lastModified;
+    osg::ref_ptr<osg::Texture2D> texture;
+  };
+  std::map<std::string, Texture> mTextures;
+};
+
+#endif // TEXTURECACHE_H
@@ -43,6 +43,15 @@
 #include <osgDB/Export>
 #include <osgDB/Registry>
 #include <osgDB/WriteFile>
+#include <osgUtil/Optimizer>
+#include <osg/CopyOp>
+#include <QDataStream>
+#include <QFile>
+#include <QFileInfo>
+
+// "OMVS", the magic number of the binary scene files
+static const quint32 sceneFileMagic = 0x4f4d5653;
+static const quint32 sceneFileVersion = 1;
 
 OMVisualBase::OMVisualBase(const std::string& modelFile, const std::string& path)
   : _shapes(),
@@ -228,6 +237,171 @@ void OMVisualBase::initVisObjects()
   } // end for-loop
 }
 
+/*!
+ * \brief OMVisualBase::readSceneFile
+ * Reads the shapes from the binary scene file written by writeSceneFile.
+ * The file is only used if it was written for the current modification time and size of the visual XML file.
+ * \return true if the shapes were read.
+ */
+bool OMVisualBase::readSceneFile()
+{
+  QFileInfo xmlFileInfo(QString::fromStdString(_xmlFileName));
+  QFile file(QString::fromStdString(getSceneFileName()));
+  if (!xmlFileInfo.exists() || !file.open(QIODevice::ReadOnly))
+  {
+    return false;
+  }
+  QDataStream stream(&file);
+  stream.setFloatingPointPrecision(QDataStream::SinglePrecision);
+  quint32 magic, version;
+  qint64 lastModified, size;
+  stream >> magic >> version >> lastModified >> size;
+  if (magic != sceneFileMagic || version != sceneFileVersion
+      || lastModified != xmlFileInfo.lastModified().toMSecsSinceEpoch() || size != xmlFileInfo.size())
+  {
+    return false;
+  }
+  // the interned identifiers, types, file names and variable names
+  quint32 numStrings;
+  stream >> numStrings;
+  std::vector<std::string> strings;
+  for (quint32 i = 0; i < numStrings && stream.status() == QDataStream::Ok; ++i)
+  {
+    QByteArray bytes;
+    stream >> bytes;
+    strings.push_back(std::string(bytes.constData(), bytes.size()));
+  }
+  auto readString = [&stream, &strings](std::string& string) {
+    quint32 index;
+    stream >> index;
+    if (index >= strings.size())
+    {
+      return false;
+    }
+    string = strings[index];
+    return true;
+  };
+  quint32 numShapes;
+  stream >> numShapes;
+  if (stream.status() != QDataStream::Ok)
+  {
+    return false;
+  }
+  std::vector<ShapeObject> shapes(numShapes);
+  ShapeObjectAttribute* attributes[ShapeObject::numAttributes];
+  for (ShapeObject& shape : shapes)
+  {
+    if (!readString(shape._id) || !readString(shape._type) || !readString(shape._fileName))
+    {
+      return false;
+    }
+    shape.getAttributes(attributes);
+    for (ShapeObjectAttribute* attribute : attributes)
+    {
+      quint8 isConst;
+      stream >> isConst;
+      attribute->isConst = isConst;
+      if (attribute->isConst)
+      {
+        stream >> attribute->exp;
+        attribute->cref = "NONE";
+      }
+      else
+      {
+        attribute->exp = -1.0;
+        if (!readString(attribute->cref))
+        {
+          return false;
+        }
+      }
+    }
+  }
+  if (stream.status() != QDataStream::Ok)
+  {
+    return false;
+  }
+  _shapes.insert(_shapes.end(), shapes.begin(), shapes.end());
+  return true;
+}
+
+/*!
+ * \brief OMVisualBase::writeSceneFile
+ * Writes the shapes to a binary scene file next to the visual XML file, so that opening the animation again doesn't parse the XML.
+ * The strings are interned, the attributes are stored either as constant value or as index of the variable name.
+ */
+void OMVisualBase::writeSceneFile()
+{
+  QFileInfo xmlFileInfo(QString::fromStdString(_xmlFileName));
+  if (!xmlFileInfo.exists())
+  {
+    return;
+  }
+  std::map<std::string, quint32> indexes;
+  std::vector<const std::string*> strings;
+  auto intern = [&indexes, &strings](const std::string& string) {
+    auto it = indexes.find(string);
+    if (it == indexes.end())
+    {
+      it = indexes.insert(std::make_pair(string, static_cast<quint32>(strings.size()))).first;
+      strings.push_back(&it->first);
+    }
+    return it->second;
+  };
+  ShapeObjectAttribute* attributes[ShapeObject::numAttributes];
+  for (ShapeObject& shape : _shapes)
+  {
+    intern(shape._id);
+    intern(shape._type);
+    intern(shape._fileName);
+    shape.getAttributes(attributes);
+    for (ShapeObjectAttribute* attribute : attributes)
+    {
+      if (!attribute->isConst)
+      {
+        intern(attribute->cref);
+      }
+    }
+  }
+  QFile file(QString::fromStdString(getSceneFileName()));
+  if (!file.open(QIODevice::WriteOnly | QIODevice::Truncate))
+  {
+    // the directory of the result file might not be writable, the XML is parsed again next time
+    return;
+  }
+  QDataStream stream(&file);
+  stream.setFloatingPointPrecision(QDataStream::SinglePrecision);
+  stream << sceneFileMagic << sceneFileVersion << static_cast<qint64>(xmlFileInfo.lastModified().toMSecsSinceEpoch())
+         << static_cast<qint64>(xmlFileInfo.size());
+  stream << static_cast<quint32>(strings.size());
+  for (const std::string* string : strings)
+  {
+    stream << QByteArray(string->data(), static_cast<int>(string->size()));
+  }
+  stream << static_cast<quint32>(_shapes.size());
+  for (ShapeObject& shape : _shapes)
+  {
+    stream << indexes[shape._id] << indexes[shape._type] << indexes[shape._fileName];
+    shape.getAttributes(attributes);
+    for (ShapeObjectAttribute* attribute : attributes)
+    {
+      stream << static_cast<quint8>(attribute->isConst);
+      if (attribute->isConst)
+      {
+        stream << attribute->exp;
+      }
+      else
+      {
+        stream << indexes[attribute->cref];
+      }
+    }
+  }
+  file.close();
+  if (stream.status() != QDataStream::Ok)
+  {
+    file.remove();
+  }
+}
+
 void OMVisualBase::clearXMLDoc()
 {
   _xmlDoc.clear();
@@ -253,6 +427,15 @@ const std::string OMVisualBase::getXMLFileName() const
   return _xmlFileName;
 }
 
+/*!
+ * \brief OMVisualBase::getSceneFileName
+ * Returns the name of the binary scene file, e.g. Model_visual.bin for Model_visual.xml.
+ */
+const std::string OMVisualBase::getSceneFileName() const
+{
+  return _xmlFileName.substr(0, _xmlFileName.rfind('.')) + ".bin";
+}
+
 void OMVisualBase::appendVisVariable(const rapidxml::xml_node<>* node, std::vector<std::string>& visVariables) const
 {
   if (strcmp("cref", node->name()) == 0)
@@ -271,7 +454,11 @@ VisualizerAbstract::VisualizerAbstract()
   : _visType(VisType::NONE),
     mpOMVisualBase(nullptr),
     mpOMVisScene(nullptr),
-    mpUpdateVisitor(nullptr)
+    mpUpdateVisitor(nullptr),
+    mStaticShapes(),
+    mStaticShapeChildren(),
+    mpStaticShapesGroup(nullptr),
+    mStaticShapesBuilt(false)
 {
   mpTimeManager = new TimeManager(0.0, 0.0, 1.0, 0.0, 0.1, 0.0, 1.0);
 }
@@ -281,7 +468,11 @@ VisualizerAbstract::VisualizerAbstract(const std::string& modelFile, const std::
     mpOMVisualBase(nullptr),
     mpOMVisScene(new OMVisScene()),
     mpUpdateVisitor(new UpdateVisitor()),
-    mpTimeManager(new TimeManager(0.0, 0.0, 0.0, 0.0, 0.1, 0.0, 100.0))
+    mpTimeManager(new TimeManager(0.0, 0.0, 0.0, 0.0, 0.1, 0.0, 100.0)),
+    mStaticShapes(),
+    mStaticShapeChildren(),
+    mpStaticShapesGroup(nullptr),
+    mStaticShapesBuilt(false)
 {
   mpOMVisualBase = new OMVisualBase(modelFile, path);
   mpOMVisScene->getScene().setPath(path);
@@ -291,9 +482,13 @@ void VisualizerAbstract::initData()
 {
   // In case of reloading, we need to make sure, that we have empty members.
   mpOMVisualBase->clearXMLDoc();
-  // Initialize XML file and get visAttributes.
-  mpOMVisualBase->initXMLDoc();
-  mpOMVisualBase->initVisObjects();
+  // Get the visAttributes from the binary scene file if it is up to date, otherwise from the XML file.
+  if (!mpOMVisualBase->readSceneFile())
+  {
+    mpOMVisualBase->initXMLDoc();
+    mpOMVisualBase->initVisObjects();
+    mpOMVisualBase->writeSceneFile();
+  }
 }
 
 void VisualizerAbstract::initVisualization()
@@ -314,10 +509,19 @@ void VisualizerAbstract::modifyShape(std::string shapeName)
   int shapeIdx = getBaseData()->getShapeObjectIndexByID(shapeName);
   ShapeObject* shape = getBaseData()->getShapeObjectByID(shapeName);
   shape->setStateSetAction(stateSetAction::modify);
-  mpUpdateVisitor->_shape = *shape;
+  mpUpdateVisitor->_shape = shape;
   osg::ref_ptr<osg::Node> child = mpOMVisScene->getScene().getRootNode()->getChild(shapeIdx);  // the transformation
+  bool flattened = isStaticShapeFlattened(shapeIdx);
+  if (flattened) {
+    // the hidden original is not traversed by the visitor
+    child->setNodeMask(~0u);
+  }
   child->accept(*mpUpdateVisitor);
   shape->setStateSetAction(stateSetAction::update);
+  if (flattened) {
+    mpStaticShapesGroup->setChild(mStaticShapeChildren[shapeIdx], createStaticShapeNode(shapeIdx));
+    child->setNodeMask(0);
+  }
 }
 
 
@@ -342,10 +546,109 @@ void VisualizerAbstract::sceneUpdate()
   }
 }
 
+/*!
+ * \brief VisualizerAbstract::applyFrame
+ * Applies the attribute values and transformations of a computed frame to the shapes and the scene graph.
+ * \param frame
+ */
+void VisualizerAbstract::applyFrame(const AnimationFrame& frame)
+{
+  if (frame.matrices.size() != mpOMVisualBase->_shapes.size()) {
+    return;
+  }
+  ShapeObjectAttribute* attributes[FramePrefetcher::maxAttributes];
+  osg::ref_ptr<osg::Node> child = nullptr;
+  size_t valueIdx = 0;
+  unsigned int shapeIdx = 0;
+  for (ShapeObject& shape : mpOMVisualBase->_shapes) {
+    size_t n = FramePrefetcher::getAttributes(shape, attributes);
+    for (size_t i = 0; i < n && valueIdx < frame.values.size(); ++i) {
+      attributes[i]->exp = frame.values[valueIdx++];
+    }
+    shape._mat = frame.matrices[shapeIdx];
+    // Update the shapes.
+    if (!isStaticShapeFlattened(shapeIdx)) {
+      mpUpdateVisitor->_shape = &shape;
+      child = mpOMVisScene->getScene().getRootNode()->getChild(shapeIdx);  // the transformation
+      child->accept(*mpUpdateVisitor);
+    }
+    ++shapeIdx;
+  }
+  if (!mStaticShapesBuilt) {
+    buildStaticShapes();
+  }
+}
+
+/*!
+ * \brief VisualizerAbstract::isStaticShapeFlattened
+ * Returns true if the shape is static and already part of the flattened subgraph, i.e. it doesn't need to be updated.
+ * \param shapeIdx
+ */
+bool VisualizerAbstract::isStaticShapeFlattened(const size_t shapeIdx) const
+{
+  return mStaticShapesBuilt && shapeIdx < mStaticShapes.size() && mStaticShapes[shapeIdx];
+}
+
+/*!
+ * \brief VisualizerAbstract::buildStaticShapes
+ * Moves the static shapes into one subgraph with the transformations applied to the geometry.
+ * Must be called after all the shapes were updated once. The original nodes stay in the scene but are hidden,
+ * so the children of the root node still match the shape indexes.
+ */
+void VisualizerAbstract::buildStaticShapes()
+{
+  if (!mpStaticShapesGroup) {
+    return;
+  }
+  osg::ref_ptr<osg::Group> rootNode = mpOMVisScene->getScene().getRootNode();
+  mpStaticShapesGroup->removeChildren(0, mpStaticShapesGroup->getNumChildren());
+  for (size_t i = 0; i < mStaticShapes.size(); ++i) {
+    if (mStaticShapes[i]) {
+      mStaticShapeChildren[i] = mpStaticShapesGroup->getNumChildren();
+      mpStaticShapesGroup->addChild(createStaticShapeNode(i));
+      rootNode->getChild(i)->setNodeMask(0);
+    }
+  }
+  osgUtil::Optimizer optimizer;
+  optimizer.optimize(mpStaticShapesGroup.get(), osgUtil::Optimizer::SHARE_DUPLICATE_STATE);
+  mStaticShapesBuilt = true;
+}
+
+/*!
+ * \brief VisualizerAbstract::createStaticShapeNode
+ * Copies the node of a shape and flattens its transformation into the geometry.
+ * The geodes are kept, so their names still identify the shapes for picking.
+ * \param shapeIdx
+ */
+osg::ref_ptr<osg::Node> VisualizerAbstract::createStaticShapeNode(const size_t shapeIdx)
+{
+  osg::Node* node = mpOMVisScene->getScene().getRootNode()->getChild(shapeIdx);
+  osg::CopyOp copyOp(osg::CopyOp::DEEP_COPY_NODES | osg::CopyOp::DEEP_COPY_DRAWABLES | osg::CopyOp::DEEP_COPY_STATESETS
+                     | osg::CopyOp::DEEP_COPY_STATEATTRIBUTES | osg::CopyOp::DEEP_COPY_ARRAYS | osg::CopyOp::DEEP_COPY_PRIMITIVES);
+  osg::ref_ptr<osg::Node> copy = static_cast<osg::Node*>(node->clone(copyOp));
+  copy->setNodeMask(~0u);
+  copy->setDataVariance(osg::Object::STATIC);
+  osg::ref_ptr<osg::Group> group = new osg::Group();
+  group->addChild(copy.get());
+  osgUtil::Optimizer optimizer;
+  optimizer.optimize(group.get(), osgUtil::Optimizer::FLATTEN_STATIC_TRANSFORMS_DUPLICATING_SHARED_SUBGRAPHS
+                     | osgUtil::Optimizer::REMOVE_REDUNDANT_NODES);
+  return group;
+}
+
 void VisualizerAbstract::setUpScene()
 {
   // Build scene graph.
   mpOMVisScene->getScene().setUpScene(mpOMVisualBase->_shapes);
+  // Classify the shapes, the static ones are flattened after their first update.
+  mStaticShapes.clear();
+  for (const ShapeObject& shape : mpOMVisualBase->_shapes) {
+    mStaticShapes.push_back(shape.isStatic());
+  }
+  mStaticShapeChildren.assign(mStaticShapes.size(), 0);
+  mpStaticShapesGroup = new osg::Group();
+  mpOMVisScene->getScene().getRootNode()->addChild(mpStaticShapesGroup.get());
+  mStaticShapesBuilt = false;
 }
 
 VisType VisualizerAbstract::getVisType() const
@@ -425,22 +728,21 @@ int OSGScene::setUpScene(std::vector<ShapeObject> allShapes)
     //matrix transformation
     osg::ref_ptr<osg::MatrixTransform> transf = new osg::MatrixTransform();
 
-    //cad node
+    //cad node, the meshes are shared between all shapes using the same file
     if (shape._type.compare("stl") == 0) {
       //std::cout<<"Its a CAD and the filename is "<<shape._fileName<<std::endl;
-      osg::ref_ptr<osg::Node> node = osgDB::readNodeFile(shape._fileName);
-      if (node) {
-        osg::ref_ptr<osg::StateSet> ss = node->getOrCreateStateSet();
+      geode = MeshCache::instance()->createGeode(shape._fileName, shape._type);
+      if (geode) {
+        osg::ref_ptr<osg::StateSet> ss = geode->getOrCreateStateSet();
         ss->setAttribute(material.get());
-        node->setStateSet(ss);
-        transf->addChild(node.get());
+        geode->setStateSet(ss);
+        transf->addChild(geode.get());
       }
     } else if ((shape._type.compare("dxf") == 0)) {
-      std::string name = shape._fileName;
-      DXFile* shape = new DXFile(name);
-      geode = new osg::Geode();
-      geode->addDrawable(shape);
-      transf->addChild(geode);
+      geode = MeshCache::instance()->createGeode(shape._fileName, shape._type);
+      if (geode) {
+        transf->addChild(geode.get());
+      }
     } else { //geode with shape drawable
       osg::ref_ptr<osg::ShapeDrawable> shapeDraw = new osg::ShapeDrawable();
       shapeDraw->setColor(osg::Vec4(1.0, 1.0, 1.0, 1.0));
@@ -448,6 +750,8 @@ int OSGScene::setUpScene(std::vector<ShapeObject> allShapes)
       geode->addDrawable(shapeDraw.get());
       osg::ref_ptr<osg::StateSet> ss = geode->getOrCreateStateSet();
       ss->setAttribute(material.get());
+      //the unit geometries are scaled by the transformation so the normals have to be normalized again
+      ss->setMode(GL_NORMALIZE, osg::StateAttribute::ON);
       geode->setStateSet(ss);
       transf->addChild(geode.get());
     }
@@ -473,7 +777,8 @@ void OSGScene::setPath(const std::string path)
 
 
 UpdateVisitor::UpdateVisitor()
-  : _shape()
+  : _shape(nullptr),
+    _unitShapeDrawables()
 {
   setTraversalMode(NodeVisitor::TRAVERSE_ALL_CHILDREN);
 }
@@ -484,7 +789,8 @@ UpdateVisitor::UpdateVisitor()
 void UpdateVisitor::apply(osg::MatrixTransform& node)
 {
   //std::cout<<"MT "<<node.className()<<"  "<<node.getName()<<std::endl;
-  node.setMatrix(_shape._mat);
+  //the geometries are unit sized, they get their size from the transformation
+  node.setMatrix(osg::Matrix::scale(getUnitGeometryScale()) * _shape->_mat);
   traverse(node);
 }
 
@@ -493,56 +799,57 @@ void UpdateVisitor::apply(osg::MatrixTransform& node)
  */
 void UpdateVisitor::apply(osg::Geode& node)
 {
-  //std::cout<<"GEODE "<< _shape._id<<" "<<_shape.getTransparency()<<std::endl;
+  //std::cout<<"GEODE "<< _shape->_id<<" "<<_shape->getTransparency()<<std::endl;
   osg::ref_ptr<osg::StateSet> ss = node.getOrCreateStateSet();
-  node.setName(_shape._id);
-  switch(_shape.getStateSetAction())
+  node.setName(_shape->_id);
+  switch(_shape->getStateSetAction())
   {
   case(stateSetAction::update):
    {
-    //its a drawable and not a cad file so we have to create a new drawable
-    if (_shape._type.compare("dxf") != 0 and (_shape._type.compare("stl") != 0))
-    {
-    osg::ref_ptr<osg::Drawable> draw = node.getDrawable(0);
-    draw->dirtyDisplayList();
-    if (_shape._type == "pipe")
+    //its a drawable and not a cad file so we have to make sure that the geode holds the unit geometry of the shape.
+    //the geometry is only created again if a parameter changes that can not be applied by scaling.
+    if (_shape->_type.compare("dxf") != 0 and (_shape->_type.compare("stl") != 0))
     {
-      node.removeDrawable(draw);
-      draw = new Pipecylinder((_shape._width.exp * _shape._extra.exp) / 2, (_shape._width.exp) / 2, _shape._length.exp);
-    }
-    else if (_shape._type == "pipecylinder")
+    osg::Drawable* draw = node.getNumDrawables() > 0 ? node.getDrawable(0) : nullptr;
+    osg::ref_ptr<osg::Drawable> newDraw = nullptr;
+    if ((_shape->_type == "pipe") || (_shape->_type == "pipecylinder"))
     {
-      node.removeDrawable(draw);
-      draw = new Pipecylinder((_shape._width.exp * _shape._extra.exp) / 2, (_shape._width.exp) / 2, _shape._length.exp);
+      Pipecylinder* pipe = dynamic_cast<Pipecylinder*>(draw);
+      if (!pipe || pipe->getInnerRadius() != _shape->_extra.exp / 2)
+        newDraw = new Pipecylinder(_shape->_extra.exp / 2, 0.5, 1.0);
     }
-    else if (_shape._type == "spring")
+    else if (_shape->_type == "spring")
     {
-      node.removeDrawable(draw);
-      draw = new Spring(_shape._width.exp, _shape._height.exp, _shape._extra.exp, _shape._length.exp);
-    }
-    else if (_shape._type == "cylinder")
-    {
-      draw->setShape(new osg::Cylinder(osg::Vec3f(0.0, 0.0, 0.0), _shape._width.exp / 2.0, _shape._length.exp));
-    }
-    else if (_shape._type == "box")
-    {
-      draw->setShape(new osg::Box(osg::Vec3f(0.0, 0.0, 0.0), _shape._width.exp, _shape._height.exp, _shape._length.exp));
+      // only a new coil needs a new geometry, a new length moves the vertices of the existing one.
+      Spring* spring = dynamic_cast<Spring*>(draw);
+      if (!spring || spring->getRadius() != _shape->_width.exp || spring->getWireRadius() != _shape->_height.exp
+          || spring->getWindings() != _shape->_extra.exp)
+        newDraw = new Spring(_shape->_width.exp, _shape->_height.exp, _shape->_extra.exp, _shape->_length.exp);
+      else
+        spring->setLength(_shape->_length.exp);
     }
-    else if (_shape._type == "cone")
+    else if ((_shape->_type == "cylinder") || (_shape->_type == "box") || (_shape->_type == "cone") || (_shape->_type == "sphere"))
     {
-      draw->setShape(new osg::Cone(osg::Vec3f(0.0, 0.0, 0.0), _shape._width.exp / 2.0, _shape._length.exp));
+      osg::ShapeDrawable* unitDraw = getUnitShapeDrawable(_shape->_type);
+      if (draw != unitDraw)
+        newDraw = unitDraw;
     }
-    else if (_shape._type == "sphere")
+    else
     {
-      draw->setShape(new osg::Sphere(osg::Vec3f(0.0, 0.0, 0.0), _shape._length.exp / 2.0));
+      osg::ShapeDrawable* shapeDraw = dynamic_cast<osg::ShapeDrawable*>(draw);
+      if (!shapeDraw || !dynamic_cast<osg::Capsule*>(shapeDraw->getShape()))
+      {
+        std::cout<<"Unknown type "<<_shape->_type<<", we make a capsule."<<std::endl;
+        shapeDraw = new osg::ShapeDrawable(new osg::Capsule(osg::Vec3f(0.0, 0.0, 0.0), 0.1, 0.5));
+        shapeDraw->setColor(osg::Vec4(1.0, 1.0, 1.0, 1.0));
+        newDraw = shapeDraw;
+      }
     }
-    else
+    if (newDraw.valid())
     {
-      std::cout<<"Unknown type "<<_shape._type<<", we make a capsule."<<std::endl;
-      draw->setShape(new osg::Capsule(osg::Vec3f(0.0, 0.0, 0.0), 0.1, 0.5));
+      node.removeDrawables(0, node.getNumDrawables());
+      node.addDrawable(newDraw.get());
     }
-    //std::cout<<"SHAPE "<<draw->getShape()->className()<<std::endl;
-    node.addDrawable(draw.get());
     }
     break;
    }//end case
@@ -550,7 +857,7 @@ void UpdateVisitor::apply(osg::Geode& node)
   case(stateSetAction::modify):
    {
      //apply texture
-     applyTexture(ss, _shape.getTextureImagePath());
+     applyTexture(ss, _shape->getTextureImagePath());
      break;
    }//end case
 
@@ -560,16 +867,57 @@ void UpdateVisitor::apply(osg::Geode& node)
   }//end switch
 
   //set color
-  if (_shape._type.compare("dxf") != 0)
-    changeColor(ss, _shape._color[0].exp, _shape._color[1].exp, _shape._color[2].exp);
+  if (_shape->_type.compare("dxf") != 0)
+    changeColor(ss, _shape->_color[0].exp, _shape->_color[1].exp, _shape->_color[2].exp);
 
   //set transparency
-  makeTransparent(node, _shape.getTransparency());
+  makeTransparent(node, _shape->getTransparency());
 
   node.setStateSet(ss);
   traverse(node);
 }
 
+/*!
+ * \brief UpdateVisitor::getUnitGeometryScale
+ * returns the scaling that sizes the unit geometry of the current shape
+ * springs are not scaled since scaling would distort the coil and the wire, their geometry is created with the actual size
+ */
+osg::Vec3f UpdateVisitor::getUnitGeometryScale()
+{
+  if ((_shape->_type == "cylinder") || (_shape->_type == "cone") || (_shape->_type == "pipe") || (_shape->_type == "pipecylinder"))
+    return osg::Vec3f(_shape->_width.exp, _shape->_width.exp, _shape->_length.exp);
+  else if (_shape->_type == "box")
+    return osg::Vec3f(_shape->_width.exp, _shape->_height.exp, _shape->_length.exp);
+  else if (_shape->_type == "sphere")
+    return osg::Vec3f(_shape->_length.exp, _shape->_length.exp, _shape->_length.exp);
+  else
+    return osg::Vec3f(1.0, 1.0, 1.0);
+}
+
+/*!
+ * \brief UpdateVisitor::getUnitShapeDrawable
+ * returns the unit sized drawable of a primitive type which is shared by all shapes of this type
+ */
+osg::ShapeDrawable* UpdateVisitor::getUnitShapeDrawable(const std::string& type)
+{
+  osg::ref_ptr<osg::ShapeDrawable>& draw = _unitShapeDrawables[type];
+  if (!draw.valid())
+  {
+    osg::Shape* shape;
+    if (type == "cylinder")
+      shape = new osg::Cylinder(osg::Vec3f(0.0, 0.0, 0.0), 0.5, 1.0);
+    else if (type == "box")
+      shape = new osg::Box(osg::Vec3f(0.0, 0.0, 0.0), 1.0, 1.0, 1.0);
+    else if (type == "cone")
+      shape = new osg::Cone(osg::Vec3f(0.0, 0.0, 0.0), 0.5, 1.0);
+    else
+      shape = new osg::Sphere(osg::Vec3f(0.0, 0.0, 0.0), 0.5);
+    draw = new osg::ShapeDrawable(shape);
+    draw->setColor(osg::Vec4(1.0, 1.0, 1.0, 1.0));
+  }
+  return draw.get();
+}
+
 /*!
  * \brief UpdateVisitor::changeColor
  * changes color for a geode
@@ -594,28 +942,10 @@ void UpdateVisitor::applyTexture(osg::StateSet* ss, std::string imagePath)
 {
   if (imagePath.compare(""))
   {
-    osg::Image *image = nullptr;
-    std::string resIdent = ":/Resources";
-    if(!imagePath.compare(0,resIdent.length(),resIdent))
+    osg::ref_ptr<osg::Texture2D> texture = TextureCache::instance()->getTexture(imagePath);
+    if (texture.valid())
     {
-      QImage* qim = new QImage(QString::fromStdString(imagePath));
-      image = convertImage(*qim);
-      image->setInternalTextureFormat(GL_RGBA);
-    }
-    else
-    {
-      image = osgDB::readImageFile(imagePath);
-    }
-    if (image)
-    {
-    osg::Texture2D *texture = new osg::Texture2D;
-    texture->setDataVariance(osg::Object::DYNAMIC);
-    texture->setFilter(osg::Texture::MIN_FILTER, osg::Texture::LINEAR_MIPMAP_LINEAR);
-    texture->setFilter(osg::Texture::MAG_FILTER, osg::Texture::LINEAR);
-    texture->setWrap(osg::Texture::WRAP_S, osg::Texture::CLAMP);
-    texture->setImage(image);
-    texture->setResizeNonPowerOfTwoHint(false);// dont output console message about scaling
-    ss->setTextureAttributeAndModes(0, texture, osg::StateAttribute::ON);
+      ss->setTextureAttributeAndModes(0, texture.get(), osg::StateAttribute::ON);
     }
   }
   else
@@ -625,26 +955,6 @@ void UpdateVisitor::applyTexture(osg::StateSet* ss, std::string imagePath)
   }
 }
 
-osg::Image* UpdateVisitor::convertImage(const QImage& iImage)
-{
-  osg::Image* osgImage = new osg::Image();
-  if (false == iImage.isNull()) {
-#if (QT_VERSION >= QT_VERSION_CHECK(5, 2, 0))
-    QImage glImage = iImage.convertToFormat(QImage::Format_RGBA8888_Premultiplied);
-#else
-    QImage glImage = QGLWidget::convertToGLFormat(iImage);
-#endif
-    if (false == glImage.isNull()) {
-      unsigned char* data = new unsigned char[glImage.byteCount()];
-      for(int i=0; i < glImage.byteCount(); ++i) {
-        data[i] = glImage.bits()[i];
-      }
-      osgImage->setImage(glImage.width(), glImage.height(), 1, 4, GL_RGBA, GL_UNSIGNED_BYTE, data, osg::Image::USE_NEW_DELETE, 1);
-    }
-  }
-  return osgImage;
-}
-
 
 /*!
  * \brief UpdateVisitor::makeTransparent
@@ -652,7 +962,7 @@ osg::Image* UpdateVisitor::convertImage(const QImage& iImage)
  */
 void UpdateVisitor::makeTransparent(osg::Geode& node, float transpCoeff)
 {
-  if (_shape.getTransparency())
+  if (_shape->getTransparency())
       {
       node.getStateSet()->setMode( GL_BLEND, osg::StateAttribute::ON );
       node.getStateSet()->setRenderingHint(osg::StateSet::TRANSPARENT_BIN);
@@ -38,6 +38,7 @@
 #include <stdlib.h>
 #include <memory.h>
 #include <iostream>
+#include <map>
 
 #include <QImage>
 #include <osg/NodeVisitor>
@@ -51,6 +52,9 @@
 
 #include "AnimationUtil.h"
 #include "ExtraShapes.h"
+#include "FramePrefetcher.h"
+#include "MeshCache.h"
+#include "TextureCache.h"
 #include "rapidxml.hpp"
 #include "Shapes.h"
 #include "TimeManager.h"
@@ -72,9 +76,12 @@ class UpdateVisitor : public osg::NodeVisitor
   void makeTransparent(osg::Geode& node, float transpCoeff);
   void applyTexture(osg::StateSet* ss, std::string imagePath);
   void changeColor(osg::StateSet* ss, float r, float g, float b);
-  osg::Image* convertImage(const QImage& iImage);
+  osg::Vec3f getUnitGeometryScale();
+  osg::ShapeDrawable* getUnitShapeDrawable(const std::string& type);
 public:
-  ShapeObject _shape;
+  ShapeObject* _shape;
+private:
+  std::map<std::string, osg::ref_ptr<osg::ShapeDrawable>> _unitShapeDrawables;
 };
 
 class InfoVisitor : public osg::NodeVisitor
@@ -131,10 +138,13 @@ class OMVisualBase
   void initXMLDoc();
   void clearXMLDoc();
   void initVisObjects();
+  bool readSceneFile();
+  void writeSceneFile();
   const std::string getModelFile() const;
   const std::string getPath() const;
   rapidxml::xml_node<>* getFirstXMLNode() const;
   const std::string getXMLFileName() const;
+  const std::string getSceneFileName() const;
   ShapeObject* getShapeObjectByID(std::string shapeID);
   int getShapeObjectIndexByID(std::string shapeID);
 private:
@@ -175,12 +185,23 @@ class VisualizerAbstract
   //virtual void simulate(TimeManager& omvm) = 0;
   virtual void startVisualization();
   virtual void pauseVisualization();
+protected:
+  void applyFrame(const AnimationFrame& frame);
+  bool isStaticShapeFlattened(const size_t shapeIdx) const;
+  void buildStaticShapes();
+private:
+  osg::ref_ptr<osg::Node> createStaticShapeNode(const size_t shapeIdx);
 protected:
   const VisType _visType;
   OMVisualBase* mpOMVisualBase;
   OMVisScene* mpOMVisScene;
   UpdateVisitor* mpUpdateVisitor;
   TimeManager* mpTimeManager;
+  // shapes with only constant attributes, they are flattened into one subgraph after their first update
+  std::vector<bool> mStaticShapes;
+  std::vector<unsigned int> mStaticShapeChildren;
+  osg::ref_ptr<osg::Group> mpStaticShapesGroup;
+  bool mStaticShapesBuilt;
 };
 
 osg::Vec3f Mat3mulV3(osg::Matrix3 M, osg::Vec3f V);
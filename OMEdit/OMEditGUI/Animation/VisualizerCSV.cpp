@@ -33,14 +33,23 @@
 
 #include "VisualizerCSV.h"
 
+#include <algorithm>
+
 VisualizerCSV::VisualizerCSV(const std::string& modelFile, const std::string& path)
-  : VisualizerAbstract(modelFile, path, VisType::CSV), mpCSVData(0)
+  : VisualizerAbstract(modelFile, path, VisType::CSV), mpCSVData(0),
+    mReaderMutex(),
+    mFramePrefetcher([this](const ShapeObjectAttribute& attribute, const double time) {
+      std::lock_guard<std::mutex> lock(mReaderMutex);
+      return omcGetVarValue(attribute.cref.c_str(), time);
+    }),
+    mFrame()
 {
 
 }
 
 VisualizerCSV::~VisualizerCSV()
 {
+  mFramePrefetcher.stop();
   if (mpCSVData) {
     omc_free_csv_reader(mpCSVData);
   }
@@ -48,6 +57,7 @@ VisualizerCSV::~VisualizerCSV()
 
 void VisualizerCSV::initData()
 {
+  mFramePrefetcher.stop();
   VisualizerAbstract::initData();
   readCSV(mpOMVisualBase->getModelFile(), mpOMVisualBase->getPath());
   double *time = read_csv_dataset(mpCSVData, "time");
@@ -62,6 +72,7 @@ void VisualizerCSV::initializeVisAttributes(const double time)
   if (0.0 > time) {
     std::cout<<"Cannot load visualization attributes for time point < 0.0."<<std::endl;
   }
+  mFramePrefetcher.setShapes(mpOMVisualBase->_shapes);
   updateVisAttributes(time);
 }
 
@@ -86,71 +97,9 @@ void VisualizerCSV::readCSV(const std::string& modelFile, const std::string& pat
 
 void VisualizerCSV::updateVisAttributes(const double time)
 {
-  //std::cout<<"updateVisAttributes at "<<time <<std::endl;
-  // Update all shapes.
-  unsigned int shapeIdx = 0;
-  rAndT rT;
-  osg::ref_ptr<osg::Node> child = nullptr;
   try {
-    for (ShapeObject &shape : mpOMVisualBase->_shapes) {
-      //std::cout<<"shape "<<shape._id <<std::endl;
-
-      // Get the values for the scene graph objects
-      updateObjectAttributeCSV(&shape._length, time);
-      updateObjectAttributeCSV(&shape._width, time);
-      updateObjectAttributeCSV(&shape._height, time);
-
-      updateObjectAttributeCSV(&shape._lDir[0], time);
-      updateObjectAttributeCSV(&shape._lDir[1], time);
-      updateObjectAttributeCSV(&shape._lDir[2], time);
-
-      updateObjectAttributeCSV(&shape._wDir[0], time);
-      updateObjectAttributeCSV(&shape._wDir[1], time);
-      updateObjectAttributeCSV(&shape._wDir[2], time);
-
-      updateObjectAttributeCSV(&shape._r[0], time);
-      updateObjectAttributeCSV(&shape._r[1], time);
-      updateObjectAttributeCSV(&shape._r[2], time);
-
-      updateObjectAttributeCSV(&shape._rShape[0], time);
-      updateObjectAttributeCSV(&shape._rShape[1], time);
-      updateObjectAttributeCSV(&shape._rShape[2], time);
-
-      updateObjectAttributeCSV(&shape._T[0], time);
-      updateObjectAttributeCSV(&shape._T[1], time);
-      updateObjectAttributeCSV(&shape._T[2], time);
-      updateObjectAttributeCSV(&shape._T[3], time);
-      updateObjectAttributeCSV(&shape._T[4], time);
-      updateObjectAttributeCSV(&shape._T[5], time);
-      updateObjectAttributeCSV(&shape._T[6], time);
-      updateObjectAttributeCSV(&shape._T[7], time);
-      updateObjectAttributeCSV(&shape._T[8], time);
-
-      updateObjectAttributeCSV(&shape._color[0], time);
-      updateObjectAttributeCSV(&shape._color[1], time);
-      updateObjectAttributeCSV(&shape._color[2], time);
-
-      updateObjectAttributeCSV(&shape._specCoeff, time);
-      updateObjectAttributeCSV(&shape._extra, time);
-
-      rT = rotateModelica2OSG(osg::Vec3f(shape._r[0].exp, shape._r[1].exp, shape._r[2].exp),
-          osg::Vec3f(shape._rShape[0].exp, shape._rShape[1].exp, shape._rShape[2].exp),
-          osg::Matrix3(shape._T[0].exp, shape._T[1].exp, shape._T[2].exp,
-          shape._T[3].exp, shape._T[4].exp, shape._T[5].exp,
-          shape._T[6].exp, shape._T[7].exp, shape._T[8].exp),
-          osg::Vec3f(shape._lDir[0].exp, shape._lDir[1].exp, shape._lDir[2].exp),
-          osg::Vec3f(shape._wDir[0].exp, shape._wDir[1].exp, shape._wDir[2].exp),
-          shape._length.exp,/* shape._width.exp, shape._height.exp,*/ shape._type);
-
-      assemblePokeMatrix(shape._mat, rT._T, rT._r);
-      // Update the shapes.
-      mpUpdateVisitor->_shape = shape;
-      //shape.dumpVisAttributes();
-      // Get the scene graph nodes and stuff.
-      child = mpOMVisScene->getScene().getRootNode()->getChild(shapeIdx);  // the transformation
-      child->accept(*mpUpdateVisitor);
-      ++shapeIdx;
-    }
+    mFramePrefetcher.computeFrame(time, mFrame);
+    applyFrame(mFrame);
   } catch (std::exception& ex) {
     std::string msg = "Error in VisualizerCSV::updateVisAttributes at time point " + std::to_string(time)
         + "\n" + std::string(ex.what());
@@ -158,23 +107,29 @@ void VisualizerCSV::updateVisAttributes(const double time)
   }
 }
 
+/*!
+ * \brief VisualizerCSV::updateScene
+ * Shows the prefetched frame for the time, or computes it if it is not ready, e.g. after seeking.
+ * Then lets the prefetcher continue with the next visualization steps.
+ * \param time
+ */
 void VisualizerCSV::updateScene(const double time)
 {
   mpTimeManager->updateTick();  //for real-time measurement
   double visTime = mpTimeManager->getRealTime();
-  updateVisAttributes(time);
+  if (!mFramePrefetcher.takeFrame(time, mFrame)) {
+    updateVisAttributes(time);
+  } else {
+    applyFrame(mFrame);
+  }
+  double step = mpTimeManager->getHVisual() * mpTimeManager->getSpeedUp();
+  mFramePrefetcher.prefetch(std::min(time + step, mpTimeManager->getEndTime()), step,
+                            mpTimeManager->getStartTime(), mpTimeManager->getEndTime());
   mpTimeManager->updateTick();  //for real-time measurement
   visTime = mpTimeManager->getRealTime() - visTime;
   mpTimeManager->setRealTimeFactor(mpTimeManager->getHVisual() / visTime);
 }
 
-void VisualizerCSV::updateObjectAttributeCSV(ShapeObjectAttribute* attr, double time)
-{
-  if (!attr->isConst) {
-    attr->exp = omcGetVarValue(attr->cref.c_str(), time);
-  }
-}
-
 double VisualizerCSV::omcGetVarValue(const char* varName, double time)
 {
   double *timeDataSet = read_csv_dataset(mpCSVData, "time");
@@ -34,8 +34,11 @@
 #define VISUALIZERCSV_H
 
 #include "Visualizer.h"
+#include "FramePrefetcher.h"
 #include "util/read_csv.h"
 
+#include <mutex>
+
 class VisualizerCSV : public VisualizerAbstract
 {
 public:
@@ -50,10 +53,12 @@ public:
   void simulate(TimeManager& omvm) override {Q_UNUSED(omvm);}
   void updateVisAttributes(const double time) override;
   void updateScene(const double time) override;
-  void updateObjectAttributeCSV(ShapeObjectAttribute* attr, double time);
   double omcGetVarValue(const char* varName, double time);
 private:
   csv_data *mpCSVData;
+  std::mutex mReaderMutex;
+  FramePrefetcher mFramePrefetcher;
+  AnimationFrame mFrame;
 };
 
 #endif // VISUALIZERCSV_H
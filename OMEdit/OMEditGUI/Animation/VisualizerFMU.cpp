@@ -35,15 +35,113 @@
 
 #include "VisualizerFMU.h"
 
+#include <algorithm>
+#include <chrono>
+#include <cmath>
+
+FMUFrameBuffer::FMUFrameBuffer()
+  : mValues(),
+    mTimes(),
+    mCapacity(0),
+    mFrameSize(0),
+    mHead(0),
+    mTail(0)
+{
+}
+
+/*!
+ * \brief FMUFrameBuffer::reset
+ * Preallocates the frames. Must not be called while the producer or the consumer is active.
+ * \param capacity
+ * \param frameSize
+ */
+void FMUFrameBuffer::reset(const size_t capacity, const size_t frameSize)
+{
+  // one slot always stays empty to distinguish a full from an empty ring
+  mCapacity = capacity + 1;
+  mFrameSize = frameSize;
+  mValues.assign(mCapacity * mFrameSize, 0.0);
+  mTimes.assign(mCapacity, 0.0);
+  mHead.store(0);
+  mTail.store(0);
+}
+
+/*!
+ * \brief FMUFrameBuffer::beginPush
+ * Producer side. Returns the values of the next free frame or nullptr if the ring is full.
+ */
+double* FMUFrameBuffer::beginPush()
+{
+  if (mCapacity == 0) {
+    return nullptr;
+  }
+  size_t tail = mTail.load(std::memory_order_relaxed);
+  if ((tail + 1) % mCapacity == mHead.load(std::memory_order_acquire)) {
+    return nullptr;
+  }
+  return mValues.data() + tail * mFrameSize;
+}
+
+/*!
+ * \brief FMUFrameBuffer::commitPush
+ * Producer side. Publishes the frame returned by beginPush().
+ * \param time
+ */
+void FMUFrameBuffer::commitPush(const double time)
+{
+  size_t tail = mTail.load(std::memory_order_relaxed);
+  mTimes[tail] = time;
+  mTail.store((tail + 1) % mCapacity, std::memory_order_release);
+}
+
+/*!
+ * \brief FMUFrameBuffer::front
+ * Consumer side. Returns the values of the oldest frame or nullptr if the ring is empty.
+ * \param time The time stamp of the frame.
+ */
+const double* FMUFrameBuffer::front(double* time) const
+{
+  size_t head = mHead.load(std::memory_order_relaxed);
+  if (head == mTail.load(std::memory_order_acquire)) {
+    return nullptr;
+  }
+  *time = mTimes[head];
+  return mValues.data() + head * mFrameSize;
+}
+
+/*!
+ * \brief FMUFrameBuffer::pop
+ * Consumer side. Releases the frame returned by front().
+ */
+void FMUFrameBuffer::pop()
+{
+  size_t head = mHead.load(std::memory_order_relaxed);
+  mHead.store((head + 1) % mCapacity, std::memory_order_release);
+}
+
 
 VisualizerFMU::VisualizerFMU(const std::string& modelFile, const std::string& path)
     : VisualizerAbstract(modelFile, path, VisType::FMU),
       mpFMU(nullptr),
-      mpSimSettings(new SimSettingsFMU())
+      mpSimSettings(new SimSettingsFMU()),
+      mStopSimulation(true),
+      mSimulationMutex(),
+      mSimulationCondition(),
+      mSimulationRealTimeFactor(0.0),
+      mFrameBuffer(),
+      mFrameAttributes(),
+      mFrameValueRefs(),
+      mCurrentFrame(),
+      mTransforms(),
+      mCurrentFrameTime(0.0),
+      mLastVisTime(0.0),
+      mSimulationTime(0.0),
+      mFrameInterval(0.1)
 {
 }
  VisualizerFMU::~VisualizerFMU()
  {
+   stopSimulationThread();
    if (mpFMU){
      free(mpFMU);
    }
@@ -52,6 +150,7 @@ VisualizerFMU::VisualizerFMU(const std::string& modelFile, const std::string& pa
 
 void VisualizerFMU::initData()
 {
+  stopSimulationThread();
   VisualizerAbstract::initData();
   loadFMU(mpOMVisualBase->getModelFile(), mpOMVisualBase->getPath());
   mpSimSettings->setTend(mpTimeManager->getEndTime());
@@ -176,6 +275,7 @@ void VisualizerFMU::simulate(TimeManager& omvm)
 
 void VisualizerFMU::updateSystem()
 {
+  stopSimulationThread();
   // Set states
   mpFMU->setContinuousStates();
   int zero_crossning_event = 0;
@@ -190,8 +290,46 @@ void VisualizerFMU::updateSystem()
   // Step is complete
   mpFMU->completedIntegratorStep(mpSimSettings->getCallEventUpdate());
   updateVisAttributes(mpTimeManager->getVisTime());
+  startSimulationThread();
+}
+
+/*!
+ * \brief VisualizerFMU::setState
+ * Sets a state value and continues the simulation from the frame that is currently shown.
+ * \param idx
+ * \param value
+ */
+void VisualizerFMU::setState(const size_t idx, const double value)
+{
+  restartSimulation(mCurrentFrameTime);
+  mpFMU->getFMUData()->_states[idx] = value;
+  updateSystem();
 }
 
+/*!
+ * \brief VisualizerFMU::restartSimulation
+ * Stops the simulation thread, which has run ahead, and sets the states of the frame that is currently shown at the time.
+ * \param time
+ */
+void VisualizerFMU::restartSimulation(const double time)
+{
+  stopSimulationThread();
+  const FMUData* data = mpFMU->getFMUData();
+  std::copy(mCurrentFrame.begin() + mFrameValueRefs.size(), mCurrentFrame.end(), data->_states);
+  mpFMU->setCurrentTime(time);
+  mpTimeManager->setVisTime(time);
+}
+
+/*!
+ * \brief VisualizerFMU::seek
+ * Discards the frames simulated ahead and continues the simulation from the shown states at the time.
+ * \param time
+ */
+void VisualizerFMU::seek(const double time)
+{
+  restartSimulation(time);
+  updateSystem();
+}
 
 double VisualizerFMU::simulateStep(const double time)
 {
@@ -216,16 +354,8 @@ double VisualizerFMU::simulateStep(const double time)
   // Solve system
   mpFMU->solveSystem();
 
-  //print out some values for debugging:
-  //std::cout<<"DO EULER at "<< mpFMU->getFMUData()->_tcur<<std::endl;
-  //fmi1_import_variable_t* var = fmi1_import_get_variable_by_name(mpFMUl.mpFMU, "prismatic.s");
-  //const fmi1_value_reference_t vr  = fmi1_import_get_variable_vr(var);
-  //double value = -1.0;
-  //fmi1_import_get_real(mpFMUl.mpFMU, &vr, 1, &value);
-  //std::cout<<"value "<<value<<std::endl;
-
-  // integrate a step with euler
-  mpFMU->doEulerStep();
+  // integrate a step with the chosen solver
+  mpFMU->integrateStep(mpSimSettings->getSolver(), mpSimSettings->getRelativeTolerance());
 
   // Set states
   mpFMU->setContinuousStates();
@@ -238,76 +368,75 @@ double VisualizerFMU::simulateStep(const double time)
 
 void VisualizerFMU::initializeVisAttributes(const double time)
 {
+  stopSimulationThread();
   mpFMU->initialize(mpSimSettings);
   std::cout<<"VisualizerFMU::loadFMU: FMU was successfully initialized."<<std::endl;
 
   mpTimeManager->setVisTime(mpTimeManager->getStartTime());
   mpTimeManager->setSimTime(mpTimeManager->getStartTime());
   setVarReferencesInVisAttributes();
+  initFrameLayout();
   updateVisAttributes(mpTimeManager->getVisTime());
+  startSimulationThread();
 }
 
-void VisualizerFMU::updateVisAttributes(const double time)
+/*!
+ * \brief VisualizerFMU::initFrameLayout
+ * Collects the variable attributes of all shapes. A frame holds their values in this order followed by the states.
+ */
+void VisualizerFMU::initFrameLayout()
 {
-  // Update all shapes.
-  rAndT rT;
-  osg::ref_ptr<osg::Node> child = nullptr;
-  try
+  mFrameAttributes.clear();
+  mFrameValueRefs.clear();
+  mTransforms.resize(mpOMVisualBase->_shapes.size());
+  size_t i = 0;
+  for (auto& shape : mpOMVisualBase->_shapes)
   {
-    size_t i = 0;
-    for (auto& shape : mpOMVisualBase->_shapes)
+    mTransforms.setType(i++, shape._type);
+    ShapeObjectAttribute* attributes[] = {&shape._length, &shape._width, &shape._height,
+                                          &shape._lDir[0], &shape._lDir[1], &shape._lDir[2],
+                                          &shape._wDir[0], &shape._wDir[1], &shape._wDir[2],
+                                          &shape._r[0], &shape._r[1], &shape._r[2],
+                                          &shape._rShape[0], &shape._rShape[1], &shape._rShape[2],
+                                          &shape._T[0], &shape._T[1], &shape._T[2],
+                                          &shape._T[3], &shape._T[4], &shape._T[5],
+                                          &shape._T[6], &shape._T[7], &shape._T[8]};
+    for (ShapeObjectAttribute* attr : attributes)
     {
-      // Get the values for the scene graph objects
-      updateObjectAttributeFMU(&shape._length, mpFMU);
-      updateObjectAttributeFMU(&shape._width, mpFMU);
-      updateObjectAttributeFMU(&shape._height, mpFMU);
-
-      updateObjectAttributeFMU(&shape._lDir[0], mpFMU);
-      updateObjectAttributeFMU(&shape._lDir[1], mpFMU);
-      updateObjectAttributeFMU(&shape._lDir[2], mpFMU);
-
-      updateObjectAttributeFMU(&shape._wDir[0], mpFMU);
-      updateObjectAttributeFMU(&shape._wDir[1], mpFMU);
-      updateObjectAttributeFMU(&shape._wDir[2], mpFMU);
-
-      updateObjectAttributeFMU(&shape._r[0], mpFMU);
-      updateObjectAttributeFMU(&shape._r[1], mpFMU);
-      updateObjectAttributeFMU(&shape._r[2], mpFMU);
-
-      updateObjectAttributeFMU(&shape._rShape[0], mpFMU);
-      updateObjectAttributeFMU(&shape._rShape[1], mpFMU);
-      updateObjectAttributeFMU(&shape._rShape[2], mpFMU);
-
-      updateObjectAttributeFMU(&shape._T[0], mpFMU);
-      updateObjectAttributeFMU(&shape._T[1], mpFMU);
-      updateObjectAttributeFMU(&shape._T[2], mpFMU);
-      updateObjectAttributeFMU(&shape._T[3], mpFMU);
-      updateObjectAttributeFMU(&shape._T[4], mpFMU);
-      updateObjectAttributeFMU(&shape._T[5], mpFMU);
-      updateObjectAttributeFMU(&shape._T[6], mpFMU);
-      updateObjectAttributeFMU(&shape._T[7], mpFMU);
-      updateObjectAttributeFMU(&shape._T[8], mpFMU);
-      rT = rotateModelica2OSG(osg::Vec3f(shape._r[0].exp, shape._r[1].exp, shape._r[2].exp),
-                osg::Vec3f(shape._rShape[0].exp, shape._rShape[1].exp, shape._rShape[2].exp),
-                osg::Matrix3(shape._T[0].exp, shape._T[1].exp, shape._T[2].exp,
-                             shape._T[3].exp, shape._T[4].exp, shape._T[5].exp,
-                             shape._T[6].exp, shape._T[7].exp, shape._T[8].exp),
-                osg::Vec3f(shape._lDir[0].exp, shape._lDir[1].exp, shape._lDir[2].exp),
-                osg::Vec3f(shape._wDir[0].exp, shape._wDir[1].exp, shape._wDir[2].exp),
-                shape._length.exp,/* shape._width.exp, shape._height.exp,*/ shape._type);
-
-      assemblePokeMatrix(shape._mat, rT._T, rT._r);
-
-      // Update the shapes.
-      mpUpdateVisitor->_shape = shape;
+      if (!attr->isConst)
+      {
+        mFrameAttributes.push_back(attr);
+        mFrameValueRefs.push_back(attr->fmuValueRef);
+      }
+    }
+  }
+  mCurrentFrame.assign(mFrameValueRefs.size() + mpFMU->getFMUData()->_nStates, 0.0);
+  mFrameBuffer.reset(64, mCurrentFrame.size());
+}
 
-      // Get the scene graph nodes and stuff.
-      //mpOMVisScene->dumpOSGTreeDebug();
-      child = mpOMVisScene->getScene().getRootNode()->getChild(i);  // the transformation
-      child->accept(*mpUpdateVisitor);
-      ++i;
-    }  //end for
-  }  // end try
+/*!
+ * \brief VisualizerFMU::readFrame
+ * Reads the values of the variable shape attributes and the states from the FMU.
+ * \param values
+ */
+void VisualizerFMU::readFrame(double* values)
+{
+  if (!mFrameValueRefs.empty())
+  {
+    mpFMU->fmi_get_reals(mFrameValueRefs.data(), mFrameValueRefs.size(), values);
+  }
+  const FMUData* data = mpFMU->getFMUData();
+  std::copy(data->_states, data->_states + data->_nStates, values + mFrameValueRefs.size());
+}
+
+void VisualizerFMU::updateVisAttributes(const double time)
+{
+  try
+  {
+    readFrame(mCurrentFrame.data());
+    mCurrentFrameTime = time;
+    applyFrame();
+  }
   catch (std::exception& ex)
   {
     std::string msg = "Error in VisualizerFMU::updateVisAttributes at time point " + std::to_string(time)
@@ -317,22 +446,165 @@ void VisualizerFMU::updateVisAttributes(const double time)
   }
 }
 
+/*!
+ * \brief VisualizerFMU::applyFrame
+ * Updates all shapes with the values of the current frame.
+ */
+void VisualizerFMU::applyFrame()
+{
+  for (size_t i = 0; i < mFrameAttributes.size(); ++i)
+  {
+    mFrameAttributes[i]->exp = (float) mCurrentFrame[i];
+  }
+
+  // Compute the transformations of all shapes at once.
+  size_t i = 0;
+  for (auto& shape : mpOMVisualBase->_shapes)
+  {
+    mTransforms.setValues(i++, shape);
+  }
+  mTransforms.compute();
+
+  // Update all shapes.
+  osg::ref_ptr<osg::Node> child = nullptr;
+  i = 0;
+  for (auto& shape : mpOMVisualBase->_shapes)
+  {
+    mTransforms.getMatrix(i, shape._mat);
+
+    // Update the shapes, the flattened static shapes don't change anymore.
+    if (!isStaticShapeFlattened(i)) {
+      mpUpdateVisitor->_shape = &shape;
+
+      // Get the scene graph nodes and stuff.
+      child = mpOMVisScene->getScene().getRootNode()->getChild(i);  // the transformation
+      child->accept(*mpUpdateVisitor);
+    }
+    ++i;
+  }  //end for
+  if (!mStaticShapesBuilt) {
+    buildStaticShapes();
+  }
+}
+
+/*!
+ * \brief VisualizerFMU::updateScene
+ * Shows the latest simulated frame that is not ahead of the visualization time.
+ * If the simulation thread falls behind, the visualization time is held back to the shown frame.
+ * If the time is not the next visualization step, e.g. after seeking, the simulation continues at the time.
+ * \param time
+ */
 void VisualizerFMU::updateScene(const double time)
 {
-  mpTimeManager->updateTick(); //for real-time measurement
+  const double eps = 1e-10;
+  const double nextVisTime = std::min(mLastVisTime + mpTimeManager->getHVisual() * mpTimeManager->getSpeedUp(),
+                                      mpTimeManager->getEndTime());
+  if (std::fabs(time - mLastVisTime) > eps && std::fabs(time - nextVisTime) > eps)
+  {
+    seek(time);
+    mLastVisTime = mpTimeManager->getVisTime();
+    return;
+  }
+  bool newFrame = false;
+  double frameTime = 0.0;
+  const double* values = mFrameBuffer.front(&frameTime);
+  while (values && frameTime <= mpTimeManager->getVisTime() + eps)
+  {
+    std::copy(values, values + mFrameBuffer.getFrameSize(), mCurrentFrame.begin());
+    mCurrentFrameTime = frameTime;
+    newFrame = true;
+    mFrameBuffer.pop();
+    values = mFrameBuffer.front(&frameTime);
+  }
+  if (newFrame)
+  {
+    // wake up the simulation thread if it waits for a free frame
+    {
+      std::lock_guard<std::mutex> lock(mSimulationMutex);
+    }
+    mSimulationCondition.notify_one();
+    applyFrame();
+  }
+  if (mCurrentFrameTime < mpTimeManager->getVisTime() - eps)
+  {
+    mpTimeManager->setVisTime(mCurrentFrameTime);
+  }
+  mLastVisTime = mpTimeManager->getVisTime();
+  mpTimeManager->setSimTime(mCurrentFrameTime);
+  mpTimeManager->setRealTimeFactor(mSimulationRealTimeFactor.load());
+}
 
-  mpTimeManager->setSimTime(mpTimeManager->getVisTime());
-  double nextStep = mpTimeManager->getVisTime() + mpTimeManager->getHVisual();
+/*!
+ * \brief VisualizerFMU::startSimulationThread
+ * Starts simulating ahead of the renderer from the current FMU time.
+ */
+void VisualizerFMU::startSimulationThread()
+{
+  if (!mpFMU || mSimulationThread.joinable())
+  {
+    return;
+  }
+  mSimulationTime = mpFMU->getFMUData()->_tcur;
+  mFrameInterval = mpTimeManager->getHVisual();
+  mFrameBuffer.reset(64, mCurrentFrame.size());
+  mSimulationRealTimeFactor.store(0.0);
+  mLastVisTime = mpTimeManager->getVisTime();
+  mStopSimulation.store(false);
+  mSimulationThread = std::thread(&VisualizerFMU::simulationThread, this);
+}
 
-  double vis1 = mpTimeManager->getRealTime();
-  while (mpTimeManager->getSimTime() < nextStep)
+/*!
+ * \brief VisualizerFMU::stopSimulationThread
+ * Stops the simulation thread. Afterwards the FMU can be accessed safely from the GUI thread.
+ */
+void VisualizerFMU::stopSimulationThread()
+{
   {
-    //std::cout<<"simulate "<<omvManager->_simTime<<" to "<<nextStep<<std::endl;
-    mpTimeManager->setSimTime(simulateStep(mpTimeManager->getSimTime()));
+    std::lock_guard<std::mutex> lock(mSimulationMutex);
+    mStopSimulation.store(true);
+  }
+  mSimulationCondition.notify_one();
+  if (mSimulationThread.joinable())
+  {
+    mSimulationThread.join();
+  }
+}
+
+/*!
+ * \brief VisualizerFMU::simulationThread
+ * Simulates the FMU and pushes a frame every visualization step.
+ * Waits while the ring is full or the end time is reached until the renderer takes a frame or the thread is stopped.
+ */
+void VisualizerFMU::simulationThread()
+{
+  const double endTime = mpSimSettings->getTend();
+  while (!mStopSimulation.load(std::memory_order_acquire))
+  {
+    double* values = mFrameBuffer.beginPush();
+    if (!values || mSimulationTime >= endTime)
+    {
+      // check again under the lock so that a frame taken in between is not missed
+      std::unique_lock<std::mutex> lock(mSimulationMutex);
+      if (!mStopSimulation.load() && (!mFrameBuffer.beginPush() || mSimulationTime >= endTime))
+      {
+        mSimulationCondition.wait(lock);
+      }
+      continue;
+    }
+    std::chrono::steady_clock::time_point start = std::chrono::steady_clock::now();
+    const double frameTime = std::min(mSimulationTime + mFrameInterval, endTime);
+    while (mSimulationTime < frameTime && !mStopSimulation.load(std::memory_order_relaxed))
+    {
+      mSimulationTime = simulateStep(mSimulationTime);
+    }
+    readFrame(values);
+    mFrameBuffer.commitPush(mSimulationTime);
+    std::chrono::duration<double> elapsed = std::chrono::steady_clock::now() - start;
+    if (elapsed.count() > 0.0)
+    {
+      mSimulationRealTimeFactor.store(mFrameInterval / elapsed.count());
+    }
   }
-  mpTimeManager->updateTick();                     //for real-time measurement
-  mpTimeManager->setRealTimeFactor(mpTimeManager->getHVisual() / (mpTimeManager->getRealTime() - vis1));
-  updateVisAttributes(mpTimeManager->getVisTime());
 }
 
 // Todo pass by const ref
@@ -348,9 +620,15 @@ void VisualizerFMU::updateObjectAttributeFMU(ShapeObjectAttribute* attr, FMUWrap
 
 void VisualizerFMU::setSimulationSettings(double stepsize, Solver solver, bool iterateEvents)
 {
+  bool running = mSimulationThread.joinable();
+  stopSimulationThread();
   mpSimSettings->setHdef(stepsize);
   mpSimSettings->setSolver(solver);
   mpSimSettings->setIterateEvents(iterateEvents);
+  if (running)
+  {
+    startSimulationThread();
+  }
 }
 
 FMUWrapperAbstract* VisualizerFMU::getFMU()
@@ -358,3 +636,13 @@ FMUWrapperAbstract* VisualizerFMU::getFMU()
   return mpFMU;
 };
 
+/*!
+ * \brief VisualizerFMU::getFrameState
+ * Returns the value of a state in the frame that is currently shown.
+ * \param idx
+ */
+double VisualizerFMU::getFrameState(const size_t idx) const
+{
+  return mCurrentFrame.at(mFrameValueRefs.size() + idx);
+}
+
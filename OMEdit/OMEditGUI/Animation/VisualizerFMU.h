@@ -40,6 +40,37 @@
 #include "FMUWrapper.h"
 #include "Shapes.h"
 #include "TimeManager.h"
+#include "ShapeTransforms.h"
+
+#include <atomic>
+#include <condition_variable>
+#include <mutex>
+#include <thread>
+#include <vector>
+
+/*!
+ * \class FMUFrameBuffer
+ * \brief Lock-free single producer/single consumer ring of simulation frames.
+ * The simulation thread pushes frames, the renderer pops them. Each frame has a time stamp and a fixed number of values.
+ */
+class FMUFrameBuffer
+{
+ public:
+  FMUFrameBuffer();
+  void reset(const size_t capacity, const size_t frameSize);
+  size_t getFrameSize() const {return mFrameSize;}
+  double* beginPush();
+  void commitPush(const double time);
+  const double* front(double* time) const;
+  void pop();
+ private:
+  std::vector<double> mValues;
+  std::vector<double> mTimes;
+  size_t mCapacity;
+  size_t mFrameSize;
+  std::atomic<size_t> mHead;
+  std::atomic<size_t> mTail;
+};
 
 class VisualizerFMU : public VisualizerAbstract
 {
@@ -59,18 +90,44 @@ class VisualizerFMU : public VisualizerAbstract
   void simulate(TimeManager& omvm) override;
   double simulateStep(const double time);
   void updateSystem();
+  void setState(const size_t idx, const double value);
   void updateVisAttributes(const double time) override;
   void updateScene(const double time = 0.0) override;
   void updateObjectAttributeFMU(ShapeObjectAttribute* attr, FMUWrapperAbstract* fmuWrapper);
   void setSimulationSettings(double stepsize, Solver solver, bool iterateEvents);
   FMUWrapperAbstract* getFMU();
+  void startSimulationThread();
+  void stopSimulationThread();
+  double getFrameState(const size_t idx) const;
 
  private:
+  void initFrameLayout();
+  void readFrame(double* values);
+  void applyFrame();
+  void restartSimulation(const double time);
+  void seek(const double time);
+  void simulationThread();
+
   std::shared_ptr<fmi_import_context_t> mpContext;
   jm_callbacks mCallbacks;
   fmi_version_enu_t mVersion;
   FMUWrapperAbstract* mpFMU;
   std::shared_ptr<SimSettingsFMU> mpSimSettings;
+  // background simulation
+  std::thread mSimulationThread;
+  std::atomic<bool> mStopSimulation;
+  std::mutex mSimulationMutex;
+  std::condition_variable mSimulationCondition;
+  std::atomic<double> mSimulationRealTimeFactor;
+  FMUFrameBuffer mFrameBuffer;
+  std::vector<ShapeObjectAttribute*> mFrameAttributes;
+  std::vector<unsigned int> mFrameValueRefs;
+  std::vector<double> mCurrentFrame;
+  ShapeTransforms mTransforms;
+  double mCurrentFrameTime;
+  double mLastVisTime;
+  double mSimulationTime;
+  double mFrameInterval;
 };
 
 
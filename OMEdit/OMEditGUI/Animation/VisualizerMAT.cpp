@@ -34,9 +34,17 @@
 
 #include "VisualizerMAT.h"
 
+#include <algorithm>
+
 VisualizerMAT::VisualizerMAT(const std::string& modelFile, const std::string& path)
   : VisualizerAbstract(modelFile, path, VisType::MAT),
-    _matReader()
+    _matReader(),
+    mReaderMutex(),
+    mFramePrefetcher([this](const ShapeObjectAttribute& attribute, const double time) {
+      std::lock_guard<std::mutex> lock(mReaderMutex);
+      return omcGetVarValue(&_matReader, attribute.cref.c_str(), time);
+    }),
+    mFrame()
 {
 
 }
@@ -47,6 +55,7 @@ VisualizerMAT::VisualizerMAT(const std::string& modelFile, const std::string& pa
  */
 VisualizerMAT::~VisualizerMAT()
 {
+  mFramePrefetcher.stop();
   if (_matReader.file) {
     omc_free_matlab4_reader(&_matReader);
   }
@@ -54,6 +63,7 @@ VisualizerMAT::~VisualizerMAT()
 
 void VisualizerMAT::initData()
 {
+  mFramePrefetcher.stop();
   VisualizerAbstract::initData();
   readMat(mpOMVisualBase->getModelFile(), mpOMVisualBase->getPath());
   mpTimeManager->setStartTime(omc_matlab4_startTime(&_matReader));
@@ -64,6 +74,7 @@ void VisualizerMAT::initializeVisAttributes(const double time)
 {
   if (0.0 > time)
     std::cout<<"Cannot load visualization attributes for time point < 0.0."<<std::endl;
+  mFramePrefetcher.setShapes(mpOMVisualBase->_shapes);
   updateVisAttributes(time);
 }
 
@@ -104,74 +115,10 @@ void VisualizerMAT::setSimulationSettings(const UserSimSettingsMAT& simSetMAT)
 
 void VisualizerMAT::updateVisAttributes(const double time)
 {
-  //std::cout<<"updateVisAttributes at "<<time <<std::endl;
-  // Update all shapes.
-  unsigned int shapeIdx = 0;
-  rAndT rT;
-  osg::ref_ptr<osg::Node> child = nullptr;
-  ModelicaMatReader* tmpReaderPtr = &_matReader;
   try
   {
-    for (auto& shape : mpOMVisualBase->_shapes)
-    {
-      //std::cout<<"shape "<<shape._id <<std::endl;
-
-      // Get the values for the scene graph objects
-      updateObjectAttributeMAT(&shape._length, time, tmpReaderPtr);
-      updateObjectAttributeMAT(&shape._width, time, tmpReaderPtr);
-      updateObjectAttributeMAT(&shape._height, time, tmpReaderPtr);
-
-      updateObjectAttributeMAT(&shape._lDir[0], time, tmpReaderPtr);
-      updateObjectAttributeMAT(&shape._lDir[1], time, tmpReaderPtr);
-      updateObjectAttributeMAT(&shape._lDir[2], time, tmpReaderPtr);
-
-      updateObjectAttributeMAT(&shape._wDir[0], time, tmpReaderPtr);
-      updateObjectAttributeMAT(&shape._wDir[1], time, tmpReaderPtr);
-      updateObjectAttributeMAT(&shape._wDir[2], time, tmpReaderPtr);
-
-      updateObjectAttributeMAT(&shape._r[0], time, tmpReaderPtr);
-      updateObjectAttributeMAT(&shape._r[1], time, tmpReaderPtr);
-      updateObjectAttributeMAT(&shape._r[2], time, tmpReaderPtr);
-
-      updateObjectAttributeMAT(&shape._rShape[0], time, tmpReaderPtr);
-      updateObjectAttributeMAT(&shape._rShape[1], time, tmpReaderPtr);
-      updateObjectAttributeMAT(&shape._rShape[2], time, tmpReaderPtr);
-
-      updateObjectAttributeMAT(&shape._T[0], time, tmpReaderPtr);
-      updateObjectAttributeMAT(&shape._T[1], time, tmpReaderPtr);
-      updateObjectAttributeMAT(&shape._T[2], time, tmpReaderPtr);
-      updateObjectAttributeMAT(&shape._T[3], time, tmpReaderPtr);
-      updateObjectAttributeMAT(&shape._T[4], time, tmpReaderPtr);
-      updateObjectAttributeMAT(&shape._T[5], time, tmpReaderPtr);
-      updateObjectAttributeMAT(&shape._T[6], time, tmpReaderPtr);
-      updateObjectAttributeMAT(&shape._T[7], time, tmpReaderPtr);
-      updateObjectAttributeMAT(&shape._T[8], time, tmpReaderPtr);
-
-      updateObjectAttributeMAT(&shape._color[0], time, tmpReaderPtr);
-      updateObjectAttributeMAT(&shape._color[1], time, tmpReaderPtr);
-      updateObjectAttributeMAT(&shape._color[2], time, tmpReaderPtr);
-
-      updateObjectAttributeMAT(&shape._specCoeff, time, tmpReaderPtr);
-      updateObjectAttributeMAT(&shape._extra, time, tmpReaderPtr);
-
-      rT = rotateModelica2OSG(osg::Vec3f(shape._r[0].exp, shape._r[1].exp, shape._r[2].exp),
-          osg::Vec3f(shape._rShape[0].exp, shape._rShape[1].exp, shape._rShape[2].exp),
-          osg::Matrix3(shape._T[0].exp, shape._T[1].exp, shape._T[2].exp,
-          shape._T[3].exp, shape._T[4].exp, shape._T[5].exp,
-          shape._T[6].exp, shape._T[7].exp, shape._T[8].exp),
-          osg::Vec3f(shape._lDir[0].exp, shape._lDir[1].exp, shape._lDir[2].exp),
-          osg::Vec3f(shape._wDir[0].exp, shape._wDir[1].exp, shape._wDir[2].exp),
-          shape._length.exp,/* shape._width.exp, shape._height.exp,*/ shape._type);
-
-      assemblePokeMatrix(shape._mat, rT._T, rT._r);
-      // Update the shapes.
-      mpUpdateVisitor->_shape = shape;
-      //shape.dumpVisAttributes();
-      // Get the scene graph nodes and stuff.
-      child = mpOMVisScene->getScene().getRootNode()->getChild(shapeIdx);  // the transformation
-      child->accept(*mpUpdateVisitor);
-      ++shapeIdx;
-    }
+    mFramePrefetcher.computeFrame(time, mFrame);
+    applyFrame(mFrame);
   }
   catch (std::exception& ex)
   {
@@ -181,22 +128,29 @@ void VisualizerMAT::updateVisAttributes(const double time)
   }
 }
 
+/*!
+ * \brief VisualizerMAT::updateScene
+ * Shows the prefetched frame for the time, or computes it if it is not ready, e.g. after seeking.
+ * Then lets the prefetcher continue with the next visualization steps.
+ * \param time
+ */
 void VisualizerMAT::updateScene(const double time)
 {
   mpTimeManager->updateTick();  //for real-time measurement
   double visTime = mpTimeManager->getRealTime();
-  updateVisAttributes(time);
+  if (!mFramePrefetcher.takeFrame(time, mFrame)) {
+    updateVisAttributes(time);
+  } else {
+    applyFrame(mFrame);
+  }
+  double step = mpTimeManager->getHVisual() * mpTimeManager->getSpeedUp();
+  mFramePrefetcher.prefetch(std::min(time + step, mpTimeManager->getEndTime()), step,
+                            mpTimeManager->getStartTime(), mpTimeManager->getEndTime());
   mpTimeManager->updateTick();  //for real-time measurement
   visTime = mpTimeManager->getRealTime() - visTime;
   mpTimeManager->setRealTimeFactor(mpTimeManager->getHVisual() / visTime);
 }
 
-void VisualizerMAT::updateObjectAttributeMAT(ShapeObjectAttribute* attr, double time, ModelicaMatReader* reader)
-{
-  if (!attr->isConst)
-    attr->exp = omcGetVarValue(reader, attr->cref.c_str(), time);
-}
-
 double VisualizerMAT::omcGetVarValue(ModelicaMatReader* reader, const char* varName, double time)
 {
     double val = 0.0;
@@ -36,8 +36,11 @@
 #define VISUALIZERMAT_H
 
 #include "Visualizer.h"
+#include "FramePrefetcher.h"
 #include "util/read_matlab4.h"
 
+#include <mutex>
+
 class VisualizerMAT : public VisualizerAbstract
 {
  public:
@@ -53,10 +56,12 @@ class VisualizerMAT : public VisualizerAbstract
   void simulate(TimeManager& omvm) override {Q_UNUSED(omvm);}
   void updateVisAttributes(const double time) override;
   void updateScene(const double time) override;
-  void updateObjectAttributeMAT(ShapeObjectAttribute* attr, double time, ModelicaMatReader* reader);
   double omcGetVarValue(ModelicaMatReader* reader, const char* varName, double time);
 private:
   ModelicaMatReader _matReader;
+  std::mutex mReaderMutex;
+  FramePrefetcher mFramePrefetcher;
+  AnimationFrame mFrame;
 };
 
 #endif // end VISUALIZERMAT_H
@@ -98,7 +98,7 @@ void EllipseAnnotation::parseShapeAnnotation(QString annotation)
 
 QRectF EllipseAnnotation::boundingRect() const
 {
-  return shape().boundingRect();
+  return adjustBoundingRectWithLineThickness(shape().boundingRect());
 }
 
 QPainterPath EllipseAnnotation::shape() const
@@ -461,7 +461,9 @@ QPainterPath LineAnnotation::getShape() const
 
 QRectF LineAnnotation::boundingRect() const
 {
-  return shape().boundingRect();
+  // the arrows are drawn around the end points of the line
+  QRectF rect = adjustBoundingRectWithLineThickness(shape().boundingRect());
+  return rect.adjusted(-mArrowSize, -mArrowSize, mArrowSize, mArrowSize);
 }
 
 QPainterPath LineAnnotation::shape() const
@@ -1041,6 +1043,7 @@ void LineAnnotation::updateShape(ShapeAnnotation *pShapeAnnotation)
     mpTextAnnotation = 0;
   }
   setOldAnnotation(pLineAnnotation->getOldAnnotation());
+  mOldPoints = pLineAnnotation->getOldPoints();
   setDelay(pLineAnnotation->getDelay());
   setZf(pLineAnnotation->getZf());
   setZfr(pLineAnnotation->getZfr());
@@ -1235,6 +1238,23 @@ void LineAnnotation::updateConnectionAnnotation()
   }
 }
 
+/*!
+ * \brief LineAnnotation::getOldAnnotation
+ * Returns the annotation of the line before it was changed.\n
+ * The annotation is only created from the points saved by saveOldPoints() when it is asked for.
+ * \return
+ */
+QString LineAnnotation::getOldAnnotation()
+{
+  if (mOldAnnotation.isEmpty() && !mOldPoints.isEmpty()) {
+    QList<QPointF> points = mPoints;
+    mPoints = mOldPoints;
+    mOldAnnotation = getOMCShapeAnnotation();
+    mPoints = points;
+  }
+  return mOldAnnotation;
+}
+
 /*!
  * \brief LineAnnotation::updateConnectionTransformation
  * Slot activated when Component transformChanging SIGNAL is emitted.\n
@@ -1242,16 +1262,17 @@ void LineAnnotation::updateConnectionAnnotation()
  */
 void LineAnnotation::updateConnectionTransformation()
 {
-  assert(!mOldAnnotation.isEmpty());
+  QString oldAnnotation = getOldAnnotation();
+  assert(!oldAnnotation.isEmpty());
   if (mLineType == LineAnnotation::ConnectionType) {
-    mpGraphicsView->getModelWidget()->getUndoStack()->push(new UpdateConnectionCommand(this, mOldAnnotation, getOMCShapeAnnotation()));
+    mpGraphicsView->getModelWidget()->getUndoStack()->push(new UpdateConnectionCommand(this, oldAnnotation, getOMCShapeAnnotation()));
   } else if (mLineType == LineAnnotation::TransitionType) {
     mpGraphicsView->getModelWidget()->getUndoStack()->push(new UpdateTransitionCommand(this, mCondition, mImmediate, mReset,
-                                                                                       mSynchronize, mPriority, mOldAnnotation,
+                                                                                       mSynchronize, mPriority, oldAnnotation,
                                                                                        mCondition, mImmediate, mReset, mSynchronize,
                                                                                        mPriority, getOMCShapeAnnotation()));
   } else if (mLineType == LineAnnotation::InitialStateType) {
-    mpGraphicsView->getModelWidget()->getUndoStack()->push(new UpdateInitialStateCommand(this, mOldAnnotation, getOMCShapeAnnotation()));
+    mpGraphicsView->getModelWidget()->getUndoStack()->push(new UpdateInitialStateCommand(this, oldAnnotation, getOMCShapeAnnotation()));
   }
 }
 
@@ -117,7 +117,9 @@ public:
   int getPriority() {return mPriority;}
   TextAnnotation* getTextAnnotation() {return mpTextAnnotation;}
   void setOldAnnotation(QString oldAnnotation) {mOldAnnotation = oldAnnotation;}
-  QString getOldAnnotation() {return mOldAnnotation;}
+  QString getOldAnnotation();
+  void saveOldPoints() {mOldPoints = mPoints; mOldAnnotation.clear();}
+  QList<QPointF> getOldPoints() {return mOldPoints;}
   void setDelay(QString delay) {mDelay = delay;}
   QString getDelay() {return mDelay;}
   void setZf(QString zf) {mZf = zf;}
@@ -153,6 +155,7 @@ protected:
   TextAnnotation *mpTextAnnotation;
   // MetaModel attributes
   QString mOldAnnotation;
+  QList<QPointF> mOldPoints;
   // CompositeModel attributes
   QString mDelay;
   QString mZf;
@@ -162,7 +162,7 @@ QPainterPath PolygonAnnotation::getShape() const
 
 QRectF PolygonAnnotation::boundingRect() const
 {
-  return shape().boundingRect();
+  return adjustBoundingRectWithLineThickness(shape().boundingRect());
 }
 
 QPainterPath PolygonAnnotation::shape() const
@@ -141,7 +141,7 @@ void RectangleAnnotation::parseShapeAnnotation(QString annotation)
 
 QRectF RectangleAnnotation::boundingRect() const
 {
-  return shape().boundingRect();
+  return adjustBoundingRectWithLineThickness(shape().boundingRect());
 }
 
 QPainterPath RectangleAnnotation::shape() const
@@ -305,6 +305,12 @@ ShapeAnnotation::ShapeAnnotation(QGraphicsItem *pParent)
   mIsInheritedShape = false;
   setOldScenePosition(QPointF(0, 0));
   mIsCornerItemClicked = false;
+  /* The shapes of a component are only changed through update() so cache them in device coordinates.
+   * Moving the component then reuses the cached pixmap instead of redrawing the shapes.
+   */
+  if (mpParentComponent) {
+    setCacheMode(QGraphicsItem::DeviceCoordinateCache);
+  }
 }
 
 /*!
@@ -461,6 +467,18 @@ QPainterPath ShapeAnnotation::addPathStroker(QPainterPath &path) const
   return stroker.createStroke(path);
 }
 
+/*!
+ * \brief ShapeAnnotation::adjustBoundingRectWithLineThickness
+ * Grows the rectangle by half of the line thickness so that the partial viewport updates repaint the complete outline.
+ * \param rect
+ * \return the adjusted rectangle.
+ */
+QRectF ShapeAnnotation::adjustBoundingRectWithLineThickness(const QRectF &rect) const
+{
+  qreal margin = qMax(Helper::shapesStrokeWidth, Utilities::convertMMToPixel(mLineThickness)) / 2;
+  return rect.adjusted(-margin, -margin, margin, margin);
+}
+
 /*!
   Returns the bounding rectangle of the shape.
   \return the bounding rectangle.
@@ -789,18 +807,27 @@ QImage ShapeAnnotation::getImage()
 }
 
 /*!
-  Returns a dynamic value or null if no dynamic value exists
-  */
-QVariant ShapeAnnotation::getDynamicValue(QString name)
+ * \brief ShapeAnnotation::getDynamicValue
+ * Returns a dynamic value or null if no dynamic value exists.\n
+ * The variable is resolved once into the binding and only looked up again when the result variables have changed.
+ * \param name - the variable name.
+ * \param dynamicValueBinding - the binding holding the resolved variable.
+ * \return
+ */
+QVariant ShapeAnnotation::getDynamicValue(const QString &name, DynamicValueBinding &dynamicValueBinding)
 {
   QVariant dynamicValue; // isNull() per default
   if (mpParentComponent) {
     ModelWidget *pModelWidget = mpParentComponent->getGraphicsView()->getModelWidget();
     if (!pModelWidget->getResultFileName().isEmpty()) {
-      QString fullName = pModelWidget->getResultFileName() + "." + mpParentComponent->getComponentInfo()->getName() + "." + name;
-      MainWindow *pMainWindow = MainWindow::instance();
-      VariablesTreeModel *pVariablesTreeModel = pMainWindow->getVariablesWidget()->getVariablesTreeModel();
-      VariablesTreeItem *pVariablesTreeItem = pVariablesTreeModel->findVariablesTreeItem(fullName, pVariablesTreeModel->getRootVariablesTreeItem());
+      VariablesTreeModel *pVariablesTreeModel = MainWindow::instance()->getVariablesWidget()->getVariablesTreeModel();
+      if (dynamicValueBinding.mVariablesRevision != pVariablesTreeModel->getVariablesRevision() || dynamicValueBinding.mVariable != name) {
+        QString fullName = pModelWidget->getResultFileName() + "." + mpParentComponent->getComponentInfo()->getName() + "." + name;
+        dynamicValueBinding.mVariable = name;
+        dynamicValueBinding.mpVariablesTreeItem = pVariablesTreeModel->getVariablesTreeItem(fullName);
+        dynamicValueBinding.mVariablesRevision = pVariablesTreeModel->getVariablesRevision();
+      }
+      VariablesTreeItem *pVariablesTreeItem = dynamicValueBinding.mpVariablesTreeItem;
       if (pVariablesTreeItem != NULL) {
         dynamicValue = pVariablesTreeItem->getValue(pVariablesTreeItem->getPreviousUnit(), pVariablesTreeItem->getUnit());
       }
@@ -1017,7 +1044,7 @@ void ShapeAnnotation::updateVisible()
 {
   bool visible = mVisible; // model provided default value
   if (!mDynamicVisible.isEmpty()) {
-    QVariant dynamicValue = getDynamicValue(mDynamicVisible);
+    QVariant dynamicValue = getDynamicValue(mDynamicVisible, mDynamicVisibleBinding);
     if (!dynamicValue.isNull()) {
       visible = dynamicValue.toBool();
     }
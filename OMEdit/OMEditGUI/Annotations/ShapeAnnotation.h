@@ -52,6 +52,19 @@ class GraphicsView;
 class CornerItem;
 class ResizerItem;
 class ShapeAnnotation;
+class VariablesTreeItem;
+
+/*!
+ * \brief The DynamicValueBinding struct
+ * Binds a DynamicSelect variable of the shape to its pre-resolved result variable.
+ */
+struct DynamicValueBinding
+{
+  DynamicValueBinding() : mpVariablesTreeItem(0), mVariablesRevision(-1) {}
+  QString mVariable;
+  VariablesTreeItem *mpVariablesTreeItem;
+  int mVariablesRevision; /* revision of the VariablesTreeModel the variable is resolved for, -1 if not resolved yet. */
+};
 
 class GraphicItem
 {
@@ -71,6 +84,7 @@ protected:
   QPointF mOrigin;
   qreal mRotation;
   QString mDynamicVisible; /* variable for visible attribute */
+  DynamicValueBinding mDynamicVisibleBinding;
 };
 
 class FilledShape
@@ -124,6 +138,7 @@ public:
   bool isInheritedShape();
   void createActions();
   QPainterPath addPathStroker(QPainterPath &path) const;
+  QRectF adjustBoundingRectWithLineThickness(const QRectF &rect) const;
   QRectF getBoundingRect() const;
   void applyLinePattern(QPainter *painter);
   void applyFillPattern(QPainter *painter);
@@ -177,7 +192,7 @@ public:
   QString getImageSource();
   void setImage(QImage image);
   QImage getImage();
-  QVariant getDynamicValue(QString name);
+  QVariant getDynamicValue(const QString &name, DynamicValueBinding &dynamicValueBinding);
   void applyRotation(qreal angle);
   void adjustPointsWithOrigin();
   void adjustExtentsWithOrigin();
@@ -259,6 +274,7 @@ protected:
   QImage mImage;
   QList<CornerItem*> mCornerItemsList;
   QList<QVariant> mDynamicTextString; /* list of String() arguments */
+  DynamicValueBinding mDynamicTextStringBinding;
   void initUpdateVisible();
   virtual void contextMenuEvent(QGraphicsSceneContextMenuEvent *pEvent);
   virtual QVariant itemChange(GraphicsItemChange change, const QVariant &value);
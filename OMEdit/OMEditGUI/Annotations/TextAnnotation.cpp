@@ -557,10 +557,12 @@ void TextAnnotation::updateTextStringHelper(QRegExp regExp)
  */
 void TextAnnotation::updateTextString()
 {
+  // schedule the repaint. The shape might be cached so it is not repainted otherwise.
+  update();
   /* optional DynamicSelect of textString attribute */
   QVariant dynamicValue; // isNull() per default
   if (mDynamicTextString.count() > 0) {
-    dynamicValue = getDynamicValue(mDynamicTextString.at(0).toString());
+    dynamicValue = getDynamicValue(mDynamicTextString.at(0).toString(), mDynamicTextStringBinding);
   }
   if (!dynamicValue.isNull()) {
     mTextString = dynamicValue.toString();
@@ -0,0 +1,380 @@
+/*
+ * This file is part of OpenModelica.
+ *
+ * Copyright (c) 1998-CurrentYear, Open Source Modelica Consortium (OSMC),
+ * c/o Linköpings universitet, Department of Computer and Information Science,
+ * SE-58183 Linköping, Sweden.
+ *
+ * All rights reserved.
+ *
+ * THIS PROGRAM IS PROVIDED UNDER THE TERMS OF GPL VERSION 3 LICENSE OR
+ * THIS OSMC PUBLIC LICENSE (OSMC-PL) VERSION 1.2.
+ * ANY USE, REPRODUCTION OR DISTRIBUTION OF THIS PROGRAM CONSTITUTES
+ * RECIPIENT'S ACCEPTANCE OF THE OSMC PUBLIC LICENSE OR THE GPL VERSION 3,
+ * ACCORDING TO RECIPIENTS CHOICE.
+ *
+ * The OpenModelica software and the Open Source Modelica
+ * Consortium (OSMC) Public License (OSMC-PL) are obtained
+ * from OSMC, either from the above address,
+ * from the URLs: http://www.ida.liu.se/projects/OpenModelica or
+ * http://www.openmodelica.org, and in the OpenModelica distribution.
+ * GNU version 3 is obtained from: http://www.gnu.org/copyleft/gpl.html.
+ *
+ * This program is distributed WITHOUT ANY WARRANTY; without
+ * even the implied warranty of  MERCHANTABILITY or FITNESS
+ * FOR A PARTICULAR PURPOSE, EXCEPT AS EXPRESSLY SET FORTH
+ * IN THE BY RECIPIENT SELECTED SUBSIDIARY LICENSE CONDITIONS OF OSMC-PL.
+ *
+ * See the full OSMC Public License conditions for more details.
+ *
+ */
+
+#include "Benchmark/AnimationBenchmark.h"
+#include "Animation/VisualizerMAT.h"
+#include "Animation/VisualizerCSV.h"
+#include "Util/Utilities.h"
+
+#include <cmath>
+#include <stdio.h>
+#include <string.h>
+
+#include <QFile>
+#include <osg/GraphicsContext>
+#include <osg/Viewport>
+#include <osgGA/TrackballManipulator>
+#include <osgViewer/Viewer>
+
+namespace {
+// the number of frames played for each visualizer
+const int frames = 200;
+// every fourth shape has only constant attributes
+const int staticShapeInterval = 4;
+// the result variables of a moving shape
+const char *shapeVariables[] = {"r[1]", "r[2]", "r[3]", "cos", "sin", "msin"};
+const int numShapeVariables = sizeof(shapeVariables) / sizeof(shapeVariables[0]);
+
+/*!
+ * \brief writeMatHeader
+ * Writes the header of a MAT v4 matrix.
+ */
+void writeMatHeader(QFile &file, const char *name, qint32 type, qint32 rows, qint32 cols)
+{
+  qint32 header[5] = {type, rows, cols, 0, static_cast<qint32>(strlen(name) + 1)};
+  file.write(reinterpret_cast<const char*>(header), sizeof(header));
+  file.write(name, strlen(name) + 1);
+}
+
+/*!
+ * \brief writeMatStrings
+ * Writes the strings as a transposed MAT v4 text matrix, i.e. one string per column.
+ */
+void writeMatStrings(QFile &file, const char *name, const QStringList &strings)
+{
+  int length = 1;
+  foreach (QString string, strings) {
+    length = qMax(length, string.length());
+  }
+  writeMatHeader(file, name, 51, length, strings.size());
+  foreach (QString string, strings) {
+    file.write(string.leftJustified(length, QChar('\0')).toLatin1());
+  }
+}
+}
+
+/*!
+ * \class AnimationBenchmark
+ * \brief Headless benchmark of the animation of result files.
+ * Generates a visualization with the given number of shapes and a result file in mat and csv format.
+ * The result files are played with VisualizerMAT and VisualizerCSV and the scene is rendered to an offscreen pbuffer.
+ * The stages of a frame are reported as time per frame.
+ */
+/*!
+ * \brief AnimationBenchmark::AnimationBenchmark
+ * \param sizes The number of shapes.
+ * \param outputFileName
+ * \param pParent
+ */
+AnimationBenchmark::AnimationBenchmark(const QList<int> &sizes, const QString &outputFileName, QObject *pParent)
+  : Benchmark("animation", sizes, outputFileName, pParent)
+{
+}
+
+/*!
+ * \brief AnimationBenchmark::runBenchmark
+ * Generates the visualization and result files for each size and benchmarks the visualizers.
+ */
+void AnimationBenchmark::runBenchmark()
+{
+  // the visualization step of the TimeManager
+  const double step = 0.1;
+  foreach (int size, mSizes) {
+    QString modelName = QString("AnimationBenchmark%1").arg(size);
+    QStringList variables;
+    if (!writeFile(QString("%1%2_visual.xml").arg(Utilities::tempDirectory()).arg(modelName), generateVisualXML(size, variables))) {
+      continue;
+    }
+    std::vector<double> data;
+    generateTrajectories(size, frames, step, data);
+    QString matFileName = modelName + "_res.mat";
+    QString csvFileName = modelName + "_res.csv";
+    if (!writeMatFile(Utilities::tempDirectory() + matFileName, variables, data)
+        || !writeCSVFile(Utilities::tempDirectory() + csvFileName, variables, data)) {
+      continue;
+    }
+    std::string path = Utilities::tempDirectory().toStdString();
+    VisualizerAbstract *pVisualizer = new VisualizerMAT(matFileName.toStdString(), path);
+    benchmarkVisualizer(pVisualizer, "mat", size);
+    delete pVisualizer;
+    pVisualizer = new VisualizerCSV(csvFileName.toStdString(), path);
+    benchmarkVisualizer(pVisualizer, "csv", size);
+    delete pVisualizer;
+    restartTimer();
+  }
+}
+
+/*!
+ * \brief AnimationBenchmark::generateVisualXML
+ * Generates the visualization with boxes, cylinders, spheres and cones placed on a grid.
+ * \param size
+ * \param variables - the result variables used by the shapes, time first.
+ * \return
+ */
+QString AnimationBenchmark::generateVisualXML(int size, QStringList &variables)
+{
+  static const char *types[] = {"box", "cylinder", "sphere", "cone"};
+  auto constant = [](double value) {return QString("<exp>%1</exp>").arg(value);};
+  auto variable = [](const QString &name) {return QString("<cref>%1</cref>").arg(name);};
+  variables.clear();
+  variables << "time";
+  int columns = qMax(1, static_cast<int>(std::sqrt(static_cast<double>(size))));
+  QString xml = "<?xml version=\"1.0\" encoding=\"UTF-8\"?>\n<visualization>\n";
+  for (int i = 0; i < size; ++i) {
+    QString shape = QString("s%1.").arg(i);
+    QString r[3] = {constant(2.0 * (i % columns)), constant(2.0 * (i / columns)), constant(0)};
+    QString T[9] = {constant(1), constant(0), constant(0), constant(0), constant(1), constant(0), constant(0), constant(0), constant(1)};
+    if (i % staticShapeInterval != 0) {
+      for (int k = 0; k < numShapeVariables; ++k) {
+        variables << shape + shapeVariables[k];
+      }
+      for (int k = 0; k < 3; ++k) {
+        r[k] = variable(shape + shapeVariables[k]);
+      }
+      // a rotation about the z axis
+      T[0] = T[4] = variable(shape + "cos");
+      T[1] = variable(shape + "msin");
+      T[3] = variable(shape + "sin");
+    }
+    xml += "  <shape>\n";
+    xml += QString("    <ident>%1shape</ident>\n").arg(shape);
+    xml += QString("    <type>%1</type>\n").arg(types[i % (sizeof(types) / sizeof(types[0]))]);
+    xml += "    <T>";
+    for (int k = 0; k < 9; ++k) {
+      xml += T[k];
+    }
+    xml += "</T>\n";
+    xml += QString("    <r>%1%2%3</r>\n").arg(r[0], r[1], r[2]);
+    xml += QString("    <r_shape>%1%2%3</r_shape>\n").arg(constant(0), constant(0), constant(0));
+    xml += QString("    <lengthDir>%1%2%3</lengthDir>\n").arg(constant(1), constant(0), constant(0));
+    xml += QString("    <widthDir>%1%2%3</widthDir>\n").arg(constant(0), constant(1), constant(0));
+    xml += QString("    <length>%1</length>\n").arg(constant(1));
+    xml += QString("    <width>%1</width>\n").arg(constant(0.5));
+    xml += QString("    <height>%1</height>\n").arg(constant(0.5));
+    xml += QString("    <extra>%1</extra>\n").arg(constant(0));
+    xml += QString("    <color>%1%2%3</color>\n").arg(constant(255.0 * (i % 2)), constant(128), constant(255.0 * ((i + 1) % 2)));
+    xml += QString("    <specCoeff>%1</specCoeff>\n").arg(constant(0.7));
+    xml += "  </shape>\n";
+  }
+  xml += "</visualization>\n";
+  return xml;
+}
+
+/*!
+ * \brief AnimationBenchmark::generateTrajectories
+ * Generates the values of the result variables, one row per time step with the time first.\n
+ * The time is accumulated in the same way as the animation does so that the time points match exactly.
+ * \param size
+ * \param steps
+ * \param step
+ * \param data
+ */
+void AnimationBenchmark::generateTrajectories(int size, int steps, double step, std::vector<double> &data)
+{
+  int columns = qMax(1, static_cast<int>(std::sqrt(static_cast<double>(size))));
+  data.clear();
+  double time = 0.0;
+  for (int j = 0; j <= steps; ++j) {
+    data.push_back(time);
+    for (int i = 0; i < size; ++i) {
+      if (i % staticShapeInterval != 0) {
+        double phase = 0.1 * i;
+        double angle = (1 + i % 3) * time;
+        data.push_back(2.0 * (i % columns) + 0.5 * std::sin(time + phase));
+        data.push_back(2.0 * (i / columns));
+        data.push_back(0.5 * std::cos(time + phase));
+        data.push_back(std::cos(angle));
+        data.push_back(std::sin(angle));
+        data.push_back(-std::sin(angle));
+      }
+    }
+    time += step;
+  }
+}
+
+/*!
+ * \brief AnimationBenchmark::writeMatFile
+ * Writes the result file in the transposed MAT v4 format written by the simulation runtime.
+ * \param fileName
+ * \param variables
+ * \param data
+ * \return
+ */
+bool AnimationBenchmark::writeMatFile(const QString &fileName, const QStringList &variables, const std::vector<double> &data)
+{
+  QFile file(fileName);
+  if (!file.open(QIODevice::WriteOnly | QIODevice::Truncate)) {
+    fprintf(stderr, "Unable to write the benchmark file %s.\n", fileName.toStdString().c_str());
+    return false;
+  }
+  writeMatStrings(file, "Aclass", QStringList() << "Atrajectory" << "1.1" << "" << "binTrans");
+  writeMatStrings(file, "name", variables);
+  QStringList descriptions;
+  for (int i = 0; i < variables.size(); ++i) {
+    descriptions << "";
+  }
+  writeMatStrings(file, "description", descriptions);
+  // the time is the first variable of both data sets, all the other variables are in data_2
+  writeMatHeader(file, "dataInfo", 20, 4, variables.size());
+  for (int i = 0; i < variables.size(); ++i) {
+    qint32 info[4] = {i == 0 ? 0 : 2, i + 1, 0, -1};
+    file.write(reinterpret_cast<const char*>(info), sizeof(info));
+  }
+  size_t rows = data.size() / variables.size();
+  double interval[2] = {data.front(), data[(rows - 1) * variables.size()]};
+  writeMatHeader(file, "data_1", 0, 1, 2);
+  file.write(reinterpret_cast<const char*>(interval), sizeof(interval));
+  writeMatHeader(file, "data_2", 0, variables.size(), rows);
+  file.write(reinterpret_cast<const char*>(data.data()), data.size() * sizeof(double));
+  file.close();
+  return true;
+}
+
+/*!
+ * \brief AnimationBenchmark::writeCSVFile
+ * Writes the result file in the csv format written by the simulation runtime.
+ * \param fileName
+ * \param variables
+ * \param data
+ * \return
+ */
+bool AnimationBenchmark::writeCSVFile(const QString &fileName, const QStringList &variables, const std::vector<double> &data)
+{
+  QString contents = QString("\"%1\"\n").arg(variables.join("\",\""));
+  QStringList row;
+  for (size_t i = 0; i < data.size(); ++i) {
+    row << QString::number(data[i], 'g', 17);
+    if (row.size() == variables.size()) {
+      contents += row.join(",") + "\n";
+      row.clear();
+    }
+  }
+  return writeFile(fileName, contents);
+}
+
+/*!
+ * \brief AnimationBenchmark::createOffscreenViewer
+ * Creates a single threaded viewer that renders to a pbuffer, e.g. with Mesa llvmpipe.
+ * \return the viewer or nullptr if no pbuffer context is available.
+ */
+osg::ref_ptr<osgViewer::Viewer> AnimationBenchmark::createOffscreenViewer()
+{
+  osg::ref_ptr<osg::GraphicsContext::Traits> traits = new osg::GraphicsContext::Traits;
+  traits->x = 0;
+  traits->y = 0;
+  traits->width = 800;
+  traits->height = 600;
+  traits->red = 8;
+  traits->green = 8;
+  traits->blue = 8;
+  traits->alpha = 8;
+  traits->depth = 24;
+  traits->windowDecoration = false;
+  traits->pbuffer = true;
+  traits->doubleBuffer = false;
+  osg::ref_ptr<osg::GraphicsContext> pGraphicsContext = osg::GraphicsContext::createGraphicsContext(traits.get());
+  if (!pGraphicsContext.valid()) {
+    return nullptr;
+  }
+  osg::ref_ptr<osgViewer::Viewer> pViewer = new osgViewer::Viewer;
+  pViewer->setThreadingModel(osgViewer::Viewer::SingleThreaded);
+  osg::Camera *pCamera = pViewer->getCamera();
+  pCamera->setGraphicsContext(pGraphicsContext.get());
+  pCamera->setViewport(new osg::Viewport(0, 0, traits->width, traits->height));
+  pCamera->setProjectionMatrixAsPerspective(30.0, static_cast<double>(traits->width) / traits->height, 1.0, 10000.0);
+  pCamera->setDrawBuffer(GL_FRONT);
+  pCamera->setReadBuffer(GL_FRONT);
+  pViewer->setCameraManipulator(new osgGA::TrackballManipulator);
+  return pViewer;
+}
+
+/*!
+ * \brief AnimationBenchmark::benchmarkVisualizer
+ * Loads the visualization and plays the frames.\n
+ * The updateVisAttributes stage reads the values and runs the UpdateVisitor for every frame,
+ * the updateScene stage plays the frames like the animation timer does, i.e. with the prefetched frames.
+ * \param pVisualizer
+ * \param benchmarkCase
+ * \param size
+ */
+void AnimationBenchmark::benchmarkVisualizer(VisualizerAbstract *pVisualizer, const QString &benchmarkCase, int size)
+{
+  try {
+    restartTimer();
+    pVisualizer->initData();
+    addTimedResult(benchmarkCase, size, "initData");
+    pVisualizer->setUpScene();
+    addTimedResult(benchmarkCase, size, "setUpScene");
+    pVisualizer->initVisualization();
+    addTimedResult(benchmarkCase, size, "initVisualization");
+    TimeManager *pTimeManager = pVisualizer->getTimeManager();
+    double step = pTimeManager->getHVisual() * pTimeManager->getSpeedUp();
+    // read and apply every frame
+    qint64 nsecs = 0;
+    double time = pTimeManager->getStartTime();
+    for (int frame = 0; frame < frames; ++frame) {
+      restartTimer();
+      pVisualizer->updateVisAttributes(time);
+      nsecs += elapsed();
+      time = qMin(time + step, pTimeManager->getEndTime());
+    }
+    addResult(benchmarkCase, size, "updateVisAttributes/frame", nsecs / frames);
+    // play and render the frames
+    osg::ref_ptr<osgViewer::Viewer> pViewer = createOffscreenViewer();
+    if (pViewer.valid()) {
+      pViewer->setSceneData(pVisualizer->getOMVisScene()->getScene().getRootNode());
+      pViewer->realize();
+    } else {
+      fprintf(stderr, "Unable to create a pbuffer context, the frames are not rendered.\n");
+    }
+    nsecs = 0;
+    qint64 renderNsecs = 0;
+    time = pTimeManager->getStartTime();
+    for (int frame = 0; frame < frames; ++frame) {
+      restartTimer();
+      pVisualizer->updateScene(time);
+      nsecs += elapsed();
+      if (pViewer.valid()) {
+        restartTimer();
+        pViewer->frame();
+        renderNsecs += elapsed();
+      }
+      time = qMin(time + step, pTimeManager->getEndTime());
+    }
+    addResult(benchmarkCase, size, "updateScene/frame", nsecs / frames);
+    if (pViewer.valid()) {
+      addResult(benchmarkCase, size, "render/frame", renderNsecs / frames);
+    }
+  } catch (std::string &exception) {
+    fprintf(stderr, "%s\n", exception.c_str());
+  }
+  restartTimer();
+}
@@ -0,0 +1,180 @@
+/*
+ * This file is part of OpenModelica.
+ *
+ * Copyright (c) 1998-CurrentYear, Open Source Modelica Consortium (OSMC),
+ * c/o Linköpings universitet, Department of Computer and Information Science,
+ * SE-58183 Linköping, Sweden.
+ *
+ * All rights reserved.
+ *
+ * THIS PROGRAM IS PROVIDED UNDER THE TERMS OF GPL VERSION 3 LICENSE OR
+ * THIS OSMC PUBLIC LICENSE (OSMC-PL) VERSION 1.2.
+ * ANY USE, REPRODUCTION OR DISTRIBUTION OF THIS PROGRAM CONSTITUTES
+ * RECIPIENT'S ACCEPTANCE OF THE OSMC PUBLIC LICENSE OR THE GPL VERSION 3,
+ * ACCORDING TO RECIPIENTS CHOICE.
+ *
+ * The OpenModelica software and the Open Source Modelica
+ * Consortium (OSMC) Public License (OSMC-PL) are obtained
+ * from OSMC, either from the above address,
+ * from the URLs: http://www.ida.liu.se/projects/OpenModelica or
+ * http://www.openmodelica.org, and in the OpenModelica distribution.
+ * GNU version 3 is obtained from: http://www.gnu.org/copyleft/gpl.html.
+ *
+ * This program is distributed WITHOUT ANY WARRANTY; without
+ * even the implied warranty of  MERCHANTABILITY or FITNESS
+ * FOR A PARTICULAR PURPOSE, EXCEPT AS EXPRESSLY SET FORTH
+ * IN THE BY RECIPIENT SELECTED SUBSIDIARY LICENSE CONDITIONS OF OSMC-PL.
+ *
+ * See the full OSMC Public License conditions for more details.
+ *
+ */
+
+#include "Benchmark/Benchmark.h"
+#include "Benchmark/DiagramBenchmark.h"
+#include "Benchmark/HighlighterBenchmark.h"
+#include "Benchmark/EditorBenchmark.h"
+#if !defined(WITHOUT_OSG)
+#include "Benchmark/TransformBenchmark.h"
+#include "Benchmark/AnimationBenchmark.h"
+#endif
+
+#include <QCoreApplication>
+#include <QFile>
+#include <QTextStream>
+#include <stdio.h>
+
+/*!
+ * \class Benchmark
+ * \brief Base class for the headless benchmarks started with the --Benchmark command line argument.
+ * Each benchmark runs a number of stages for each requested size and records the elapsed time of every stage.
+ * The results are written as CSV either to the output file or to stdout.
+ */
+/*!
+ * \brief Benchmark::Benchmark
+ * \param name
+ * \param sizes
+ * \param outputFileName
+ * \param pParent
+ */
+Benchmark::Benchmark(const QString &name, const QList<int> &sizes, const QString &outputFileName, QObject *pParent)
+  : QObject(pParent)
+{
+  mName = name;
+  mSizes = sizes;
+  mOutputFileName = outputFileName;
+  mResults << "benchmark,case,size,stage,milliseconds";
+}
+
+/*!
+ * \brief Benchmark::create
+ * Creates the benchmark with the given name.
+ * \param name
+ * \param sizes
+ * \param outputFileName
+ * \param pParent
+ * \return the benchmark or 0 if the name is unknown.
+ */
+Benchmark* Benchmark::create(const QString &name, const QList<int> &sizes, const QString &outputFileName, QObject *pParent)
+{
+  if (name.compare("diagram") == 0) {
+    return new DiagramBenchmark(sizes.isEmpty() ? QList<int>() << 50 << 200 << 1000 : sizes, outputFileName, pParent);
+  }
+  if (name.compare("highlighter") == 0) {
+    return new HighlighterBenchmark(sizes.isEmpty() ? QList<int>() << 10000 << 40000 : sizes, outputFileName, pParent);
+  }
+  if (name.compare("editor") == 0) {
+    return new EditorBenchmark(sizes.isEmpty() ? QList<int>() << 10000 << 40000 : sizes, outputFileName, pParent);
+  }
+#if !defined(WITHOUT_OSG)
+  if (name.compare("transforms") == 0) {
+    return new TransformBenchmark(sizes.isEmpty() ? QList<int>() << 10000 : sizes, outputFileName, pParent);
+  }
+  if (name.compare("animation") == 0) {
+    return new AnimationBenchmark(sizes.isEmpty() ? QList<int>() << 100 << 1000 : sizes, outputFileName, pParent);
+  }
+#endif
+  return 0;
+}
+
+/*!
+ * \brief Benchmark::addResult
+ * Records the time of a benchmark stage.
+ * \param benchmarkCase
+ * \param size
+ * \param stage
+ * \param nsecs
+ */
+void Benchmark::addResult(const QString &benchmarkCase, int size, const QString &stage, qint64 nsecs)
+{
+  mResults << QString("%1,%2,%3,%4,%5").arg(mName).arg(benchmarkCase).arg(size).arg(stage).arg(nsecs / 1.0e6, 0, 'f', 3);
+}
+
+/*!
+ * \brief Benchmark::addTimedResult
+ * Records the time elapsed since the last call to restartTimer() and restarts the timer.
+ * \param benchmarkCase
+ * \param size
+ * \param stage
+ */
+void Benchmark::addTimedResult(const QString &benchmarkCase, int size, const QString &stage)
+{
+  addResult(benchmarkCase, size, stage, elapsed());
+  restartTimer();
+}
+
+/*!
+ * \brief Benchmark::processEvents
+ * Processes the pending events including the deferred deletes so that queued work is not attributed to the next stage.
+ */
+void Benchmark::processEvents()
+{
+  QCoreApplication::sendPostedEvents(0, QEvent::DeferredDelete);
+  QCoreApplication::processEvents();
+}
+
+/*!
+ * \brief Benchmark::writeFile
+ * Writes the contents to the file.
+ * \param fileName
+ * \param contents
+ * \return
+ */
+bool Benchmark::writeFile(const QString &fileName, const QString &contents)
+{
+  QFile file(fileName);
+  if (!file.open(QIODevice::WriteOnly | QIODevice::Truncate)) {
+    fprintf(stderr, "Unable to write the benchmark file %s.\n", fileName.toStdString().c_str());
+    return false;
+  }
+  QTextStream textStream(&file);
+  textStream << contents;
+  file.close();
+  return true;
+}
+
+/*!
+ * \brief Benchmark::writeResults
+ * Writes the results to the output file or to stdout if no output file is given.
+ * \return
+ */
+bool Benchmark::writeResults()
+{
+  QString results = mResults.join("\n") + "\n";
+  if (mOutputFileName.isEmpty()) {
+    fprintf(stdout, "%s", results.toStdString().c_str());
+    fflush(stdout);
+    return true;
+  }
+  return writeFile(mOutputFileName, results);
+}
+
+/*!
+ * \brief Benchmark::run
+ * Slot activated when the event loop is started. Runs the benchmark, writes the results and exits the application.
+ */
+void Benchmark::run()
+{
+  processEvents();
+  runBenchmark();
+  QCoreApplication::exit(writeResults() ? 0 : 1);
+}
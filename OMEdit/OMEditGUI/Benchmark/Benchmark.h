@@ -0,0 +1,68 @@
+/*
+ * This file is part of OpenModelica.
+ *
+ * Copyright (c) 1998-CurrentYear, Open Source Modelica Consortium (OSMC),
+ * c/o Linköpings universitet, Department of Computer and Information Science,
+ * SE-58183 Linköping, Sweden.
+ *
+ * All rights reserved.
+ *
+ * THIS PROGRAM IS PROVIDED UNDER THE TERMS OF GPL VERSION 3 LICENSE OR
+ * THIS OSMC PUBLIC LICENSE (OSMC-PL) VERSION 1.2.
+ * ANY USE, REPRODUCTION OR DISTRIBUTION OF THIS PROGRAM CONSTITUTES
+ * RECIPIENT'S ACCEPTANCE OF THE OSMC PUBLIC LICENSE OR THE GPL VERSION 3,
+ * ACCORDING TO RECIPIENTS CHOICE.
+ *
+ * The OpenModelica software and the Open Source Modelica
+ * Consortium (OSMC) Public License (OSMC-PL) are obtained
+ * from OSMC, either from the above address,
+ * from the URLs: http://www.ida.liu.se/projects/OpenModelica or
+ * http://www.openmodelica.org, and in the OpenModelica distribution.
+ * GNU version 3 is obtained from: http://www.gnu.org/copyleft/gpl.html.
+ *
+ * This program is distributed WITHOUT ANY WARRANTY; without
+ * even the implied warranty of  MERCHANTABILITY or FITNESS
+ * FOR A PARTICULAR PURPOSE, EXCEPT AS EXPRESSLY SET FORTH
+ * IN THE BY RECIPIENT SELECTED SUBSIDIARY LICENSE CONDITIONS OF OSMC-PL.
+ *
+ * See the full OSMC Public License conditions for more details.
+ *
+ */
+
+#ifndef BENCHMARK_H
+#define BENCHMARK_H
+
+#include <QObject>
+#include <QElapsedTimer>
+#include <QStringList>
+#include <QList>
+
+class Benchmark : public QObject
+{
+  Q_OBJECT
+public:
+  Benchmark(const QString &name, const QList<int> &sizes, const QString &outputFileName, QObject *pParent = 0);
+  static Benchmark* create(const QString &name, const QList<int> &sizes, const QString &outputFileName, QObject *pParent = 0);
+  QString getName() const {return mName;}
+protected:
+  QList<int> mSizes;
+
+  virtual void runBenchmark() = 0;
+  void restartTimer() {mElapsedTimer.restart();}
+  qint64 elapsed() {return mElapsedTimer.nsecsElapsed();}
+  void addResult(const QString &benchmarkCase, int size, const QString &stage, qint64 nsecs);
+  void addTimedResult(const QString &benchmarkCase, int size, const QString &stage);
+  void processEvents();
+  bool writeFile(const QString &fileName, const QString &contents);
+private:
+  QString mName;
+  QString mOutputFileName;
+  QElapsedTimer mElapsedTimer;
+  QStringList mResults;
+
+  bool writeResults();
+public slots:
+  void run();
+};
+
+#endif // BENCHMARK_H
@@ -0,0 +1,288 @@
+/*
+ * This file is part of OpenModelica.
+ *
+ * Copyright (c) 1998-CurrentYear, Open Source Modelica Consortium (OSMC),
+ * c/o Linköpings universitet, Department of Computer and Information Science,
+ * SE-58183 Linköping, Sweden.
+ *
+ * All rights reserved.
+ *
+ * THIS PROGRAM IS PROVIDED UNDER THE TERMS OF GPL VERSION 3 LICENSE OR
+ * THIS OSMC PUBLIC LICENSE (OSMC-PL) VERSION 1.2.
+ * ANY USE, REPRODUCTION OR DISTRIBUTION OF THIS PROGRAM CONSTITUTES
+ * RECIPIENT'S ACCEPTANCE OF THE OSMC PUBLIC LICENSE OR THE GPL VERSION 3,
+ * ACCORDING TO RECIPIENTS CHOICE.
+ *
+ * The OpenModelica software and the Open Source Modelica
+ * Consortium (OSMC) Public License (OSMC-PL) are obtained
+ * from OSMC, either from the above address,
+ * from the URLs: http://www.ida.liu.se/projects/OpenModelica or
+ * http://www.openmodelica.org, and in the OpenModelica distribution.
+ * GNU version 3 is obtained from: http://www.gnu.org/copyleft/gpl.html.
+ *
+ * This program is distributed WITHOUT ANY WARRANTY; without
+ * even the implied warranty of  MERCHANTABILITY or FITNESS
+ * FOR A PARTICULAR PURPOSE, EXCEPT AS EXPRESSLY SET FORTH
+ * IN THE BY RECIPIENT SELECTED SUBSIDIARY LICENSE CONDITIONS OF OSMC-PL.
+ *
+ * See the full OSMC Public License conditions for more details.
+ *
+ */
+
+#include "Benchmark/DiagramBenchmark.h"
+#include "MainWindow.h"
+#include "Modeling/LibraryTreeWidget.h"
+#include "Modeling/ModelWidgetContainer.h"
+#include "Util/Utilities.h"
+#include "Util/Helper.h"
+
+#include <QKeyEvent>
+#include <qmath.h>
+#include <stdio.h>
+
+/*!
+ * \class DiagramBenchmark
+ * \brief Measures loading and editing of large diagrams.
+ * For each size N it generates a package with a flat model of N components and N-1 connections
+ * and a model with a deep inheritance chain where every level adds components, connections and heavy icon and diagram annotations.
+ * The stages ModelWidget construction, loadComponents, loadDiagramView, drawModelDiagramComponents, loadConnections,
+ * show, repaint, select all, move, undo and unload are timed separately.
+ */
+/*!
+ * \brief DiagramBenchmark::DiagramBenchmark
+ * \param sizes
+ * \param outputFileName
+ * \param pParent
+ */
+DiagramBenchmark::DiagramBenchmark(const QList<int> &sizes, const QString &outputFileName, QObject *pParent)
+  : Benchmark("diagram", sizes, outputFileName, pParent)
+{
+
+}
+
+/*!
+ * \brief DiagramBenchmark::runBenchmark
+ * Generates, loads and benchmarks the models for each size.
+ */
+void DiagramBenchmark::runBenchmark()
+{
+  MainWindow *pMainWindow = MainWindow::instance();
+  LibraryTreeModel *pLibraryTreeModel = pMainWindow->getLibraryWidget()->getLibraryTreeModel();
+  foreach (int size, mSizes) {
+    QString packageName = QString("DiagramBenchmark%1").arg(size);
+    QString fileName = QString("%1%2.mo").arg(Utilities::tempDirectory()).arg(packageName);
+    if (!writeFile(fileName, generatePackage(packageName, size))) {
+      continue;
+    }
+    restartTimer();
+    pMainWindow->getLibraryWidget()->openFile(fileName, Helper::utf8, false);
+    addTimedResult("package", size, "openFile");
+    LibraryTreeItem *pPackageLibraryTreeItem = pLibraryTreeModel->findLibraryTreeItemOneLevel(packageName);
+    if (!pPackageLibraryTreeItem) {
+      fprintf(stderr, "Unable to load the benchmark package %s.\n", packageName.toStdString().c_str());
+      continue;
+    }
+    benchmarkModel(pLibraryTreeModel->findLibraryTreeItem(packageName + ".Flat"), "flat", size);
+    benchmarkModel(pLibraryTreeModel->findLibraryTreeItem(packageName + ".Deep"), "inheritance", size);
+    processEvents();
+    restartTimer();
+    pMainWindow->getLibraryWidget()->getLibraryTreeModel()->unloadClass(pPackageLibraryTreeItem, false);
+    processEvents();
+    addTimedResult("package", size, "unload");
+  }
+}
+
+/*!
+ * \brief DiagramBenchmark::generatePackage
+ * Generates the Modelica code of the benchmark package.
+ * \param packageName
+ * \param size - the number of components in each model.
+ * \return
+ */
+QString DiagramBenchmark::generatePackage(const QString &packageName, int size)
+{
+  const int depth = 10;
+  int columns = qMax(1, qCeil(qSqrt(size)));
+  int extent = columns * 20 + 20;
+  QString coordinateSystem = QString("coordinateSystem(extent={{%1,%1},{%2,%2}})").arg(-extent).arg(extent);
+  QString code;
+  code.append(QString("package %1\n").arg(packageName));
+  code.append("  connector Pin\n"
+              "    Real v;\n"
+              "    flow Real i;\n"
+              "    annotation(Icon(graphics={Rectangle(extent={{-100,100},{100,-100}}, lineColor={0,0,255}, "
+              "fillColor={0,0,255}, fillPattern=FillPattern.Solid)}));\n"
+              "  end Pin;\n");
+  code.append("  model Block\n"
+              "    Pin p annotation(Placement(transformation(extent={{-110,-10},{-90,10}})));\n"
+              "    Pin n annotation(Placement(transformation(extent={{90,-10},{110,10}})));\n"
+              "  equation\n"
+              "    p.i + n.i = 0;\n"
+              "    p.v - n.v = p.i;\n"
+              "    annotation(Icon(graphics={Rectangle(extent={{-100,40},{100,-40}}, lineColor={0,0,0}, fillColor={255,255,255}, "
+              "fillPattern=FillPattern.Solid), Line(points={{-90,0},{90,0}}, color={0,0,255}), "
+              "Text(extent={{-100,90},{100,50}}, textString=\"%name\")}));\n"
+              "  end Block;\n");
+  // flat model
+  code.append("  model Flat\n");
+  code.append(generateComponents("b", 0, size, columns));
+  code.append("  equation\n");
+  code.append(generateConnections("b", 0, size, columns));
+  code.append(QString("    annotation(Diagram(%1));\n").arg(coordinateSystem));
+  code.append("  end Flat;\n");
+  // deep inheritance chain with heavy annotations
+  int count = qMax(1, size / (depth + 1));
+  for (int level = 1 ; level <= depth + 1 ; level++) {
+    QString className = level > depth ? "Deep" : QString("Base%1").arg(level);
+    code.append(QString("  model %1\n").arg(className));
+    if (level > 1) {
+      code.append(QString("    extends Base%1;\n").arg(level - 1));
+    }
+    code.append(generateComponents(QString("l%1b").arg(level), (level - 1) * count, count, columns));
+    code.append("  equation\n");
+    code.append(generateConnections(QString("l%1b").arg(level), (level - 1) * count, count, columns));
+    QString graphics = generateHeavyAnnotation(20);
+    code.append(QString("    annotation(Icon(%1, graphics={%2}), Diagram(%1, graphics={%2}));\n").arg(coordinateSystem).arg(graphics));
+    code.append(QString("  end %1;\n").arg(className));
+  }
+  code.append(QString("end %1;\n").arg(packageName));
+  return code;
+}
+
+/*!
+ * \brief DiagramBenchmark::generateComponents
+ * Generates the component declarations placed on a grid.
+ * \param prefix - the component name prefix.
+ * \param first - the grid index of the first component.
+ * \param count
+ * \param columns - the number of grid columns.
+ * \return
+ */
+QString DiagramBenchmark::generateComponents(const QString &prefix, int first, int count, int columns)
+{
+  QString code;
+  for (int i = 0 ; i < count ; i++) {
+    int index = first + i;
+    int x = (index % columns) * 40 - columns * 20;
+    int y = columns * 20 - (index / columns) * 40;
+    code.append(QString("    Block %1%2 annotation(Placement(transformation(extent={{%3,%4},{%5,%6}})));\n")
+                .arg(prefix).arg(i).arg(x - 10).arg(y - 10).arg(x + 10).arg(y + 10));
+  }
+  return code;
+}
+
+/*!
+ * \brief DiagramBenchmark::generateConnections
+ * Generates connect equations chaining the components generated by DiagramBenchmark::generateComponents().
+ * \param prefix - the component name prefix.
+ * \param first - the grid index of the first component.
+ * \param count
+ * \param columns - the number of grid columns.
+ * \return
+ */
+QString DiagramBenchmark::generateConnections(const QString &prefix, int first, int count, int columns)
+{
+  QString code;
+  for (int i = 0 ; i < count - 1 ; i++) {
+    int index = first + i;
+    int x1 = (index % columns) * 40 - columns * 20 + 10;
+    int y1 = columns * 20 - (index / columns) * 40;
+    int x2 = ((index + 1) % columns) * 40 - columns * 20 - 10;
+    int y2 = columns * 20 - ((index + 1) / columns) * 40;
+    int xm = (x1 + x2) / 2;
+    code.append(QString("    connect(%1%2.n, %1%3.p) annotation(Line(points={{%4,%5},{%6,%5},{%6,%7},{%8,%7}}, color={0,0,255}));\n")
+                .arg(prefix).arg(i).arg(i + 1).arg(x1).arg(y1).arg(xm).arg(y2).arg(x2));
+  }
+  return code;
+}
+
+/*!
+ * \brief DiagramBenchmark::generateHeavyAnnotation
+ * Generates a graphics annotation with the given number of shapes.
+ * \param shapes
+ * \return
+ */
+QString DiagramBenchmark::generateHeavyAnnotation(int shapes)
+{
+  QStringList graphics;
+  for (int i = 0 ; i < shapes ; i++) {
+    int offset = (i * 9) % 80;
+    switch (i % 5) {
+      case 0:
+        graphics << QString("Rectangle(extent={{%1,%1},{%2,%2}}, lineColor={0,0,0}, fillColor={%3,200,200}, "
+                            "fillPattern=FillPattern.HorizontalCylinder, radius=5)").arg(-100 + offset).arg(100 - offset).arg(offset * 3);
+        break;
+      case 1:
+        graphics << QString("Ellipse(extent={{%1,%1},{%2,%2}}, lineColor={0,0,255}, fillColor={200,%3,200}, "
+                            "fillPattern=FillPattern.Sphere)").arg(-90 + offset).arg(90 - offset).arg(offset * 3);
+        break;
+      case 2:
+        graphics << QString("Polygon(points={{%1,0},{0,%2},{%2,0},{0,%1},{%1,0}}, lineColor={255,0,0}, "
+                            "fillColor={255,255,0}, fillPattern=FillPattern.Solid, smooth=Smooth.Bezier)").arg(-80 + offset).arg(80 - offset);
+        break;
+      case 3:
+        graphics << QString("Line(points={{%1,%1},{0,%2},{%2,%1}}, color={0,127,0}, thickness=0.5, "
+                            "arrow={Arrow.None,Arrow.Filled})").arg(-100 + offset).arg(100 - offset);
+        break;
+      default:
+        graphics << QString("Text(extent={{-100,%1},{100,%2}}, textString=\"%name %3\", lineColor={0,0,0})").arg(-offset).arg(-offset - 10).arg(i);
+        break;
+    }
+  }
+  return graphics.join(", ");
+}
+
+/*!
+ * \brief DiagramBenchmark::benchmarkModel
+ * Loads the model in a ModelWidget and times the loading and editing stages.
+ * \param pLibraryTreeItem
+ * \param benchmarkCase
+ * \param size
+ */
+void DiagramBenchmark::benchmarkModel(LibraryTreeItem *pLibraryTreeItem, const QString &benchmarkCase, int size)
+{
+  if (!pLibraryTreeItem) {
+    fprintf(stderr, "Unable to find the benchmark model for the case %s.\n", benchmarkCase.toStdString().c_str());
+    return;
+  }
+  MainWindow *pMainWindow = MainWindow::instance();
+  processEvents();
+  restartTimer();
+  ModelWidget *pModelWidget = new ModelWidget(pLibraryTreeItem, pMainWindow->getModelWidgetContainer());
+  pLibraryTreeItem->setModelWidget(pModelWidget);
+  addTimedResult(benchmarkCase, size, "construct");
+  pModelWidget->loadComponents();
+  addTimedResult(benchmarkCase, size, "loadComponents");
+  pModelWidget->loadDiagramView();
+  addTimedResult(benchmarkCase, size, "loadDiagramView");
+  // redraw the diagram components to time drawModelDiagramComponents on its own.
+  pModelWidget->removeClassComponents(StringHandler::Diagram);
+  processEvents();
+  restartTimer();
+  pModelWidget->drawModelDiagramComponents();
+  addTimedResult(benchmarkCase, size, "drawModelDiagramComponents");
+  pModelWidget->loadConnections();
+  addTimedResult(benchmarkCase, size, "loadConnections");
+  pModelWidget->setWindowTitle(pLibraryTreeItem->getName());
+  pMainWindow->getModelWidgetContainer()->addModelWidget(pModelWidget, false, StringHandler::Diagram);
+  processEvents();
+  addTimedResult(benchmarkCase, size, "show");
+  GraphicsView *pGraphicsView = pModelWidget->getDiagramGraphicsView();
+  pGraphicsView->viewport()->repaint();
+  addTimedResult(benchmarkCase, size, "repaint");
+  pGraphicsView->selectAll();
+  processEvents();
+  addTimedResult(benchmarkCase, size, "selectAll");
+  QKeyEvent keyPressEvent(QEvent::KeyPress, Qt::Key_Right, Qt::NoModifier);
+  QCoreApplication::sendEvent(pGraphicsView, &keyPressEvent);
+  QKeyEvent keyReleaseEvent(QEvent::KeyRelease, Qt::Key_Right, Qt::NoModifier);
+  QCoreApplication::sendEvent(pGraphicsView, &keyReleaseEvent);
+  processEvents();
+  addTimedResult(benchmarkCase, size, "move");
+  pModelWidget->getUndoStack()->undo();
+  processEvents();
+  addTimedResult(benchmarkCase, size, "undo");
+  pGraphicsView->clearSelection();
+  pGraphicsView->viewport()->repaint();
+  addTimedResult(benchmarkCase, size, "repaintAfterUndo");
+}
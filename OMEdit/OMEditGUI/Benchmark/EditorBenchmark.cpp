@@ -0,0 +1,274 @@
+/*
+ * This file is part of OpenModelica.
+ *
+ * Copyright (c) 1998-CurrentYear, Open Source Modelica Consortium (OSMC),
+ * c/o Linköpings universitet, Department of Computer and Information Science,
+ * SE-58183 Linköping, Sweden.
+ *
+ * All rights reserved.
+ *
+ * THIS PROGRAM IS PROVIDED UNDER THE TERMS OF GPL VERSION 3 LICENSE OR
+ * THIS OSMC PUBLIC LICENSE (OSMC-PL) VERSION 1.2.
+ * ANY USE, REPRODUCTION OR DISTRIBUTION OF THIS PROGRAM CONSTITUTES
+ * RECIPIENT'S ACCEPTANCE OF THE OSMC PUBLIC LICENSE OR THE GPL VERSION 3,
+ * ACCORDING TO RECIPIENTS CHOICE.
+ *
+ * The OpenModelica software and the Open Source Modelica
+ * Consortium (OSMC) Public License (OSMC-PL) are obtained
+ * from OSMC, either from the above address,
+ * from the URLs: http://www.ida.liu.se/projects/OpenModelica or
+ * http://www.openmodelica.org, and in the OpenModelica distribution.
+ * GNU version 3 is obtained from: http://www.gnu.org/copyleft/gpl.html.
+ *
+ * This program is distributed WITHOUT ANY WARRANTY; without
+ * even the implied warranty of  MERCHANTABILITY or FITNESS
+ * FOR A PARTICULAR PURPOSE, EXCEPT AS EXPRESSLY SET FORTH
+ * IN THE BY RECIPIENT SELECTED SUBSIDIARY LICENSE CONDITIONS OF OSMC-PL.
+ *
+ * See the full OSMC Public License conditions for more details.
+ *
+ */
+
+#include "Benchmark/EditorBenchmark.h"
+#include "Benchmark/HighlighterBenchmark.h"
+#include "MainWindow.h"
+#include "Modeling/LibraryTreeWidget.h"
+#include "Modeling/ModelWidgetContainer.h"
+#include "Editors/BaseEditor.h"
+#include "Util/Utilities.h"
+#include "Util/Helper.h"
+
+#include <QAbstractItemView>
+#include <QCompleter>
+#include <QFileInfo>
+#include <QKeyEvent>
+#include <QScrollBar>
+#include <QSyntaxHighlighter>
+#include <stdio.h>
+
+/*!
+ * \class EditorBenchmark
+ * \brief Measures the text editors with generated Modelica, C and MetaModelica files.
+ * For each size N, i.e., the number of lines, the files are opened in ModelicaEditor, CEditor and MetaModelicaEditor and
+ * the stages load, show, rehighlight, foldAll, scrolling page by page with and without the folding, typing, the completion popup,
+ * replaceAll and unload are timed separately.
+ */
+/*!
+ * \brief EditorBenchmark::EditorBenchmark
+ * \param sizes The number of lines of the generated files.
+ * \param outputFileName
+ * \param pParent
+ */
+EditorBenchmark::EditorBenchmark(const QList<int> &sizes, const QString &outputFileName, QObject *pParent)
+  : Benchmark("editor", sizes, outputFileName, pParent)
+{
+
+}
+
+/*!
+ * \brief EditorBenchmark::runBenchmark
+ * Generates, opens and benchmarks the files for each size.
+ */
+void EditorBenchmark::runBenchmark()
+{
+  LibraryWidget *pLibraryWidget = MainWindow::instance()->getLibraryWidget();
+  LibraryTreeModel *pLibraryTreeModel = pLibraryWidget->getLibraryTreeModel();
+  foreach (int size, mSizes) {
+    // Modelica package loaded in OMC
+    QString fileName = QString("%1EditorBenchmark%2.mo").arg(Utilities::tempDirectory()).arg(size);
+    if (writeFile(fileName, HighlighterBenchmark::generateModelicaText(size))) {
+      restartTimer();
+      pLibraryWidget->openFile(fileName, Helper::utf8, false);
+      addTimedResult("modelica", size, "openFile");
+      LibraryTreeItem *pLibraryTreeItem = pLibraryTreeModel->findLibraryTreeItemOneLevel("HighlighterBenchmark");
+      benchmarkEditor(pLibraryTreeItem, "modelica", size, "    Real y = 2 * x;\n", "sin(x)", "cos(x)");
+      if (pLibraryTreeItem) {
+        processEvents();
+        restartTimer();
+        pLibraryTreeModel->unloadClass(pLibraryTreeItem, false);
+        processEvents();
+        addTimedResult("modelica", size, "unload");
+      }
+    }
+    // C file
+    fileName = QString("%1EditorBenchmark%2.c").arg(Utilities::tempDirectory()).arg(size);
+    if (writeFile(fileName, generateCText(size))) {
+      restartTimer();
+      pLibraryWidget->openFile(fileName, Helper::utf8, false);
+      addTimedResult("c", size, "openFile");
+      LibraryTreeItem *pLibraryTreeItem = pLibraryTreeModel->findLibraryTreeItemOneLevel(QFileInfo(fileName).fileName());
+      benchmarkEditor(pLibraryTreeItem, "c", size, "  counter += size;\n", "counter", "total");
+      if (pLibraryTreeItem) {
+        processEvents();
+        restartTimer();
+        pLibraryTreeModel->unloadCompositeModelOrTextFile(pLibraryTreeItem, false);
+        processEvents();
+        addTimedResult("c", size, "unload");
+      }
+    }
+    // MetaModelica file loaded as a text file
+    fileName = QString("%1EditorBenchmarkMetaModelica%2.mo").arg(Utilities::tempDirectory()).arg(size);
+    if (writeFile(fileName, HighlighterBenchmark::generateMetaModelicaText(size))) {
+      restartTimer();
+      pLibraryWidget->openFile(fileName, Helper::utf8, false, false, true);
+      addTimedResult("metamodelica", size, "openFile");
+      LibraryTreeItem *pLibraryTreeItem = pLibraryTreeModel->findLibraryTreeItemOneLevel(QFileInfo(fileName).fileName());
+      benchmarkEditor(pLibraryTreeItem, "metamodelica", size, "  outInteger := 0;\n", "inList", "inElements");
+      if (pLibraryTreeItem) {
+        processEvents();
+        restartTimer();
+        pLibraryTreeModel->unloadCompositeModelOrTextFile(pLibraryTreeItem, false);
+        processEvents();
+        addTimedResult("metamodelica", size, "unload");
+      }
+    }
+  }
+}
+
+/*!
+ * \brief EditorBenchmark::generateCText
+ * Generates a C file with about the given number of lines.
+ * The functions mix declarations, comments, strings, numbers and nested blocks.
+ * \param lines
+ * \return
+ */
+QString EditorBenchmark::generateCText(int lines)
+{
+  QString text;
+  text.reserve(lines * 36);
+  text.append("#include <stdio.h>\n\n");
+  int line = 2, function = 0;
+  while (line < lines) {
+    text.append(QString("/* Function %1 computes the weighted sum. */\n").arg(function));
+    text.append(QString("static int f%1(int *values, int size)\n").arg(function));
+    text.append("{\n");
+    text.append("  int counter = 0; // the sum\n");
+    text.append("  for (int i = 0; i < size; ++i) {\n");
+    text.append(QString("    counter += values[i] * %1;\n").arg(function));
+    text.append("  }\n");
+    text.append("  if (counter > 100) {\n");
+    text.append("    printf(\"large \\\"%d\\\"\\n\", counter);\n");
+    text.append("  }\n");
+    text.append("  return counter;\n");
+    text.append("}\n\n");
+    line += 13;
+    function++;
+  }
+  return text;
+}
+
+/*!
+ * \brief EditorBenchmark::benchmarkEditor
+ * Opens the text of the item in its editor and times the loading and editing stages.
+ * \param pLibraryTreeItem
+ * \param benchmarkCase
+ * \param size
+ * \param typedText - the text typed in the middle of the file.
+ * \param textToFind - the text replaced with replaceWithText in all of the file.
+ * \param replaceWithText
+ */
+void EditorBenchmark::benchmarkEditor(LibraryTreeItem *pLibraryTreeItem, const QString &benchmarkCase, int size, const QString &typedText,
+                                      const QString &textToFind, const QString &replaceWithText)
+{
+  if (!pLibraryTreeItem) {
+    fprintf(stderr, "Unable to load the benchmark file for the case %s.\n", benchmarkCase.toStdString().c_str());
+    return;
+  }
+  MainWindow *pMainWindow = MainWindow::instance();
+  processEvents();
+  restartTimer();
+  ModelWidget *pModelWidget = new ModelWidget(pLibraryTreeItem, pMainWindow->getModelWidgetContainer());
+  pLibraryTreeItem->setModelWidget(pModelWidget);
+  addTimedResult(benchmarkCase, size, "load");
+  pModelWidget->setWindowTitle(pLibraryTreeItem->getName());
+  pMainWindow->getModelWidgetContainer()->addModelWidget(pModelWidget, false, StringHandler::ModelicaText);
+  processEvents();
+  addTimedResult(benchmarkCase, size, "show");
+  BaseEditor *pEditor = pModelWidget->getEditor();
+  PlainTextEdit *pPlainTextEdit = pEditor->getPlainTextEdit();
+  // the highlighters are children of the document
+  if (QSyntaxHighlighter *pSyntaxHighlighter = pPlainTextEdit->document()->findChild<QSyntaxHighlighter*>()) {
+    restartTimer();
+    pSyntaxHighlighter->rehighlight();
+    addTimedResult(benchmarkCase, size, "rehighlight");
+  }
+  restartTimer();
+  pPlainTextEdit->foldAll();
+  processEvents();
+  addTimedResult(benchmarkCase, size, "foldAll");
+  scroll(pPlainTextEdit);
+  addTimedResult(benchmarkCase, size, "scrollFolded");
+  pPlainTextEdit->unFoldAll();
+  processEvents();
+  addTimedResult(benchmarkCase, size, "unFoldAll");
+  scroll(pPlainTextEdit);
+  addTimedResult(benchmarkCase, size, "scroll");
+  // type in the middle of the text
+  QTextCursor cursor(pPlainTextEdit->document()->findBlockByNumber(pPlainTextEdit->document()->blockCount() / 2));
+  pPlainTextEdit->setTextCursor(cursor);
+  processEvents();
+  restartTimer();
+  for (int i = 0; i < TypingBursts; ++i) {
+    type(pPlainTextEdit, typedText);
+    processEvents();
+  }
+  addTimedResult(benchmarkCase, size, "typing");
+  // complete the first two characters of the typed text
+  pPlainTextEdit->insertPlainText(typedText.trimmed().left(2));
+  processEvents();
+  restartTimer();
+  for (int i = 0; i < Completions; ++i) {
+    pEditor->popUpCompleter();
+    processEvents();
+  }
+  addResult(benchmarkCase, size, "popUpCompleter", elapsed() / Completions);
+  pPlainTextEdit->completer()->popup()->hide();
+  pPlainTextEdit->undo();
+  FindReplaceWidget *pFindReplaceWidget = pEditor->getFindReplaceWidget();
+  pFindReplaceWidget->setTextToFind(textToFind);
+  pFindReplaceWidget->setReplaceWithText(replaceWithText);
+  processEvents();
+  restartTimer();
+  pFindReplaceWidget->replaceAll();
+  processEvents();
+  addTimedResult(benchmarkCase, size, "replaceAll");
+}
+
+/*!
+ * \brief EditorBenchmark::scroll
+ * Scrolls from the top to the bottom of the text page by page and paints every page.
+ * \param pPlainTextEdit
+ */
+void EditorBenchmark::scroll(PlainTextEdit *pPlainTextEdit)
+{
+  QScrollBar *pScrollBar = pPlainTextEdit->verticalScrollBar();
+  pScrollBar->setValue(pScrollBar->minimum());
+  processEvents();
+  restartTimer();
+  const int pageStep = qMax(1, pScrollBar->pageStep());
+  while (pScrollBar->value() < pScrollBar->maximum()) {
+    pScrollBar->setValue(pScrollBar->value() + pageStep);
+    pPlainTextEdit->viewport()->repaint();
+    pPlainTextEdit->getLineNumberArea()->repaint();
+  }
+}
+
+/*!
+ * \brief EditorBenchmark::type
+ * Sends the key press events of the text to the editor.
+ * \param pPlainTextEdit
+ * \param text
+ */
+void EditorBenchmark::type(PlainTextEdit *pPlainTextEdit, const QString &text)
+{
+  foreach (const QChar &character, text) {
+    if (character == QLatin1Char('\n')) {
+      QKeyEvent keyPressEvent(QEvent::KeyPress, Qt::Key_Return, Qt::NoModifier, QString("\r"));
+      QCoreApplication::sendEvent(pPlainTextEdit, &keyPressEvent);
+    } else {
+      // the Qt key codes of the printable ASCII characters are their upper case character codes
+      QKeyEvent keyPressEvent(QEvent::KeyPress, character.toUpper().unicode(), Qt::NoModifier, QString(character));
+      QCoreApplication::sendEvent(pPlainTextEdit, &keyPressEvent);
+    }
+  }
+}
@@ -0,0 +1,169 @@
+/*
+ * This file is part of OpenModelica.
+ *
+ * Copyright (c) 1998-CurrentYear, Open Source Modelica Consortium (OSMC),
+ * c/o Linköpings universitet, Department of Computer and Information Science,
+ * SE-58183 Linköping, Sweden.
+ *
+ * All rights reserved.
+ *
+ * THIS PROGRAM IS PROVIDED UNDER THE TERMS OF GPL VERSION 3 LICENSE OR
+ * THIS OSMC PUBLIC LICENSE (OSMC-PL) VERSION 1.2.
+ * ANY USE, REPRODUCTION OR DISTRIBUTION OF THIS PROGRAM CONSTITUTES
+ * RECIPIENT'S ACCEPTANCE OF THE OSMC PUBLIC LICENSE OR THE GPL VERSION 3,
+ * ACCORDING TO RECIPIENTS CHOICE.
+ *
+ * The OpenModelica software and the Open Source Modelica
+ * Consortium (OSMC) Public License (OSMC-PL) are obtained
+ * from OSMC, either from the above address,
+ * from the URLs: http://www.ida.liu.se/projects/OpenModelica or
+ * http://www.openmodelica.org, and in the OpenModelica distribution.
+ * GNU version 3 is obtained from: http://www.gnu.org/copyleft/gpl.html.
+ *
+ * This program is distributed WITHOUT ANY WARRANTY; without
+ * even the implied warranty of  MERCHANTABILITY or FITNESS
+ * FOR A PARTICULAR PURPOSE, EXCEPT AS EXPRESSLY SET FORTH
+ * IN THE BY RECIPIENT SELECTED SUBSIDIARY LICENSE CONDITIONS OF OSMC-PL.
+ *
+ * See the full OSMC Public License conditions for more details.
+ *
+ */
+
+#include "Benchmark/HighlighterBenchmark.h"
+#include "Editors/ModelicaEditor.h"
+#include "Editors/MetaModelicaEditor.h"
+#include "Options/OptionsDialog.h"
+
+#include <QPlainTextEdit>
+
+/*!
+ * \class HighlighterBenchmark
+ * \brief Benchmark of the Modelica and MetaModelica syntax highlighters.
+ * Highlights a large generated file end to end, once when the text is set and once more with a full rehighlight.
+ */
+/*!
+ * \brief HighlighterBenchmark::HighlighterBenchmark
+ * \param sizes The number of lines of the generated files.
+ * \param outputFileName
+ * \param pParent
+ */
+HighlighterBenchmark::HighlighterBenchmark(const QList<int> &sizes, const QString &outputFileName, QObject *pParent)
+  : Benchmark("highlighter", sizes, outputFileName, pParent)
+{
+}
+
+/*!
+ * \brief HighlighterBenchmark::runBenchmark
+ * Highlights the generated Modelica and MetaModelica files of each size.
+ */
+void HighlighterBenchmark::runBenchmark()
+{
+  OptionsDialog *pOptionsDialog = OptionsDialog::instance();
+  foreach (int size, mSizes) {
+    QPlainTextEdit *pPlainTextEdit = new QPlainTextEdit;
+    ModelicaHighlighter *pModelicaHighlighter = new ModelicaHighlighter(pOptionsDialog->getModelicaEditorPage(), pPlainTextEdit);
+    highlight("modelica", size, generateModelicaText(size), pPlainTextEdit, pModelicaHighlighter);
+    delete pPlainTextEdit;
+    processEvents();
+    pPlainTextEdit = new QPlainTextEdit;
+    MetaModelicaHighlighter *pMetaModelicaHighlighter = new MetaModelicaHighlighter(pOptionsDialog->getMetaModelicaEditorPage(), pPlainTextEdit);
+    highlight("metamodelica", size, generateMetaModelicaText(size), pPlainTextEdit, pMetaModelicaHighlighter);
+    delete pPlainTextEdit;
+    processEvents();
+  }
+}
+
+/*!
+ * \brief HighlighterBenchmark::generateModelicaText
+ * Generates a Modelica package with about the given number of lines.
+ * The models mix declarations, comments, strings, numbers, function calls and multi line annotations.
+ * \param lines
+ * \return
+ */
+QString HighlighterBenchmark::generateModelicaText(int lines)
+{
+  QString text;
+  text.reserve(lines * 48);
+  text.append("package HighlighterBenchmark \"Generated package\"\n");
+  int line = 1, model = 0;
+  while (line < lines) {
+    text.append(QString("  model M%1 \"Model %1\"\n").arg(model));
+    text.append("    /* A multi line comment\n");
+    text.append("       spanning two lines */\n");
+    text.append(QString("    parameter Real k = %1.5e-3 \"Gain\";\n").arg(model));
+    text.append("    Real x(start = 1.0, fixed = true); // state\n");
+    text.append("    Integer n = 42;\n");
+    text.append("    Boolean b = false;\n");
+    text.append("  equation\n");
+    text.append("    der(x) = -k * sin(x) + abs(n) * 2.0;\n");
+    text.append("    if b then\n");
+    text.append("      assert(x > 0, \"x must be \\\"positive\\\"\");\n");
+    text.append("    end if;\n");
+    text.append("    annotation(Icon(coordinateSystem(extent = {{-100, -100}, {100, 100}}),\n");
+    text.append("      graphics = {Rectangle(extent = {{-80, 60}, {80, -60}}, lineColor = {0, 0, 255})}),\n");
+    text.append("      Documentation(info = \"<html><p>Generated model.</p></html>\"));\n");
+    text.append(QString("  end M%1;\n").arg(model));
+    line += 16;
+    model++;
+  }
+  text.append("end HighlighterBenchmark;\n");
+  return text;
+}
+
+/*!
+ * \brief HighlighterBenchmark::generateMetaModelicaText
+ * Generates a MetaModelica package with about the given number of lines.
+ * The functions mix match expressions, uniontypes, comments, strings and numbers.
+ * \param lines
+ * \return
+ */
+QString HighlighterBenchmark::generateMetaModelicaText(int lines)
+{
+  QString text;
+  text.reserve(lines * 40);
+  text.append("encapsulated package HighlighterBenchmark \"Generated package\"\n");
+  int line = 1, function = 0;
+  while (line < lines) {
+    text.append(QString("uniontype U%1\n").arg(function));
+    text.append("  record R\n");
+    text.append("    Integer i; // the index\n");
+    text.append("  end R;\n");
+    text.append(QString("end U%1;\n").arg(function));
+    text.append(QString("function f%1 \"Function %1\"\n").arg(function));
+    text.append("  input list<Integer> inList;\n");
+    text.append("  output Integer outInteger;\n");
+    text.append("algorithm\n");
+    text.append("  /* match the list */\n");
+    text.append("  outInteger := match(inList)\n");
+    text.append("    case {} then 0;\n");
+    text.append(QString("    case _ :: _ then listLength(inList) + %1;\n").arg(function));
+    text.append("    else fail();\n");
+    text.append("  end match;\n");
+    text.append("  print(\"done \\\"now\\\"\\n\");\n");
+    text.append(QString("end f%1;\n").arg(function));
+    line += 17;
+    function++;
+  }
+  text.append("end HighlighterBenchmark;\n");
+  return text;
+}
+
+/*!
+ * \brief HighlighterBenchmark::highlight
+ * Times setting the text, which highlights every block, and a full rehighlight of the document.
+ * \param benchmarkCase
+ * \param size
+ * \param text
+ * \param pPlainTextEdit
+ * \param pSyntaxHighlighter
+ */
+void HighlighterBenchmark::highlight(const QString &benchmarkCase, int size, const QString &text, QPlainTextEdit *pPlainTextEdit,
+                                     QSyntaxHighlighter *pSyntaxHighlighter)
+{
+  restartTimer();
+  pPlainTextEdit->setPlainText(text);
+  processEvents();
+  addTimedResult(benchmarkCase, size, "setText");
+  pSyntaxHighlighter->rehighlight();
+  addTimedResult(benchmarkCase, size, "rehighlight");
+}
@@ -0,0 +1,54 @@
+/*
+ * This file is part of OpenModelica.
+ *
+ * Copyright (c) 1998-CurrentYear, Open Source Modelica Consortium (OSMC),
+ * c/o Linköpings universitet, Department of Computer and Information Science,
+ * SE-58183 Linköping, Sweden.
+ *
+ * All rights reserved.
+ *
+ * THIS PROGRAM IS PROVIDED UNDER THE TERMS OF GPL VERSION 3 LICENSE OR
+ * THIS OSMC PUBLIC LICENSE (OSMC-PL) VERSION 1.2.
+ * ANY USE, REPRODUCTION OR DISTRIBUTION OF THIS PROGRAM CONSTITUTES
+ * RECIPIENT'S ACCEPTANCE OF THE OSMC PUBLIC LICENSE OR THE GPL VERSION 3,
+ * ACCORDING TO RECIPIENTS CHOICE.
+ *
+ * The OpenModelica software and the Open Source Modelica
+ * Consortium (OSMC) Public License (OSMC-PL) are obtained
+ * from OSMC, either from the above address,
+ * from the URLs: http://www.ida.liu.se/projects/OpenModelica or
+ * http://www.openmodelica.org, and in the OpenModelica distribution.
+ * GNU version 3 is obtained from: http://www.gnu.org/copyleft/gpl.html.
+ *
+ * This program is distributed WITHOUT ANY WARRANTY; without
+ * even the implied warranty of  MERCHANTABILITY or FITNESS
+ * FOR A PARTICULAR PURPOSE, EXCEPT AS EXPRESSLY SET FORTH
+ * IN THE BY RECIPIENT SELECTED SUBSIDIARY LICENSE CONDITIONS OF OSMC-PL.
+ *
+ * See the full OSMC Public License conditions for more details.
+ *
+ */
+
+#ifndef HIGHLIGHTERBENCHMARK_H
+#define HIGHLIGHTERBENCHMARK_H
+
+#include "Benchmark/Benchmark.h"
+
+class QPlainTextEdit;
+class QSyntaxHighlighter;
+
+class HighlighterBenchmark : public Benchmark
+{
+  Q_OBJECT
+public:
+  HighlighterBenchmark(const QList<int> &sizes, const QString &outputFileName, QObject *pParent = 0);
+  static QString generateModelicaText(int lines);
+  static QString generateMetaModelicaText(int lines);
+protected:
+  virtual void runBenchmark();
+private:
+  void highlight(const QString &benchmarkCase, int size, const QString &text, QPlainTextEdit *pPlainTextEdit,
+                 QSyntaxHighlighter *pSyntaxHighlighter);
+};
+
+#endif // HIGHLIGHTERBENCHMARK_H
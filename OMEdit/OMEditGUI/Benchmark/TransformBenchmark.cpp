@@ -0,0 +1,158 @@
+/*
+ * This file is part of OpenModelica.
+ *
+ * Copyright (c) 1998-CurrentYear, Open Source Modelica Consortium (OSMC),
+ * c/o Linköpings universitet, Department of Computer and Information Science,
+ * SE-58183 Linköping, Sweden.
+ *
+ * All rights reserved.
+ *
+ * THIS PROGRAM IS PROVIDED UNDER THE TERMS OF GPL VERSION 3 LICENSE OR
+ * THIS OSMC PUBLIC LICENSE (OSMC-PL) VERSION 1.2.
+ * ANY USE, REPRODUCTION OR DISTRIBUTION OF THIS PROGRAM CONSTITUTES
+ * RECIPIENT'S ACCEPTANCE OF THE OSMC PUBLIC LICENSE OR THE GPL VERSION 3,
+ * ACCORDING TO RECIPIENTS CHOICE.
+ *
+ * The OpenModelica software and the Open Source Modelica
+ * Consortium (OSMC) Public License (OSMC-PL) are obtained
+ * from OSMC, either from the above address,
+ * from the URLs: http://www.ida.liu.se/projects/OpenModelica or
+ * http://www.openmodelica.org, and in the OpenModelica distribution.
+ * GNU version 3 is obtained from: http://www.gnu.org/copyleft/gpl.html.
+ *
+ * This program is distributed WITHOUT ANY WARRANTY; without
+ * even the implied warranty of  MERCHANTABILITY or FITNESS
+ * FOR A PARTICULAR PURPOSE, EXCEPT AS EXPRESSLY SET FORTH
+ * IN THE BY RECIPIENT SELECTED SUBSIDIARY LICENSE CONDITIONS OF OSMC-PL.
+ *
+ * See the full OSMC Public License conditions for more details.
+ *
+ */
+
+#include "Benchmark/TransformBenchmark.h"
+#include "Animation/Visualizer.h"
+#include "Animation/ShapeTransforms.h"
+
+#include <cmath>
+#include <stdio.h>
+
+/*!
+ * \class TransformBenchmark
+ * \brief Micro benchmark of the per frame transformation of the animation shapes.
+ * Compares rotateModelica2OSG and assemblePokeMatrix called per shape with the batch kernel of ShapeTransforms.
+ */
+/*!
+ * \brief TransformBenchmark::TransformBenchmark
+ * \param sizes The number of shapes.
+ * \param outputFileName
+ * \param pParent
+ */
+TransformBenchmark::TransformBenchmark(const QList<int> &sizes, const QString &outputFileName, QObject *pParent)
+  : Benchmark("transforms", sizes, outputFileName, pParent)
+{
+}
+
+/*!
+ * \brief TransformBenchmark::runBenchmark
+ * Transforms the shapes for a number of frames with both implementations and checks that they agree.
+ */
+void TransformBenchmark::runBenchmark()
+{
+  const int frames = 100;
+  foreach (int size, mSizes) {
+    std::vector<ShapeObject> shapes;
+    generateShapes(shapes, size);
+    std::vector<osg::Matrix> scalarMatrices(shapes.size());
+    std::vector<osg::Matrix> batchMatrices(shapes.size());
+    // per shape
+    restartTimer();
+    for (int frame = 0; frame < frames; ++frame) {
+      for (size_t i = 0; i < shapes.size(); ++i) {
+        ShapeObject &shape = shapes[i];
+        rAndT rT = rotateModelica2OSG(osg::Vec3f(shape._r[0].exp, shape._r[1].exp, shape._r[2].exp),
+                                      osg::Vec3f(shape._rShape[0].exp, shape._rShape[1].exp, shape._rShape[2].exp),
+                                      osg::Matrix3(shape._T[0].exp, shape._T[1].exp, shape._T[2].exp,
+                                                   shape._T[3].exp, shape._T[4].exp, shape._T[5].exp,
+                                                   shape._T[6].exp, shape._T[7].exp, shape._T[8].exp),
+                                      osg::Vec3f(shape._lDir[0].exp, shape._lDir[1].exp, shape._lDir[2].exp),
+                                      osg::Vec3f(shape._wDir[0].exp, shape._wDir[1].exp, shape._wDir[2].exp),
+                                      shape._length.exp, shape._type);
+        assemblePokeMatrix(scalarMatrices[i], rT._T, rT._r);
+      }
+    }
+    addTimedResult("scalar", size, "transform");
+    // batch
+    ShapeTransforms transforms;
+    transforms.resize(shapes.size());
+    for (size_t i = 0; i < shapes.size(); ++i) {
+      transforms.setType(i, shapes[i]._type);
+    }
+    qint64 gather = 0, kernel = 0, matrices = 0;
+    for (int frame = 0; frame < frames; ++frame) {
+      restartTimer();
+      for (size_t i = 0; i < shapes.size(); ++i) {
+        transforms.setValues(i, shapes[i]);
+      }
+      gather += elapsed();
+      restartTimer();
+      transforms.compute();
+      kernel += elapsed();
+      restartTimer();
+      for (size_t i = 0; i < shapes.size(); ++i) {
+        transforms.getMatrix(i, batchMatrices[i]);
+      }
+      matrices += elapsed();
+    }
+    addResult("batch", size, "gather", gather);
+    addResult("batch", size, "kernel", kernel);
+    addResult("batch", size, "matrices", matrices);
+    addResult("batch", size, "transform", gather + kernel + matrices);
+    // compare
+    double maxDifference = 0.0;
+    for (size_t i = 0; i < shapes.size(); ++i) {
+      for (int row = 0; row < 4; ++row) {
+        for (int col = 0; col < 4; ++col) {
+          maxDifference = qMax(maxDifference, qAbs(scalarMatrices[i](row, col) - batchMatrices[i](row, col)));
+        }
+      }
+    }
+    if (maxDifference > 1e-3) {
+      fprintf(stderr, "The batch transformation differs from rotateModelica2OSG by %g.\n", maxDifference);
+    }
+    restartTimer();
+  }
+}
+
+/*!
+ * \brief TransformBenchmark::generateShapes
+ * Generates shapes of all types with pseudo random positions, orientations and directions.
+ * \param shapes
+ * \param size
+ */
+void TransformBenchmark::generateShapes(std::vector<ShapeObject> &shapes, int size)
+{
+  static const char *types[] = {"cylinder", "box", "sphere", "cone", "pipe", "spring", "stl", "dxf", "capsule"};
+  unsigned int seed = 12345;
+  // a small linear congruential generator so that every run uses the same shapes
+  auto random = [&seed]() {
+    seed = seed * 1103515245u + 12345u;
+    return ((seed >> 16) & 0x7fff) / 16383.5f - 1.0f;
+  };
+  shapes.resize(size);
+  for (int i = 0; i < size; ++i) {
+    ShapeObject &shape = shapes[i];
+    shape._type = types[i % (sizeof(types) / sizeof(types[0]))];
+    shape._length.exp = 1.0f + random();
+    for (int k = 0; k < 3; ++k) {
+      shape._r[k].exp = 10.0f * random();
+      shape._rShape[k].exp = random();
+      shape._lDir[k].exp = random();
+      shape._wDir[k].exp = random();
+    }
+    // a proper rotation about the z axis
+    float angle = 3.14159265f * random();
+    shape._T[0].exp = std::cos(angle); shape._T[1].exp = -std::sin(angle); shape._T[2].exp = 0.0f;
+    shape._T[3].exp = std::sin(angle); shape._T[4].exp = std::cos(angle);  shape._T[5].exp = 0.0f;
+    shape._T[6].exp = 0.0f;            shape._T[7].exp = 0.0f;             shape._T[8].exp = 1.0f;
+  }
+}
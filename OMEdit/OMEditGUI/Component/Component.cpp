@@ -2705,162 +2705,6 @@ updateComponentTransformations(oldTransformation);
   showResizerItems();
 }
 
-/*!
- * \brief Component::moveUp
- * Slot that moves component upwards depending on the grid step size value
- * \sa moveDown(), moveLeft(), moveRight(), moveShiftUp(), moveShiftDown(), moveShiftLeft(), moveShiftRight(), moveCtrlUp(), moveCtrlDown(),
- * moveCtrlLeft(), moveCtrlRight()
- */
-void Component::moveUp()
-{
-  Transformation oldTransformation = mTransformation;
-  mTransformation.adjustPosition(0, mpGraphicsView->mCoOrdinateSystem.getVerticalGridStep());
-  updateComponentTransformations(oldTransformation);
-}
-
-/*!
- * \brief Component::moveShiftUp
- * Slot that moves component upwards depending on the grid step size value multiplied by 5
- * \sa moveUp(), moveDown(), moveLeft(), moveRight(), moveShiftDown(), moveShiftLeft(), moveShiftRight(), moveCtrlUp(), moveCtrlDown(),
- * moveCtrlLeft() and moveCtrlRight()
- */
-void Component::moveShiftUp()
-{
-  Transformation oldTransformation = mTransformation;
-  mTransformation.adjustPosition(0, mpGraphicsView->mCoOrdinateSystem.getVerticalGridStep() * 5);
-  updateComponentTransformations(oldTransformation);
-}
-
-/*!
- * \brief Component::moveCtrlUp
- * Slot that moves component one pixel upwards
- * \sa moveUp(), moveDown(), moveLeft(), moveRight(), moveShiftUp(), moveShiftDown(), moveShiftLeft(), moveShiftRight(), moveCtrlDown(),
- * moveCtrlLeft() and moveCtrlRight()
- */
-void Component::moveCtrlUp()
-{
-  Transformation oldTransformation = mTransformation;
-  mTransformation.adjustPosition(0, 1);
-  updateComponentTransformations(oldTransformation);
-}
-
-/*!
- * \brief Component::moveDown
- * Slot that moves component downwards depending on the grid step size value
- * \sa moveUp(), moveLeft(), moveRight(), moveShiftUp(), moveShiftDown(), moveShiftLeft(), moveShiftRight(), moveCtrlUp(), moveCtrlDown(),
- * moveCtrlLeft() and moveCtrlRight()
- */
-void Component::moveDown()
-{
-  Transformation oldTransformation = mTransformation;
-  mTransformation.adjustPosition(0, -mpGraphicsView->mCoOrdinateSystem.getVerticalGridStep());
-  updateComponentTransformations(oldTransformation);
-}
-
-/*!
- * \brief Component::moveShiftDown
- * Slot that moves component downwards depending on the grid step size value multiplied by 5
- * \sa moveUp(), moveDown(), moveLeft(), moveRight(), moveShiftUp(), moveShiftLeft(), moveShiftRight(), moveCtrlUp(), moveCtrlDown(),
- * moveCtrlLeft() and moveCtrlRight()
- */
-void Component::moveShiftDown()
-{
-  Transformation oldTransformation = mTransformation;
-  mTransformation.adjustPosition(0, -(mpGraphicsView->mCoOrdinateSystem.getVerticalGridStep() * 5));
-  updateComponentTransformations(oldTransformation);
-}
-
-/*!
- * \brief Component::moveCtrlDown
- * Slot that moves component one pixel downwards
- * \sa moveUp(), moveDown(), moveLeft(), moveRight(), moveShiftUp(), moveShiftDown(), moveShiftLeft(), moveShiftRight(), moveCtrlUp(),
- * moveCtrlLeft() and moveCtrlRight()
- */
-void Component::moveCtrlDown()
-{
-  Transformation oldTransformation = mTransformation;
-  mTransformation.adjustPosition(0, -1);
-  updateComponentTransformations(oldTransformation);
-}
-
-/*!
- * \brief Component::moveLeft
- * Slot that moves component leftwards depending on the grid step size value
- * \sa moveUp(), moveDown(), moveRight(), moveShiftUp(), moveShiftDown(), moveShiftLeft(), moveShiftRight(), moveCtrlUp(), moveCtrlDown(),
- * moveCtrlLeft() and moveCtrlRight()
- */
-void Component::moveLeft()
-{
-  Transformation oldTransformation = mTransformation;
-  mTransformation.adjustPosition(-mpGraphicsView->mCoOrdinateSystem.getHorizontalGridStep(), 0);
-  updateComponentTransformations(oldTransformation);
-}
-
-/*!
- * \brief Component::moveShiftLeft
- * Slot that moves component leftwards depending on the grid step size value multiplied by 5
- * \sa moveUp(), moveDown(), moveLeft(), moveRight(), moveShiftUp(), moveShiftDown(), moveShiftRight(), moveCtrlUp(), moveCtrlDown(),
- * moveCtrlLeft() and moveCtrlRight()
- */
-void Component::moveShiftLeft()
-{
-  Transformation oldTransformation = mTransformation;
-  mTransformation.adjustPosition(-(mpGraphicsView->mCoOrdinateSystem.getHorizontalGridStep() * 5), 0);
-  updateComponentTransformations(oldTransformation);
-}
-
-/*!
- * \brief Component::moveCtrlLeft
- * Slot that moves component one pixel leftwards
- * \sa moveUp(), moveDown(), moveLeft(), moveRight(), moveShiftUp(), moveShiftDown(), moveShiftLeft(), moveShiftRight(), moveCtrlUp(),
- * moveCtrlDown() and moveCtrlRight()
- */
-void Component::moveCtrlLeft()
-{
-  Transformation oldTransformation = mTransformation;
-  mTransformation.adjustPosition(-1, 0);
-  updateComponentTransformations(oldTransformation);
-}
-
-/*!
- * \brief Component::moveRight
- * Slot that moves component rightwards depending on the grid step size value
- * \sa moveUp(), moveDown(), moveLeft(), moveShiftUp(), moveShiftDown(), moveShiftLeft(), moveShiftRight(), moveCtrlUp(), moveCtrlDown(),
- * moveCtrlLeft() and moveCtrlRight()
- */
-void Component::moveRight()
-{
-  Transformation oldTransformation = mTransformation;
-  mTransformation.adjustPosition(mpGraphicsView->mCoOrdinateSystem.getHorizontalGridStep(), 0);
-  updateComponentTransformations(oldTransformation);
-}
-
-/*!
- * \brief Component::moveShiftRight
- * Slot that moves component rightwards depending on the grid step size value multiplied by 5
- * \sa moveUp(), moveDown(), moveLeft(), moveRight(), moveShiftUp(), moveShiftDown(), moveShiftLeft(), moveCtrlUp(), moveCtrlDown(),
- * moveCtrlLeft() and moveCtrlRight()
- */
-void Component::moveShiftRight()
-{
-  Transformation oldTransformation = mTransformation;
-  mTransformation.adjustPosition(mpGraphicsView->mCoOrdinateSystem.getHorizontalGridStep() * 5, 0);
-  updateComponentTransformations(oldTransformation);
-}
-
-/*!
- * \brief Component::moveCtrlRight
- * Slot that moves component one pixel rightwards
- * \sa moveUp(), moveDown(), moveLeft(), moveRight(), moveShiftUp(), moveShiftDown(), moveShiftLeft(), moveShiftRight(), moveCtrlUp(),
- * moveCtrlDown() and moveCtrlLeft()
- */
-void Component::moveCtrlRight()
-{
-  Transformation oldTransformation = mTransformation;
-  mTransformation.adjustPosition(1, 0);
-  updateComponentTransformations(oldTransformation);
-}
-
 //! Slot that opens up the component parameters dialog.
 //! @see showAttributes()
 void Component::showParameters()
@@ -2947,17 +2791,23 @@ void Component::showElementPropertiesDialog()
 
 /*!
  * \brief Component::updateDynamicSelect
- * Slot activated when updateDynamicSelect SIGNAL is raised by VariablesWidget during the visualization of result file.
- * \param time
+ * Called by VariablesWidget during the visualization of result file when the active value of the state has changed.\n
+ * Repaints only the state and its incoming transitions.
+ * \param value
  */
-void Component::updateDynamicSelect(double time)
+void Component::updateDynamicSelect(double value)
 {
   if (mpLibraryTreeItem && mpLibraryTreeItem->isState()) {
-    double value = MainWindow::instance()->getVariablesWidget()->readVariableValue(getName() + ".active", time);
     setActiveState(value);
+    // the shapes of the state are cached so update them explicitly
+    update();
+    foreach (QGraphicsItem *pGraphicsItem, childItems()) {
+      pGraphicsItem->update();
+    }
     foreach (LineAnnotation *pTransitionLineAnnotation, mpGraphicsView->getTransitionsList()) {
       if (pTransitionLineAnnotation->getEndComponent()->getName().compare(getName()) == 0) {
         pTransitionLineAnnotation->setActiveState(value);
+        pTransitionLineAnnotation->update();
       }
     }
   }
@@ -3055,18 +2905,6 @@ QVariant Component::itemChange(GraphicsItemChange change, const QVariant &value)
         connect(mpGraphicsView, SIGNAL(keyPressRotateAntiClockwise()), this, SLOT(rotateAntiClockwise()), Qt::UniqueConnection);
         connect(mpGraphicsView, SIGNAL(keyPressFlipHorizontal()), this, SLOT(flipHorizontal()), Qt::UniqueConnection);
         connect(mpGraphicsView, SIGNAL(keyPressFlipVertical()), this, SLOT(flipVertical()), Qt::UniqueConnection);
-        connect(mpGraphicsView, SIGNAL(keyPressUp()), this, SLOT(moveUp()), Qt::UniqueConnection);
-        connect(mpGraphicsView, SIGNAL(keyPressShiftUp()), this, SLOT(moveShiftUp()), Qt::UniqueConnection);
-        connect(mpGraphicsView, SIGNAL(keyPressCtrlUp()), this, SLOT(moveCtrlUp()), Qt::UniqueConnection);
-        connect(mpGraphicsView, SIGNAL(keyPressDown()), this, SLOT(moveDown()), Qt::UniqueConnection);
-        connect(mpGraphicsView, SIGNAL(keyPressShiftDown()), this, SLOT(moveShiftDown()), Qt::UniqueConnection);
-        connect(mpGraphicsView, SIGNAL(keyPressCtrlDown()), this, SLOT(moveCtrlDown()), Qt::UniqueConnection);
-        connect(mpGraphicsView, SIGNAL(keyPressLeft()), this, SLOT(moveLeft()), Qt::UniqueConnection);
-        connect(mpGraphicsView, SIGNAL(keyPressShiftLeft()), this, SLOT(moveShiftLeft()), Qt::UniqueConnection);
-        connect(mpGraphicsView, SIGNAL(keyPressCtrlLeft()), this, SLOT(moveCtrlLeft()), Qt::UniqueConnection);
-        connect(mpGraphicsView, SIGNAL(keyPressRight()), this, SLOT(moveRight()), Qt::UniqueConnection);
-        connect(mpGraphicsView, SIGNAL(keyPressShiftRight()), this, SLOT(moveShiftRight()), Qt::UniqueConnection);
-        connect(mpGraphicsView, SIGNAL(keyPressCtrlRight()), this, SLOT(moveCtrlRight()), Qt::UniqueConnection);
       }
     } else {
       if (!mpBottomLeftResizerItem->isPressed() && !mpTopLeftResizerItem->isPressed() &&
@@ -3092,18 +2930,6 @@ QVariant Component::itemChange(GraphicsItemChange change, const QVariant &value)
         disconnect(mpGraphicsView, SIGNAL(keyPressRotateAntiClockwise()), this, SLOT(rotateAntiClockwise()));
         disconnect(mpGraphicsView, SIGNAL(keyPressFlipHorizontal()), this, SLOT(flipHorizontal()));
         disconnect(mpGraphicsView, SIGNAL(keyPressFlipVertical()), this, SLOT(flipVertical()));
-        disconnect(mpGraphicsView, SIGNAL(keyPressUp()), this, SLOT(moveUp()));
-        disconnect(mpGraphicsView, SIGNAL(keyPressShiftUp()), this, SLOT(moveShiftUp()));
-        disconnect(mpGraphicsView, SIGNAL(keyPressCtrlUp()), this, SLOT(moveCtrlUp()));
-        disconnect(mpGraphicsView, SIGNAL(keyPressDown()), this, SLOT(moveDown()));
-        disconnect(mpGraphicsView, SIGNAL(keyPressShiftDown()), this, SLOT(moveShiftDown()));
-        disconnect(mpGraphicsView, SIGNAL(keyPressCtrlDown()), this, SLOT(moveCtrlDown()));
-        disconnect(mpGraphicsView, SIGNAL(keyPressLeft()), this, SLOT(moveLeft()));
-        disconnect(mpGraphicsView, SIGNAL(keyPressShiftLeft()), this, SLOT(moveShiftLeft()));
-        disconnect(mpGraphicsView, SIGNAL(keyPressCtrlLeft()), this, SLOT(moveCtrlLeft()));
-        disconnect(mpGraphicsView, SIGNAL(keyPressRight()), this, SLOT(moveRight()));
-        disconnect(mpGraphicsView, SIGNAL(keyPressShiftRight()), this, SLOT(moveShiftRight()));
-        disconnect(mpGraphicsView, SIGNAL(keyPressCtrlRight()), this, SLOT(moveCtrlRight()));
       }
     }
 #if !defined(WITHOUT_OSG)
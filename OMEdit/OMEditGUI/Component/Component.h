@@ -252,6 +252,7 @@ public:
   bool isInBus() {return mpBusComponent != 0;}
   void setBusComponent(Component *pBusComponent);
   Component* getBusComponent() {return mpBusComponent;}
+  void updateDynamicSelect(double value);
 
   Transformation mTransformation;
   Transformation mOldTransformation;
@@ -357,18 +358,6 @@ public slots:
   void rotateAntiClockwise();
   void flipHorizontal();
   void flipVertical();
-  void moveUp();
-  void moveShiftUp();
-  void moveCtrlUp();
-  void moveDown();
-  void moveShiftDown();
-  void moveCtrlDown();
-  void moveLeft();
-  void moveShiftLeft();
-  void moveCtrlLeft();
-  void moveRight();
-  void moveShiftRight();
-  void moveCtrlRight();
   void showParameters();
   void showAttributes();
   void fetchInterfaceData();
@@ -376,7 +365,6 @@ public slots:
   void viewDocumentation();
   void showSubModelAttributes();
   void showElementPropertiesDialog();
-  void updateDynamicSelect(double time);
 protected:
   virtual void contextMenuEvent(QGraphicsSceneContextMenuEvent *event);
   virtual QVariant itemChange(GraphicsItemChange change, const QVariant &value);
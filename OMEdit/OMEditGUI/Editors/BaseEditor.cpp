@@ -42,6 +42,10 @@
 #include <QCompleter>
 #include <QMessageBox>
 #include <QTextDocumentFragment>
+#include <QToolTip>
+#include <QtConcurrentRun>
+
+#include <algorithm>
 
 #if (QT_VERSION < QT_VERSION_CHECK(5, 0, 0))
 #define QStringLiteral QString::fromUtf8
@@ -575,8 +579,7 @@ void BaseEditorDocumentLayout::foldOrUnfold(const QTextBlock& block, bool unfold
   QTextBlock b = block.next();
   int indent = foldingIndent(block);
   while (b.isValid() && foldingIndent(b) > indent && (unfold || b.next().isValid())) {
-    b.setVisible(unfold);
-    b.setLineCount(unfold? qMax(1, b.layout()->lineCount()) : 0);
+    setBlockVisible(b, unfold);
     if (unfold) { // do not unfold folded sub-blocks
       if (isFolded(b) && b.next().isValid()) {
         int jndent = foldingIndent(b);
@@ -644,6 +647,141 @@ TextBlockUserData* BaseEditorDocumentLayout::userData(const QTextBlock &block)
   return data;
 }
 
+/*!
+ * \brief BaseEditorDocumentLayout::setBlockVisible
+ * Shows/hides the block. All the folding goes through this function so that the fold map is updated.
+ * \param block
+ * \param visible
+ */
+void BaseEditorDocumentLayout::setBlockVisible(const QTextBlock &block, bool visible)
+{
+  QTextBlock textBlock = block;
+  textBlock.setVisible(visible);
+  textBlock.setLineCount(visible ? qMax(1, textBlock.layout()->lineCount()) : 0);
+  if (BaseEditorDocumentLayout *pBaseEditorDocumentLayout = qobject_cast<BaseEditorDocumentLayout*>(block.document()->documentLayout())) {
+    pBaseEditorDocumentLayout->mFoldMap.invalidate();
+  }
+}
+
+/*!
+ * \brief BaseEditorDocumentLayout::nextVisibleBlock
+ * Returns the first visible block after the block or an invalid block if there is none.
+ * \param block
+ * \return
+ */
+QTextBlock BaseEditorDocumentLayout::nextVisibleBlock(const QTextBlock &block)
+{
+  QTextBlock nextBlock = block.next();
+  if (!nextBlock.isValid() || nextBlock.isVisible()) {
+    return nextBlock;
+  }
+  return document()->findBlockByNumber(mFoldMap.nextVisibleBlockNumber(document(), nextBlock.blockNumber()));
+}
+
+/*!
+ * \brief BaseEditorDocumentLayout::documentChanged
+ * Moves the hidden ranges of the fold map when blocks are added or removed.
+ * \param from
+ * \param charsRemoved
+ * \param charsAdded
+ */
+void BaseEditorDocumentLayout::documentChanged(int from, int charsRemoved, int charsAdded)
+{
+  QPlainTextDocumentLayout::documentChanged(from, charsRemoved, charsAdded);
+  const int blockCount = document()->blockCount();
+  if (blockCount != mFoldMap.blockCount()) {
+    mFoldMap.blockCountChanged(document()->findBlock(from).blockNumber(), blockCount);
+  }
+}
+
+/*!
+ * \class FoldMap
+ * \brief The hidden ranges of blocks of a document.
+ */
+/*!
+ * \brief rangeEndsBefore
+ * Used with std::lower_bound to find the first hidden range that ends at or after the block number.
+ * \param range
+ * \param blockNumber
+ * \return
+ */
+static bool rangeEndsBefore(const QPair<int, int> &range, int blockNumber)
+{
+  return range.second < blockNumber;
+}
+
+/*!
+ * \brief FoldMap::blockCountChanged
+ * Moves the hidden ranges after the changed blocks. The map is built again if a hidden range is changed.
+ * \param blockNumber - the number of the first changed block.
+ * \param blockCount - the new number of blocks.
+ */
+void FoldMap::blockCountChanged(int blockNumber, int blockCount)
+{
+  const int difference = blockCount - mBlockCount;
+  mBlockCount = blockCount;
+  if (!mValid) {
+    return;
+  }
+  // the blocks blockNumber to lastBlockNumber of the old text are changed, the following blocks are moved by difference
+  const int lastBlockNumber = blockNumber + qMax(0, -difference);
+  QVector<QPair<int, int> >::iterator range = std::lower_bound(mHiddenRanges.begin(), mHiddenRanges.end(), blockNumber, rangeEndsBefore);
+  for (; range != mHiddenRanges.end(); ++range) {
+    if (range->first <= lastBlockNumber) {
+      mValid = false;
+      return;
+    }
+    range->first += difference;
+    range->second += difference;
+  }
+}
+
+/*!
+ * \brief FoldMap::nextVisibleBlockNumber
+ * Returns the number of the first visible block starting at blockNumber.
+ * \param pTextDocument
+ * \param blockNumber
+ * \return
+ */
+int FoldMap::nextVisibleBlockNumber(QTextDocument *pTextDocument, int blockNumber)
+{
+  if (!mValid || mBlockCount != pTextDocument->blockCount()) {
+    build(pTextDocument);
+  }
+  QVector<QPair<int, int> >::const_iterator range = std::lower_bound(mHiddenRanges.constBegin(), mHiddenRanges.constEnd(), blockNumber, rangeEndsBefore);
+  if (range != mHiddenRanges.constEnd() && range->first <= blockNumber) {
+    return range->second + 1;
+  }
+  return blockNumber;
+}
+
+/*!
+ * \brief FoldMap::build
+ * Finds the hidden ranges of the document.
+ * \param pTextDocument
+ */
+void FoldMap::build(QTextDocument *pTextDocument)
+{
+  mHiddenRanges.clear();
+  int firstHiddenBlockNumber = -1;
+  int blockNumber = 0;
+  for (QTextBlock block = pTextDocument->firstBlock(); block.isValid(); block = block.next(), ++blockNumber) {
+    if (!block.isVisible()) {
+      if (firstHiddenBlockNumber < 0) {
+        firstHiddenBlockNumber = blockNumber;
+      }
+    } else if (firstHiddenBlockNumber >= 0) {
+      mHiddenRanges.append(qMakePair(firstHiddenBlockNumber, blockNumber - 1));
+      firstHiddenBlockNumber = -1;
+    }
+  }
+  if (firstHiddenBlockNumber >= 0) {
+    mHiddenRanges.append(qMakePair(firstHiddenBlockNumber, blockNumber - 1));
+  }
+  mBlockCount = blockNumber;
+  mValid = true;
+}
+
 /*!
  * \brief foldBoxWidth
  * Returns the width for folding control.
@@ -669,6 +807,7 @@ PlainTextEdit::PlainTextEdit(BaseEditor *pBaseEditor)
   BaseEditorDocumentLayout *pModelicaTextDocumentLayout = new BaseEditorDocumentLayout(pTextDocument);
   pTextDocument->setDocumentLayout(pModelicaTextDocumentLayout);
   setDocument(pTextDocument);
+  updateFontMetrics(true);
   // line numbers widget
   mpLineNumberArea = new LineNumberArea(mpBaseEditor, this);
   mCanHaveBreakpoints = false;
@@ -851,6 +990,25 @@ void PlainTextEdit::setCanHaveBreakpoints(bool canHaveBreakpoints)
   mpLineNumberArea->setMouseTracking(canHaveBreakpoints);
 }
 
+/*!
+ * \brief PlainTextEdit::updateFontMetrics
+ * Computes the font metrics used for painting when the font of the document has changed.
+ * \param force
+ */
+void PlainTextEdit::updateFontMetrics(bool force)
+{
+  if (!force && mMetricsFont == document()->defaultFont()) {
+    return;
+  }
+  mMetricsFont = document()->defaultFont();
+  const QFontMetrics fm(mMetricsFont);
+  mDigitWidth = fm.width(QLatin1Char('9'));
+  mLineSpacing = fm.lineSpacing();
+  mFontHeight = fm.height();
+  mFoldBoxWidth = foldBoxWidth(fm);
+  mFoldMarkerWidth = fm.width(QLatin1String(" ...); "));
+}
+
 /*!
  * \brief PlainTextEdit::lineNumberAreaWidth
  * Calculate appropriate width for LineNumberArea.
@@ -864,16 +1022,16 @@ int PlainTextEdit::lineNumberAreaWidth()
     max /= 10;
     ++digits;
   }
-  const QFontMetrics fm(document()->defaultFont());
-  int space = fm.width(QLatin1Char('9')) * digits;
+  updateFontMetrics();
+  int space = mDigitWidth * digits;
   if (canHaveBreakpoints()) {
-    space += fm.lineSpacing();
+    space += mLineSpacing;
   } else {
     space += 4;
   }
   TextEditorPage *pTextEditorPage = OptionsDialog::instance()->getTextEditorPage();
   if (pTextEditorPage->getSyntaxHighlightingGroupBox()->isChecked() && pTextEditorPage->getCodeFoldingCheckBox()->isChecked()) {
-    space += foldBoxWidth(fm);
+    space += mFoldBoxWidth;
   } else {
     space += 4;
   }
@@ -895,18 +1053,26 @@ void PlainTextEdit::lineNumberAreaPaintEvent(QPaintEvent *event)
   int blockNumber = block.blockNumber();
   qreal top = blockBoundingGeometry(block).translated(contentOffset()).top();
   qreal bottom = top;
-  const QFontMetrics fm(document()->defaultFont());
-  int fmLineSpacing = fm.lineSpacing();
+  updateFontMetrics();
+  BaseEditorDocumentLayout *pBaseEditorDocumentLayout = qobject_cast<BaseEditorDocumentLayout*>(document()->documentLayout());
 
+  // everything that does not depend on the block is computed once per paint
   int collapseColumnWidth = 4;
   TextEditorPage *pTextEditorPage = OptionsDialog::instance()->getTextEditorPage();
-  if (pTextEditorPage->getSyntaxHighlightingGroupBox()->isChecked() && pTextEditorPage->getCodeFoldingCheckBox()->isChecked()) {
-    collapseColumnWidth = foldBoxWidth(fm);
+  const bool codeFolding = pTextEditorPage->getSyntaxHighlightingGroupBox()->isChecked() && pTextEditorPage->getCodeFoldingCheckBox()->isChecked();
+  if (codeFolding) {
+    collapseColumnWidth = mFoldBoxWidth;
   }
   const int lineNumbersWidth = mpLineNumberArea->width() - collapseColumnWidth;
+  int lineNumberOffset = 1;
+  if (mpBaseEditor->getModelWidget() && mpBaseEditor->getModelWidget()->getLibraryTreeItem()->isInPackageOneFile() &&
+      mpBaseEditor->getModelWidget()->getLibraryTreeItem()->getLibraryType() == LibraryTreeItem::Modelica) {
+    lineNumberOffset = mpBaseEditor->getModelWidget()->getLibraryTreeItem()->mClassInformation.lineNumberStart;
+  }
+  const int currentBlockNumber = textCursor().blockNumber();
+  painter.setFont(document()->defaultFont());
 
   while (block.isValid() && top <= event->rect().bottom()) {
-    QTextDocument *pTextDocument = document();
     top = bottom;
     const qreal height = blockBoundingRect(block).height();
     bottom = top + height;
@@ -915,9 +1081,8 @@ void PlainTextEdit::lineNumberAreaPaintEvent(QPaintEvent *event)
     QTextBlock nextVisibleBlock = nextBlock;
     int nextVisibleBlockNumber = blockNumber + 1;
 
-    if (!nextVisibleBlock.isVisible()) {
-      // invisible blocks do have zero line count
-      nextVisibleBlock = pTextDocument->findBlockByLineNumber(nextVisibleBlock.firstLineNumber());
+    if (nextBlock.isValid() && !nextBlock.isVisible()) {
+      nextVisibleBlock = pBaseEditorDocumentLayout->nextVisibleBlock(block);
       nextVisibleBlockNumber = nextVisibleBlock.blockNumber();
     }
 
@@ -932,7 +1097,7 @@ void PlainTextEdit::lineNumberAreaPaintEvent(QPaintEvent *event)
       int xoffset = 0;
       foreach (ITextMark *mk, pTextBlockUserData->marks()) {
         int x = 0;
-        int radius = fmLineSpacing;
+        int radius = mLineSpacing;
         QRect r(x + xoffset, top, radius, radius);
         mk->icon().paint(&painter, r, Qt::AlignCenter);
         xoffset += 2;
@@ -940,25 +1105,16 @@ void PlainTextEdit::lineNumberAreaPaintEvent(QPaintEvent *event)
     }
     /* paint line numbers */
     if (block.isVisible() && bottom >= event->rect().top()) {
-      QString number;
-      if (mpBaseEditor->getModelWidget() && mpBaseEditor->getModelWidget()->getLibraryTreeItem()->isInPackageOneFile() &&
-          mpBaseEditor->getModelWidget()->getLibraryTreeItem()->getLibraryType() == LibraryTreeItem::Modelica) {
-        number = QString::number(blockNumber + mpBaseEditor->getModelWidget()->getLibraryTreeItem()->mClassInformation.lineNumberStart);
-      } else {
-        number = QString::number(blockNumber + 1);
-      }
       // make the current highlighted line number darker
-      if (blockNumber == textCursor().blockNumber()) {
+      if (blockNumber == currentBlockNumber) {
         painter.setPen(QColor(64, 64, 64));
       } else {
         painter.setPen(Qt::gray);
       }
-      painter.setFont(document()->defaultFont());
-      painter.drawText(0, top, lineNumbersWidth, fm.height(), Qt::AlignRight, number);
+      painter.drawText(0, top, lineNumbersWidth, mFontHeight, Qt::AlignRight, QString::number(blockNumber + lineNumberOffset));
     }
     // paint folding markers
-    TextEditorPage *pTextEditorPage = OptionsDialog::instance()->getTextEditorPage();
-    if (pTextEditorPage->getSyntaxHighlightingGroupBox()->isChecked() && pTextEditorPage->getCodeFoldingCheckBox()->isChecked()) {
+    if (codeFolding) {
       painter.save();
       painter.setRenderHint(QPainter::Antialiasing, false);
       painter.setPen(Qt::gray);
@@ -967,8 +1123,7 @@ void PlainTextEdit::lineNumberAreaPaintEvent(QPaintEvent *event)
       bool drawFoldingControl = nextBlockUserData && BaseEditorDocumentLayout::foldingIndent(block) < nextBlockUserData->foldingIndent();
       bool drawLine = BaseEditorDocumentLayout::foldingIndent(block) > 0;
       bool drawEnd = drawLine && (!nextBlockUserData || (nextBlockUserData && BaseEditorDocumentLayout::foldingIndent(block) > nextBlockUserData->foldingIndent()));
-      int boxWidth = foldBoxWidth(fm);
-      int size = boxWidth / 4;
+      int size = mFoldBoxWidth / 4;
       QRect foldingMarkerBox(lineNumbersWidth + size, top + size, 2 * (size) + 1, 2 * (size) + 1);
       QRect foldingLineBox(lineNumbersWidth + size, top, 2 * (size) + 1, height);
 
@@ -1021,10 +1176,10 @@ void PlainTextEdit::lineNumberAreaPaintEvent(QPaintEvent *event)
 void PlainTextEdit::lineNumberAreaMouseEvent(QMouseEvent *event)
 {
   QTextCursor cursor = cursorForPosition(QPoint(0, event->pos().y()));
-  const QFontMetrics fm(document()->defaultFont());
+  updateFontMetrics();
   // check mouse click for breakpoints
   if (canHaveBreakpoints()) {
-    int breakPointWidth = fm.lineSpacing();
+    int breakPointWidth = mLineSpacing;
     // Set whether the mouse cursor is a hand or a normal arrow
     if (event->type() == QEvent::MouseMove) {
       bool handCursor = (event->pos().x() <= breakPointWidth);
@@ -1053,8 +1208,7 @@ void PlainTextEdit::lineNumberAreaMouseEvent(QMouseEvent *event)
   // check mouse click for folding markers
   TextEditorPage *pTextEditorPage = OptionsDialog::instance()->getTextEditorPage();
   if (pTextEditorPage->getSyntaxHighlightingGroupBox()->isChecked() && pTextEditorPage->getCodeFoldingCheckBox()->isChecked()) {
-    int boxWidth = foldBoxWidth(fm);
-    if (event->button() == Qt::LeftButton && event->pos().x() > mpLineNumberArea->width() - boxWidth) {
+    if (event->button() == Qt::LeftButton && event->pos().x() > mpLineNumberArea->width() - mFoldBoxWidth) {
       if (!cursor.block().next().isVisible()) {
         toggleBlockVisible(cursor.block());
         moveCursorVisible(false);
@@ -1106,6 +1260,48 @@ void PlainTextEdit::highlightParentheses()
   Utilities::highlightParentheses(this, mParenthesesMatchFormat, mParenthesesMisMatchFormat);
 }
 
+/*!
+ * \brief matchEndsBefore
+ * Returns true if the match ends before the position.
+ * \param match
+ * \param position
+ * \return
+ */
+static bool matchEndsBefore(const TextMatch &match, int position)
+{
+  return match.mPosition + match.mLength <= position;
+}
+
+/*!
+ * \brief PlainTextEdit::highlightSearchMatches
+ * Highlights the search matches which are in the visible blocks.
+ * The matches are sorted so the first visible match is found with a binary search.
+ */
+void PlainTextEdit::highlightSearchMatches()
+{
+  if (mSearchMatches.isEmpty()) {
+    return;
+  }
+  QTextBlock firstBlock = firstVisibleBlock();
+  QTextBlock lastBlock = cursorForPosition(viewport()->rect().bottomRight()).block();
+  if (!firstBlock.isValid() || !lastBlock.isValid()) {
+    return;
+  }
+  const int start = firstBlock.position();
+  const int end = qMin(lastBlock.position() + lastBlock.length(), document()->characterCount() - 1);
+  QList<QTextEdit::ExtraSelection> selections = extraSelections();
+  QTextEdit::ExtraSelection selection;
+  selection.format.setBackground(QColor(255, 239, 11, 128));
+  selection.cursor = QTextCursor(document());
+  QList<TextMatch>::const_iterator match = std::lower_bound(mSearchMatches.constBegin(), mSearchMatches.constEnd(), start, matchEndsBefore);
+  for (; match != mSearchMatches.constEnd() && match->mPosition < end; ++match) {
+    selection.cursor.setPosition(match->mPosition);
+    selection.cursor.setPosition(qMin(match->mPosition + match->mLength, end), QTextCursor::KeepAnchor);
+    selections.append(selection);
+  }
+  setExtraSelections(selections);
+}
+
 /*!
  * \brief BaseEditor::setLineWrapping
  * Sets the Editor Line Wrapping mode.
@@ -1301,6 +1497,9 @@ void PlainTextEdit::foldOrUnfold(bool unFold)
   while (block.isValid()) {
     if (BaseEditorDocumentLayout::canFold(block)) {
       BaseEditorDocumentLayout::foldOrUnfold(block, unFold);
+    } else if (unFold && !block.isVisible()) {
+      // the blocks hidden by setBlocksVisible
+      BaseEditorDocumentLayout::setBlockVisible(block, true);
     }
     block = block.next();
   }
@@ -1311,6 +1510,93 @@ void PlainTextEdit::foldOrUnfold(bool unFold)
   centerCursor();
 }
 
+/*!
+ * \brief PlainTextEdit::foldBlocks
+ * Folds the foldings that contain the blocks firstBlockNumber to lastBlockNumber.\n
+ * Used after a partial update of the document so that the folding of the unchanged blocks is kept.
+ * \param firstBlockNumber
+ * \param lastBlockNumber
+ */
+void PlainTextEdit::foldBlocks(int firstBlockNumber, int lastBlockNumber)
+{
+  TextEditorPage *pTextEditorPage = OptionsDialog::instance()->getTextEditorPage();
+  if (!pTextEditorPage->getSyntaxHighlightingGroupBox()->isChecked() || !pTextEditorPage->getCodeFoldingCheckBox()->isChecked()) {
+    return;
+  }
+  BaseEditorDocumentLayout *pBaseEditorDocumentLayout = qobject_cast<BaseEditorDocumentLayout*>(document()->documentLayout());
+  // start from the block that opens the folding containing the first block
+  QTextBlock block = document()->findBlockByNumber(firstBlockNumber);
+  while (block.previous().isValid() && BaseEditorDocumentLayout::foldingIndent(block) > 0) {
+    block = block.previous();
+  }
+  // the changed blocks might have been hidden by a folding that does not exist anymore so show them first
+  QTextBlock firstBlock = block;
+  while (block.isValid() && (block.blockNumber() <= lastBlockNumber || BaseEditorDocumentLayout::foldingIndent(block) > 0)) {
+    if (!block.isVisible()) {
+      BaseEditorDocumentLayout::setBlockVisible(block, true);
+    }
+    block = block.next();
+  }
+  QTextBlock lastBlock = block;
+  for (block = firstBlock; block.isValid() && block != lastBlock; block = block.next()) {
+    if (BaseEditorDocumentLayout::canFold(block)) {
+      BaseEditorDocumentLayout::foldOrUnfold(block, false);
+    }
+  }
+  moveCursorVisible(false);
+  pBaseEditorDocumentLayout->requestUpdate();
+  pBaseEditorDocumentLayout->emitDocumentSizeChanged();
+}
+
+/*!
+ * \brief PlainTextEdit::setBlocksVisible
+ * Hides or shows the blocks firstBlockNumber to lastBlockNumber, e.g., to fold a class from the outline.\n
+ * The foldings inside the shown blocks are folded again.
+ * \param firstBlockNumber
+ * \param lastBlockNumber
+ * \param visible
+ */
+void PlainTextEdit::setBlocksVisible(int firstBlockNumber, int lastBlockNumber, bool visible)
+{
+  BaseEditorDocumentLayout *pBaseEditorDocumentLayout = qobject_cast<BaseEditorDocumentLayout*>(document()->documentLayout());
+  int blockNumber = firstBlockNumber;
+  for (QTextBlock block = document()->findBlockByNumber(firstBlockNumber); block.isValid() && blockNumber <= lastBlockNumber;
+       block = block.next(), ++blockNumber) {
+    BaseEditorDocumentLayout::setBlockVisible(block, visible);
+  }
+  if (visible) {
+    foldBlocks(firstBlockNumber, lastBlockNumber);
+  }
+  moveCursorVisible(false);
+  pBaseEditorDocumentLayout->requestUpdate();
+  pBaseEditorDocumentLayout->emitDocumentSizeChanged();
+}
+
+/*!
+ * \brief PlainTextEdit::setDiagnostics
+ * Sets the inline diagnostics. The tooltip of the selection format is shown when the mouse is over the diagnostic.
+ * \param diagnostics
+ */
+void PlainTextEdit::setDiagnostics(const QList<QTextEdit::ExtraSelection> &diagnostics)
+{
+  mDiagnostics = diagnostics;
+  updateHighlights();
+}
+
+/*!
+ * \brief PlainTextEdit::setSearchMatches
+ * Sets the matches of the find text. Only the matches in the visible blocks are highlighted.
+ * \param searchMatches - the matches sorted by position.
+ */
+void PlainTextEdit::setSearchMatches(const QList<TextMatch> &searchMatches)
+{
+  if (mSearchMatches.isEmpty() && searchMatches.isEmpty()) {
+    return;
+  }
+  mSearchMatches = searchMatches;
+  updateHighlights();
+}
+
 /*!
  * \brief PlainTextEdit::handleHomeKey
  * Handles the home key.\n
@@ -1379,6 +1665,10 @@ void PlainTextEdit::updateLineNumberArea(const QRect &rect, int dy)
 {
   if (dy) {
     mpLineNumberArea->scroll(0, dy);
+    // the visible blocks are changed so update the highlighted search matches.
+    if (!mSearchMatches.isEmpty()) {
+      updateHighlights();
+    }
   } else {
     mpLineNumberArea->update(0, rect.y(), mpLineNumberArea->width(), rect.height());
   }
@@ -1395,9 +1685,9 @@ void PlainTextEdit::updateLineNumberArea(const QRect &rect, int dy)
  */
 void PlainTextEdit::updateHighlights()
 {
-  QList<QTextEdit::ExtraSelection> selections;
-  setExtraSelections(selections);
+  setExtraSelections(mDiagnostics);
   highlightCurrentLine();
+  highlightSearchMatches();
   highlightParentheses();
 }
 
@@ -1540,6 +1830,9 @@ void PlainTextEdit::resizeEvent(QResizeEvent *pEvent)
 
   QRect cr = contentsRect();
   mpLineNumberArea->setGeometry(QRect(cr.left(), cr.top(), lineNumberAreaWidth(), cr.height()));
+  if (!mSearchMatches.isEmpty()) {
+    updateHighlights();
+  }
 }
 
 QCompleter *PlainTextEdit::completer()
@@ -1873,18 +2166,15 @@ void PlainTextEdit::paintEvent(QPaintEvent *e)
   int selectionEnd = cursor.selectionEnd();
 
   QTextDocument *pTextDocument = document();
+  BaseEditorDocumentLayout *pBaseEditorDocumentLayout = qobject_cast<BaseEditorDocumentLayout*>(pTextDocument->documentLayout());
+  updateFontMetrics();
 
   while (block.isValid() && top <= e->rect().bottom()) {
     QTextBlock nextBlock = block.next();
     QTextBlock nextVisibleBlock = nextBlock;
 
-    if (!nextVisibleBlock.isVisible()) {
-      // invisible blocks do have zero line count
-      nextVisibleBlock = pTextDocument->findBlockByLineNumber(nextVisibleBlock.firstLineNumber());
-      // in case our code somewhere did not set the line count of the invisible block to 0
-      while (nextVisibleBlock.isValid() && !nextVisibleBlock.isVisible()) {
-        nextVisibleBlock = nextVisibleBlock.next();
-      }
+    if (nextBlock.isValid() && !nextBlock.isVisible()) {
+      nextVisibleBlock = pBaseEditorDocumentLayout->nextVisibleBlock(block);
     }
     if (block.isVisible() && bottom >= e->rect().top()) {
       if (nextBlock.isValid() && !nextBlock.isVisible()) {
@@ -1902,10 +2192,7 @@ void PlainTextEdit::paintEvent(QPaintEvent *e)
         lineRect.adjust(0, 0, -1, -1);
 
         QString replacement = QLatin1String("...");
-        QString rectReplacement = QLatin1String(" ") + replacement + QLatin1String("); ");
-
-        const QFontMetrics fm(document()->defaultFont());
-        QRectF collapseRect(lineRect.right() + 12, lineRect.top(), fm.width(rectReplacement), lineRect.height());
+        QRectF collapseRect(lineRect.right() + 12, lineRect.top(), mFoldMarkerWidth, lineRect.height());
         painter.setRenderHint(QPainter::Antialiasing, true);
         painter.translate(.5, .5);
         painter.drawRoundedRect(collapseRect.adjusted(0, 0, 0, -1), 3, 3);
@@ -1958,6 +2245,28 @@ void PlainTextEdit::wheelEvent(QWheelEvent *event)
   QPlainTextEdit::wheelEvent(event);
 }
 
+/*!
+ * \brief PlainTextEdit::viewportEvent
+ * Shows the message of the diagnostic under the mouse as tooltip.
+ * \param event
+ * \return
+ */
+bool PlainTextEdit::viewportEvent(QEvent *event)
+{
+  if (event->type() == QEvent::ToolTip && !mDiagnostics.isEmpty()) {
+    QHelpEvent *pHelpEvent = static_cast<QHelpEvent*>(event);
+    int position = cursorForPosition(pHelpEvent->pos()).position();
+    foreach (const QTextEdit::ExtraSelection &diagnostic, mDiagnostics) {
+      if (position >= diagnostic.cursor.selectionStart() && position <= diagnostic.cursor.selectionEnd()) {
+        QToolTip::showText(pHelpEvent->globalPos(), diagnostic.format.toolTip(), viewport());
+        return true;
+      }
+    }
+    QToolTip::hideText();
+  }
+  return QPlainTextEdit::viewportEvent(event);
+}
+
 /*!
  * \class BaseEditor
  * Base class for all editors.
@@ -2429,6 +2738,11 @@ FindReplaceWidget::FindReplaceWidget(BaseEditor *pBaseEditor)
   mpCaseSensitiveCheckBox = new QCheckBox(tr("Case Sensitive"));
   mpWholeWordCheckBox = new QCheckBox(tr("Whole Words"));
   mpRegularExpressionCheckBox = new QCheckBox(tr("Regular Expressions"));
+  mpHighlightAllCheckBox = new QCheckBox(tr("Highlight All"));
+  connect(mpCaseSensitiveCheckBox, SIGNAL(toggled(bool)), SLOT(scheduleHighlightAllMatches()));
+  connect(mpWholeWordCheckBox, SIGNAL(toggled(bool)), SLOT(scheduleHighlightAllMatches()));
+  connect(mpRegularExpressionCheckBox, SIGNAL(toggled(bool)), SLOT(scheduleHighlightAllMatches()));
+  connect(mpHighlightAllCheckBox, SIGNAL(toggled(bool)), SLOT(scheduleHighlightAllMatches()));
   // Replace & replace all buttons
   mpReplaceButton = new QPushButton(tr("Replace"));
   connect(mpReplaceButton, SIGNAL(clicked()), this, SLOT(replace()));
@@ -2439,6 +2753,7 @@ FindReplaceWidget::FindReplaceWidget(BaseEditor *pBaseEditor)
   pOptionsHorizontalLayout->addWidget(mpCaseSensitiveCheckBox);
   pOptionsHorizontalLayout->addWidget(mpWholeWordCheckBox);
   pOptionsHorizontalLayout->addWidget(mpRegularExpressionCheckBox);
+  pOptionsHorizontalLayout->addWidget(mpHighlightAllCheckBox);
   pOptionsHorizontalLayout->addWidget(mpReplaceButton);
   pOptionsHorizontalLayout->addWidget(mpReplaceAllButton);
   // set main layout
@@ -2456,6 +2771,15 @@ FindReplaceWidget::FindReplaceWidget(BaseEditor *pBaseEditor)
   // set tab order
   setTabOrder(mpFindComboBox, mpReplaceWithTextBox);
   setTabOrder(mpReplaceWithTextBox, mpFindPreviousButton);
+  // the matches are searched in a background thread when the user stops typing.
+  mpHighlightAllTimer = new QTimer(this);
+  mpHighlightAllTimer->setSingleShot(true);
+  mpHighlightAllTimer->setInterval(250);
+  connect(mpHighlightAllTimer, SIGNAL(timeout()), SLOT(highlightAllMatches()));
+  mpHighlightAllWatcher = new QFutureWatcher<QList<TextMatch> >(this);
+  connect(mpHighlightAllWatcher, SIGNAL(finished()), SLOT(allMatchesFound()));
+  mHighlightAllRevision = -1;
+  connect(mpBaseEditor->getPlainTextEdit()->document(), SIGNAL(contentsChanged()), SLOT(scheduleHighlightAllMatches()));
 }
 
 /*!
@@ -2476,6 +2800,7 @@ void FindReplaceWidget::show()
   mpFindComboBox->setFocus();
   mpFindComboBox->lineEdit()->selectAll();
   setVisible(true);
+  scheduleHighlightAllMatches();
 }
 
 /*!
@@ -2518,6 +2843,92 @@ void FindReplaceWidget::saveFindTextToSettings(QString textToFind)
   pSettings->setValue("FindReplaceDialog/textsToFind", texts);
 }
 
+/*!
+ * \brief FindReplaceWidget::findMatches
+ * Finds all the matches of the expression in a single pass over the text.
+ * The text is searched line by line so the expression matches the same way as QTextDocument::find.
+ * Empty matches are skipped. The function only uses its arguments so it can run in a background thread.
+ * \param text
+ * \param expression
+ * \param captureTexts - if true then the captured texts of each match are saved.
+ * \return the matches sorted by position.
+ */
+QList<TextMatch> FindReplaceWidget::findMatches(const QString &text, QRegExp expression, bool captureTexts)
+{
+  QList<TextMatch> matches;
+  if (expression.isEmpty() || !expression.isValid()) {
+    return matches;
+  }
+  int lineStart = 0;
+  while (lineStart <= text.size()) {
+    int lineEnd = text.indexOf(QLatin1Char('\n'), lineStart);
+    if (lineEnd < 0) {
+      lineEnd = text.size();
+    }
+    const QString line = text.mid(lineStart, lineEnd - lineStart);
+    int index = 0;
+    while ((index = expression.indexIn(line, index)) >= 0) {
+      const int length = expression.matchedLength();
+      if (length > 0) {
+        TextMatch match(lineStart + index, length);
+        if (captureTexts) {
+          match.mCapturedTexts = expression.capturedTexts();
+        }
+        matches.append(match);
+      }
+      index += qMax(length, 1);
+    }
+    lineStart = lineEnd + 1;
+  }
+  return matches;
+}
+
+/*!
+ * \brief FindReplaceWidget::searchExpression
+ * Returns the expression for the find text and the selected options.
+ * The plain text is escaped so find, replace and replace all use the same matching.
+ * \return
+ */
+QRegExp FindReplaceWidget::searchExpression() const
+{
+  QString pattern = mpFindComboBox->currentText();
+  if (!mpRegularExpressionCheckBox->isChecked()) {
+    pattern = QRegExp::escape(pattern);
+  }
+  if (mpWholeWordCheckBox->isChecked()) {
+    pattern = QString("\\b(?:%1)\\b").arg(pattern);
+  }
+  return QRegExp(pattern, mpCaseSensitiveCheckBox->isChecked() ? Qt::CaseSensitive : Qt::CaseInsensitive);
+}
+
+/*!
+ * \brief FindReplaceWidget::replacementText
+ * Returns the replace with text.
+ * If regular expressions are used then \\1 to \\9 are replaced with the captured texts of the match.
+ * \param capturedTexts
+ * \return
+ */
+QString FindReplaceWidget::replacementText(const QStringList &capturedTexts) const
+{
+  const QString replaceWith = mpReplaceWithTextBox->text();
+  if (!mpRegularExpressionCheckBox->isChecked() || !replaceWith.contains(QLatin1Char('\\'))) {
+    return replaceWith;
+  }
+  QString replacement;
+  for (int i = 0 ; i < replaceWith.size() ; i++) {
+    if (replaceWith.at(i) == QLatin1Char('\\') && i + 1 < replaceWith.size() && replaceWith.at(i + 1).isDigit()) {
+      const int capture = replaceWith.at(i + 1).digitValue();
+      if (capture < capturedTexts.size()) {
+        replacement.append(capturedTexts.at(capture));
+        i++;
+        continue;
+      }
+    }
+    replacement.append(replaceWith.at(i));
+  }
+  return replacement;
+}
+
 /*!
  * \brief FindReplaceWidget::findText
  * Finds the text
@@ -2538,24 +2949,17 @@ void FindReplaceWidget::findText(bool forward)
   if (backward) {
     flags |= QTextDocument::FindBackward;
   }
-  if (mpCaseSensitiveCheckBox->isChecked()) {
-    flags |= QTextDocument::FindCaseSensitively;
-  }
-  if (mpWholeWordCheckBox->isChecked()) {
-    flags |= QTextDocument::FindWholeWords;
-  }
-
-  if (mpRegularExpressionCheckBox->isChecked()) {
-    QRegExp reg(textToFind, (mpCaseSensitiveCheckBox->isChecked() ? Qt::CaseSensitive : Qt::CaseInsensitive));
-    currentTextCursor = mpBaseEditor->getPlainTextEdit()->document()->find(reg, currentTextCursor, flags);
-    mpBaseEditor->getPlainTextEdit()->setTextCursor(currentTextCursor);
+  // the case sensitivity and whole words options are part of the expression.
+  const QRegExp expression = searchExpression();
+  if (textToFind.isEmpty() || !expression.isValid()) {
+    return;
   }
 
-  QTextCursor newTextCursor = mpBaseEditor->getPlainTextEdit()->document()->find(textToFind, currentTextCursor, flags);
+  QTextCursor newTextCursor = mpBaseEditor->getPlainTextEdit()->document()->find(expression, currentTextCursor, flags);
   if (newTextCursor.isNull()) {
     QTextCursor ac(mpBaseEditor->getPlainTextEdit()->document());
     ac.movePosition(flags & QTextDocument::FindBackward ? QTextCursor::End : QTextCursor::Start);
-    newTextCursor = mpBaseEditor->getPlainTextEdit()->document()->find(textToFind, ac, flags);
+    newTextCursor = mpBaseEditor->getPlainTextEdit()->document()->find(expression, ac, flags);
     if (newTextCursor.isNull()) {
       newTextCursor = currentTextCursor;
     }
@@ -2588,6 +2992,8 @@ void FindReplaceWidget::findNext()
  */
 bool FindReplaceWidget::close()
 {
+  mpHighlightAllTimer->stop();
+  mpBaseEditor->getPlainTextEdit()->setSearchMatches(QList<TextMatch>());
   bool closed = QWidget::close();
   mpBaseEditor->getPlainTextEdit()->setFocus(Qt::ActiveWindowFocusReason);
   return closed;
@@ -2599,19 +3005,12 @@ bool FindReplaceWidget::close()
  */
 void FindReplaceWidget::replace()
 {
-  int compareString(0);
-  if(mpCaseSensitiveCheckBox->isChecked()) {
-    compareString = Qt::CaseSensitive;
-  } else {
-    compareString = Qt::CaseInsensitive;
-  }
-  int same = mpBaseEditor->getPlainTextEdit()->textCursor().selectedText().compare(mpFindComboBox->currentText(),( Qt::CaseSensitivity)compareString );
-  if (mpBaseEditor->getPlainTextEdit()->textCursor().hasSelection() && same == 0) {
-    mpBaseEditor->getPlainTextEdit()->textCursor().insertText(mpReplaceWithTextBox->text());
-    findNext();
-  } else {
-    findNext();
+  QTextCursor cursor = mpBaseEditor->getPlainTextEdit()->textCursor();
+  QRegExp expression = searchExpression();
+  if (cursor.hasSelection() && expression.isValid() && expression.exactMatch(cursor.selectedText())) {
+    cursor.insertText(replacementText(expression.capturedTexts()));
   }
+  findNext();
 }
 
 /*!
@@ -2620,28 +3019,38 @@ void FindReplaceWidget::replace()
  */
 void FindReplaceWidget::replaceAll()
 {
-  // move cursor to start of text
-  QTextCursor cursor = mpBaseEditor->getPlainTextEdit()->textCursor();
-  cursor.movePosition(QTextCursor::Start);
-  mpBaseEditor->getPlainTextEdit()->setTextCursor(cursor);
-
-  QTextDocument::FindFlags flags;
-  if (mpCaseSensitiveCheckBox->isChecked()) {
-    flags |= QTextDocument::FindCaseSensitively;
-  }
-  if (mpWholeWordCheckBox->isChecked()) {
-    flags |= QTextDocument::FindWholeWords;
+  const QString textToFind = mpFindComboBox->currentText();
+  if (textToFind.isEmpty()) {
+    return;
   }
   // save the find text in settings
-  saveFindTextToSettings(mpFindComboBox->currentText());
-  // replace all
-  int i=0;
-  mpBaseEditor->getPlainTextEdit()->textCursor().beginEditBlock();
-  while (mpBaseEditor->getPlainTextEdit()->find(mpFindComboBox->currentText(), flags)) {
-    mpBaseEditor->getPlainTextEdit()->textCursor().insertText(mpReplaceWithTextBox->text());
-    i++;
+  saveFindTextToSettings(textToFind);
+  /* Scan the text once and build the replaced text from the first to the last match.
+   * Replacing it with one insertText makes a single undoable edit, so the document is laid out and highlighted only once.
+   */
+  PlainTextEdit *pPlainTextEdit = mpBaseEditor->getPlainTextEdit();
+  const QString text = pPlainTextEdit->toPlainText();
+  QList<TextMatch> matches = findMatches(text, searchExpression(), mpRegularExpressionCheckBox->isChecked());
+  if (matches.isEmpty()) {
+    return;
   }
-  mpBaseEditor->getPlainTextEdit()->textCursor().endEditBlock();
+  const int start = matches.first().mPosition;
+  const int end = matches.last().mPosition + matches.last().mLength;
+  QString replacedText;
+  replacedText.reserve(end - start);
+  int position = start;
+  foreach (const TextMatch &match, matches) {
+    replacedText.append(text.midRef(position, match.mPosition - position));
+    replacedText.append(replacementText(match.mCapturedTexts));
+    position = match.mPosition + match.mLength;
+  }
+  QTextCursor cursor = pPlainTextEdit->textCursor();
+  cursor.beginEditBlock();
+  cursor.setPosition(start);
+  cursor.setPosition(end, QTextCursor::KeepAnchor);
+  cursor.insertText(replacedText);
+  cursor.endEditBlock();
+  pPlainTextEdit->setTextCursor(cursor);
 }
 
 /*!
@@ -2694,6 +3103,48 @@ void FindReplaceWidget::regularExpressionSelected(bool selected)
 void FindReplaceWidget::textToFindChanged()
 {
   mpFindNextButton->setEnabled(mpFindComboBox->currentText().size() > 0);
+  scheduleHighlightAllMatches();
+}
+
+/*!
+ * \brief FindReplaceWidget::scheduleHighlightAllMatches
+ * Restarts the timer to highlight all the matches.
+ * Called when the find text, the find options or the text of the editor is changed.
+ */
+void FindReplaceWidget::scheduleHighlightAllMatches()
+{
+  if (mpHighlightAllCheckBox->isChecked() && isVisible()) {
+    mpHighlightAllTimer->start();
+  } else {
+    mpHighlightAllTimer->stop();
+    mpBaseEditor->getPlainTextEdit()->setSearchMatches(QList<TextMatch>());
+  }
+}
+
+/*!
+ * \brief FindReplaceWidget::highlightAllMatches
+ * Finds all the matches in a background thread.
+ * Setting a new future on the watcher discards the result of the search that is still running.
+ */
+void FindReplaceWidget::highlightAllMatches()
+{
+  QTextDocument *pTextDocument = mpBaseEditor->getPlainTextEdit()->document();
+  mHighlightAllRevision = pTextDocument->revision();
+  mpHighlightAllWatcher->setFuture(QtConcurrent::run(&FindReplaceWidget::findMatches, pTextDocument->toPlainText(), searchExpression(), false));
+}
+
+/*!
+ * \brief FindReplaceWidget::allMatchesFound
+ * Slot activated when the background search is finished.
+ * The matches are discarded if the text is changed in the meantime. The change has already scheduled a new search.
+ */
+void FindReplaceWidget::allMatchesFound()
+{
+  if (mpHighlightAllWatcher->isCanceled() || mHighlightAllRevision != mpBaseEditor->getPlainTextEdit()->document()->revision()
+      || !mpHighlightAllCheckBox->isChecked() || !isVisible()) {
+    return;
+  }
+  mpBaseEditor->getPlainTextEdit()->setSearchMatches(mpHighlightAllWatcher->result());
 }
 
 /*!
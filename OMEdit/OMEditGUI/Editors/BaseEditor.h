@@ -42,6 +42,8 @@
 #include <QCheckBox>
 #include <QToolButton>
 #include <QStandardItemModel>
+#include <QTimer>
+#include <QFutureWatcher>
 
 class ModelWidget;
 class InfoBar;
@@ -191,6 +193,28 @@ private:
   QString m_multiLineEnd;
 };
 
+/*!
+ * \brief The FoldMap class
+ * Keeps the ranges of hidden blocks sorted by block number so that the next visible block is found in O(log n)
+ * instead of walking the hidden blocks. The ranges are built again when the folding changes.
+ */
+class FoldMap
+{
+public:
+  FoldMap() : mValid(false), mBlockCount(0) {}
+  void invalidate() {mValid = false;}
+  int blockCount() const {return mBlockCount;}
+  void blockCountChanged(int blockNumber, int blockCount);
+  int nextVisibleBlockNumber(QTextDocument *pTextDocument, int blockNumber);
+private:
+  bool mValid;
+  int mBlockCount;
+  // the first and last block numbers of the hidden ranges
+  QVector<QPair<int, int> > mHiddenRanges;
+
+  void build(QTextDocument *pTextDocument);
+};
+
 class BaseEditorDocumentLayout : public QPlainTextDocumentLayout
 {
   Q_OBJECT
@@ -206,8 +230,14 @@ public:
   static void setFolded(const QTextBlock &block, bool folded);
   static TextBlockUserData *testUserData(const QTextBlock &block);
   static TextBlockUserData *userData(const QTextBlock &block);
+  static void setBlockVisible(const QTextBlock &block, bool visible);
+  QTextBlock nextVisibleBlock(const QTextBlock &block);
   void emitDocumentSizeChanged() {emit documentSizeChanged(documentSize());}
   bool mHasBreakpoint;
+protected:
+  virtual void documentChanged(int from, int charsRemoved, int charsAdded);
+private:
+  FoldMap mFoldMap;
 };
 
 class CompleterItem
@@ -236,6 +266,16 @@ public:
 
 Q_DECLARE_METATYPE(CompleterItem)
 
+class TextMatch
+{
+public:
+  TextMatch() : mPosition(0), mLength(0) {}
+  TextMatch(int position, int length) : mPosition(position), mLength(length) {}
+  int mPosition;
+  int mLength;
+  QStringList mCapturedTexts;
+};
+
 class BaseEditor;
 class QCompleter;
 class PlainTextEdit : public QPlainTextEdit
@@ -256,6 +296,10 @@ public:
   void lineNumberAreaPaintEvent(QPaintEvent *event);
   void lineNumberAreaMouseEvent(QMouseEvent *event);
   void goToLineNumber(int lineNumber);
+  void foldBlocks(int firstBlockNumber, int lastBlockNumber);
+  void setBlocksVisible(int firstBlockNumber, int lastBlockNumber, bool visible);
+  void setDiagnostics(const QList<QTextEdit::ExtraSelection> &diagnostics);
+  void setSearchMatches(const QList<TextMatch> &searchMatches);
   QCompleter *completer();
   bool isUndoAvailable() {return mIsUndoAvailable;}
   bool isRedoAvailable() {return mIsRedoAvailable;}
@@ -273,9 +317,20 @@ private:
   bool mIsUndoAvailable;
   bool mIsRedoAvailable;
   QString mCompletionCharacters;
+  QList<QTextEdit::ExtraSelection> mDiagnostics;
+  QList<TextMatch> mSearchMatches;
+  // the font metrics used for painting, computed again only when the font changes
+  QFont mMetricsFont;
+  int mDigitWidth;
+  int mLineSpacing;
+  int mFontHeight;
+  int mFoldBoxWidth;
+  int mFoldMarkerWidth;
 
+  void updateFontMetrics(bool force = false);
   void highlightCurrentLine();
   void highlightParentheses();
+  void highlightSearchMatches();
   void setLineWrapping();
   QString plainTextFromSelection(const QTextCursor &cursor) const;
   static QString convertToPlainText(const QString &txt);
@@ -313,6 +368,7 @@ protected:
   virtual void focusOutEvent(QFocusEvent *event);
   void paintEvent(QPaintEvent *e);
   void wheelEvent(QWheelEvent *event);
+  virtual bool viewportEvent(QEvent *event);
 };
 
 class BaseEditor : public QWidget
@@ -401,6 +457,9 @@ public:
   void show();
   void readFindTextFromSettings();
   void saveFindTextToSettings(QString textToFind);
+  static QList<TextMatch> findMatches(const QString &text, QRegExp expression, bool captureTexts);
+  void setTextToFind(const QString &textToFind) {mpFindComboBox->setEditText(textToFind);}
+  void setReplaceWithText(const QString &replaceWithText) {mpReplaceWithTextBox->setText(replaceWithText);}
 private:
   BaseEditor *mpBaseEditor;
   Label *mpFindLabel;
@@ -413,9 +472,15 @@ private:
   QCheckBox *mpCaseSensitiveCheckBox;
   QCheckBox *mpWholeWordCheckBox;
   QCheckBox *mpRegularExpressionCheckBox;
+  QCheckBox *mpHighlightAllCheckBox;
   QPushButton *mpReplaceButton;
   QPushButton *mpReplaceAllButton;
+  QTimer *mpHighlightAllTimer;
+  QFutureWatcher<QList<TextMatch> > *mpHighlightAllWatcher;
+  int mHighlightAllRevision;
 
+  QRegExp searchExpression() const;
+  QString replacementText(const QStringList &capturedTexts) const;
   void findText(bool next);
 public slots:
   void findPrevious();
@@ -429,6 +494,9 @@ protected slots:
   void validateRegularExpression(const QString &text);
   void regularExpressionSelected(bool selected);
   void textToFindChanged();
+  void scheduleHighlightAllMatches();
+  void highlightAllMatches();
+  void allMatchesFound();
 };
 
 class GotoLineDialog : public QDialog
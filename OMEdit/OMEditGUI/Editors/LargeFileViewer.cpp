@@ -0,0 +1,790 @@
+/*
+ * This file is part of OpenModelica.
+ *
+ * Copyright (c) 1998-CurrentYear, Open Source Modelica Consortium (OSMC),
+ * c/o Linköpings universitet, Department of Computer and Information Science,
+ * SE-58183 Linköping, Sweden.
+ *
+ * All rights reserved.
+ *
+ * THIS PROGRAM IS PROVIDED UNDER THE TERMS OF GPL VERSION 3 LICENSE OR
+ * THIS OSMC PUBLIC LICENSE (OSMC-PL) VERSION 1.2.
+ * ANY USE, REPRODUCTION OR DISTRIBUTION OF THIS PROGRAM CONSTITUTES RECIPIENT'S ACCEPTANCE
+ * OF THE OSMC PUBLIC LICENSE OR THE GPL VERSION 3, ACCORDING TO RECIPIENTS CHOICE.
+ *
+ * The OpenModelica software and the Open Source Modelica
+ * Consortium (OSMC) Public License (OSMC-PL) are obtained
+ * from OSMC, either from the above address,
+ * from the URLs: http://www.ida.liu.se/projects/OpenModelica or
+ * http://www.openmodelica.org, and in the OpenModelica distribution.
+ * GNU version 3 is obtained from: http://www.gnu.org/copyleft/gpl.html.
+ *
+ * This program is distributed WITHOUT ANY WARRANTY; without
+ * even the implied warranty of  MERCHANTABILITY or FITNESS
+ * FOR A PARTICULAR PURPOSE, EXCEPT AS EXPRESSLY SET FORTH
+ * IN THE BY RECIPIENT SELECTED SUBSIDIARY LICENSE CONDITIONS OF OSMC-PL.
+ *
+ * See the full OSMC Public License conditions for more details.
+ *
+ */
+
+#include "LargeFileViewer.h"
+#include "Options/OptionsDialog.h"
+#include "Modeling/MessagesWidget.h"
+#include "Util/Helper.h"
+
+#include <QApplication>
+#include <QClipboard>
+#include <QFileInfo>
+#include <QInputDialog>
+#include <QPainter>
+#include <QScrollBar>
+#include <QtConcurrentRun>
+
+#include <algorithm>
+#include <cstring>
+
+/*!
+ * \class LargeFileView
+ * Read-only view of a large file.
+ * The line offsets are indexed in a background thread and only the visible lines are read, decoded and painted.
+ * The file is not kept open or mapped since the generated files are rewritten while they are shown.
+ * The file is indexed again when it changes.
+ */
+/*!
+ * \brief LargeFileView::LargeFileView
+ * \param pParent
+ */
+LargeFileView::LargeFileView(QWidget *pParent)
+  : QAbstractScrollArea(pParent), mFileSize(0), mFindLength(0), mCurrentLine(0), mMatchOffset(-1), mMatchLength(0), mMaxLineWidth(0)
+{
+  setFocusPolicy(Qt::StrongFocus);
+  QFont font;
+  font.setFamily(OptionsDialog::instance()->getTextEditorPage()->getFontFamilyComboBox()->currentFont().family());
+  font.setPointSizeF(OptionsDialog::instance()->getTextEditorPage()->getFontSizeSpinBox()->value());
+  setFont(font);
+  mTabSize = OptionsDialog::instance()->getTextEditorPage()->getTabSizeSpinBox()->value();
+  mpFileSystemWatcher = new QFileSystemWatcher(this);
+  connect(mpFileSystemWatcher, SIGNAL(fileChanged(QString)), SLOT(fileChanged()));
+  // the file is usually written in several steps so wait until the changes settle before indexing it again.
+  mpReloadTimer = new QTimer(this);
+  mpReloadTimer->setSingleShot(true);
+  mpReloadTimer->setInterval(500);
+  connect(mpReloadTimer, SIGNAL(timeout()), SLOT(reloadFile()));
+  mpLineIndexWatcher = new QFutureWatcher<QVector<qint64> >(this);
+  connect(mpLineIndexWatcher, SIGNAL(finished()), SLOT(linesIndexed()));
+  mpFindWatcher = new QFutureWatcher<qint64>(this);
+  connect(mpFindWatcher, SIGNAL(finished()), SLOT(textFound()));
+}
+
+/*!
+ * \brief LargeFileView::~LargeFileView
+ * Waits for the background threads so their results are not delivered to a deleted view.
+ */
+LargeFileView::~LargeFileView()
+{
+  mpLineIndexWatcher->waitForFinished();
+  mpFindWatcher->waitForFinished();
+}
+
+/*!
+ * \brief LargeFileView::openFile
+ * Checks that the file can be read, starts watching it and starts indexing its lines in a background thread.
+ * \param fileName
+ * \return false if the file can't be opened.
+ */
+bool LargeFileView::openFile(const QString &fileName)
+{
+  QFile file(fileName);
+  if (!file.open(QIODevice::ReadOnly)) {
+    mErrorString = file.errorString();
+    return false;
+  }
+  file.close();
+  mFileName = fileName;
+  mpFileSystemWatcher->addPath(mFileName);
+  reloadFile();
+  return true;
+}
+
+/*!
+ * \brief LargeFileView::goToLineNumber
+ * Scrolls to the line and makes it the current line.
+ * \param lineNumber - the line number starting from 1.
+ */
+void LargeFileView::goToLineNumber(int lineNumber)
+{
+  if (!isIndexed()) {
+    return;
+  }
+  const int line = qBound(0, lineNumber - 1, lineCount() - 1);
+  verticalScrollBar()->setValue(line - visibleLineCount() / 2);
+  setCurrentLine(line);
+}
+
+/*!
+ * \brief LargeFileView::findText
+ * Finds the text from the current match or line in a background thread.
+ * The search wraps around the end of the file. A new search is only started when the previous one is finished.
+ * \param text
+ * \param forward - direction flag.
+ * \param caseSensitive - only ASCII letters are compared case insensitively.
+ */
+void LargeFileView::findText(const QString &text, bool forward, bool caseSensitive)
+{
+  if (!isIndexed() || text.isEmpty() || mpFindWatcher->isRunning()) {
+    return;
+  }
+  QByteArray bytes = text.toUtf8();
+  if (!caseSensitive) {
+    for (int i = 0 ; i < bytes.size() ; i++) {
+      if (bytes.at(i) >= 'A' && bytes.at(i) <= 'Z') {
+        bytes[i] = bytes.at(i) + ('a' - 'A');
+      }
+    }
+  }
+  qint64 from;
+  if (mMatchOffset >= 0 && lineAt(mMatchOffset) == mCurrentLine) {
+    from = forward ? mMatchOffset + 1 : mMatchOffset;
+  } else {
+    from = forward ? mLineOffsets.at(mCurrentLine) : lineEnd(mCurrentLine);
+  }
+  QTextDocument::FindFlags flags;
+  if (!forward) {
+    flags |= QTextDocument::FindBackward;
+  }
+  if (caseSensitive) {
+    flags |= QTextDocument::FindCaseSensitively;
+  }
+  mFindLength = bytes.size();
+  mpFindWatcher->setFuture(QtConcurrent::run(&LargeFileView::findBytes, mFileName, bytes, from, flags));
+}
+
+/*!
+ * \brief LargeFileView::indexLines
+ * Returns the offsets of the lines in the file followed by the size of the file.
+ * The file is read in chunks of ChunkSize bytes.
+ * The function only uses its arguments so it can run in a background thread.
+ * \param fileName
+ * \return
+ */
+QVector<qint64> LargeFileView::indexLines(const QString &fileName)
+{
+  QVector<qint64> lineOffsets;
+  lineOffsets.append(0);
+  qint64 size = 0;
+  QFile file(fileName);
+  if (file.open(QIODevice::ReadOnly)) {
+    QByteArray chunk;
+    while (!(chunk = file.read(ChunkSize)).isEmpty()) {
+      const char *pData = chunk.constData();
+      const char *pPosition = pData;
+      const char *pEnd = pData + chunk.size();
+      while (pPosition < pEnd) {
+        const char *pNewLine = static_cast<const char*>(memchr(pPosition, '\n', pEnd - pPosition));
+        if (!pNewLine) {
+          break;
+        }
+        pPosition = pNewLine + 1;
+        lineOffsets.append(size + (pPosition - pData));
+      }
+      size += chunk.size();
+    }
+  }
+  lineOffsets.append(size);
+  return lineOffsets;
+}
+
+/*!
+ * \brief bytesMatchAt
+ * Returns true if the bytes are found at the position.
+ * If the search is case insensitive then the bytes are expected in lower case.
+ * \param pData
+ * \param position
+ * \param bytes
+ * \param caseSensitive
+ * \return
+ */
+static bool bytesMatchAt(const char *pData, qint64 position, const QByteArray &bytes, bool caseSensitive)
+{
+  for (int i = 0 ; i < bytes.size() ; i++) {
+    char character = pData[position + i];
+    if (!caseSensitive && character >= 'A' && character <= 'Z') {
+      character += 'a' - 'A';
+    }
+    if (character != bytes.at(i)) {
+      return false;
+    }
+  }
+  return true;
+}
+
+/*!
+ * \brief findBytesInRange
+ * Finds the bytes starting at a position between first and last. The file is read in chunks of ChunkSize positions.
+ * \param file
+ * \param bytes
+ * \param first
+ * \param last
+ * \param backward - if true the last match is returned otherwise the first.
+ * \param caseSensitive
+ * \return the offset of the match or -1.
+ */
+static qint64 findBytesInRange(QFile &file, const QByteArray &bytes, qint64 first, qint64 last, bool backward, bool caseSensitive)
+{
+  const qint64 chunkSize = LargeFileView::ChunkSize;
+  if (backward) {
+    for (qint64 chunkEnd = last ; chunkEnd >= first ; chunkEnd -= chunkSize) {
+      const qint64 chunkStart = qMax(first, chunkEnd - chunkSize + 1);
+      if (!file.seek(chunkStart)) {
+        return -1;
+      }
+      // the chunk includes the bytes of the match starting at chunkEnd
+      const QByteArray chunk = file.read(chunkEnd - chunkStart + bytes.size());
+      for (qint64 position = qMin(chunkEnd - chunkStart, qint64(chunk.size() - bytes.size())) ; position >= 0 ; position--) {
+        if (bytesMatchAt(chunk.constData(), position, bytes, caseSensitive)) {
+          return chunkStart + position;
+        }
+      }
+    }
+  } else {
+    for (qint64 chunkStart = first ; chunkStart <= last ; chunkStart += chunkSize) {
+      const qint64 chunkEnd = qMin(last, chunkStart + chunkSize - 1);
+      if (!file.seek(chunkStart)) {
+        return -1;
+      }
+      const QByteArray chunk = file.read(chunkEnd - chunkStart + bytes.size());
+      const qint64 lastPosition = qMin(chunkEnd - chunkStart, qint64(chunk.size() - bytes.size()));
+      for (qint64 position = 0 ; position <= lastPosition ; position++) {
+        if (bytesMatchAt(chunk.constData(), position, bytes, caseSensitive)) {
+          return chunkStart + position;
+        }
+      }
+    }
+  }
+  return -1;
+}
+
+/*!
+ * \brief LargeFileView::findBytes
+ * Finds the bytes in the file. The search wraps around the end of the file.
+ * The function only uses its arguments so it can run in a background thread.
+ * \param fileName
+ * \param bytes
+ * \param from - the forward search starts at this offset. The backward search finds a match before it.
+ * \param flags - only FindBackward and FindCaseSensitively are used.
+ * \return the offset of the match or -1.
+ */
+qint64 LargeFileView::findBytes(const QString &fileName, const QByteArray &bytes, qint64 from, QTextDocument::FindFlags flags)
+{
+  QFile file(fileName);
+  if (bytes.isEmpty() || !file.open(QIODevice::ReadOnly)) {
+    return -1;
+  }
+  const bool caseSensitive = flags.testFlag(QTextDocument::FindCaseSensitively);
+  const qint64 last = file.size() - bytes.size();
+  if (last < 0) {
+    return -1;
+  }
+  from = qBound(qint64(0), from, last + 1);
+  qint64 position;
+  if (!flags.testFlag(QTextDocument::FindBackward)) {
+    position = findBytesInRange(file, bytes, from, last, false, caseSensitive);
+    if (position < 0) {
+      position = findBytesInRange(file, bytes, 0, from - 1, false, caseSensitive);
+    }
+  } else {
+    position = findBytesInRange(file, bytes, 0, from - 1, true, caseSensitive);
+    if (position < 0) {
+      position = findBytesInRange(file, bytes, from, last, true, caseSensitive);
+    }
+  }
+  return position;
+}
+
+/*!
+ * \brief LargeFileView::lineAt
+ * Returns the line containing the offset.
+ * \param offset
+ * \return
+ */
+int LargeFileView::lineAt(qint64 offset) const
+{
+  const int line = std::upper_bound(mLineOffsets.constBegin(), mLineOffsets.constEnd(), offset) - mLineOffsets.constBegin() - 1;
+  return qBound(0, line, lineCount() - 1);
+}
+
+/*!
+ * \brief LargeFileView::lineEnd
+ * Returns the offset after the end of the line including its new line character.
+ * \param line
+ * \return
+ */
+qint64 LargeFileView::lineEnd(int line) const
+{
+  return mLineOffsets.at(line + 1);
+}
+
+/*!
+ * \brief LargeFileView::lineText
+ * Reads and decodes the text between the offsets. At most MaxLineLength bytes are read.
+ * The new line characters are removed and the tabs are replaced with spaces.
+ * If the file has changed since it was indexed then less text is returned.
+ * \param file - the opened file.
+ * \param start
+ * \param end
+ * \return
+ */
+QString LargeFileView::lineText(QFile &file, qint64 start, qint64 end) const
+{
+  end = qMin(end, start + MaxLineLength);
+  if (end <= start || !file.isOpen() || !file.seek(start)) {
+    return QString();
+  }
+  QByteArray bytes = file.read(end - start);
+  while (bytes.endsWith('\n') || bytes.endsWith('\r')) {
+    bytes.chop(1);
+  }
+  QString text = QString::fromUtf8(bytes);
+  return text.replace(QLatin1Char('\t'), QString(mTabSize, QLatin1Char(' ')));
+}
+
+/*!
+ * \brief LargeFileView::lineText
+ * Reads and decodes the text of the line.
+ * \param line
+ * \return
+ */
+QString LargeFileView::lineText(int line) const
+{
+  QFile file(mFileName);
+  file.open(QIODevice::ReadOnly);
+  return lineText(file, mLineOffsets.at(line), lineEnd(line));
+}
+
+/*!
+ * \brief LargeFileView::lineNumberAreaWidth
+ * Returns the width of the line numbers.
+ * \return
+ */
+int LargeFileView::lineNumberAreaWidth() const
+{
+  const int digits = QString::number(qMax(1, lineCount())).size();
+  return 8 + fontMetrics().width(QLatin1Char('9')) * digits;
+}
+
+/*!
+ * \brief LargeFileView::visibleLineCount
+ * Returns the number of lines that fit in the viewport.
+ * \return
+ */
+int LargeFileView::visibleLineCount() const
+{
+  return qMax(1, viewport()->height() / fontMetrics().height());
+}
+
+/*!
+ * \brief LargeFileView::updateScrollBars
+ * Sets the range of the scroll bars. The vertical scroll bar scrolls by lines.
+ */
+void LargeFileView::updateScrollBars()
+{
+  const int pageLines = visibleLineCount();
+  verticalScrollBar()->setRange(0, qMax(0, lineCount() - pageLines));
+  verticalScrollBar()->setPageStep(pageLines);
+  const int textWidth = viewport()->width() - lineNumberAreaWidth() - 4;
+  horizontalScrollBar()->setRange(0, qMax(0, mMaxLineWidth - textWidth));
+  horizontalScrollBar()->setPageStep(qMax(1, textWidth));
+  horizontalScrollBar()->setSingleStep(fontMetrics().width(QLatin1Char(' ')) * 4);
+}
+
+/*!
+ * \brief LargeFileView::setCurrentLine
+ * Sets the current line and scrolls to it if it is not visible.
+ * \param line
+ */
+void LargeFileView::setCurrentLine(int line)
+{
+  if (!isIndexed()) {
+    return;
+  }
+  mCurrentLine = qBound(0, line, lineCount() - 1);
+  const int firstLine = verticalScrollBar()->value();
+  const int pageLines = visibleLineCount();
+  if (mCurrentLine < firstLine) {
+    verticalScrollBar()->setValue(mCurrentLine);
+  } else if (mCurrentLine >= firstLine + pageLines) {
+    verticalScrollBar()->setValue(mCurrentLine - pageLines + 1);
+  }
+  viewport()->update();
+}
+
+/*!
+ * \brief LargeFileView::fileChanged
+ * Slot activated when the file is changed on disk. Starts the timer to index the file again.
+ */
+void LargeFileView::fileChanged()
+{
+  // the file is removed from the watcher if it is replaced by a new file.
+  if (!mpFileSystemWatcher->files().contains(mFileName) && QFile::exists(mFileName)) {
+    mpFileSystemWatcher->addPath(mFileName);
+  }
+  mpReloadTimer->start();
+}
+
+/*!
+ * \brief LargeFileView::reloadFile
+ * Indexes the lines of the file in a background thread if its size or modification time has changed.
+ */
+void LargeFileView::reloadFile()
+{
+  QFileInfo fileInfo(mFileName);
+  if (isIndexed() && fileInfo.size() == mFileSize && fileInfo.lastModified() == mLastModified) {
+    return;
+  }
+  // index again when the file changes while it is being indexed.
+  if (mpLineIndexWatcher->isRunning()) {
+    mpReloadTimer->start();
+    return;
+  }
+  mFileSize = fileInfo.size();
+  mLastModified = fileInfo.lastModified();
+  mpLineIndexWatcher->setFuture(QtConcurrent::run(&LargeFileView::indexLines, mFileName));
+}
+
+/*!
+ * \brief LargeFileView::linesIndexed
+ * Slot activated when the background indexing of the lines is finished.
+ */
+void LargeFileView::linesIndexed()
+{
+  mLineOffsets = mpLineIndexWatcher->result();
+  mCurrentLine = qBound(0, mCurrentLine, lineCount() - 1);
+  mMatchOffset = -1;
+  updateScrollBars();
+  viewport()->update();
+  emit lineIndexed(lineCount());
+}
+
+/*!
+ * \brief LargeFileView::textFound
+ * Slot activated when the background search is finished. Scrolls to the match.
+ */
+void LargeFileView::textFound()
+{
+  const qint64 offset = mpFindWatcher->result();
+  if (offset < 0) {
+    mMatchOffset = -1;
+    viewport()->update();
+    emit textNotFound();
+    return;
+  }
+  mMatchOffset = offset;
+  mMatchLength = mFindLength;
+  const int line = lineAt(offset);
+  setCurrentLine(line);
+  // scroll horizontally if the match is not visible
+  QFile file(mFileName);
+  file.open(QIODevice::ReadOnly);
+  const int matchX = fontMetrics().width(lineText(file, mLineOffsets.at(line), offset));
+  const int textWidth = viewport()->width() - lineNumberAreaWidth() - 4;
+  if (matchX < horizontalScrollBar()->value() || matchX > horizontalScrollBar()->value() + textWidth - 50) {
+    mMaxLineWidth = qMax(mMaxLineWidth, matchX + textWidth / 2);
+    updateScrollBars();
+    horizontalScrollBar()->setValue(matchX - textWidth / 2);
+  }
+  viewport()->update();
+}
+
+/*!
+ * \brief LargeFileView::paintEvent
+ * Paints the visible lines and their line numbers.
+ * \param pEvent
+ */
+void LargeFileView::paintEvent(QPaintEvent *pEvent)
+{
+  QPainter painter(viewport());
+  painter.fillRect(pEvent->rect(), palette().base());
+  const QFontMetrics fm(font());
+  const int lineHeight = fm.height();
+  const int lineNumberWidth = lineNumberAreaWidth();
+  const int x = lineNumberWidth + 4 - horizontalScrollBar()->value();
+  if (!isIndexed()) {
+    painter.setPen(palette().text().color());
+    painter.drawText(lineNumberWidth + 4, fm.ascent(), tr("Indexing lines..."));
+    return;
+  }
+  const int firstLine = verticalScrollBar()->value();
+  const int lastLine = qMin(firstLine + visibleLineCount() + 1, lineCount());
+  QFile file(mFileName);
+  file.open(QIODevice::ReadOnly);
+  int maxLineWidth = mMaxLineWidth;
+  painter.setClipRect(lineNumberWidth, 0, viewport()->width() - lineNumberWidth, viewport()->height());
+  for (int line = firstLine, y = 0 ; line < lastLine ; line++, y += lineHeight) {
+    const qint64 start = mLineOffsets.at(line);
+    const qint64 end = lineEnd(line);
+    if (line == mCurrentLine) {
+      painter.fillRect(QRect(0, y, viewport()->width(), lineHeight), QColor(232, 242, 254));
+    }
+    if (mMatchOffset >= start && mMatchOffset < end) {
+      const int matchX = x + fm.width(lineText(file, start, mMatchOffset));
+      const int matchWidth = fm.width(lineText(file, mMatchOffset, qMin(mMatchOffset + mMatchLength, end)));
+      painter.fillRect(QRect(matchX, y, matchWidth, lineHeight), QColor(255, 239, 11, 128));
+    }
+    const QString text = lineText(file, start, end);
+    painter.setPen(palette().text().color());
+    painter.drawText(x, y + fm.ascent(), text);
+    maxLineWidth = qMax(maxLineWidth, fm.width(text));
+  }
+  // line numbers
+  painter.setClipping(false);
+  painter.fillRect(QRect(0, 0, lineNumberWidth, viewport()->height()), QColor(240, 240, 240));
+  painter.setPen(Qt::darkGray);
+  for (int line = firstLine, y = 0 ; line < lastLine ; line++, y += lineHeight) {
+    painter.drawText(QRect(0, y, lineNumberWidth - 4, lineHeight), Qt::AlignRight, QString::number(line + 1));
+  }
+  // the horizontal scroll bar grows with the longest line seen so far.
+  if (maxLineWidth != mMaxLineWidth) {
+    mMaxLineWidth = maxLineWidth;
+    updateScrollBars();
+  }
+}
+
+/*!
+ * \brief LargeFileView::resizeEvent
+ * \param pEvent
+ */
+void LargeFileView::resizeEvent(QResizeEvent *pEvent)
+{
+  QAbstractScrollArea::resizeEvent(pEvent);
+  updateScrollBars();
+}
+
+/*!
+ * \brief LargeFileView::scrollContentsBy
+ * The lines are painted from the scroll bar values so just repaint.
+ * \param dx
+ * \param dy
+ */
+void LargeFileView::scrollContentsBy(int dx, int dy)
+{
+  Q_UNUSED(dx);
+  Q_UNUSED(dy);
+  viewport()->update();
+}
+
+/*!
+ * \brief LargeFileView::keyPressEvent
+ * Moves the current line. Ctrl+c copies the current line. Ctrl+f and Ctrl+l request the find and go to line.
+ * \param pEvent
+ */
+void LargeFileView::keyPressEvent(QKeyEvent *pEvent)
+{
+  bool controlModifier = pEvent->modifiers().testFlag(Qt::ControlModifier);
+  if (controlModifier && pEvent->key() == Qt::Key_F) {
+    emit findRequested();
+  } else if (controlModifier && pEvent->key() == Qt::Key_L) {
+    emit goToLineRequested();
+  } else if (controlModifier && pEvent->key() == Qt::Key_C) {
+    if (isIndexed()) {
+      QApplication::clipboard()->setText(lineText(mCurrentLine));
+    }
+  } else if (pEvent->key() == Qt::Key_Up) {
+    setCurrentLine(mCurrentLine - 1);
+  } else if (pEvent->key() == Qt::Key_Down) {
+    setCurrentLine(mCurrentLine + 1);
+  } else if (pEvent->key() == Qt::Key_PageUp) {
+    setCurrentLine(mCurrentLine - visibleLineCount());
+  } else if (pEvent->key() == Qt::Key_PageDown) {
+    setCurrentLine(mCurrentLine + visibleLineCount());
+  } else if (controlModifier && pEvent->key() == Qt::Key_Home) {
+    setCurrentLine(0);
+  } else if (controlModifier && pEvent->key() == Qt::Key_End) {
+    setCurrentLine(lineCount() - 1);
+  } else {
+    QAbstractScrollArea::keyPressEvent(pEvent);
+  }
+}
+
+/*!
+ * \brief LargeFileView::mousePressEvent
+ * Makes the clicked line the current line.
+ * \param pEvent
+ */
+void LargeFileView::mousePressEvent(QMouseEvent *pEvent)
+{
+  setCurrentLine(verticalScrollBar()->value() + pEvent->pos().y() / fontMetrics().height());
+  QAbstractScrollArea::mousePressEvent(pEvent);
+}
+
+/*!
+ * \class LargeFileViewer
+ * Read-only editor for files larger than LargeFileSize.
+ * The file is shown by LargeFileView. The PlainTextEdit of BaseEditor stays empty and hidden.
+ */
+/*!
+ * \brief LargeFileViewer::LargeFileViewer
+ * \param pParent
+ */
+LargeFileViewer::LargeFileViewer(QWidget *pParent)
+  : BaseEditor(pParent)
+{
+  mpPlainTextEdit->setReadOnly(true);
+  mpPlainTextEdit->hide();
+  mpLargeFileView = new LargeFileView;
+  mpPlainTextEdit->setFocusProxy(mpLargeFileView);
+  connect(mpLargeFileView, SIGNAL(lineIndexed(int)), SLOT(lineIndexed(int)));
+  connect(mpLargeFileView, SIGNAL(textNotFound()), SLOT(textNotFound()));
+  connect(mpLargeFileView, SIGNAL(findRequested()), SLOT(showFindWidget()));
+  connect(mpLargeFileView, SIGNAL(goToLineRequested()), SLOT(goToLine()));
+  // find widget
+  mpFindTextBox = new QLineEdit;
+  connect(mpFindTextBox, SIGNAL(returnPressed()), SLOT(findNext()));
+  mpCaseSensitiveCheckBox = new QCheckBox(tr("Case Sensitive"));
+  mpFindPreviousButton = new QPushButton(Helper::previous);
+  connect(mpFindPreviousButton, SIGNAL(clicked()), SLOT(findPrevious()));
+  mpFindNextButton = new QPushButton(Helper::next);
+  connect(mpFindNextButton, SIGNAL(clicked()), SLOT(findNext()));
+  mpCloseButton = new QPushButton(Helper::close);
+  connect(mpCloseButton, SIGNAL(clicked()), SLOT(hideFindWidget()));
+  mpStatusLabel = new Label;
+  QHBoxLayout *pFindHorizontalLayout = new QHBoxLayout;
+  pFindHorizontalLayout->setContentsMargins(2, 2, 2, 2);
+  pFindHorizontalLayout->addWidget(new Label(tr("Find:")));
+  pFindHorizontalLayout->addWidget(mpFindTextBox, 1);
+  pFindHorizontalLayout->addWidget(mpCaseSensitiveCheckBox);
+  pFindHorizontalLayout->addWidget(mpFindPreviousButton);
+  pFindHorizontalLayout->addWidget(mpFindNextButton);
+  pFindHorizontalLayout->addWidget(mpCloseButton);
+  pFindHorizontalLayout->addWidget(mpStatusLabel);
+  mpFindWidget = new QWidget;
+  mpFindWidget->setLayout(pFindHorizontalLayout);
+  mpFindWidget->hide();
+  // add the view and the find widget to the BaseEditor layout
+  QVBoxLayout *pMainLayout = qobject_cast<QVBoxLayout*>(layout());
+  pMainLayout->insertWidget(pMainLayout->indexOf(mpPlainTextEdit) + 1, mpLargeFileView, 1);
+  pMainLayout->addWidget(mpFindWidget, 0, Qt::AlignBottom);
+}
+
+/*!
+ * \brief LargeFileViewer::isLargeFile
+ * Returns true if the file is larger than LargeFileSize and should be shown with LargeFileViewer.
+ * \param fileName
+ * \return
+ */
+bool LargeFileViewer::isLargeFile(const QString &fileName)
+{
+  QFileInfo fileInfo(fileName);
+  return fileInfo.isFile() && fileInfo.size() > LargeFileSize;
+}
+
+/*!
+ * \brief LargeFileViewer::openFile
+ * Opens the file in LargeFileView.
+ * \param fileName
+ * \return
+ */
+bool LargeFileViewer::openFile(const QString &fileName)
+{
+  if (!mpLargeFileView->openFile(fileName)) {
+    MessagesWidget::instance()->addGUIMessage(MessageItem(MessageItem::Modelica, "", false, 0, 0, 0, 0,
+                                                          GUIMessages::getMessage(GUIMessages::ERROR_OPENING_FILE).arg(fileName)
+                                                          .arg(mpLargeFileView->errorString()), Helper::scriptingKind, Helper::errorLevel));
+    return false;
+  }
+  mpInfoBar->showMessage(tr("<b>Information: </b>The file is larger than %1 MB and is shown read-only.")
+                         .arg(QString::number(LargeFileSize / (1024 * 1024))));
+  return true;
+}
+
+/*!
+ * \brief LargeFileViewer::findPrevious
+ * Finds the text in backward direction.
+ */
+void LargeFileViewer::findPrevious()
+{
+  mpStatusLabel->clear();
+  mpLargeFileView->findText(mpFindTextBox->text(), false, mpCaseSensitiveCheckBox->isChecked());
+}
+
+/*!
+ * \brief LargeFileViewer::findNext
+ * Finds the text in forward direction.
+ */
+void LargeFileViewer::findNext()
+{
+  mpStatusLabel->clear();
+  mpLargeFileView->findText(mpFindTextBox->text(), true, mpCaseSensitiveCheckBox->isChecked());
+}
+
+/*!
+ * \brief LargeFileViewer::lineIndexed
+ * Slot activated when the lines of the file are indexed.
+ * \param lineCount
+ */
+void LargeFileViewer::lineIndexed(int lineCount)
+{
+  mpStatusLabel->setText(tr("%1 lines").arg(lineCount));
+}
+
+/*!
+ * \brief LargeFileViewer::textNotFound
+ * Slot activated when the find text is not found.
+ */
+void LargeFileViewer::textNotFound()
+{
+  mpStatusLabel->setText(tr("Not found"));
+}
+
+/*!
+ * \brief LargeFileViewer::contentsHasChanged
+ * The file is read-only so there is nothing to update.
+ * \param position
+ * \param charsRemoved
+ * \param charsAdded
+ */
+void LargeFileViewer::contentsHasChanged(int position, int charsRemoved, int charsAdded)
+{
+  Q_UNUSED(position);
+  Q_UNUSED(charsRemoved);
+  Q_UNUSED(charsAdded);
+}
+
+/*!
+ * \brief LargeFileViewer::showFindWidget
+ * Shows the find widget.
+ */
+void LargeFileViewer::showFindWidget()
+{
+  mpFindWidget->show();
+  mpFindTextBox->setFocus();
+  mpFindTextBox->selectAll();
+}
+
+/*!
+ * \brief LargeFileViewer::hideFindWidget
+ * Hides the find widget and sets the focus on LargeFileView.
+ */
+void LargeFileViewer::hideFindWidget()
+{
+  mpFindWidget->hide();
+  mpLargeFileView->setFocus(Qt::ActiveWindowFocusReason);
+}
+
+/*!
+ * \brief LargeFileViewer::goToLine
+ * Asks for a line number and goes to it.
+ */
+void LargeFileViewer::goToLine()
+{
+  if (!mpLargeFileView->isIndexed()) {
+    return;
+  }
+  bool ok;
+  int lineNumber = QInputDialog::getInt(this, QString(Helper::applicationName).append(" - Go to Line"),
+                                        tr("Enter line number (1 to %1):").arg(QString::number(mpLargeFileView->lineCount())),
+                                        mpLargeFileView->getCurrentLine() + 1, 1, mpLargeFileView->lineCount(), 1, &ok);
+  if (ok) {
+    mpLargeFileView->goToLineNumber(lineNumber);
+  }
+}
@@ -0,0 +1,135 @@
+/*
+ * This file is part of OpenModelica.
+ *
+ * Copyright (c) 1998-CurrentYear, Open Source Modelica Consortium (OSMC),
+ * c/o Linköpings universitet, Department of Computer and Information Science,
+ * SE-58183 Linköping, Sweden.
+ *
+ * All rights reserved.
+ *
+ * THIS PROGRAM IS PROVIDED UNDER THE TERMS OF GPL VERSION 3 LICENSE OR
+ * THIS OSMC PUBLIC LICENSE (OSMC-PL) VERSION 1.2.
+ * ANY USE, REPRODUCTION OR DISTRIBUTION OF THIS PROGRAM CONSTITUTES RECIPIENT'S ACCEPTANCE
+ * OF THE OSMC PUBLIC LICENSE OR THE GPL VERSION 3, ACCORDING TO RECIPIENTS CHOICE.
+ *
+ * The OpenModelica software and the Open Source Modelica
+ * Consortium (OSMC) Public License (OSMC-PL) are obtained
+ * from OSMC, either from the above address,
+ * from the URLs: http://www.ida.liu.se/projects/OpenModelica or
+ * http://www.openmodelica.org, and in the OpenModelica distribution.
+ * GNU version 3 is obtained from: http://www.gnu.org/copyleft/gpl.html.
+ *
+ * This program is distributed WITHOUT ANY WARRANTY; without
+ * even the implied warranty of  MERCHANTABILITY or FITNESS
+ * FOR A PARTICULAR PURPOSE, EXCEPT AS EXPRESSLY SET FORTH
+ * IN THE BY RECIPIENT SELECTED SUBSIDIARY LICENSE CONDITIONS OF OSMC-PL.
+ *
+ * See the full OSMC Public License conditions for more details.
+ *
+ */
+
+#ifndef LARGEFILEVIEWER_H
+#define LARGEFILEVIEWER_H
+
+#include "Editors/BaseEditor.h"
+
+#include <QAbstractScrollArea>
+#include <QDateTime>
+#include <QFile>
+#include <QFileSystemWatcher>
+#include <QTimer>
+#include <QVector>
+
+class LargeFileView : public QAbstractScrollArea
+{
+  Q_OBJECT
+public:
+  LargeFileView(QWidget *pParent = 0);
+  ~LargeFileView();
+  enum {MaxLineLength = 4096, ChunkSize = 1024 * 1024};
+  bool openFile(const QString &fileName);
+  QString errorString() const {return mErrorString;}
+  bool isIndexed() const {return !mLineOffsets.isEmpty();}
+  int lineCount() const {return qMax(0, mLineOffsets.size() - 1);}
+  int getCurrentLine() const {return mCurrentLine;}
+  void goToLineNumber(int lineNumber);
+  void findText(const QString &text, bool forward, bool caseSensitive);
+  static QVector<qint64> indexLines(const QString &fileName);
+  static qint64 findBytes(const QString &fileName, const QByteArray &bytes, qint64 from, QTextDocument::FindFlags flags);
+private:
+  QString mFileName;
+  QString mErrorString;
+  qint64 mFileSize;
+  QDateTime mLastModified;
+  QFileSystemWatcher *mpFileSystemWatcher;
+  QTimer *mpReloadTimer;
+  QVector<qint64> mLineOffsets;
+  QFutureWatcher<QVector<qint64> > *mpLineIndexWatcher;
+  QFutureWatcher<qint64> *mpFindWatcher;
+  int mFindLength;
+  int mCurrentLine;
+  qint64 mMatchOffset;
+  int mMatchLength;
+  int mTabSize;
+  int mMaxLineWidth;
+
+  int lineAt(qint64 offset) const;
+  qint64 lineEnd(int line) const;
+  QString lineText(QFile &file, qint64 start, qint64 end) const;
+  QString lineText(int line) const;
+  int lineNumberAreaWidth() const;
+  int visibleLineCount() const;
+  void updateScrollBars();
+  void setCurrentLine(int line);
+signals:
+  void lineIndexed(int lineCount);
+  void textNotFound();
+  void findRequested();
+  void goToLineRequested();
+private slots:
+  void fileChanged();
+  void reloadFile();
+  void linesIndexed();
+  void textFound();
+protected:
+  virtual void paintEvent(QPaintEvent *pEvent);
+  virtual void resizeEvent(QResizeEvent *pEvent);
+  virtual void scrollContentsBy(int dx, int dy);
+  virtual void keyPressEvent(QKeyEvent *pEvent);
+  virtual void mousePressEvent(QMouseEvent *pEvent);
+};
+
+class LargeFileViewer : public BaseEditor
+{
+  Q_OBJECT
+public:
+  LargeFileViewer(QWidget *pParent);
+  enum {LargeFileSize = 10 * 1024 * 1024};
+  static bool isLargeFile(const QString &fileName);
+  bool openFile(const QString &fileName);
+  LargeFileView* getLargeFileView() {return mpLargeFileView;}
+  virtual void popUpCompleter() {}
+private:
+  LargeFileView *mpLargeFileView;
+  QWidget *mpFindWidget;
+  QLineEdit *mpFindTextBox;
+  QCheckBox *mpCaseSensitiveCheckBox;
+  QPushButton *mpFindPreviousButton;
+  QPushButton *mpFindNextButton;
+  QPushButton *mpCloseButton;
+  Label *mpStatusLabel;
+private slots:
+  virtual void showContextMenu(QPoint point) {Q_UNUSED(point);}
+  void findPrevious();
+  void findNext();
+  void lineIndexed(int lineCount);
+  void textNotFound();
+public slots:
+  virtual void contentsHasChanged(int position, int charsRemoved, int charsAdded);
+  virtual void toggleCommentSelection() {}
+  void showFindWidget();
+  void hideFindWidget();
+  void goToLine();
+};
+
+#endif // LARGEFILEVIEWER_H
@@ -158,6 +158,7 @@ MetaModelicaHighlighter::MetaModelicaHighlighter(MetaModelicaEditorPage *pMetaMo
 {
   mpMetaModelicaEditorPage = pMetaModelicaEditorPage;
   mpPlainTextEdit = pPlainTextEdit;
+  mLexer.initialize(getKeywords(), getTypes(), false);
   initializeSettings();
 }
 
@@ -169,39 +170,16 @@ void MetaModelicaHighlighter::initializeSettings()
   font.setPointSizeF(mpMetaModelicaEditorPage->getOptionsDialog()->getTextEditorPage()->getFontSizeSpinBox()->value());
   mpPlainTextEdit->document()->setDefaultFont(font);
   mpPlainTextEdit->setTabStopWidth(mpMetaModelicaEditorPage->getOptionsDialog()->getTextEditorPage()->getTabSizeSpinBox()->value() * QFontMetrics(font).width(QLatin1Char(' ')));
+  // cache the options used for every block
+  mMatchParenthesesCommentsQuotes = mpMetaModelicaEditorPage->getOptionsDialog()->getTextEditorPage()->getMatchParenthesesCommentsQuotesCheckBox()->isChecked();
   // set color highlighting
-  mHighlightingRules.clear();
-  HighlightingRule rule;
   mTextFormat.setForeground(mpMetaModelicaEditorPage->getColor("Text"));
   mKeywordFormat.setForeground(mpMetaModelicaEditorPage->getColor("Keyword"));
   mTypeFormat.setForeground(mpMetaModelicaEditorPage->getColor("Type"));
   mSingleLineCommentFormat.setForeground(mpMetaModelicaEditorPage->getColor("Comment"));
   mMultiLineCommentFormat.setForeground(mpMetaModelicaEditorPage->getColor("Comment"));
   mQuotationFormat.setForeground(mpMetaModelicaEditorPage->getColor("Quotes"));
-  // Priority: keyword > func() > ident > number. Yes, the order matters :)
   mNumberFormat.setForeground(mpMetaModelicaEditorPage->getColor("Number"));
-  rule.mPattern = QRegExp("[0-9][0-9]*([.][0-9]*)?([eE][+-]?[0-9]*)?");
-  rule.mFormat = mNumberFormat;
-  mHighlightingRules.append(rule);
-  rule.mPattern = QRegExp("\\b[A-Za-z_][A-Za-z0-9_]*");
-  rule.mFormat = mTextFormat;
-  mHighlightingRules.append(rule);
-  // keywords
-  QStringList keywordPatterns = getKeywords();
-  foreach (const QString &pattern, keywordPatterns) {
-    QString newPattern = QString("\\b%1\\b").arg(pattern);
-    rule.mPattern = QRegExp(newPattern);
-    rule.mFormat = mKeywordFormat;
-    mHighlightingRules.append(rule);
-  }
-  // Modelica types
-  QStringList typePatterns = getTypes();
-  foreach (const QString &pattern, typePatterns) {
-    QString newPattern = QString("\\b%1\\b").arg(pattern);
-    rule.mPattern = QRegExp(newPattern);
-    rule.mFormat = mTypeFormat;
-    mHighlightingRules.append(rule);
-  }
 }
 // Function which returns list of keywords for the highlighter
 QStringList MetaModelicaHighlighter::getKeywords()
@@ -306,10 +284,41 @@ QStringList MetaModelicaHighlighter::getTypes()
   return typesList;
 }
 
+/*!
+ * \brief isFoldingStart
+ * Returns true if the word text[index, end) starts a MetaModelica folding block.
+ * \param text
+ * \param index
+ * \param end
+ * \return
+ */
+static bool isFoldingStart(const QString &text, int index, int end)
+{
+  static const QStringList foldingStartWords = QStringList() << "function" << "package" << "record" << "uniontype" << "for" << "while"
+                                                             << "if" << "try";
+  static const QStringList foldingStartExpressions = QStringList() << "match" << "matchcontinue";
+  bool followedBySpace = end == text.length() || text[end].isSpace();
+  if (followedBySpace || text[end] == '(') {
+    foreach (const QString &word, foldingStartExpressions) {
+      if (ModelicaLexer::isWord(text, index, end, word)) {
+        return true;
+      }
+    }
+  }
+  if (followedBySpace) {
+    foreach (const QString &word, foldingStartWords) {
+      if (ModelicaLexer::isWord(text, index, end, word)) {
+        return true;
+      }
+    }
+  }
+  return false;
+}
+
 /*!
  * \brief MetaModelicaHighlighter::highlightMultiLine
- * Highlights the multilines text.
- * Quoted text or multiline comments.
+ * Highlights the text block in one pass.
+ * Keywords, types, numbers, quoted text, comments, parentheses and the folding blocks.
  * \param text
  */
 void MetaModelicaHighlighter::highlightMultiLine(const QString &text)
@@ -340,6 +349,8 @@ void MetaModelicaHighlighter::highlightMultiLine(const QString &text)
     pTextBlockUserData->setFoldingEndIncluded(false);
   }
   while (index < text.length()) {
+    // the end of the word or number starting at index
+    int wordEnd = -1;
     switch (blockState) {
       /* if the block already has single line comment then don't check for multi line comment and quotes. */
       case 1:
@@ -375,10 +386,27 @@ void MetaModelicaHighlighter::highlightMultiLine(const QString &text)
         } else if (text[index] == '"') {
           startIndex = index;
           blockState = 3;
+        } else if (ModelicaLexer::isWordStart(text[index])) {
+          wordEnd = ModelicaLexer::scanWord(text, index);
+          switch (mLexer.wordType(text, index, wordEnd)) {
+            case ModelicaLexer::Keyword:
+              setFormat(index, wordEnd - index, mKeywordFormat);
+              break;
+            case ModelicaLexer::Type:
+              setFormat(index, wordEnd - index, mTypeFormat);
+              break;
+            default:
+              break;
+          }
+        } else if (ModelicaLexer::isDigit(text[index])) {
+          wordEnd = ModelicaLexer::scanNumber(text, index);
+          setFormat(index, wordEnd - index, mNumberFormat);
+          // the letters directly after a number are not an identifier
+          wordEnd = ModelicaLexer::scanWord(text, wordEnd);
         }
     }
     // if no single line comment, no multi line comment and no quotes then store the parentheses
-    if (pTextBlockUserData && (blockState < 1 || blockState > 3 || mpMetaModelicaEditorPage->getOptionsDialog()->getTextEditorPage()->getMatchParenthesesCommentsQuotesCheckBox()->isChecked())) {
+    if (pTextBlockUserData && (blockState < 1 || blockState > 3 || mMatchParenthesesCommentsQuotes)) {
       if (text[index] == '(' || text[index] == '{' || text[index] == '[') {
         parentheses.append(Parenthesis(Parenthesis::Opened, text[index], index));
       } else if (text[index] == ')' || text[index] == '}' || text[index] == ']') {
@@ -388,49 +416,23 @@ void MetaModelicaHighlighter::highlightMultiLine(const QString &text)
     if (pTextBlockUserData) {
       // if no single line comment, no multi line comment and no quotes then check for block start and end
       if (blockState < 1 || blockState > 3) {
-        if (!foldingEndState) {
-          if (Utilities::containsWord(text, index, "function")) {
-            foldingStartIndex = index;
-            index = index + QString("function").length();
-          } else if (Utilities::containsWord(text, index, "package")) {
-            foldingStartIndex = index;
-            index = index + QString("package").length();
-          } else if (Utilities::containsWord(text, index, "record")) {
-            foldingStartIndex = index;
-            index = index + QString("record").length();
-          } else if (Utilities::containsWord(text, index, "uniontype")) {
-            foldingStartIndex = index;
-            index = index + QString("uniontype").length();
-          } else if (Utilities::containsWord(text, index, "match", true)) {
-            foldingStartIndex = index;
-            index = index + QString("match").length();
-          } else if (Utilities::containsWord(text, index, "matchcontinue", true)) {
-            foldingStartIndex = index;
-            index = index + QString("matchcontinue").length();
-          } else if (Utilities::containsWord(text, index, "for")) {
+        if (wordEnd > index) {
+          if (!foldingEndState && isFoldingStart(text, index, wordEnd)) {
             foldingStartIndex = index;
-            index = index + QString("for").length();
-          } else if (Utilities::containsWord(text, index, "while")) {
-            foldingStartIndex = index;
-            index = index + QString("while").length();
-          } else if (Utilities::containsWord(text, index, "if")) {
-            foldingStartIndex = index;
-            index = index + QString("if").length();
-          } else if (Utilities::containsWord(text, index, "try")) {
-            foldingStartIndex = index;
-            index = index + QString("try").length();
+          } else if (ModelicaLexer::isWord(text, index, wordEnd, "end") && (wordEnd == text.length() || text[wordEnd].isSpace())) {
+            foldingEndState = true;
           }
         }
-        if (Utilities::containsWord(text, index, "end")) {
-          index = index + QString("end").length();
-          foldingEndState = true;
-        }
-        if ((foldingEndState || foldingStartIndex > -1) && (index<text.length() && text[index] == ';')) {
+        if ((foldingEndState || foldingStartIndex > -1) && text[index] == ';') {
           foldingEndState = false;
           foldingEnd = true;
         }
       }
     }
+    // continue after the word or number
+    if (wordEnd > index) {
+      index = wordEnd - 1;
+    }
     index++;
   }
   if (pTextBlockUserData) {
@@ -483,16 +485,7 @@ void MetaModelicaHighlighter::highlightMultiLine(const QString &text)
 void MetaModelicaHighlighter::highlightBlock(const QString &text)
 {
   setCurrentBlockState(0);
-  setFormat(0, text.length(), mTextFormat.foreground().color());
-  foreach (const HighlightingRule &rule, mHighlightingRules) {
-    QRegExp expression(rule.mPattern);
-    int index = expression.indexIn(text);
-    while (index >= 0) {
-      int length = expression.matchedLength();
-      setFormat(index, length, rule.mFormat);
-      index = expression.indexIn(text, index + length);
-    }
-  }
+  setFormat(0, text.length(), mTextFormat);
   highlightMultiLine(text);
 }
 
@@ -34,6 +34,7 @@
 #define METAMODELICAEDITOR_H
 
 #include "Editors/BaseEditor.h"
+#include "Editors/ModelicaLexer.h"
 
 #include <QSyntaxHighlighter>
 
@@ -67,12 +68,8 @@ protected:
 private:
   MetaModelicaEditorPage *mpMetaModelicaEditorPage;
   QPlainTextEdit *mpPlainTextEdit;
-  struct HighlightingRule
-  {
-    QRegExp mPattern;
-    QTextCharFormat mFormat;
-  };
-  QVector<HighlightingRule> mHighlightingRules;
+  ModelicaLexer mLexer;
+  bool mMatchParenthesesCommentsQuotes;
   QTextCharFormat mTextFormat;
   QTextCharFormat mKeywordFormat;
   QTextCharFormat mTypeFormat;
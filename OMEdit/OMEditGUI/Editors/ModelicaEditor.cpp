@@ -45,6 +45,10 @@
 #include <QCompleter>
 #include <QMenu>
 #include <QMessageBox>
+#include <QScrollBar>
+#include <QSet>
+#include <QTreeWidgetItemIterator>
+#include <QtConcurrentRun>
 
 
 /*!
@@ -62,6 +66,42 @@ ModelicaEditor::ModelicaEditor(QWidget *pParent)
   mpPlainTextEdit->setCompletionCharacters(".");
   /* set the document marker */
   mpDocumentMarker = new DocumentMarker(mpPlainTextEdit->document());
+  // check the syntax on a worker thread when the user stops typing
+  mpSyntaxCheckTimer = new QTimer(this);
+  mpSyntaxCheckTimer->setSingleShot(true);
+  mpSyntaxCheckTimer->setInterval(500);
+  connect(mpSyntaxCheckTimer, SIGNAL(timeout()), SLOT(checkSyntax()));
+  mpSyntaxCheckWatcher = new QFutureWatcher<QList<SyntaxDiagnostic> >(this);
+  connect(mpSyntaxCheckWatcher, SIGNAL(finished()), SLOT(syntaxChecked()));
+  mSyntaxCheckRevision = -1;
+  // the outline of the text is shown on the left side of the text. It is created when it is shown the first time.
+  mpModelicaOutline = 0;
+  mpOutlineTreeWidget = new QTreeWidget;
+  mpOutlineTreeWidget->setHeaderHidden(true);
+  mpOutlineTreeWidget->setColumnCount(1);
+  mpOutlineTreeWidget->setContextMenuPolicy(Qt::CustomContextMenu);
+  connect(mpOutlineTreeWidget, SIGNAL(itemActivated(QTreeWidgetItem*,int)), SLOT(outlineTreeItemActivated(QTreeWidgetItem*)));
+  connect(mpOutlineTreeWidget, SIGNAL(customContextMenuRequested(QPoint)), SLOT(showOutlineContextMenu(QPoint)));
+  mpOutlineTreeWidget->hide();
+  mpOutlineSplitter = new QSplitter(Qt::Horizontal);
+  mpOutlineSplitter->setChildrenCollapsible(false);
+  QVBoxLayout *pMainLayout = qobject_cast<QVBoxLayout*>(layout());
+  int index = pMainLayout->indexOf(mpPlainTextEdit);
+  pMainLayout->removeWidget(mpPlainTextEdit);
+  mpOutlineSplitter->addWidget(mpOutlineTreeWidget);
+  mpOutlineSplitter->addWidget(mpPlainTextEdit);
+  mpOutlineSplitter->setStretchFactor(1, 1);
+  pMainLayout->insertWidget(index, mpOutlineSplitter, 1);
+  mpShowOutlineAction = new QAction(tr("Show Outline"), this);
+  mpShowOutlineAction->setStatusTip(tr("Shows the outline of the classes"));
+  mpShowOutlineAction->setCheckable(true);
+  connect(mpShowOutlineAction, SIGNAL(toggled(bool)), SLOT(showOutline(bool)));
+  mpFoldOutlineItemAction = new QAction(tr("Fold"), this);
+  mpFoldOutlineItemAction->setStatusTip(tr("Folds the text of the item"));
+  connect(mpFoldOutlineItemAction, SIGNAL(triggered()), SLOT(foldOutlineItem()));
+  mpUnFoldOutlineItemAction = new QAction(tr("Unfold"), this);
+  mpUnFoldOutlineItemAction->setStatusTip(tr("Unfolds the text of the item"));
+  connect(mpUnFoldOutlineItemAction, SIGNAL(triggered()), SLOT(unFoldOutlineItem()));
 }
 
 /*!
@@ -137,9 +177,16 @@ QList<LibraryTreeItem*> ModelicaEditor::getCandidateContexts(QStringList nameCom
 {
   QList<LibraryTreeItem*> result;
   QList<LibraryTreeItem*> roots;
+  QSet<LibraryTreeItem*> visited;
   LibraryTreeItem *pItem = getModelWidget()->getLibraryTreeItem();
   while (pItem) {
-    roots.append(pItem->getInheritedClassesDeepList());
+    // the enclosing classes can share base classes so only add each class once
+    foreach (LibraryTreeItem *pInheritedItem, pItem->getInheritedClassesDeepList()) {
+      if (!visited.contains(pInheritedItem)) {
+        visited.insert(pInheritedItem);
+        roots.append(pInheritedItem);
+      }
+    }
     pItem = pItem->parent();
   }
 
@@ -153,16 +200,19 @@ QList<LibraryTreeItem*> ModelicaEditor::getCandidateContexts(QStringList nameCom
 
 QString ModelicaEditor::wordUnderCursor()
 {
-  int end = mpPlainTextEdit->textCursor().position();
+  // a word never spans lines so only look at the current block
+  QTextCursor cursor = mpPlainTextEdit->textCursor();
+  QString text = cursor.block().text();
+  int end = cursor.positionInBlock();
   int begin = end - 1;
   while (begin >= 0) {
-    QChar ch = mpPlainTextEdit->document()->characterAt(begin);
+    QChar ch = text.at(begin);
     if (!(ch.isLetterOrNumber() || ch == '.' || ch == '_'))
       break;
     begin--;
   }
   begin++;
-  return mpPlainTextEdit->document()->toPlainText().mid(begin, end - begin);
+  return text.mid(begin, end - begin);
 }
 
 void ModelicaEditor::getCompletionSymbols(QString word, QList<CompleterItem> &classes, QList<CompleterItem> &components)
@@ -203,14 +253,13 @@ QStringList ModelicaEditor::getClassNames(QString *errorString)
     QString stringToParse = modelicaText;
     if (!modelicaText.startsWith("within")) {
       if (pLibraryTreeItem->isInPackageOneFile()) {
-        stringToParse = pLibraryTreeItem->getClassTextBefore() + modelicaText + pLibraryTreeItem->getClassTextAfter();
-        // first we try to parse whole string so that we get correct line numbers for errors if any (see Ticket #3969).
+        /* Only parse the class. Start it at its line in the file so that we get correct line numbers for errors if any (see Ticket #3969).
+         * The within clause is on the first line so the class can't start before the second line.
+         */
+        int lineNumberStart = qMax(pLibraryTreeItem->mClassInformation.lineNumberStart, 2);
+        stringToParse = QString("within %1;%2%3").arg(pLibraryTreeItem->parent()->getNameStructure())
+                        .arg(QString(lineNumberStart - 1, '\n')).arg(modelicaText);
         classNames = pOMCProxy->parseString(stringToParse, pLibraryTreeItem->getFileName());
-        // if the whole string parses successfully then parse the subset for just this class.
-        if (classNames.size() > 0) {
-          stringToParse = QString("within %1;%2").arg(pLibraryTreeItem->parent()->getNameStructure()).arg(modelicaText);
-          classNames = pOMCProxy->parseString(stringToParse, pLibraryTreeItem->getFileName());
-        }
       } else {
         stringToParse = QString("within %1;%2").arg(pLibraryTreeItem->parent()->getNameStructure()).arg(modelicaText);
         classNames = pOMCProxy->parseString(stringToParse, pLibraryTreeItem->getFileName());
@@ -396,10 +445,140 @@ void ModelicaEditor::showContextMenu(QPoint point)
   pMenu->addSeparator();
   pMenu->addAction(mpFoldAllAction);
   pMenu->addAction(mpUnFoldAllAction);
+  pMenu->addSeparator();
+  pMenu->addAction(mpShowOutlineAction);
   pMenu->exec(mapToGlobal(point));
   delete pMenu;
 }
 
+/*!
+ * \brief ModelicaEditor::addOutlineTreeItems
+ * Adds the tree items for the children of the outline item.
+ * \param pParentTreeItem - the parent tree item or 0 for the top level items.
+ * \param pOutlineItem
+ * \param expandedPaths - the paths of the tree items that were expanded before the update.
+ * \param path - the path of the parent tree item.
+ */
+void ModelicaEditor::addOutlineTreeItems(QTreeWidgetItem *pParentTreeItem, OutlineItem *pOutlineItem, const QSet<QString> &expandedPaths,
+                                         const QString &path)
+{
+  foreach (OutlineItem *pChildOutlineItem, pOutlineItem->mChildren) {
+    QTreeWidgetItem *pTreeItem;
+    if (pParentTreeItem) {
+      pTreeItem = new QTreeWidgetItem(pParentTreeItem);
+    } else {
+      pTreeItem = new QTreeWidgetItem(mpOutlineTreeWidget);
+    }
+    switch (pChildOutlineItem->mType) {
+      case OutlineItem::Class:
+        pTreeItem->setText(0, pChildOutlineItem->mName);
+        pTreeItem->setToolTip(0, QString("%1 %2").arg(pChildOutlineItem->mDetail, pChildOutlineItem->mName));
+        pTreeItem->setIcon(0, QIcon(":/Resources/icons/completerClass.svg"));
+        break;
+      case OutlineItem::Extends:
+        pTreeItem->setText(0, QString("extends %1").arg(pChildOutlineItem->mName));
+        break;
+      case OutlineItem::Component:
+        pTreeItem->setText(0, QString("%1 : %2").arg(pChildOutlineItem->mName, pChildOutlineItem->mDetail));
+        pTreeItem->setIcon(0, QIcon(":/Resources/icons/completerComponent.svg"));
+        break;
+      default:
+        pTreeItem->setText(0, pChildOutlineItem->mName);
+        break;
+    }
+    const QString childPath = path + QLatin1Char('/') + pTreeItem->text(0);
+    addOutlineTreeItems(pTreeItem, pChildOutlineItem, expandedPaths, childPath);
+    if (expandedPaths.contains(childPath)) {
+      pTreeItem->setExpanded(true);
+    }
+  }
+}
+
+/*!
+ * \brief ModelicaEditor::outlineTreeItemPath
+ * Returns the texts of the tree item and its parents. Used to keep the tree items expanded when the outline is updated.
+ * \param pTreeItem
+ * \return
+ */
+QString ModelicaEditor::outlineTreeItemPath(QTreeWidgetItem *pTreeItem)
+{
+  QString path;
+  while (pTreeItem) {
+    path.prepend(QLatin1Char('/') + pTreeItem->text(0));
+    pTreeItem = pTreeItem->parent();
+  }
+  return path;
+}
+
+/*!
+ * \brief ModelicaEditor::findOutlineItem
+ * Returns the outline item of the tree item.\n
+ * The outline is built again while typing so the item is found by the indexes of the tree item and its parents.
+ * \param pTreeItem
+ * \return
+ */
+OutlineItem* ModelicaEditor::findOutlineItem(QTreeWidgetItem *pTreeItem)
+{
+  return findOutlineItem(outlineTreeItemIndexes(pTreeItem));
+}
+
+/*!
+ * \brief ModelicaEditor::outlineTreeItemIndexes
+ * Returns the indexes of the tree item and its parents.
+ * \param pTreeItem
+ * \return
+ */
+QList<int> ModelicaEditor::outlineTreeItemIndexes(QTreeWidgetItem *pTreeItem)
+{
+  QList<int> indexes;
+  while (pTreeItem->parent()) {
+    indexes.prepend(pTreeItem->parent()->indexOfChild(pTreeItem));
+    pTreeItem = pTreeItem->parent();
+  }
+  indexes.prepend(mpOutlineTreeWidget->indexOfTopLevelItem(pTreeItem));
+  return indexes;
+}
+
+/*!
+ * \brief ModelicaEditor::findOutlineItem
+ * Returns the outline item at the indexes.
+ * \param indexes
+ * \return
+ */
+OutlineItem* ModelicaEditor::findOutlineItem(const QList<int> &indexes)
+{
+  OutlineItem *pOutlineItem = mpModelicaOutline->getRootItem();
+  foreach (int index, indexes) {
+    if (index < 0 || index >= pOutlineItem->mChildren.size()) {
+      return 0;
+    }
+    pOutlineItem = pOutlineItem->mChildren.at(index);
+  }
+  return pOutlineItem;
+}
+
+/*!
+ * \brief ModelicaEditor::setOutlineItemVisible
+ * Folds or unfolds the text of the class or section between its first line and its end.
+ * \param pTreeItem
+ * \param visible
+ */
+void ModelicaEditor::setOutlineItemVisible(QTreeWidgetItem *pTreeItem, bool visible)
+{
+  QList<int> indexes = outlineTreeItemIndexes(pTreeItem);
+  mpModelicaOutline->update();
+  OutlineItem *pOutlineItem = findOutlineItem(indexes);
+  if (!pOutlineItem) {
+    return;
+  }
+  QTextDocument *pTextDocument = mpPlainTextEdit->document();
+  int firstBlockNumber = pTextDocument->findBlock(pOutlineItem->mPosition).blockNumber() + 1;
+  int lastBlockNumber = pTextDocument->findBlock(pOutlineItem->mEndPosition).blockNumber() - 1;
+  if (firstBlockNumber <= lastBlockNumber) {
+    mpPlainTextEdit->setBlocksVisible(firstBlockNumber, lastBlockNumber, visible);
+  }
+}
+
 /*!
  * \brief ModelicaEditor::setPlainText
  * Reimplementation of QPlainTextEdit::setPlainText method.
@@ -419,15 +598,14 @@ void ModelicaEditor::setPlainText(const QString &text, bool useInserText)
   // Only set the text when it is really new
   if (contents != mpPlainTextEdit->toPlainText()) {
     mForceSetPlainText = true;
+    int firstBlockNumber = 0, lastBlockNumber = 0;
     if (!useInserText) {
       mpPlainTextEdit->setPlainText(contents);
     } else {
-      QTextCursor textCursor (mpPlainTextEdit->document());
-      textCursor.beginEditBlock();
-      textCursor.select(QTextCursor::Document);
-      textCursor.insertText(contents);
-      textCursor.endEditBlock();
-      mpPlainTextEdit->setTextCursor(textCursor);
+      /* Only replace the changed text so that the highlighter updates the changed blocks
+       * and the folding of the rest of the document is kept.
+       */
+      replaceChangedText(contents, &firstBlockNumber, &lastBlockNumber);
     }
     if (mpModelWidget->getLibraryTreeItem()->isInPackageOneFile()) {
       storeLeadingSpaces(leadingSpacesMap);
@@ -435,14 +613,215 @@ void ModelicaEditor::setPlainText(const QString &text, bool useInserText)
     setTextChanged(false);
     mForceSetPlainText = false;
     mLastValidText = contents;
+    // the text set from the model is valid so drop the diagnostics of the previous text
+    mpSyntaxCheckTimer->stop();
+    mpPlainTextEdit->setDiagnostics(QList<QTextEdit::ExtraSelection>());
     /* ticket:4409 Object moving in block diagram unfolds all annotations in text view.
-     * Make sure ModelicaHighlighter::highlightBlock is called before calling foldAll.
+     * ModelicaHighlighter::highlightBlock must be called before folding.
+     * The highlighter updates the changed blocks synchronously when the text is set so no rehighlight is needed.
      */
-    OptionsDialog::instance()->emitModelicaEditorSettingsChanged();
-    mpPlainTextEdit->foldAll();
+    if (!useInserText) {
+      mpPlainTextEdit->foldAll();
+    } else {
+      mpPlainTextEdit->foldBlocks(firstBlockNumber, lastBlockNumber);
+    }
   }
 }
 
+/*!
+ * \brief ModelicaEditor::checkSyntax
+ * Slot activated when the user stops typing. Starts the syntax check of the text on a worker thread.\n
+ * Setting a new future on the watcher drops the result of a check that is still running.
+ */
+void ModelicaEditor::checkSyntax()
+{
+  mSyntaxCheckRevision = mpPlainTextEdit->document()->revision();
+  mpSyntaxCheckWatcher->setFuture(QtConcurrent::run(&ModelicaSyntaxChecker::check, mpPlainTextEdit->toPlainText()));
+}
+
+/*!
+ * \brief ModelicaEditor::syntaxChecked
+ * Slot activated when the syntax check is finished. Shows the errors as inline diagnostics.\n
+ * The result is discarded if the text has changed since the check was started.
+ */
+void ModelicaEditor::syntaxChecked()
+{
+  if (mpSyntaxCheckWatcher->isCanceled() || mSyntaxCheckRevision != mpPlainTextEdit->document()->revision()) {
+    return;
+  }
+  QList<QTextEdit::ExtraSelection> diagnostics;
+  foreach (const SyntaxDiagnostic &syntaxDiagnostic, mpSyntaxCheckWatcher->result()) {
+    QTextEdit::ExtraSelection diagnostic;
+    diagnostic.format.setUnderlineStyle(QTextCharFormat::WaveUnderline);
+    diagnostic.format.setUnderlineColor(Qt::red);
+    diagnostic.format.setToolTip(syntaxDiagnostic.mMessage);
+    diagnostic.cursor = QTextCursor(mpPlainTextEdit->document());
+    const int lastPosition = mpPlainTextEdit->document()->characterCount() - 1;
+    diagnostic.cursor.setPosition(qMin(syntaxDiagnostic.mPosition, lastPosition));
+    diagnostic.cursor.setPosition(qMin(syntaxDiagnostic.mPosition + qMax(syntaxDiagnostic.mLength, 1), lastPosition), QTextCursor::KeepAnchor);
+    diagnostics.append(diagnostic);
+  }
+  mpPlainTextEdit->setDiagnostics(diagnostics);
+}
+
+/*!
+ * \brief ModelicaEditor::showOutline
+ * Shows/hides the outline.
+ * \param show
+ */
+void ModelicaEditor::showOutline(bool show)
+{
+  if (show && !mpModelicaOutline) {
+    mpModelicaOutline = new ModelicaOutline(mpPlainTextEdit->document());
+    connect(mpModelicaOutline, SIGNAL(outlineChanged()), SLOT(updateOutlineTree()));
+  }
+  mpOutlineTreeWidget->setVisible(show);
+  if (show) {
+    updateOutlineTree();
+  }
+}
+
+/*!
+ * \brief ModelicaEditor::updateOutlineTree
+ * Updates the tree items when the outline has changed.
+ */
+void ModelicaEditor::updateOutlineTree()
+{
+  if (!mpShowOutlineAction->isChecked()) {
+    return;
+  }
+  QSet<QString> expandedPaths;
+  bool expandClasses = mpOutlineTreeWidget->topLevelItemCount() == 0;
+  for (QTreeWidgetItemIterator iterator(mpOutlineTreeWidget); *iterator; ++iterator) {
+    if ((*iterator)->isExpanded()) {
+      expandedPaths.insert(outlineTreeItemPath(*iterator));
+    }
+  }
+  int scrollBarValue = mpOutlineTreeWidget->verticalScrollBar()->value();
+  mpOutlineTreeWidget->setUpdatesEnabled(false);
+  mpOutlineTreeWidget->clear();
+  addOutlineTreeItems(0, mpModelicaOutline->getRootItem(), expandedPaths, QString());
+  // expand the top level classes when the outline is shown the first time
+  if (expandClasses) {
+    for (int i = 0; i < mpOutlineTreeWidget->topLevelItemCount(); ++i) {
+      mpOutlineTreeWidget->topLevelItem(i)->setExpanded(true);
+    }
+  }
+  mpOutlineTreeWidget->verticalScrollBar()->setValue(scrollBarValue);
+  mpOutlineTreeWidget->setUpdatesEnabled(true);
+}
+
+/*!
+ * \brief ModelicaEditor::outlineTreeItemActivated
+ * Moves the cursor to the outline item.
+ * \param pTreeItem
+ */
+void ModelicaEditor::outlineTreeItemActivated(QTreeWidgetItem *pTreeItem)
+{
+  /* the positions of the outline are only updated when the user stops typing so update them now.
+   * The tree items are created again if the outline has changed so find the outline item by the indexes of the tree item.
+   */
+  QList<int> indexes = outlineTreeItemIndexes(pTreeItem);
+  mpModelicaOutline->update();
+  OutlineItem *pOutlineItem = findOutlineItem(indexes);
+  if (!pOutlineItem) {
+    return;
+  }
+  QTextCursor cursor(mpPlainTextEdit->document());
+  cursor.setPosition(qMin(pOutlineItem->mPosition, mpPlainTextEdit->document()->characterCount() - 1));
+  // show the blocks hidden by folding an outline item
+  QTextBlock block = cursor.block();
+  if (!block.isVisible()) {
+    QTextBlock firstBlock = block;
+    while (firstBlock.previous().isValid() && !firstBlock.previous().isVisible()) {
+      firstBlock = firstBlock.previous();
+    }
+    QTextBlock lastBlock = block;
+    while (lastBlock.next().isValid() && !lastBlock.next().isVisible()) {
+      lastBlock = lastBlock.next();
+    }
+    mpPlainTextEdit->setBlocksVisible(firstBlock.blockNumber(), lastBlock.blockNumber(), true);
+  }
+  mpPlainTextEdit->setTextCursor(cursor);
+  mpPlainTextEdit->centerCursor();
+  mpPlainTextEdit->setFocus();
+}
+
+/*!
+ * \brief ModelicaEditor::showOutlineContextMenu
+ * Shows the context menu of the classes and sections of the outline.
+ * \param point
+ */
+void ModelicaEditor::showOutlineContextMenu(QPoint point)
+{
+  QTreeWidgetItem *pTreeItem = mpOutlineTreeWidget->itemAt(point);
+  if (!pTreeItem) {
+    return;
+  }
+  OutlineItem *pOutlineItem = findOutlineItem(pTreeItem);
+  if (!pOutlineItem || (pOutlineItem->mType != OutlineItem::Class && pOutlineItem->mType != OutlineItem::Section)) {
+    return;
+  }
+  mpOutlineTreeWidget->setCurrentItem(pTreeItem);
+  QMenu menu(this);
+  menu.addAction(mpFoldOutlineItemAction);
+  menu.addAction(mpUnFoldOutlineItemAction);
+  menu.exec(mpOutlineTreeWidget->viewport()->mapToGlobal(point));
+}
+
+/*!
+ * \brief ModelicaEditor::foldOutlineItem
+ * Folds the current item of the outline.
+ */
+void ModelicaEditor::foldOutlineItem()
+{
+  if (mpOutlineTreeWidget->currentItem()) {
+    setOutlineItemVisible(mpOutlineTreeWidget->currentItem(), false);
+  }
+}
+
+/*!
+ * \brief ModelicaEditor::unFoldOutlineItem
+ * Unfolds the current item of the outline.
+ */
+void ModelicaEditor::unFoldOutlineItem()
+{
+  if (mpOutlineTreeWidget->currentItem()) {
+    setOutlineItemVisible(mpOutlineTreeWidget->currentItem(), true);
+  }
+}
+
+/*!
+ * \brief ModelicaEditor::replaceChangedText
+ * Replaces the text between the common prefix and the common suffix of the document and the contents.\n
+ * Graphical edits usually change a few lines of the class so this keeps the document edit minimal.
+ * \param contents
+ * \param pFirstBlockNumber - the first changed block.
+ * \param pLastBlockNumber - the last changed block.
+ */
+void ModelicaEditor::replaceChangedText(const QString &contents, int *pFirstBlockNumber, int *pLastBlockNumber)
+{
+  const QString text = mpPlainTextEdit->toPlainText();
+  const int length = qMin(text.length(), contents.length());
+  int prefix = 0;
+  while (prefix < length && text.at(prefix) == contents.at(prefix)) {
+    prefix++;
+  }
+  int suffix = 0;
+  while (suffix < length - prefix && text.at(text.length() - suffix - 1) == contents.at(contents.length() - suffix - 1)) {
+    suffix++;
+  }
+  const QString changedText = contents.mid(prefix, contents.length() - prefix - suffix);
+  QTextCursor textCursor(mpPlainTextEdit->document());
+  textCursor.beginEditBlock();
+  textCursor.setPosition(prefix);
+  textCursor.setPosition(text.length() - suffix, QTextCursor::KeepAnchor);
+  textCursor.insertText(changedText);
+  textCursor.endEditBlock();
+  *pFirstBlockNumber = mpPlainTextEdit->document()->findBlock(prefix).blockNumber();
+  *pLastBlockNumber = mpPlainTextEdit->document()->findBlock(prefix + changedText.length()).blockNumber();
+}
+
 //! Slot activated when ModelicaTextEdit's QTextDocument contentsChanged SIGNAL is raised.
 //! Sets the model as modified so that user knows that his current model is not saved.
 void ModelicaEditor::contentsHasChanged(int position, int charsRemoved, int charsAdded)
@@ -461,6 +840,7 @@ void ModelicaEditor::contentsHasChanged(int position, int charsRemoved, int char
     } else {
       /* if user is changing, the normal class. */
       if (!mForceSetPlainText) {
+        mpSyntaxCheckTimer->start();
         mpModelWidget->setWindowTitle(QString(mpModelWidget->getLibraryTreeItem()->getName()).append("*"));
         mpModelWidget->getLibraryTreeItem()->setIsSaved(false);
         MainWindow::instance()->getLibraryWidget()->getLibraryTreeModel()->updateLibraryTreeItem(mpModelWidget->getLibraryTreeItem());
@@ -502,6 +882,7 @@ ModelicaHighlighter::ModelicaHighlighter(ModelicaEditorPage *pModelicaEditorPage
 {
   mpModelicaEditorPage = pModelicaEditorPage;
   mpPlainTextEdit = pPlainTextEdit;
+  mLexer.initialize(getKeywords(), getTypes(), true);
   initializeSettings();
 }
 
@@ -513,9 +894,10 @@ void ModelicaHighlighter::initializeSettings()
   font.setPointSizeF(mpModelicaEditorPage->getOptionsDialog()->getTextEditorPage()->getFontSizeSpinBox()->value());
   mpPlainTextEdit->document()->setDefaultFont(font);
   mpPlainTextEdit->setTabStopWidth(mpModelicaEditorPage->getOptionsDialog()->getTextEditorPage()->getTabSizeSpinBox()->value() * QFontMetrics(font).width(QLatin1Char(' ')));
+  // cache the options used for every block
+  mSyntaxHighlighting = mpModelicaEditorPage->getOptionsDialog()->getTextEditorPage()->getSyntaxHighlightingGroupBox()->isChecked();
+  mMatchParenthesesCommentsQuotes = mpModelicaEditorPage->getOptionsDialog()->getTextEditorPage()->getMatchParenthesesCommentsQuotesCheckBox()->isChecked();
   // set color highlighting
-  mHighlightingRules.clear();
-  HighlightingRule rule;
   mTextFormat.setForeground(mpModelicaEditorPage->getColor("Text"));
   mKeywordFormat.setForeground(mpModelicaEditorPage->getColor("Keyword"));
   mTypeFormat.setForeground(mpModelicaEditorPage->getColor("Type"));
@@ -523,34 +905,7 @@ void ModelicaHighlighter::initializeSettings()
   mMultiLineCommentFormat.setForeground(mpModelicaEditorPage->getColor("Comment"));
   mFunctionFormat.setForeground(mpModelicaEditorPage->getColor("Function"));
   mQuotationFormat.setForeground(mpModelicaEditorPage->getColor("Quotes"));
-  // Priority: keyword > func() > ident > number. Yes, the order matters :)
   mNumberFormat.setForeground(mpModelicaEditorPage->getColor("Number"));
-  rule.mPattern = QRegExp("[0-9][0-9]*([.][0-9]*)?([eE][+-]?[0-9]*)?");
-  rule.mFormat = mNumberFormat;
-  mHighlightingRules.append(rule);
-  rule.mPattern = QRegExp("\\b[A-Za-z_][A-Za-z0-9_]*");
-  rule.mFormat = mTextFormat;
-  mHighlightingRules.append(rule);
-  // functions
-  rule.mPattern = QRegExp("\\b[A-Za-z0-9_]+(?=\\()");
-  rule.mFormat = mFunctionFormat;
-  mHighlightingRules.append(rule);
-  // keywords
-  QStringList keywordPatterns = getKeywords();
-  foreach (const QString &pattern, keywordPatterns) {
-    QString newPattern = QString("\\b%1\\b").arg(pattern);
-    rule.mPattern = QRegExp(newPattern);
-    rule.mFormat = mKeywordFormat;
-    mHighlightingRules.append(rule);
-  }
-  // Modelica types
-  QStringList typePatterns = getTypes();
-  foreach (const QString &pattern, typePatterns) {
-    QString newPattern = QString("\\b%1\\b").arg(pattern);
-    rule.mPattern = QRegExp(newPattern);
-    rule.mFormat = mTypeFormat;
-    mHighlightingRules.append(rule);
-  }
 }
 
 // Function which returns list of keywords for the highlighter
@@ -634,23 +989,23 @@ QStringList ModelicaHighlighter::getTypes()
 
 /*!
  * \brief ModelicaTextHighlighter::highlightMultiLine
- * Highlights the multilines text.
- * Quoted text or multiline comments.
+ * Highlights the text block in one pass.
+ * Keywords, types, functions, numbers, quoted text, comments, parentheses and the annotation folding.
  * \param text
  */
 void ModelicaHighlighter::highlightMultiLine(const QString &text)
 {
   /* Hand-written recognizer beats the crap known as QRegEx ;) */
   int index = 0, startIndex = 0;
-  int blockState = previousBlockState();
+  // the previous block state might include the FoldingState flag
+  int blockState = qMax(previousBlockState(), 0) & ~FoldingState;
   bool foldingState = false;
   QTextBlock previousTextBlck = currentBlock().previous();
   TextBlockUserData *pPreviousTextBlockUserData = BaseEditorDocumentLayout::userData(previousTextBlck);
   if (pPreviousTextBlockUserData) {
     foldingState = pPreviousTextBlockUserData->foldingState();
   }
-  QRegExp annotationRegExp("\\bannotation\\b");
-  int annotationIndex = annotationRegExp.indexIn(text);
+  int annotationIndex = ModelicaLexer::indexOfWord(text, "annotation");
   // store parentheses info
   Parentheses parentheses;
   TextBlockUserData *pTextBlockUserData = BaseEditorDocumentLayout::userData(currentBlock());
@@ -660,6 +1015,8 @@ void ModelicaHighlighter::highlightMultiLine(const QString &text)
     pTextBlockUserData->setFoldingEndIncluded(false);
   }
   while (index < text.length()) {
+    // the end of the word or number starting at index
+    int wordEnd = -1;
     switch (blockState) {
       /* if the block already has single line comment then don't check for multi line comment and quotes. */
       case 1:
@@ -695,10 +1052,30 @@ void ModelicaHighlighter::highlightMultiLine(const QString &text)
         } else if (text[index] == '"') {
           startIndex = index;
           blockState = 3;
+        } else if (ModelicaLexer::isWordStart(text[index])) {
+          wordEnd = ModelicaLexer::scanWord(text, index);
+          switch (mLexer.wordType(text, index, wordEnd)) {
+            case ModelicaLexer::Keyword:
+              setFormat(index, wordEnd - index, mKeywordFormat);
+              break;
+            case ModelicaLexer::Type:
+              setFormat(index, wordEnd - index, mTypeFormat);
+              break;
+            case ModelicaLexer::Function:
+              setFormat(index, wordEnd - index, mFunctionFormat);
+              break;
+            default:
+              break;
+          }
+        } else if (ModelicaLexer::isDigit(text[index])) {
+          wordEnd = ModelicaLexer::scanNumber(text, index);
+          setFormat(index, wordEnd - index, mNumberFormat);
+          // the letters directly after a number are not an identifier
+          wordEnd = ModelicaLexer::scanWord(text, wordEnd);
         }
     }
     // if no single line comment, no multi line comment and no quotes then store the parentheses
-    if (pTextBlockUserData && (blockState < 1 || blockState > 3 || mpModelicaEditorPage->getOptionsDialog()->getTextEditorPage()->getMatchParenthesesCommentsQuotesCheckBox()->isChecked())) {
+    if (pTextBlockUserData && (blockState < 1 || blockState > 3 || mMatchParenthesesCommentsQuotes)) {
       if (text[index] == '(' || text[index] == '{' || text[index] == '[') {
         parentheses.append(Parenthesis(Parenthesis::Opened, text[index], index));
       } else if (text[index] == ')' || text[index] == '}' || text[index] == ']') {
@@ -735,19 +1112,19 @@ void ModelicaHighlighter::highlightMultiLine(const QString &text)
     } else {
       // if no single line comment, no multi line comment and no quotes then check for annotation start
       if (blockState < 1 || blockState > 3) {
-        if (text[index] == 'a' && index+9<text.length() && text[index+1] == 'n' && text[index+2] == 'n' && text[index+3] == 'o'
-            && text[index+4] == 't' && text[index+5] == 'a' && text[index+6] == 't' && text[index+7] == 'i' && text[index+8] == 'o'
-            && text[index+9] == 'n') {
-          if (index+9 == text.length() - 1) { // if we just have annotation keyword in the line
-            index = index + 8;
+        if (wordEnd > index && ModelicaLexer::isWord(text, index, wordEnd, "annotation")) {
+          if (wordEnd == text.length()) { // if we just have annotation keyword in the line
             foldingState = true;
-          } else if (index+10<text.length() && (text[index+10] == '(' || text[index+10] == ' ')) { // if annotation keyword is followed by '(' or space.
-            index = index + 9;
+          } else if (text[wordEnd] == '(' || text[wordEnd] == ' ') { // if annotation keyword is followed by '(' or space.
             foldingState = true;
           }
         }
       }
     }
+    // continue after the word or number
+    if (wordEnd > index) {
+      index = wordEnd - 1;
+    }
     index++;
   }
   if (pTextBlockUserData) {
@@ -762,23 +1139,28 @@ void ModelicaHighlighter::highlightMultiLine(const QString &text)
     // set text block user data
     setCurrentBlockUserData(pTextBlockUserData);
   }
+  int currentState = 0;
   switch (blockState) {
     case 2:
       setFormat(startIndex, text.length()-startIndex, mMultiLineCommentFormat);
-      setCurrentBlockState(2);
+      currentState = 2;
       break;
     case 3:
       setFormat(startIndex, text.length()-startIndex, mQuotationFormat);
-      setCurrentBlockState(3);
+      currentState = 3;
       break;
   }
+  /* Keep the annotation folding in the block state so that QSyntaxHighlighter continues highlighting the next blocks
+   * when an edit opens or closes an annotation.
+   */
+  setCurrentBlockState(foldingState ? currentState | FoldingState : currentState);
 }
 
 //! Reimplementation of QSyntaxHighlighter::highlightBlock
 void ModelicaHighlighter::highlightBlock(const QString &text)
 {
   /* Only highlight the text if user has enabled the syntax highlighting */
-  if (!mpModelicaEditorPage->getOptionsDialog()->getTextEditorPage()->getSyntaxHighlightingGroupBox()->isChecked()) {
+  if (!mSyntaxHighlighting) {
     return;
   }
   // set text block state
@@ -787,16 +1169,7 @@ void ModelicaHighlighter::highlightBlock(const QString &text)
   if (pTextBlockUserData) {
     pTextBlockUserData->setFoldingState(false);
   }
-  setFormat(0, text.length(), mpModelicaEditorPage->getColor("Text"));
-  foreach (const HighlightingRule &rule, mHighlightingRules) {
-    QRegExp expression(rule.mPattern);
-    int index = expression.indexIn(text);
-    while (index >= 0) {
-      int length = expression.matchedLength();
-      setFormat(index, length, rule.mFormat);
-      index = expression.indexIn(text, index + length);
-    }
-  }
+  setFormat(0, text.length(), mTextFormat);
   highlightMultiLine(text);
 }
 
@@ -38,8 +38,15 @@
 #include "Util/Helper.h"
 #include "Util/Utilities.h"
 #include "Editors/BaseEditor.h"
+#include "Editors/ModelicaLexer.h"
+#include "Editors/ModelicaSyntaxChecker.h"
+#include "Editors/ModelicaOutline.h"
 
 #include <QSyntaxHighlighter>
+#include <QFutureWatcher>
+#include <QSet>
+#include <QSplitter>
+#include <QTreeWidget>
 
 class ModelWidget;
 class LibraryTreeItem;
@@ -67,8 +74,33 @@ public:
 private:
   QString mLastValidText;
   bool mTextChanged;
+  QTimer *mpSyntaxCheckTimer;
+  QFutureWatcher<QList<SyntaxDiagnostic> > *mpSyntaxCheckWatcher;
+  int mSyntaxCheckRevision;
+  ModelicaOutline *mpModelicaOutline;
+  QSplitter *mpOutlineSplitter;
+  QTreeWidget *mpOutlineTreeWidget;
+  QAction *mpShowOutlineAction;
+  QAction *mpFoldOutlineItemAction;
+  QAction *mpUnFoldOutlineItemAction;
+
+  void replaceChangedText(const QString &contents, int *pFirstBlockNumber, int *pLastBlockNumber);
+  void addOutlineTreeItems(QTreeWidgetItem *pParentTreeItem, OutlineItem *pOutlineItem, const QSet<QString> &expandedPaths, const QString &path);
+  QString outlineTreeItemPath(QTreeWidgetItem *pTreeItem);
+  OutlineItem* findOutlineItem(QTreeWidgetItem *pTreeItem);
+  QList<int> outlineTreeItemIndexes(QTreeWidgetItem *pTreeItem);
+  OutlineItem* findOutlineItem(const QList<int> &indexes);
+  void setOutlineItemVisible(QTreeWidgetItem *pTreeItem, bool visible);
 private slots:
   virtual void showContextMenu(QPoint point);
+  void checkSyntax();
+  void syntaxChecked();
+  void showOutline(bool show);
+  void updateOutlineTree();
+  void outlineTreeItemActivated(QTreeWidgetItem *pTreeItem);
+  void showOutlineContextMenu(QPoint point);
+  void foldOutlineItem();
+  void unFoldOutlineItem();
 public slots:
   void setPlainText(const QString &text, bool useInserText = true);
   virtual void contentsHasChanged(int position, int charsRemoved, int charsAdded);
@@ -88,14 +120,13 @@ public:
 protected:
   virtual void highlightBlock(const QString &text);
 private:
+  // flag added to the block state when the block ends inside an annotation
+  enum {FoldingState = 4};
   ModelicaEditorPage *mpModelicaEditorPage;
   QPlainTextEdit *mpPlainTextEdit;
-  struct HighlightingRule
-  {
-    QRegExp mPattern;
-    QTextCharFormat mFormat;
-  };
-  QVector<HighlightingRule> mHighlightingRules;
+  ModelicaLexer mLexer;
+  bool mSyntaxHighlighting;
+  bool mMatchParenthesesCommentsQuotes;
   QTextCharFormat mTextFormat;
   QTextCharFormat mKeywordFormat;
   QTextCharFormat mTypeFormat;
@@ -0,0 +1,212 @@
+/*
+ * This file is part of OpenModelica.
+ *
+ * Copyright (c) 1998-CurrentYear, Open Source Modelica Consortium (OSMC),
+ * c/o Linköpings universitet, Department of Computer and Information Science,
+ * SE-58183 Linköping, Sweden.
+ *
+ * All rights reserved.
+ *
+ * THIS PROGRAM IS PROVIDED UNDER THE TERMS OF GPL VERSION 3 LICENSE OR
+ * THIS OSMC PUBLIC LICENSE (OSMC-PL) VERSION 1.2.
+ * ANY USE, REPRODUCTION OR DISTRIBUTION OF THIS PROGRAM CONSTITUTES
+ * RECIPIENT'S ACCEPTANCE OF THE OSMC PUBLIC LICENSE OR THE GPL VERSION 3,
+ * ACCORDING TO RECIPIENTS CHOICE.
+ *
+ * The OpenModelica software and the Open Source Modelica
+ * Consortium (OSMC) Public License (OSMC-PL) are obtained
+ * from OSMC, either from the above address,
+ * from the URLs: http://www.ida.liu.se/projects/OpenModelica or
+ * http://www.openmodelica.org, and in the OpenModelica distribution.
+ * GNU version 3 is obtained from: http://www.gnu.org/copyleft/gpl.html.
+ *
+ * This program is distributed WITHOUT ANY WARRANTY; without
+ * even the implied warranty of  MERCHANTABILITY or FITNESS
+ * FOR A PARTICULAR PURPOSE, EXCEPT AS EXPRESSLY SET FORTH
+ * IN THE BY RECIPIENT SELECTED SUBSIDIARY LICENSE CONDITIONS OF OSMC-PL.
+ *
+ * See the full OSMC Public License conditions for more details.
+ *
+ */
+
+#include "ModelicaLexer.h"
+
+/*!
+ * \brief ModelicaLexer::ModelicaLexer
+ */
+ModelicaLexer::ModelicaLexer()
+  : mHighlightFunctions(false), mWords(128)
+{
+}
+
+/*!
+ * \brief ModelicaLexer::restrictionKeywords
+ * Returns the keywords that start a class definition, including the MetaModelica uniontype.
+ * \return
+ */
+const QStringList& ModelicaLexer::restrictionKeywords()
+{
+  static const QStringList restrictions = QStringList() << "block" << "class" << "connector" << "function" << "model" << "operator"
+                                                        << "package" << "record" << "type" << "uniontype";
+  return restrictions;
+}
+
+/*!
+ * \brief ModelicaLexer::prefixKeywords
+ * Returns the keywords that can precede a class definition or a component declaration.
+ * \return
+ */
+const QStringList& ModelicaLexer::prefixKeywords()
+{
+  static const QStringList prefixes = QStringList() << "constant" << "discrete" << "each" << "encapsulated" << "expandable" << "final"
+                                                    << "flow" << "impure" << "inner" << "input" << "outer" << "output" << "parameter"
+                                                    << "partial" << "pure" << "redeclare" << "replaceable" << "stream";
+  return prefixes;
+}
+
+/*!
+ * \brief ModelicaLexer::initialize
+ * Builds the table of keywords and types.
+ * \param keywords
+ * \param types
+ * \param highlightFunctions - if true then the words followed by ( are classified as functions.
+ */
+void ModelicaLexer::initialize(const QStringList &keywords, const QStringList &types, bool highlightFunctions)
+{
+  mHighlightFunctions = highlightFunctions;
+  mWords = QVector<QList<QPair<QString, WordType> > >(128);
+  foreach (const QString &keyword, keywords) {
+    mWords[keyword.at(0).unicode()].append(qMakePair(keyword, Keyword));
+  }
+  // the types take precedence over the keywords
+  foreach (const QString &type, types) {
+    mWords[type.at(0).unicode()].prepend(qMakePair(type, Type));
+  }
+}
+
+/*!
+ * \brief ModelicaLexer::wordType
+ * Classifies the word text[index, end).
+ * \param text
+ * \param index
+ * \param end
+ * \return
+ */
+ModelicaLexer::WordType ModelicaLexer::wordType(const QString &text, int index, int end) const
+{
+  const ushort first = text.at(index).unicode();
+  if (first < 128) {
+    const QList<QPair<QString, WordType> > &words = mWords.at(first);
+    for (int i = 0; i < words.size(); ++i) {
+      if (isWord(text, index, end, words.at(i).first)) {
+        return words.at(i).second;
+      }
+    }
+  }
+  if (mHighlightFunctions && end < text.length() && text.at(end) == QLatin1Char('(')) {
+    return Function;
+  }
+  return Text;
+}
+
+/*!
+ * \brief ModelicaLexer::isWordStart
+ * Returns true if the character can start an identifier.
+ * \param character
+ * \return
+ */
+bool ModelicaLexer::isWordStart(const QChar &character)
+{
+  return (character >= QLatin1Char('a') && character <= QLatin1Char('z')) || (character >= QLatin1Char('A') && character <= QLatin1Char('Z'))
+      || character == QLatin1Char('_');
+}
+
+/*!
+ * \brief ModelicaLexer::isWordCharacter
+ * Returns true if the character can be part of an identifier.
+ * \param character
+ * \return
+ */
+bool ModelicaLexer::isWordCharacter(const QChar &character)
+{
+  return isWordStart(character) || isDigit(character);
+}
+
+/*!
+ * \brief ModelicaLexer::scanWord
+ * Returns the end of the word starting at index.
+ * \param text
+ * \param index
+ * \return
+ */
+int ModelicaLexer::scanWord(const QString &text, int index)
+{
+  while (index < text.length() && isWordCharacter(text.at(index))) {
+    index++;
+  }
+  return index;
+}
+
+/*!
+ * \brief ModelicaLexer::scanNumber
+ * Returns the end of the number starting at index, i.e. [0-9]+([.][0-9]*)?([eE][+-]?[0-9]*)?
+ * \param text
+ * \param index
+ * \return
+ */
+int ModelicaLexer::scanNumber(const QString &text, int index)
+{
+  while (index < text.length() && isDigit(text.at(index))) {
+    index++;
+  }
+  if (index < text.length() && text.at(index) == QLatin1Char('.')) {
+    index++;
+    while (index < text.length() && isDigit(text.at(index))) {
+      index++;
+    }
+  }
+  if (index < text.length() && (text.at(index) == QLatin1Char('e') || text.at(index) == QLatin1Char('E'))) {
+    index++;
+    if (index < text.length() && (text.at(index) == QLatin1Char('+') || text.at(index) == QLatin1Char('-'))) {
+      index++;
+    }
+    while (index < text.length() && isDigit(text.at(index))) {
+      index++;
+    }
+  }
+  return index;
+}
+
+/*!
+ * \brief ModelicaLexer::isWord
+ * Returns true if text[index, end) is the word.
+ * \param text
+ * \param index
+ * \param end
+ * \param word
+ * \return
+ */
+bool ModelicaLexer::isWord(const QString &text, int index, int end, const QString &word)
+{
+  return end - index == word.length() && QStringRef(&text, index, end - index) == word;
+}
+
+/*!
+ * \brief ModelicaLexer::indexOfWord
+ * Returns the index of the first occurrence of the word that is not part of another identifier.
+ * \param text
+ * \param word
+ * \return the index or -1 if the word is not found.
+ */
+int ModelicaLexer::indexOfWord(const QString &text, const QString &word)
+{
+  int index = text.indexOf(word);
+  while (index >= 0) {
+    const int end = index + word.length();
+    if ((index == 0 || !isWordCharacter(text.at(index - 1))) && (end == text.length() || !isWordCharacter(text.at(end)))) {
+      return index;
+    }
+    index = text.indexOf(word, index + 1);
+  }
+  return -1;
+}
@@ -0,0 +1,71 @@
+/*
+ * This file is part of OpenModelica.
+ *
+ * Copyright (c) 1998-CurrentYear, Open Source Modelica Consortium (OSMC),
+ * c/o Linköpings universitet, Department of Computer and Information Science,
+ * SE-58183 Linköping, Sweden.
+ *
+ * All rights reserved.
+ *
+ * THIS PROGRAM IS PROVIDED UNDER THE TERMS OF GPL VERSION 3 LICENSE OR
+ * THIS OSMC PUBLIC LICENSE (OSMC-PL) VERSION 1.2.
+ * ANY USE, REPRODUCTION OR DISTRIBUTION OF THIS PROGRAM CONSTITUTES
+ * RECIPIENT'S ACCEPTANCE OF THE OSMC PUBLIC LICENSE OR THE GPL VERSION 3,
+ * ACCORDING TO RECIPIENTS CHOICE.
+ *
+ * The OpenModelica software and the Open Source Modelica
+ * Consortium (OSMC) Public License (OSMC-PL) are obtained
+ * from OSMC, either from the above address,
+ * from the URLs: http://www.ida.liu.se/projects/OpenModelica or
+ * http://www.openmodelica.org, and in the OpenModelica distribution.
+ * GNU version 3 is obtained from: http://www.gnu.org/copyleft/gpl.html.
+ *
+ * This program is distributed WITHOUT ANY WARRANTY; without
+ * even the implied warranty of  MERCHANTABILITY or FITNESS
+ * FOR A PARTICULAR PURPOSE, EXCEPT AS EXPRESSLY SET FORTH
+ * IN THE BY RECIPIENT SELECTED SUBSIDIARY LICENSE CONDITIONS OF OSMC-PL.
+ *
+ * See the full OSMC Public License conditions for more details.
+ *
+ */
+
+#ifndef MODELICALEXER_H
+#define MODELICALEXER_H
+
+#include <QPair>
+#include <QString>
+#include <QStringList>
+#include <QVector>
+
+/*!
+ * \brief The ModelicaLexer class
+ * Classifies the words and numbers of a text block for the Modelica and MetaModelica highlighters.\n
+ * The keywords and types are kept in a table indexed by their first character so a word is classified without regular expressions.
+ */
+class ModelicaLexer
+{
+public:
+  enum WordType {
+    Text,
+    Keyword,
+    Type,
+    Function
+  };
+  ModelicaLexer();
+  void initialize(const QStringList &keywords, const QStringList &types, bool highlightFunctions);
+  WordType wordType(const QString &text, int index, int end) const;
+  static bool isWordStart(const QChar &character);
+  static bool isWordCharacter(const QChar &character);
+  static bool isDigit(const QChar &character) {return character >= QLatin1Char('0') && character <= QLatin1Char('9');}
+  static int scanWord(const QString &text, int index);
+  static int scanNumber(const QString &text, int index);
+  static bool isWord(const QString &text, int index, int end, const QString &word);
+  static int indexOfWord(const QString &text, const QString &word);
+  static const QStringList& restrictionKeywords();
+  static const QStringList& prefixKeywords();
+private:
+  bool mHighlightFunctions;
+  QVector<QList<QPair<QString, WordType> > > mWords;
+};
+
+#endif // MODELICALEXER_H
@@ -0,0 +1,636 @@
+/*
+ * This file is part of OpenModelica.
+ *
+ * Copyright (c) 1998-CurrentYear, Open Source Modelica Consortium (OSMC),
+ * c/o Linköpings universitet, Department of Computer and Information Science,
+ * SE-58183 Linköping, Sweden.
+ *
+ * All rights reserved.
+ *
+ * THIS PROGRAM IS PROVIDED UNDER THE TERMS OF GPL VERSION 3 LICENSE OR
+ * THIS OSMC PUBLIC LICENSE (OSMC-PL) VERSION 1.2.
+ * ANY USE, REPRODUCTION OR DISTRIBUTION OF THIS PROGRAM CONSTITUTES RECIPIENT'S ACCEPTANCE
+ * OF THE OSMC PUBLIC LICENSE OR THE GPL VERSION 3, ACCORDING TO RECIPIENTS CHOICE.
+ *
+ * The OpenModelica software and the Open Source Modelica
+ * Consortium (OSMC) Public License (OSMC-PL) are obtained
+ * from OSMC, either from the above address,
+ * from the URLs: http://www.ida.liu.se/projects/OpenModelica or
+ * http://www.openmodelica.org, and in the OpenModelica distribution.
+ * GNU version 3 is obtained from: http://www.gnu.org/copyleft/gpl.html.
+ *
+ * This program is distributed WITHOUT ANY WARRANTY; without
+ * even the implied warranty of  MERCHANTABILITY or FITNESS
+ * FOR A PARTICULAR PURPOSE, EXCEPT AS EXPRESSLY SET FORTH
+ * IN THE BY RECIPIENT SELECTED SUBSIDIARY LICENSE CONDITIONS OF OSMC-PL.
+ *
+ * See the full OSMC Public License conditions for more details.
+ *
+ */
+
+#include "ModelicaOutline.h"
+#include "ModelicaLexer.h"
+
+#include <QStringList>
+#include <QTextBlock>
+#include <QTextDocument>
+#include <QTimer>
+
+namespace {
+
+  enum Section {
+    DeclarationSection,
+    EquationSection,
+    AlgorithmSection,
+    ExternalSection
+  };
+
+  // a token of the statement being parsed together with its block
+  class StatementToken
+  {
+  public:
+    StatementToken() : mPosition(0) {}
+    StatementToken(const OutlineToken &token, const QTextBlock &block, int blockPosition)
+      : mToken(token), mBlock(block), mPosition(blockPosition + token.mPosition) {}
+    // the text is only read for the names used by the outline
+    QString text() const {return mBlock.text().mid(mToken.mPosition, mToken.mLength);}
+    bool isName() const {return mToken.mKind == OutlineToken::Word && mToken.mKeyword == ModelicaOutline::NoKeyword;}
+    int keyword() const {return mToken.mKind == OutlineToken::Word ? mToken.mKeyword : -1;}
+    OutlineToken mToken;
+    QTextBlock mBlock;
+    int mPosition;
+  };
+
+  // the class being parsed
+  class ClassContext
+  {
+  public:
+    ClassContext() : mpItem(0), mSection(DeclarationSection), mpSectionItem(0) {}
+    ClassContext(OutlineItem *pItem) : mpItem(pItem), mSection(DeclarationSection), mpSectionItem(0) {}
+    OutlineItem *mpItem;
+    int mSection;
+    OutlineItem *mpSectionItem;
+  };
+
+  void closeSection(ClassContext *pClassContext, int position)
+  {
+    if (pClassContext->mpSectionItem) {
+      pClassContext->mpSectionItem->mEndPosition = position;
+      pClassContext->mpSectionItem = 0;
+    }
+  }
+
+  void setSection(ClassContext *pClassContext, int section, const QString &name, int position)
+  {
+    closeSection(pClassContext, position);
+    pClassContext->mSection = section;
+    if (!name.isEmpty()) {
+      pClassContext->mpSectionItem = new OutlineItem(OutlineItem::Section, name, QString(), position);
+      pClassContext->mpItem->mChildren.append(pClassContext->mpSectionItem);
+    }
+  }
+
+  void addItem(ClassContext *pClassContext, OutlineItem::Type type, const QString &name, const QString &detail, int position, int endPosition)
+  {
+    OutlineItem *pOutlineItem = new OutlineItem(type, name, detail, position);
+    pOutlineItem->mEndPosition = endPosition;
+    pClassContext->mpItem->mChildren.append(pOutlineItem);
+  }
+
+  // ends the innermost open class called name and the classes nested in it
+  void endClass(QList<ClassContext> *pClasses, const QString &name, int position)
+  {
+    int index = pClasses->size() - 1;
+    while (index > 0 && pClasses->at(index).mpItem->mName != name) {
+      index--;
+    }
+    if (index == 0) {
+      return;
+    }
+    while (pClasses->size() > index) {
+      closeSection(&pClasses->last(), position);
+      pClasses->last().mpItem->mEndPosition = position;
+      pClasses->removeLast();
+    }
+  }
+
+  // reads the name A.B.C starting at index
+  QString dottedName(const QVector<StatementToken> &statement, int *pIndex)
+  {
+    QString name;
+    int index = *pIndex;
+    if (index < statement.size() && statement.at(index).mToken.mKind == OutlineToken::Dot) {
+      name.append(QLatin1Char('.'));
+      index++;
+    }
+    while (index < statement.size() && statement.at(index).isName()) {
+      name.append(statement.at(index).text());
+      index++;
+      if (index + 1 < statement.size() && statement.at(index).mToken.mKind == OutlineToken::Dot && statement.at(index + 1).isName()) {
+        name.append(QLatin1Char('.'));
+        index++;
+      } else {
+        break;
+      }
+    }
+    *pIndex = index;
+    return name;
+  }
+
+  // joins the restriction keywords starting at index, e.g. operator record
+  QString restriction(const QVector<StatementToken> &statement, int *pIndex)
+  {
+    QStringList words;
+    int index = *pIndex;
+    while (index < statement.size() && statement.at(index).keyword() == ModelicaOutline::RestrictionKeyword) {
+      words.append(statement.at(index).text());
+      index++;
+    }
+    *pIndex = index;
+    return words.join(QLatin1String(" "));
+  }
+
+  int skipPrefixes(const QVector<StatementToken> &statement, int index)
+  {
+    while (index < statement.size() && statement.at(index).keyword() == ModelicaOutline::PrefixKeyword) {
+      index++;
+    }
+    return index;
+  }
+
+  /* Called for each token added to the statement.
+   * Handles the section keywords and opens a class as soon as the token after its name is seen since the class header has no semicolon.
+   */
+  void startStatement(QVector<StatementToken> *pStatement, QList<ClassContext> *pClasses)
+  {
+    const StatementToken &first = pStatement->first();
+    ClassContext *pClassContext = &pClasses->last();
+    const int keyword = first.keyword();
+    if (pStatement->size() == 1) {
+      switch (keyword) {
+        case ModelicaOutline::EquationKeyword:
+          setSection(pClassContext, EquationSection, QLatin1String("equation"), first.mPosition);
+          pStatement->clear();
+          return;
+        case ModelicaOutline::AlgorithmKeyword:
+          setSection(pClassContext, AlgorithmSection, QLatin1String("algorithm"), first.mPosition);
+          pStatement->clear();
+          return;
+        case ModelicaOutline::PublicKeyword:
+        case ModelicaOutline::ProtectedKeyword:
+          setSection(pClassContext, DeclarationSection, QString(), first.mPosition);
+          pStatement->clear();
+          return;
+        case ModelicaOutline::ExternalKeyword:
+          // the external function call ends with a semicolon and is ignored
+          setSection(pClassContext, ExternalSection, QString(), first.mPosition);
+          return;
+        default:
+          break;
+      }
+    } else if (pStatement->size() == 2 && keyword == ModelicaOutline::InitialKeyword) {
+      if (pStatement->at(1).keyword() == ModelicaOutline::EquationKeyword) {
+        setSection(pClassContext, EquationSection, QLatin1String("initial equation"), first.mPosition);
+        pStatement->clear();
+      } else if (pStatement->at(1).keyword() == ModelicaOutline::AlgorithmKeyword) {
+        setSection(pClassContext, AlgorithmSection, QLatin1String("initial algorithm"), first.mPosition);
+        pStatement->clear();
+      }
+      return;
+    }
+    if (keyword != ModelicaOutline::PrefixKeyword && keyword != ModelicaOutline::RestrictionKeyword) {
+      return;
+    }
+    int index = skipPrefixes(*pStatement, 0);
+    QString detail = restriction(*pStatement, &index);
+    if (detail.isEmpty()) {
+      return;
+    }
+    if (index < pStatement->size() && pStatement->at(index).keyword() == ModelicaOutline::ExtendsKeyword) {
+      detail.append(QLatin1String(" extends"));
+      index++;
+    }
+    // wait for the token after the name, a short class definition is added when the statement is finished
+    if (index + 1 >= pStatement->size() || !pStatement->at(index).isName() || pStatement->at(index + 1).mToken.mKind == OutlineToken::Equals) {
+      return;
+    }
+    OutlineItem *pOutlineItem = new OutlineItem(OutlineItem::Class, pStatement->at(index).text(), detail, first.mPosition);
+    pClassContext->mpItem->mChildren.append(pOutlineItem);
+    pClasses->append(ClassContext(pOutlineItem));
+    // the rest of the statement starts the first element of the class
+    pStatement->remove(0, index + 1);
+    startStatement(pStatement, pClasses);
+  }
+
+  // called when the semicolon at the end of the statement is seen
+  void finishStatement(const QVector<StatementToken> &statement, int position, QList<ClassContext> *pClasses)
+  {
+    if (statement.isEmpty()) {
+      return;
+    }
+    ClassContext *pClassContext = &pClasses->last();
+    const StatementToken &first = statement.first();
+    switch (first.keyword()) {
+      case ModelicaOutline::EndKeyword:
+        // end if, end for etc. have a keyword after end
+        if (statement.size() > 1 && statement.at(1).isName()) {
+          endClass(pClasses, statement.at(1).text(), first.mPosition);
+        }
+        return;
+      case ModelicaOutline::AnnotationKeyword:
+        addItem(pClassContext, OutlineItem::Annotation, first.text(), QString(), first.mPosition, position + 1);
+        return;
+      case ModelicaOutline::NoKeyword:
+      case ModelicaOutline::PrefixKeyword:
+      case ModelicaOutline::RestrictionKeyword:
+      case ModelicaOutline::ExtendsKeyword:
+        break;
+      default:
+        return;
+    }
+    if (pClassContext->mSection != DeclarationSection) {
+      return;
+    }
+    int index = skipPrefixes(statement, 0);
+    if (index >= statement.size()) {
+      return;
+    }
+    if (statement.at(index).keyword() == ModelicaOutline::ExtendsKeyword) {
+      index++;
+      QString name = dottedName(statement, &index);
+      if (!name.isEmpty()) {
+        addItem(pClassContext, OutlineItem::Extends, name, QString(), first.mPosition, position + 1);
+      }
+      return;
+    }
+    if (statement.at(index).keyword() == ModelicaOutline::RestrictionKeyword) {
+      // short class definition
+      QString detail = restriction(statement, &index);
+      if (index < statement.size() && statement.at(index).isName()) {
+        addItem(pClassContext, OutlineItem::Class, statement.at(index).text(), detail, first.mPosition, position + 1);
+      }
+      return;
+    }
+    QString type = dottedName(statement, &index);
+    if (type.isEmpty()) {
+      return;
+    }
+    // the component names follow the type and the commas, the rest are modifiers and bindings
+    bool expectName = true;
+    for (; index < statement.size(); ++index) {
+      const StatementToken &token = statement.at(index);
+      if (expectName && token.isName()) {
+        addItem(pClassContext, OutlineItem::Component, token.text(), type, token.mPosition, position + 1);
+      }
+      expectName = token.mToken.mKind == OutlineToken::Comma;
+    }
+  }
+
+  QHash<QString, int> createKeywords()
+  {
+    QHash<QString, int> keywords;
+    foreach (const QString &keyword, ModelicaLexer::restrictionKeywords()) {
+      keywords.insert(keyword, ModelicaOutline::RestrictionKeyword);
+    }
+    foreach (const QString &keyword, ModelicaLexer::prefixKeywords()) {
+      keywords.insert(keyword, ModelicaOutline::PrefixKeyword);
+    }
+    QStringList others;
+    others << "and" << "case" << "constrainedby" << "else" << "elseif" << "elsewhen" << "enumeration" << "false" << "for" << "if" << "in"
+           << "local" << "loop" << "match" << "matchcontinue" << "not" << "or" << "then" << "true" << "try" << "when" << "while" << "within";
+    foreach (const QString &keyword, others) {
+      keywords.insert(keyword, ModelicaOutline::OtherKeyword);
+    }
+    keywords.insert("end", ModelicaOutline::EndKeyword);
+    keywords.insert("extends", ModelicaOutline::ExtendsKeyword);
+    keywords.insert("import", ModelicaOutline::ImportKeyword);
+    keywords.insert("annotation", ModelicaOutline::AnnotationKeyword);
+    keywords.insert("equation", ModelicaOutline::EquationKeyword);
+    keywords.insert("algorithm", ModelicaOutline::AlgorithmKeyword);
+    keywords.insert("initial", ModelicaOutline::InitialKeyword);
+    keywords.insert("public", ModelicaOutline::PublicKeyword);
+    keywords.insert("protected", ModelicaOutline::ProtectedKeyword);
+    keywords.insert("external", ModelicaOutline::ExternalKeyword);
+    return keywords;
+  }
+
+}
+
+/*!
+ * \class OutlineItem
+ * \brief An item of the Modelica outline.
+ */
+/*!
+ * \brief OutlineItem::hasSameStructure
+ * Returns true if the items have the same type, name, detail and children. The positions are not compared.
+ * \param pOutlineItem
+ * \return
+ */
+bool OutlineItem::hasSameStructure(const OutlineItem *pOutlineItem) const
+{
+  if (mType != pOutlineItem->mType || mName != pOutlineItem->mName || mDetail != pOutlineItem->mDetail
+      || mChildren.size() != pOutlineItem->mChildren.size()) {
+    return false;
+  }
+  for (int i = 0; i < mChildren.size(); ++i) {
+    if (!mChildren.at(i)->hasSameStructure(pOutlineItem->mChildren.at(i))) {
+      return false;
+    }
+  }
+  return true;
+}
+
+/*!
+ * \class ModelicaOutline
+ * \brief Structural parser of the Modelica text.
+ */
+/*!
+ * \brief ModelicaOutline::ModelicaOutline
+ * \param pTextDocument
+ */
+ModelicaOutline::ModelicaOutline(QTextDocument *pTextDocument)
+  : QObject(pTextDocument), mpTextDocument(pTextDocument), mpRootItem(0), mTextChanged(false)
+{
+  // build the outline when the user stops typing
+  mpUpdateTimer = new QTimer(this);
+  mpUpdateTimer->setSingleShot(true);
+  mpUpdateTimer->setInterval(300);
+  connect(mpUpdateTimer, SIGNAL(timeout()), SLOT(update()));
+  connect(mpTextDocument, SIGNAL(contentsChange(int,int,int)), SLOT(contentsChange(int,int,int)));
+  mBlocks.resize(mpTextDocument->blockCount());
+  tokenizeBlocks(0, mBlocks.size() - 1);
+  buildOutline();
+}
+
+/*!
+ * \brief ModelicaOutline::~ModelicaOutline
+ */
+ModelicaOutline::~ModelicaOutline()
+{
+  delete mpRootItem;
+}
+
+/*!
+ * \brief ModelicaOutline::keywords
+ * Returns the keywords that are relevant for the outline.
+ * \return
+ */
+const QHash<QString, int>& ModelicaOutline::keywords()
+{
+  static const QHash<QString, int> keywords = createKeywords();
+  return keywords;
+}
+
+/*!
+ * \brief ModelicaOutline::tokenizeBlock
+ * Finds the words and structural characters of the block text. The comments, strings and numbers are skipped.
+ * \param text
+ * \param state - the state at the end of the previous block.
+ * \param pOutlineBlock
+ */
+void ModelicaOutline::tokenizeBlock(const QString &text, int state, OutlineBlock *pOutlineBlock)
+{
+  const QHash<QString, int> &keywordsHash = keywords();
+  QVector<OutlineToken> &tokens = pOutlineBlock->mTokens;
+  tokens.resize(0);
+  const int length = text.length();
+  int index = 0;
+  while (index < length) {
+    if (state == CommentState) {
+      int end = text.indexOf(QLatin1String("*/"), index);
+      if (end < 0) {
+        break;
+      }
+      index = end + 2;
+      state = NormalState;
+      continue;
+    } else if (state == StringState) {
+      while (index < length && text.at(index) != QLatin1Char('"')) {
+        if (text.at(index) == QLatin1Char('\\')) {
+          index++;
+        }
+        index++;
+      }
+      if (index >= length) {
+        break;
+      }
+      index++;
+      state = NormalState;
+      continue;
+    }
+    const QChar character = text.at(index);
+    if (ModelicaLexer::isWordStart(character)) {
+      int end = ModelicaLexer::scanWord(text, index);
+      // fromRawData avoids copying the word for the lookup
+      int keyword = keywordsHash.value(QString::fromRawData(text.unicode() + index, end - index), NoKeyword);
+      tokens.append(OutlineToken(OutlineToken::Word, keyword, index, end - index));
+      index = end;
+      continue;
+    } else if (ModelicaLexer::isDigit(character)) {
+      index = ModelicaLexer::scanNumber(text, index);
+      continue;
+    }
+    switch (character.unicode()) {
+      case '/':
+        if (index + 1 < length && text.at(index + 1) == QLatin1Char('/')) {
+          index = length;
+        } else if (index + 1 < length && text.at(index + 1) == QLatin1Char('*')) {
+          state = CommentState;
+          index++;
+        }
+        break;
+      case '"':
+        state = StringState;
+        break;
+      case '\'': {
+        int end = index + 1;
+        while (end < length && text.at(end) != QLatin1Char('\'')) {
+          if (text.at(end) == QLatin1Char('\\')) {
+            end++;
+          }
+          end++;
+        }
+        end = qMin(end + 1, length);
+        tokens.append(OutlineToken(OutlineToken::Word, NoKeyword, index, end - index));
+        index = end - 1;
+        break;
+      }
+      case ';':
+        tokens.append(OutlineToken(OutlineToken::Semicolon, NoKeyword, index, 1));
+        break;
+      case ',':
+        tokens.append(OutlineToken(OutlineToken::Comma, NoKeyword, index, 1));
+        break;
+      case '.':
+        tokens.append(OutlineToken(OutlineToken::Dot, NoKeyword, index, 1));
+        break;
+      case '=': {
+        // skip ==, <=, >= and :=
+        const QChar previous = index > 0 ? text.at(index - 1) : QChar();
+        if ((index + 1 >= length || text.at(index + 1) != QLatin1Char('=')) && previous != QLatin1Char('=')
+            && previous != QLatin1Char('<') && previous != QLatin1Char('>') && previous != QLatin1Char(':')) {
+          tokens.append(OutlineToken(OutlineToken::Equals, NoKeyword, index, 1));
+        }
+        break;
+      }
+      case '(':
+      case '[':
+      case '{':
+        tokens.append(OutlineToken(OutlineToken::Open, NoKeyword, index, 1));
+        break;
+      case ')':
+      case ']':
+      case '}':
+        tokens.append(OutlineToken(OutlineToken::Close, NoKeyword, index, 1));
+        break;
+      default:
+        break;
+    }
+    index++;
+  }
+  pOutlineBlock->mState = state;
+}
+
+/*!
+ * \brief ModelicaOutline::tokenizeBlocks
+ * Tokenizes the blocks firstBlockNumber to lastBlockNumber.
+ * Continues with the following blocks as long as the state at the end of the block changes, e.g. when a comment is opened.
+ * \param firstBlockNumber
+ * \param lastBlockNumber
+ */
+void ModelicaOutline::tokenizeBlocks(int firstBlockNumber, int lastBlockNumber)
+{
+  int state = firstBlockNumber > 0 ? mBlocks.at(firstBlockNumber - 1).mState : NormalState;
+  int blockNumber = firstBlockNumber;
+  for (QTextBlock block = mpTextDocument->findBlockByNumber(firstBlockNumber); block.isValid() && blockNumber < mBlocks.size();
+       block = block.next(), ++blockNumber) {
+    OutlineBlock *pOutlineBlock = &mBlocks[blockNumber];
+    const int previousState = pOutlineBlock->mState;
+    tokenizeBlock(block.text(), state, pOutlineBlock);
+    state = pOutlineBlock->mState;
+    if (blockNumber >= lastBlockNumber && state == previousState) {
+      break;
+    }
+  }
+}
+
+/*!
+ * \brief ModelicaOutline::buildOutline
+ * Builds the outline from the tokens of the blocks in one pass.
+ * Emits outlineChanged() if the classes, components, sections or annotations have changed.
+ */
+void ModelicaOutline::buildOutline()
+{
+  if (mBlocks.size() != mpTextDocument->blockCount()) {
+    mBlocks = QVector<OutlineBlock>(mpTextDocument->blockCount());
+    tokenizeBlocks(0, mBlocks.size() - 1);
+  }
+  OutlineItem *pRootItem = new OutlineItem(OutlineItem::Class, QString(), QString(), 0);
+  QList<ClassContext> classes;
+  classes.append(ClassContext(pRootItem));
+  QVector<StatementToken> statement;
+  // the depth of the parentheses, brackets and braces
+  int depth = 0;
+  int blockNumber = 0;
+  for (QTextBlock block = mpTextDocument->firstBlock(); block.isValid(); block = block.next(), ++blockNumber) {
+    const QVector<OutlineToken> &tokens = mBlocks.at(blockNumber).mTokens;
+    if (tokens.isEmpty()) {
+      continue;
+    }
+    const int blockPosition = block.position();
+    for (int i = 0; i < tokens.size(); ++i) {
+      const OutlineToken &token = tokens.at(i);
+      switch (token.mKind) {
+        case OutlineToken::Open:
+          depth++;
+          continue;
+        case OutlineToken::Close:
+          depth = qMax(0, depth - 1);
+          continue;
+        case OutlineToken::Word:
+          // a line starting with a section keyword or end is not part of an unbalanced expression being typed
+          if (i == 0 && depth > 0 && (token.mKeyword == EndKeyword || token.mKeyword == EquationKeyword || token.mKeyword == AlgorithmKeyword
+                                      || token.mKeyword == PublicKeyword || token.mKeyword == ProtectedKeyword)) {
+            depth = 0;
+            statement.clear();
+          }
+          break;
+        default:
+          break;
+      }
+      if (depth > 0) {
+        continue;
+      }
+      if (token.mKind == OutlineToken::Semicolon) {
+        finishStatement(statement, blockPosition + token.mPosition, &classes);
+        statement.clear();
+      } else if (statement.size() < MaxStatementTokens) {
+        statement.append(StatementToken(token, block, blockPosition));
+        startStatement(&statement, &classes);
+      }
+    }
+  }
+  // the classes that are not ended yet end with the text
+  const int endPosition = qMax(0, mpTextDocument->characterCount() - 1);
+  while (classes.size() > 1) {
+    closeSection(&classes.last(), endPosition);
+    classes.last().mpItem->mEndPosition = endPosition;
+    classes.removeLast();
+  }
+  closeSection(&classes.last(), endPosition);
+  pRootItem->mEndPosition = endPosition;
+  bool changed = !mpRootItem || !pRootItem->hasSameStructure(mpRootItem);
+  delete mpRootItem;
+  mpRootItem = pRootItem;
+  if (changed) {
+    emit outlineChanged();
+  }
+}
+
+/*!
+ * \brief ModelicaOutline::update
+ * Builds the outline now if the text has changed since the last update.
+ */
+void ModelicaOutline::update()
+{
+  mpUpdateTimer->stop();
+  if (mTextChanged) {
+    mTextChanged = false;
+    buildOutline();
+  }
+}
+
+/*!
+ * \brief ModelicaOutline::contentsChange
+ * Replaces the tokens of the changed blocks and schedules the update of the outline.
+ * \param position
+ * \param charsRemoved
+ * \param charsAdded
+ */
+void ModelicaOutline::contentsChange(int position, int charsRemoved, int charsAdded)
+{
+  Q_UNUSED(charsRemoved);
+  const int blockCount = mpTextDocument->blockCount();
+  QTextBlock firstBlock = mpTextDocument->findBlock(position);
+  QTextBlock lastBlock = mpTextDocument->findBlock(position + charsAdded);
+  if (!lastBlock.isValid()) {
+    lastBlock = mpTextDocument->lastBlock();
+  }
+  const int firstBlockNumber = firstBlock.blockNumber();
+  const int lastBlockNumber = lastBlock.blockNumber();
+  // the blocks firstBlockNumber to removedLastBlockNumber of the old text are replaced by firstBlockNumber to lastBlockNumber
+  const int removedLastBlockNumber = lastBlockNumber + mBlocks.size() - blockCount;
+  if (!firstBlock.isValid() || removedLastBlockNumber < firstBlockNumber || removedLastBlockNumber >= mBlocks.size()) {
+    mBlocks = QVector<OutlineBlock>(blockCount);
+    tokenizeBlocks(0, blockCount - 1);
+  } else {
+    if (removedLastBlockNumber > lastBlockNumber) {
+      mBlocks.remove(firstBlockNumber, removedLastBlockNumber - lastBlockNumber);
+    } else if (removedLastBlockNumber < lastBlockNumber) {
+      mBlocks.insert(firstBlockNumber, lastBlockNumber - removedLastBlockNumber, OutlineBlock());
+    }
+    tokenizeBlocks(firstBlockNumber, lastBlockNumber);
+  }
+  mTextChanged = true;
+  mpUpdateTimer->start();
+}
@@ -0,0 +1,157 @@
+/*
+ * This file is part of OpenModelica.
+ *
+ * Copyright (c) 1998-CurrentYear, Open Source Modelica Consortium (OSMC),
+ * c/o Linköpings universitet, Department of Computer and Information Science,
+ * SE-58183 Linköping, Sweden.
+ *
+ * All rights reserved.
+ *
+ * THIS PROGRAM IS PROVIDED UNDER THE TERMS OF GPL VERSION 3 LICENSE OR
+ * THIS OSMC PUBLIC LICENSE (OSMC-PL) VERSION 1.2.
+ * ANY USE, REPRODUCTION OR DISTRIBUTION OF THIS PROGRAM CONSTITUTES RECIPIENT'S ACCEPTANCE
+ * OF THE OSMC PUBLIC LICENSE OR THE GPL VERSION 3, ACCORDING TO RECIPIENTS CHOICE.
+ *
+ * The OpenModelica software and the Open Source Modelica
+ * Consortium (OSMC) Public License (OSMC-PL) are obtained
+ * from OSMC, either from the above address,
+ * from the URLs: http://www.ida.liu.se/projects/OpenModelica or
+ * http://www.openmodelica.org, and in the OpenModelica distribution.
+ * GNU version 3 is obtained from: http://www.gnu.org/copyleft/gpl.html.
+ *
+ * This program is distributed WITHOUT ANY WARRANTY; without
+ * even the implied warranty of  MERCHANTABILITY or FITNESS
+ * FOR A PARTICULAR PURPOSE, EXCEPT AS EXPRESSLY SET FORTH
+ * IN THE BY RECIPIENT SELECTED SUBSIDIARY LICENSE CONDITIONS OF OSMC-PL.
+ *
+ * See the full OSMC Public License conditions for more details.
+ *
+ */
+
+#ifndef MODELICAOUTLINE_H
+#define MODELICAOUTLINE_H
+
+#include <QObject>
+#include <QHash>
+#include <QList>
+#include <QString>
+#include <QVector>
+
+class QTextDocument;
+class QTimer;
+
+/*!
+ * \brief The OutlineToken class
+ * A word or a structural character of a text block. The position is in characters of the block.
+ */
+class OutlineToken
+{
+public:
+  enum Kind {
+    Word,
+    Semicolon,
+    Comma,
+    Dot,
+    Equals,
+    Open,
+    Close
+  };
+  OutlineToken() : mKind(Word), mKeyword(0), mPosition(0), mLength(0) {}
+  OutlineToken(Kind kind, int keyword, int position, int length) : mKind(kind), mKeyword(keyword), mPosition(position), mLength(length) {}
+  short mKind;
+  short mKeyword;
+  int mPosition;
+  int mLength;
+};
+Q_DECLARE_TYPEINFO(OutlineToken, Q_PRIMITIVE_TYPE);
+
+/*!
+ * \brief The OutlineItem class
+ * A class, extends clause, component, section or annotation of the outline.
+ * The positions are in characters of the document when the outline was built.
+ */
+class OutlineItem
+{
+public:
+  enum Type {
+    Class,
+    Extends,
+    Component,
+    Section,
+    Annotation
+  };
+  OutlineItem(Type type, const QString &name, const QString &detail, int position)
+    : mType(type), mName(name), mDetail(detail), mPosition(position), mEndPosition(position) {}
+  ~OutlineItem() {qDeleteAll(mChildren);}
+  bool hasSameStructure(const OutlineItem *pOutlineItem) const;
+  Type mType;
+  QString mName;
+  QString mDetail;
+  int mPosition;
+  int mEndPosition;
+  QList<OutlineItem*> mChildren;
+};
+
+/*!
+ * \brief The ModelicaOutline class
+ * Keeps an outline of the classes, extends clauses, components, sections and annotations of the Modelica text in a QTextDocument without OMC.\n
+ * The tokens of each block are cached and only the changed blocks are tokenized again on QTextDocument::contentsChange.
+ * The outline is built from the cached tokens when the user stops typing.
+ */
+class ModelicaOutline : public QObject
+{
+  Q_OBJECT
+public:
+  ModelicaOutline(QTextDocument *pTextDocument);
+  ~ModelicaOutline();
+  // only the first tokens of a statement are needed to find the classes and components
+  enum {MaxStatementTokens = 64};
+  enum Keyword {
+    NoKeyword,
+    RestrictionKeyword,
+    PrefixKeyword,
+    EndKeyword,
+    ExtendsKeyword,
+    ImportKeyword,
+    AnnotationKeyword,
+    EquationKeyword,
+    AlgorithmKeyword,
+    InitialKeyword,
+    PublicKeyword,
+    ProtectedKeyword,
+    ExternalKeyword,
+    OtherKeyword
+  };
+  OutlineItem* getRootItem() {return mpRootItem;}
+private:
+  enum State {
+    NormalState,
+    CommentState,
+    StringState
+  };
+  class OutlineBlock
+  {
+  public:
+    OutlineBlock() : mState(NormalState) {}
+    QVector<OutlineToken> mTokens;
+    int mState;
+  };
+  QTextDocument *mpTextDocument;
+  QVector<OutlineBlock> mBlocks;
+  OutlineItem *mpRootItem;
+  QTimer *mpUpdateTimer;
+  bool mTextChanged;
+
+  static const QHash<QString, int>& keywords();
+  static void tokenizeBlock(const QString &text, int state, OutlineBlock *pOutlineBlock);
+  void tokenizeBlocks(int firstBlockNumber, int lastBlockNumber);
+  void buildOutline();
+signals:
+  void outlineChanged();
+public slots:
+  void update();
+private slots:
+  void contentsChange(int position, int charsRemoved, int charsAdded);
+};
+
+#endif // MODELICAOUTLINE_H
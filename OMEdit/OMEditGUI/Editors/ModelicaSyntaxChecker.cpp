@@ -0,0 +1,195 @@
+/*
+ * This file is part of OpenModelica.
+ *
+ * Copyright (c) 1998-CurrentYear, Open Source Modelica Consortium (OSMC),
+ * c/o Linköpings universitet, Department of Computer and Information Science,
+ * SE-58183 Linköping, Sweden.
+ *
+ * All rights reserved.
+ *
+ * THIS PROGRAM IS PROVIDED UNDER THE TERMS OF GPL VERSION 3 LICENSE OR
+ * THIS OSMC PUBLIC LICENSE (OSMC-PL) VERSION 1.2.
+ * ANY USE, REPRODUCTION OR DISTRIBUTION OF THIS PROGRAM CONSTITUTES
+ * RECIPIENT'S ACCEPTANCE OF THE OSMC PUBLIC LICENSE OR THE GPL VERSION 3,
+ * ACCORDING TO RECIPIENTS CHOICE.
+ *
+ * The OpenModelica software and the Open Source Modelica
+ * Consortium (OSMC) Public License (OSMC-PL) are obtained
+ * from OSMC, either from the above address,
+ * from the URLs: http://www.ida.liu.se/projects/OpenModelica or
+ * http://www.openmodelica.org, and in the OpenModelica distribution.
+ * GNU version 3 is obtained from: http://www.gnu.org/copyleft/gpl.html.
+ *
+ * This program is distributed WITHOUT ANY WARRANTY; without
+ * even the implied warranty of  MERCHANTABILITY or FITNESS
+ * FOR A PARTICULAR PURPOSE, EXCEPT AS EXPRESSLY SET FORTH
+ * IN THE BY RECIPIENT SELECTED SUBSIDIARY LICENSE CONDITIONS OF OSMC-PL.
+ *
+ * See the full OSMC Public License conditions for more details.
+ *
+ */
+
+#include "ModelicaSyntaxChecker.h"
+#include "ModelicaLexer.h"
+
+#include <QCoreApplication>
+#include <QPair>
+#include <QStringList>
+
+/*!
+ * \brief ModelicaSyntaxChecker::check
+ * Checks the text and returns the syntax errors in the order they are found.
+ * \param text
+ * \return
+ */
+QList<SyntaxDiagnostic> ModelicaSyntaxChecker::check(const QString &text)
+{
+  QList<SyntaxDiagnostic> diagnostics;
+  // the open parentheses, brackets and braces
+  QList<int> openings;
+  // the names and positions of the open class definitions
+  QList<QPair<QString, int> > classes;
+  int index = 0;
+  while (index < text.length()) {
+    const QChar character = text.at(index);
+    if (character == QLatin1Char('/') && index + 1 < text.length() && text.at(index + 1) == QLatin1Char('/')) {
+      int end = text.indexOf(QLatin1Char('\n'), index);
+      index = end < 0 ? text.length() : end;
+    } else if (character == QLatin1Char('/') && index + 1 < text.length() && text.at(index + 1) == QLatin1Char('*')) {
+      int end = text.indexOf(QLatin1String("*/"), index + 2);
+      if (end < 0) {
+        diagnostics.append(SyntaxDiagnostic(index, 2, QCoreApplication::translate("ModelicaSyntaxChecker", "Unterminated comment.")));
+        return diagnostics;
+      }
+      index = end + 2;
+    } else if (character == QLatin1Char('"')) {
+      int end = index + 1;
+      while (end < text.length() && text.at(end) != QLatin1Char('"')) {
+        end += text.at(end) == QLatin1Char('\\') ? 2 : 1;
+      }
+      if (end >= text.length()) {
+        diagnostics.append(SyntaxDiagnostic(index, 1, QCoreApplication::translate("ModelicaSyntaxChecker", "Unterminated string.")));
+        return diagnostics;
+      }
+      index = end + 1;
+    } else if (character == QLatin1Char('\'')) {
+      // quoted identifier
+      int end = text.indexOf(QLatin1Char('\''), index + 1);
+      index = end < 0 ? text.length() : end + 1;
+    } else if (character == QLatin1Char('(') || character == QLatin1Char('[') || character == QLatin1Char('{')) {
+      openings.append(index);
+      index++;
+    } else if (character == QLatin1Char(')') || character == QLatin1Char(']') || character == QLatin1Char('}')) {
+      const QChar opening = character == QLatin1Char(')') ? QLatin1Char('(') : (character == QLatin1Char(']') ? QLatin1Char('[') : QLatin1Char('{'));
+      if (openings.isEmpty()) {
+        diagnostics.append(SyntaxDiagnostic(index, 1, QCoreApplication::translate("ModelicaSyntaxChecker", "Unexpected %1.").arg(character)));
+      } else if (text.at(openings.last()) != opening) {
+        diagnostics.append(SyntaxDiagnostic(index, 1, QCoreApplication::translate("ModelicaSyntaxChecker", "%1 does not match %2.")
+                                            .arg(character).arg(text.at(openings.last()))));
+        openings.removeLast();
+      } else {
+        openings.removeLast();
+      }
+      index++;
+    } else if (ModelicaLexer::isWordStart(character)) {
+      int end = ModelicaLexer::scanWord(text, index);
+      // the class definitions are only checked outside of parentheses, e.g., not in modifiers and annotations.
+      if (openings.isEmpty() && isClassRestriction(text, index, end)) {
+        int nameStart = skipSpacesAndComments(text, end);
+        int nameEnd = ModelicaLexer::scanWord(text, nameStart);
+        // skip the additional prefixes, e.g., operator record, expandable connector and model extends
+        while (nameEnd > nameStart && (isClassRestriction(text, nameStart, nameEnd) || ModelicaLexer::isWord(text, nameStart, nameEnd, "extends"))) {
+          nameStart = skipSpacesAndComments(text, nameEnd);
+          nameEnd = ModelicaLexer::scanWord(text, nameStart);
+        }
+        // short class definitions, e.g., model A = B, don't have an end
+        int next = skipSpacesAndComments(text, nameEnd);
+        if (nameEnd > nameStart && (next >= text.length() || text.at(next) != QLatin1Char('='))) {
+          classes.append(qMakePair(text.mid(nameStart, nameEnd - nameStart), nameStart));
+        }
+        index = nameEnd > nameStart ? nameEnd : end;
+      } else if (openings.isEmpty() && ModelicaLexer::isWord(text, index, end, "end")) {
+        int nameStart = skipSpacesAndComments(text, end);
+        int nameEnd = ModelicaLexer::scanWord(text, nameStart);
+        QString name = text.mid(nameStart, nameEnd - nameStart);
+        // end if, end for, end when and end while close statements and equations
+        if (!name.isEmpty() && name != QLatin1String("if") && name != QLatin1String("for") && name != QLatin1String("when")
+            && name != QLatin1String("while")) {
+          if (classes.isEmpty()) {
+            diagnostics.append(SyntaxDiagnostic(index, nameEnd - index, QCoreApplication::translate("ModelicaSyntaxChecker", "Unexpected end %1.")
+                                                .arg(name)));
+          } else {
+            if (classes.last().first != name) {
+              diagnostics.append(SyntaxDiagnostic(nameStart, nameEnd - nameStart,
+                                                  QCoreApplication::translate("ModelicaSyntaxChecker", "The end name %1 does not match the class name %2.")
+                                                  .arg(name).arg(classes.last().first)));
+            }
+            classes.removeLast();
+          }
+          index = nameEnd;
+        } else {
+          index = end;
+        }
+      } else {
+        index = end;
+      }
+    } else {
+      index++;
+    }
+  }
+  foreach (int opening, openings) {
+    diagnostics.append(SyntaxDiagnostic(opening, 1, QCoreApplication::translate("ModelicaSyntaxChecker", "%1 is not closed.").arg(text.at(opening))));
+  }
+  for (int i = 0; i < classes.size(); ++i) {
+    diagnostics.append(SyntaxDiagnostic(classes.at(i).second, classes.at(i).first.length(),
+                                        QCoreApplication::translate("ModelicaSyntaxChecker", "Missing end %1;").arg(classes.at(i).first)));
+  }
+  return diagnostics;
+}
+
+/*!
+ * \brief ModelicaSyntaxChecker::isClassRestriction
+ * Returns true if the word text[index, end) starts a class definition.
+ * \param text
+ * \param index
+ * \param end
+ * \return
+ */
+bool ModelicaSyntaxChecker::isClassRestriction(const QString &text, int index, int end)
+{
+  // a restriction in a qualified name is not a keyword, e.g., Modelica.Blocks.Types
+  if (index > 0 && text.at(index - 1) == QLatin1Char('.')) {
+    return false;
+  }
+  foreach (const QString &restriction, ModelicaLexer::restrictionKeywords()) {
+    if (ModelicaLexer::isWord(text, index, end, restriction)) {
+      return true;
+    }
+  }
+  return false;
+}
+
+/*!
+ * \brief ModelicaSyntaxChecker::skipSpacesAndComments
+ * Returns the index of the first character at or after index that is not a space or part of a comment.
+ * \param text
+ * \param index
+ * \return
+ */
+int ModelicaSyntaxChecker::skipSpacesAndComments(const QString &text, int index)
+{
+  while (index < text.length()) {
+    if (text.at(index).isSpace()) {
+      index++;
+    } else if (text.at(index) == QLatin1Char('/') && index + 1 < text.length() && text.at(index + 1) == QLatin1Char('/')) {
+      int end = text.indexOf(QLatin1Char('\n'), index);
+      index = end < 0 ? text.length() : end;
+    } else if (text.at(index) == QLatin1Char('/') && index + 1 < text.length() && text.at(index + 1) == QLatin1Char('*')) {
+      int end = text.indexOf(QLatin1String("*/"), index + 2);
+      index = end < 0 ? text.length() : end + 2;
+    } else {
+      break;
+    }
+  }
+  return index;
+}
@@ -0,0 +1,66 @@
+/*
+ * This file is part of OpenModelica.
+ *
+ * Copyright (c) 1998-CurrentYear, Open Source Modelica Consortium (OSMC),
+ * c/o Linköpings universitet, Department of Computer and Information Science,
+ * SE-58183 Linköping, Sweden.
+ *
+ * All rights reserved.
+ *
+ * THIS PROGRAM IS PROVIDED UNDER THE TERMS OF GPL VERSION 3 LICENSE OR
+ * THIS OSMC PUBLIC LICENSE (OSMC-PL) VERSION 1.2.
+ * ANY USE, REPRODUCTION OR DISTRIBUTION OF THIS PROGRAM CONSTITUTES
+ * RECIPIENT'S ACCEPTANCE OF THE OSMC PUBLIC LICENSE OR THE GPL VERSION 3,
+ * ACCORDING TO RECIPIENTS CHOICE.
+ *
+ * The OpenModelica software and the Open Source Modelica
+ * Consortium (OSMC) Public License (OSMC-PL) are obtained
+ * from OSMC, either from the above address,
+ * from the URLs: http://www.ida.liu.se/projects/OpenModelica or
+ * http://www.openmodelica.org, and in the OpenModelica distribution.
+ * GNU version 3 is obtained from: http://www.gnu.org/copyleft/gpl.html.
+ *
+ * This program is distributed WITHOUT ANY WARRANTY; without
+ * even the implied warranty of  MERCHANTABILITY or FITNESS
+ * FOR A PARTICULAR PURPOSE, EXCEPT AS EXPRESSLY SET FORTH
+ * IN THE BY RECIPIENT SELECTED SUBSIDIARY LICENSE CONDITIONS OF OSMC-PL.
+ *
+ * See the full OSMC Public License conditions for more details.
+ *
+ */
+
+#ifndef MODELICASYNTAXCHECKER_H
+#define MODELICASYNTAXCHECKER_H
+
+#include <QList>
+#include <QString>
+
+/*!
+ * \brief The SyntaxDiagnostic class
+ * A syntax error found by the ModelicaSyntaxChecker. The position and length are in characters of the checked text.
+ */
+class SyntaxDiagnostic
+{
+public:
+  SyntaxDiagnostic() : mPosition(0), mLength(0) {}
+  SyntaxDiagnostic(int position, int length, const QString &message) : mPosition(position), mLength(length), mMessage(message) {}
+  int mPosition;
+  int mLength;
+  QString mMessage;
+};
+
+/*!
+ * \brief The ModelicaSyntaxChecker class
+ * Checks the structure of Modelica text without OMC so that it can run on a worker thread while the user types.\n
+ * Reports unterminated strings and comments, unbalanced parentheses, brackets and braces, and class definitions with a missing or different end name.
+ */
+class ModelicaSyntaxChecker
+{
+public:
+  static QList<SyntaxDiagnostic> check(const QString &text);
+private:
+  static bool isClassRestriction(const QString &text, int index, int end);
+  static int skipSpacesAndComments(const QString &text, int index);
+};
+
+#endif // MODELICASYNTAXCHECKER_H
@@ -1200,7 +1200,7 @@ void MainWindow::createOMNotebookImageCell(LibraryTreeItem *pLibraryTreeItem, QD
   // paint the background color first
   painter.fillRect(modelImage.rect(), pGraphicsView->palette().background());
   // paint all the items
-  pGraphicsView->render(&painter, QRectF(painter.viewport()), pGraphicsView->viewport()->rect());
+  pGraphicsView->renderWithoutCache(&painter, QRectF(painter.viewport()), pGraphicsView->viewport()->rect(), false);
   painter.end();
   // create textcell element
   QDomElement textCellElement = xmlDocument.createElement("TextCell");
@@ -1861,9 +1861,9 @@ void MainWindow::setShowGridLines(bool showLines)
   mpModelWidgetContainer->setShowGridLines(showLines);
   ModelWidget *pModelWidget = mpModelWidgetContainer->getCurrentModelWidget();
   if (pModelWidget && pModelWidget->getIconGraphicsView() && pModelWidget->getIconGraphicsView()->isVisible()) {
-    pModelWidget->getIconGraphicsView()->scene()->update();
+    pModelWidget->getIconGraphicsView()->resetCachedContent();
   } else if (pModelWidget && pModelWidget->getDiagramGraphicsView() && pModelWidget->getDiagramGraphicsView()->isVisible()) {
-    pModelWidget->getDiagramGraphicsView()->scene()->update();
+    pModelWidget->getDiagramGraphicsView()->resetCachedContent();
   }
 }
 
@@ -2407,11 +2407,8 @@ void MainWindow::exportModelAsImage(bool copyToClipboard)
     }
     painter.setWindow(destinationRect);
     // paint all the items
-    bool oldSkipDrawBackground = pGraphicsView->mSkipBackground;
-    pGraphicsView->mSkipBackground = true;
-    pGraphicsView->render(&painter, destinationRect, destinationRect);
+    pGraphicsView->renderWithoutCache(&painter, destinationRect, destinationRect);
     painter.end();
-    pGraphicsView->mSkipBackground = oldSkipDrawBackground;
     if (!fileName.endsWith(".svg") && !copyToClipboard) {
       if (!modelImage.save(fileName)) {
         QMessageBox::critical(this, QString(Helper::applicationName).append(" - ").append(Helper::error),
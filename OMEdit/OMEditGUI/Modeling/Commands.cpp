@@ -35,6 +35,7 @@
 #include "MainWindow.h"
 
 #include <QMessageBox>
+#include <QDateTime>
 
 UndoCommand::UndoCommand(QUndoCommand *pParent)
   : QUndoCommand(pParent), mFailed(false), mEnabled(true)
@@ -385,6 +386,172 @@ void UpdateComponentTransformationsCommand::undo()
   mpComponent->emitTransformHasChanged();
 }
 
+/*!
+ * \class MoveComponentsCommand
+ * \brief Moves a set of components by offsets and updates the connections attached to them.\n
+ * Only the offsets and the points of the affected connections are stored so that moving large selections stays cheap.
+ * Consecutive moves of the same components are merged into one command.
+ */
+/*!
+ * \brief MoveComponentsCommand::MoveComponentsCommand
+ * \param pGraphicsView
+ * \param components
+ * \param offsets - the offset of each component in scene coordinates.
+ * \param pParent
+ */
+MoveComponentsCommand::MoveComponentsCommand(GraphicsView *pGraphicsView, const QList<Component*> &components, const QList<QPointF> &offsets,
+                                             UndoCommand *pParent)
+  : UndoCommand(pParent)
+{
+  mpGraphicsView = pGraphicsView;
+  mComponents = components.toVector();
+  mOffsets = offsets.toVector();
+  mTimeStamp = QDateTime::currentMSecsSinceEpoch();
+  // find the connections, transitions and initial states attached to the moved components
+  QSet<Component*> componentsSet;
+  foreach (Component *pComponent, mComponents) {
+    componentsSet.insert(pComponent);
+  }
+  QList<LineAnnotation*> lines = mpGraphicsView->getConnectionsList();
+  lines.append(mpGraphicsView->getTransitionsList());
+  lines.append(mpGraphicsView->getInitialStatesList());
+  foreach (LineAnnotation *pLineAnnotation, lines) {
+    if ((pLineAnnotation->getStartComponent() && componentsSet.contains(pLineAnnotation->getStartComponent()->getRootParentComponent())) ||
+        (pLineAnnotation->getEndComponent() && componentsSet.contains(pLineAnnotation->getEndComponent()->getRootParentComponent()))) {
+      mLines.append(pLineAnnotation);
+      mOldPoints.append(pLineAnnotation->getOldPoints().isEmpty() ? pLineAnnotation->getPoints() : pLineAnnotation->getOldPoints());
+    }
+  }
+  if (mComponents.size() == 1) {
+    setText(QString("Move Component %1").arg(mComponents.at(0)->getName()));
+  } else {
+    setText(QString("Move %1 Components").arg(mComponents.size()));
+  }
+}
+
+/*!
+ * \brief MoveComponentsCommand::redoInternal
+ * redoInternal the MoveComponentsCommand.
+ */
+void MoveComponentsCommand::redoInternal()
+{
+  for (int i = 0 ; i < mComponents.size() ; i++) {
+    moveComponent(mComponents.at(i), mOffsets.at(i));
+  }
+  /* The first time the connections follow the components through Component::transformChange SIGNAL.
+   * Save their new points so that redo after undo restores exactly the same connections.
+   */
+  bool firstTime = mNewPoints.isEmpty();
+  for (int i = 0 ; i < mLines.size() ; i++) {
+    if (firstTime) {
+      mNewPoints.append(mLines.at(i)->getPoints());
+    }
+    updateLinePoints(mLines.at(i), mNewPoints.at(i));
+  }
+}
+
+/*!
+ * \brief MoveComponentsCommand::undo
+ * Undo the MoveComponentsCommand.
+ */
+void MoveComponentsCommand::undo()
+{
+  for (int i = 0 ; i < mComponents.size() ; i++) {
+    moveComponent(mComponents.at(i), -mOffsets.at(i));
+  }
+  for (int i = 0 ; i < mLines.size() ; i++) {
+    updateLinePoints(mLines.at(i), mOldPoints.at(i));
+  }
+}
+
+/*!
+ * \brief MoveComponentsCommand::mergeWith
+ * Merges the consecutive moves of the same components.
+ * \param pUndoCommand
+ * \return
+ */
+bool MoveComponentsCommand::mergeWith(const QUndoCommand *pUndoCommand)
+{
+  const MoveComponentsCommand *pMoveComponentsCommand = static_cast<const MoveComponentsCommand*>(pUndoCommand);
+  if (pMoveComponentsCommand->mpGraphicsView != mpGraphicsView || pMoveComponentsCommand->mComponents != mComponents ||
+      pMoveComponentsCommand->mLines != mLines || pMoveComponentsCommand->mTimeStamp - mTimeStamp > 1000) {
+    return false;
+  }
+  for (int i = 0 ; i < mOffsets.size() ; i++) {
+    mOffsets[i] += pMoveComponentsCommand->mOffsets.at(i);
+  }
+  mNewPoints = pMoveComponentsCommand->mNewPoints;
+  mTimeStamp = pMoveComponentsCommand->mTimeStamp;
+  return true;
+}
+
+/*!
+ * \brief MoveComponentsCommand::moveComponent
+ * Moves the component by offset.\n
+ * If the component is a connector in the diagram view then its icon view counterpart is also moved.
+ * \param pComponent
+ * \param offset
+ */
+void MoveComponentsCommand::moveComponent(Component *pComponent, const QPointF &offset)
+{
+  Transformation transformation = pComponent->mTransformation;
+  transformation.adjustPosition(offset.x(), offset.y());
+  ModelWidget *pModelWidget = mpGraphicsView->getModelWidget();
+  if (pComponent->getLibraryTreeItem() && pComponent->getLibraryTreeItem()->isConnector() &&
+      mpGraphicsView->getViewType() == StringHandler::Diagram &&
+      pModelWidget->getLibraryTreeItem()->getLibraryType() == LibraryTreeItem::Modelica) {
+    Component *pIconComponent = pModelWidget->getIconGraphicsView()->getComponentObject(pComponent->getName());
+    if (pIconComponent && (pComponent->mTransformation == pIconComponent->mTransformation)) {
+      pIconComponent->resetTransform();
+      bool state = pIconComponent->flags().testFlag(QGraphicsItem::ItemSendsGeometryChanges);
+      pIconComponent->setFlag(QGraphicsItem::ItemSendsGeometryChanges, false);
+      pIconComponent->setPos(0, 0);
+      pIconComponent->setFlag(QGraphicsItem::ItemSendsGeometryChanges, state);
+      pIconComponent->setTransform(transformation.getTransformationMatrix());
+      pIconComponent->mTransformation = transformation;
+      pIconComponent->emitTransformChange();
+    }
+  }
+  pComponent->resetTransform();
+  bool state = pComponent->flags().testFlag(QGraphicsItem::ItemSendsGeometryChanges);
+  pComponent->setFlag(QGraphicsItem::ItemSendsGeometryChanges, false);
+  pComponent->setPos(0, 0);
+  pComponent->setFlag(QGraphicsItem::ItemSendsGeometryChanges, state);
+  pComponent->setTransform(transformation.getTransformationMatrix());
+  pComponent->mTransformation = transformation;
+  pComponent->emitTransformChange();
+  pComponent->emitTransformHasChanged();
+}
+
+/*!
+ * \brief MoveComponentsCommand::updateLinePoints
+ * Sets the points of the line and updates its annotation.
+ * \param pLineAnnotation
+ * \param points
+ */
+void MoveComponentsCommand::updateLinePoints(LineAnnotation *pLineAnnotation, const QList<QPointF> &points)
+{
+  if (pLineAnnotation->getPoints() != points) {
+    pLineAnnotation->emitPrepareGeometryChange();
+    pLineAnnotation->setPoints(points);
+    pLineAnnotation->removeCornerItems();
+    pLineAnnotation->drawCornerItems();
+    pLineAnnotation->adjustGeometries();
+    pLineAnnotation->setCornerItemsActiveOrPassive();
+    pLineAnnotation->update();
+  }
+  pLineAnnotation->emitChanged();
+  if (pLineAnnotation->getLineType() == LineAnnotation::TransitionType) {
+    pLineAnnotation->updateTransitionTextPosition();
+    pLineAnnotation->updateTransitionAnnotation(pLineAnnotation->getCondition(), pLineAnnotation->getImmediate(), pLineAnnotation->getReset(),
+                                                pLineAnnotation->getSynchronize(), pLineAnnotation->getPriority());
+  } else if (pLineAnnotation->getLineType() == LineAnnotation::InitialStateType) {
+    pLineAnnotation->updateInitialStateAnnotation();
+  } else {
+    pLineAnnotation->updateConnectionAnnotation();
+  }
+}
+
 UpdateComponentAttributesCommand::UpdateComponentAttributesCommand(Component *pComponent, const ComponentInfo &oldComponentInfo,
                                                                    const ComponentInfo &newComponentInfo, bool duplicate, UndoCommand *pParent)
   : UndoCommand(pParent)
@@ -483,6 +650,7 @@ void UpdateComponentAttributesCommand::redoInternal()
     if (pOMCProxy->renameComponentInClass(modelName, mpComponent->getComponentInfo()->getName(), mNewComponentInfo.getName())) {
       mpComponent->renameComponentInConnections(mNewComponentInfo.getName());
       mpComponent->getComponentInfo()->setName(mNewComponentInfo.getName());
+      mpComponent->getGraphicsView()->getModelWidget()->getLibraryTreeItem()->invalidateComponentsIndex();
       mpComponent->componentNameHasChanged();
       if (mpComponent->getLibraryTreeItem()->isConnector()) {
         if (mpComponent->getGraphicsView()->getViewType() == StringHandler::Icon) {
@@ -626,6 +794,7 @@ void UpdateComponentAttributesCommand::undo()
     if (pOMCProxy->renameComponentInClass(modelName, mpComponent->getComponentInfo()->getName(), mOldComponentInfo.getName())) {
       mpComponent->renameComponentInConnections(mOldComponentInfo.getName());
       mpComponent->getComponentInfo()->setName(mOldComponentInfo.getName());
+      mpComponent->getGraphicsView()->getModelWidget()->getLibraryTreeItem()->invalidateComponentsIndex();
       mpComponent->componentNameHasChanged();
       if (mpComponent->getLibraryTreeItem()->isConnector()) {
         if (mpComponent->getGraphicsView()->getViewType() == StringHandler::Icon) {
@@ -121,6 +121,28 @@ private:
   Transformation mNewTransformation;
 };
 
+class MoveComponentsCommand : public UndoCommand
+{
+public:
+  MoveComponentsCommand(GraphicsView *pGraphicsView, const QList<Component*> &components, const QList<QPointF> &offsets,
+                        UndoCommand *pParent = 0);
+  void redoInternal();
+  void undo();
+  int id() const {return 1;}
+  bool mergeWith(const QUndoCommand *pUndoCommand);
+private:
+  GraphicsView *mpGraphicsView;
+  QVector<Component*> mComponents;
+  QVector<QPointF> mOffsets;
+  QVector<LineAnnotation*> mLines;
+  QVector<QList<QPointF> > mOldPoints;
+  QVector<QList<QPointF> > mNewPoints;
+  qint64 mTimeStamp;
+
+  void moveComponent(Component *pComponent, const QPointF &offset);
+  void updateLinePoints(LineAnnotation *pLineAnnotation, const QList<QPointF> &points);
+};
+
 class UpdateComponentAttributesCommand : public UndoCommand
 {
 public:
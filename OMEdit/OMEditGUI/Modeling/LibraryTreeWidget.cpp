@@ -46,6 +46,11 @@
 #include "Git/GitCommands.h"
 #include "Git/CommitChangesDialog.h"
 
+#include <algorithm>
+#include <QSet>
+
+int LibraryTreeItem::mInheritedClassesVersion = 0;
+
 /*!
  * \class LibraryTreeItem
  * \brief Contains the information about the Modelica class.
@@ -58,6 +63,9 @@ LibraryTreeItem::LibraryTreeItem()
 {
   mIsRootItem = true;
   mpParentLibraryTreeItem = 0;
+  mInheritedClassesDeepListVersion = -1;
+  mChildrenIndexValid = false;
+  mComponentsIndexValid = false;
   setLibraryType(LibraryTreeItem::Modelica);
   setSystemLibrary(false);
   setModelWidget(0);
@@ -104,6 +112,9 @@ LibraryTreeItem::LibraryTreeItem(LibraryType type, QString text, QString nameStr
 {
   mIsRootItem = false;
   mpParentLibraryTreeItem = pParent;
+  mInheritedClassesDeepListVersion = -1;
+  mChildrenIndexValid = false;
+  mComponentsIndexValid = false;
   setPixmap(QPixmap());
   setDragPixmap(QPixmap());
   setName(text);
@@ -141,6 +152,21 @@ LibraryTreeItem::~LibraryTreeItem()
 {
   qDeleteAll(mChildren);
   mChildren.clear();
+  // the deleted class might be in the cached inheritance closures
+  mInheritedClassesVersion++;
+}
+
+/*!
+ * \brief LibraryTreeItem::setName
+ * Sets the name of the LibraryTreeItem and invalidates the children index of the parent.
+ * \param name
+ */
+void LibraryTreeItem::setName(QString name)
+{
+  mName = name;
+  if (mpParentLibraryTreeItem) {
+    mpParentLibraryTreeItem->mChildrenIndexValid = false;
+  }
 }
 
 QString LibraryTreeItem::getWhereToMoveFMU()
@@ -555,6 +581,7 @@ int LibraryTreeItem::getNestedLevelInPackage() const
 void LibraryTreeItem::insertChild(int position, LibraryTreeItem *pLibraryTreeItem)
 {
   mChildren.insert(position, pLibraryTreeItem);
+  mChildrenIndexValid = false;
 }
 
 /*!
@@ -587,6 +614,7 @@ void LibraryTreeItem::moveChild(int from, int to)
 void LibraryTreeItem::addInheritedClass(LibraryTreeItem *pLibraryTreeItem)
 {
   mInheritedClasses.append(pLibraryTreeItem);
+  mInheritedClassesVersion++;
   connect(pLibraryTreeItem, SIGNAL(loaded(LibraryTreeItem*)), this, SLOT(handleLoaded(LibraryTreeItem*)), Qt::UniqueConnection);
   connect(pLibraryTreeItem, SIGNAL(unLoaded()), this, SLOT(handleUnloaded()), Qt::UniqueConnection);
   connect(pLibraryTreeItem, SIGNAL(shapeAdded(ShapeAnnotation*,GraphicsView*)),
@@ -617,15 +645,34 @@ void LibraryTreeItem::removeInheritedClasses()
     disconnect(pLibraryTreeItem, SIGNAL(coOrdinateSystemUpdated(GraphicsView*)), this, SLOT(handleCoOrdinateSystemUpdated(GraphicsView*)));
   }
   mInheritedClasses.clear();
+  mInheritedClassesVersion++;
 }
 
+/*!
+ * \brief LibraryTreeItem::getInheritedClassesDeepList
+ * Returns the class and all its base classes in breadth first order. Each class is listed once.\n
+ * The list is cached until an inherited class is added or removed anywhere, e.g., when a class is reloaded.
+ * \return
+ */
 QList<LibraryTreeItem*> LibraryTreeItem::getInheritedClassesDeepList()
 {
+  if (mInheritedClassesDeepListVersion == mInheritedClassesVersion) {
+    return mInheritedClassesDeepList;
+  }
   QList<LibraryTreeItem*> result;
+  QSet<LibraryTreeItem*> visited;
   result.append(this);
+  visited.insert(this);
   for (int i = 0; i < result.size(); ++i) {
-    result.append(result[i]->getInheritedClasses());
+    foreach (LibraryTreeItem *pInheritedLibraryTreeItem, result[i]->getInheritedClasses()) {
+      if (!visited.contains(pInheritedLibraryTreeItem)) {
+        visited.insert(pInheritedLibraryTreeItem);
+        result.append(pInheritedLibraryTreeItem);
+      }
+    }
   }
+  mInheritedClassesDeepList = result;
+  mInheritedClassesDeepListVersion = mInheritedClassesVersion;
   return result;
 }
 
@@ -634,6 +681,7 @@ void LibraryTreeItem::setModelWidget(ModelWidget *pModelWidget)
   mpModelWidget = pModelWidget;
   mComponents.clear();
   mComponentsLoaded = false;
+  mComponentsIndexValid = false;
 }
 
 const QList<ComponentInfo*> &LibraryTreeItem::getComponentsList()
@@ -649,19 +697,74 @@ const QList<ComponentInfo*> &LibraryTreeItem::getComponentsList()
   }
 }
 
-LibraryTreeItem *LibraryTreeItem::getDirectComponentsClass(const QString &name)
+/*!
+ * \brief nameLessThan
+ * Compares the name of an index entry with a name. Used to search the sorted children and components indexes.
+ * \param entry
+ * \param name
+ * \return
+ */
+template <typename T>
+static bool nameLessThan(const QPair<QString, T*> &entry, const QString &name)
+{
+  return entry.first < name;
+}
+
+/*!
+ * \brief LibraryTreeItem::getChildrenIndex
+ * Returns the children sorted by name. The index is rebuilt when a child is added, removed or renamed.
+ * \return
+ */
+const QVector<QPair<QString, LibraryTreeItem*> > &LibraryTreeItem::getChildrenIndex()
 {
-  QList<LibraryTreeItem*> children = childrenItems();
-  for (int i = 0; i < children.size(); ++i) {
-    if (children[i]->getName() == name)
-      return children[i];
+  if (!mChildrenIndexValid) {
+    mChildrenIndex.clear();
+    mChildrenIndex.reserve(mChildren.size());
+    foreach (LibraryTreeItem *pLibraryTreeItem, mChildren) {
+      mChildrenIndex.append(qMakePair(pLibraryTreeItem->getName(), pLibraryTreeItem));
+    }
+    std::stable_sort(mChildrenIndex.begin(), mChildrenIndex.end(), nameLessThan<LibraryTreeItem>);
+    mChildrenIndexValid = true;
   }
-  const QList<ComponentInfo*> &components = getComponentsList();
-  for (int i = 0; i < components.size(); ++i) {
-    if (components[i]->getName() == name) {
-      LibraryTreeModel *pLibraryTreeModel = MainWindow::instance()->getLibraryWidget()->getLibraryTreeModel();
-      return pLibraryTreeModel->findLibraryTreeItem(components[i]->getClassName());
+  return mChildrenIndex;
+}
+
+/*!
+ * \brief LibraryTreeItem::getComponentsIndex
+ * Returns the components sorted by name.\n
+ * The index is rebuilt when the components of the ModelWidget are loaded again or a component is renamed.
+ * \return
+ * \sa LibraryTreeItem::invalidateComponentsIndex()
+ */
+const QVector<QPair<QString, ComponentInfo*> > &LibraryTreeItem::getComponentsIndex()
+{
+  if (!mComponentsIndexValid) {
+    const QList<ComponentInfo*> &components = getComponentsList();
+    mComponentsIndex.clear();
+    mComponentsIndex.reserve(components.size());
+    foreach (ComponentInfo *pComponentInfo, components) {
+      mComponentsIndex.append(qMakePair(pComponentInfo->getName(), pComponentInfo));
     }
+    std::stable_sort(mComponentsIndex.begin(), mComponentsIndex.end(), nameLessThan<ComponentInfo>);
+    mComponentsIndexValid = true;
+  }
+  return mComponentsIndex;
+}
+
+LibraryTreeItem *LibraryTreeItem::getDirectComponentsClass(const QString &name)
+{
+  const QVector<QPair<QString, LibraryTreeItem*> > &children = getChildrenIndex();
+  QVector<QPair<QString, LibraryTreeItem*> >::const_iterator child = std::lower_bound(children.constBegin(), children.constEnd(), name,
+                                                                                      nameLessThan<LibraryTreeItem>);
+  if (child != children.constEnd() && child->first == name) {
+    return child->second;
+  }
+  const QVector<QPair<QString, ComponentInfo*> > &components = getComponentsIndex();
+  QVector<QPair<QString, ComponentInfo*> >::const_iterator component = std::lower_bound(components.constBegin(), components.constEnd(), name,
+                                                                                        nameLessThan<ComponentInfo>);
+  if (component != components.constEnd() && component->first == name) {
+    LibraryTreeModel *pLibraryTreeModel = MainWindow::instance()->getLibraryWidget()->getLibraryTreeModel();
+    return pLibraryTreeModel->findLibraryTreeItem(component->second->getClassName());
   }
 
   return 0;
@@ -684,18 +787,23 @@ void LibraryTreeItem::tryToComplete(QList<CompleterItem> &completionClasses, QLi
   QList<LibraryTreeItem*> baseClasses = getInheritedClassesDeepList();
 
   for (int bc = 0; bc < baseClasses.size(); ++bc) {
-    QList<LibraryTreeItem*> classes = baseClasses[bc]->childrenItems();
-    for (int i = 0; i < classes.size(); ++i) {
-      if (classes[i]->getName().startsWith(lastPart) &&
-              classes[i]->getNameStructure().compare("OMEdit.Search.Feature") != 0)
-        completionClasses << (CompleterItem(classes[i]->getName(), classes[i]->getHTMLDescription()));
+    // the names starting with lastPart are consecutive in the sorted indexes
+    const QVector<QPair<QString, LibraryTreeItem*> > &classes = baseClasses[bc]->getChildrenIndex();
+    QVector<QPair<QString, LibraryTreeItem*> >::const_iterator classIterator = std::lower_bound(classes.constBegin(), classes.constEnd(), lastPart,
+                                                                                               nameLessThan<LibraryTreeItem>);
+    for (; classIterator != classes.constEnd() && classIterator->first.startsWith(lastPart); ++classIterator) {
+      LibraryTreeItem *pClass = classIterator->second;
+      if (pClass->getNameStructure().compare("OMEdit.Search.Feature") != 0)
+        completionClasses << (CompleterItem(pClass->getName(), pClass->getHTMLDescription()));
     }
 
-    const QList<ComponentInfo*> &components = baseClasses[bc]->getComponentsList();
     if (!baseClasses[bc]->isRootItem() && baseClasses[bc]->getLibraryType() == LibraryTreeItem::Modelica) {
-      for (int i = 0; i < components.size(); ++i) {
-        if (components[i]->getName().startsWith(lastPart))
-          completionComponents << CompleterItem(components[i]->getName(), components[i]->getHTMLDescription() + QString("<br/>// Inside %1").arg(baseClasses[bc]->mNameStructure));
+      const QVector<QPair<QString, ComponentInfo*> > &components = baseClasses[bc]->getComponentsIndex();
+      QVector<QPair<QString, ComponentInfo*> >::const_iterator componentIterator = std::lower_bound(components.constBegin(), components.constEnd(),
+                                                                                                   lastPart, nameLessThan<ComponentInfo>);
+      for (; componentIterator != components.constEnd() && componentIterator->first.startsWith(lastPart); ++componentIterator) {
+        ComponentInfo *pComponent = componentIterator->second;
+        completionComponents << CompleterItem(pComponent->getName(), pComponent->getHTMLDescription() + QString("<br/>// Inside %1").arg(baseClasses[bc]->mNameStructure));
       }
     }
   }
@@ -709,6 +817,7 @@ void LibraryTreeItem::tryToComplete(QList<CompleterItem> &completionClasses, QLi
 void LibraryTreeItem::removeChild(LibraryTreeItem *pLibraryTreeItem)
 {
   mChildren.removeOne(pLibraryTreeItem);
+  mChildrenIndexValid = false;
 }
 
 /*!
@@ -1523,6 +1632,10 @@ void LibraryTreeModel::updateLibraryTreeItemClassText(LibraryTreeItem *pLibraryT
     // we also mark the containing parent class unsaved because it is very important for saving of single file packages.
     pParentLibraryTreeItem->setIsSaved(false);
     updateLibraryTreeItem(pParentLibraryTreeItem);
+    // if the class is nested in a single file package then only update the text of the class.
+    if (pParentLibraryTreeItem != pLibraryTreeItem && updateNestedLibraryTreeItemClassText(pLibraryTreeItem, pParentLibraryTreeItem)) {
+      return;
+    }
     OMCProxy *pOMCProxy = MainWindow::instance()->getOMCProxy();
     QString before = pParentLibraryTreeItem->getClassText(this);
     QString after = pOMCProxy->listFile(pParentLibraryTreeItem->getNameStructure());
@@ -2398,6 +2511,171 @@ void LibraryTreeModel::updateChildLibraryTreeItemClassText(LibraryTreeItem *pLib
   }
 }
 
+/*!
+ * \brief LibraryTreeModel::updateNestedLibraryTreeItemClassText
+ * Updates the class text of a class nested in a single file package.\n
+ * Only the text of the class is regenerated and spliced into the containing file text.
+ * OMC is only fed the class and the positions of the other classes in the file are shifted instead of being read again.
+ * \param pLibraryTreeItem
+ * \param pParentLibraryTreeItem - the class that contains the file.
+ * \return false if the class text can't be located in the file text. The caller then updates the whole file.
+ */
+bool LibraryTreeModel::updateNestedLibraryTreeItemClassText(LibraryTreeItem *pLibraryTreeItem, LibraryTreeItem *pParentLibraryTreeItem)
+{
+  // the class text is read from the file text when it is missing
+  if (!pLibraryTreeItem->hasClassText()) {
+    return false;
+  }
+  QString contents = pParentLibraryTreeItem->getClassText(this);
+  int start, end, startColumn;
+  if (!getClassTextRange(pLibraryTreeItem, contents, &start, &end, &startColumn)) {
+    return false;
+  }
+  OMCProxy *pOMCProxy = MainWindow::instance()->getOMCProxy();
+  QString before = contents.mid(start, end - start);
+  QString after = pOMCProxy->list(pLibraryTreeItem->getNameStructure());
+  QString classContents = StringHandler::trimmedEnd(pOMCProxy->diffModelicaFileListings(before, after));
+  if (classContents.isEmpty()) {
+    return false;
+  }
+  contents = contents.left(start) + classContents + contents.mid(end);
+  // the end position of the class before and after the change
+  const int lineNumberEnd = pLibraryTreeItem->mClassInformation.lineNumberEnd;
+  const int columnNumberEnd = pLibraryTreeItem->mClassInformation.columnNumberEnd;
+  const int newLineNumberEnd = pLibraryTreeItem->mClassInformation.lineNumberStart + classContents.count('\n');
+  const int lastNewLine = classContents.lastIndexOf('\n');
+  const int newColumnNumberEnd = lastNewLine < 0 ? startColumn + classContents.length() : classContents.length() - lastNewLine - 1;
+  /* Feed OMC only the class. Pad it so that it starts at the same line and column as in the file
+   * so that OMC has the correct positions for the class and its nested classes.
+   */
+  QString classString = QString("within %1;").arg(pLibraryTreeItem->parent()->getNameStructure());
+  classString.append(QString(pLibraryTreeItem->mClassInformation.lineNumberStart - 1, '\n'));
+  classString.append(QString(startColumn, ' '));
+  classString.append(classContents);
+  pOMCProxy->loadString(classString, pParentLibraryTreeItem->getFileName(), Helper::utf8,
+                        pParentLibraryTreeItem->getSaveContentsType() == LibraryTreeItem::SaveFolderStructure, false);
+  // update the containing file class
+  pParentLibraryTreeItem->setClassText(contents);
+  if (pParentLibraryTreeItem->getModelWidget()) {
+    pParentLibraryTreeItem->getModelWidget()->setWindowTitle(QString(pParentLibraryTreeItem->getName()).append("*"));
+    ModelicaEditor *pModelicaEditor = dynamic_cast<ModelicaEditor*>(pParentLibraryTreeItem->getModelWidget()->getEditor());
+    if (pModelicaEditor) {
+      pModelicaEditor->setPlainText(contents);
+    }
+  }
+  // shift the positions of the classes after the changed class
+  shiftLibraryTreeItemClassText(pParentLibraryTreeItem, pLibraryTreeItem, lineNumberEnd, columnNumberEnd, newLineNumberEnd - lineNumberEnd,
+                                newColumnNumberEnd - columnNumberEnd, contents);
+  // update the changed class and its nested classes
+  pLibraryTreeItem->setClassInformation(pOMCProxy->getClassInformation(pLibraryTreeItem->getNameStructure()));
+  readLibraryTreeItemClassTextFromText(pLibraryTreeItem, contents);
+  if (pLibraryTreeItem->getModelWidget()) {
+    ModelicaEditor *pModelicaEditor = dynamic_cast<ModelicaEditor*>(pLibraryTreeItem->getModelWidget()->getEditor());
+    if (pModelicaEditor) {
+      pModelicaEditor->setPlainText(pLibraryTreeItem->getClassText(this));
+    }
+  }
+  updateChildLibraryTreeItemClassText(pLibraryTreeItem, contents, pParentLibraryTreeItem->getFileName());
+  return true;
+}
+
+/*!
+ * \brief LibraryTreeModel::getClassTextRange
+ * Finds the class text of the LibraryTreeItem in the text of its containing file.\n
+ * Uses the same rules as LibraryTreeModel::readLibraryTreeItemClassTextFromText().
+ * \param pLibraryTreeItem
+ * \param contents
+ * \param pStart - the position of the class text.
+ * \param pEnd - the position after the class text.
+ * \param pStartColumn - the column of the class text in its first line.
+ * \return false if the class text is not found.
+ */
+bool LibraryTreeModel::getClassTextRange(LibraryTreeItem *pLibraryTreeItem, const QString &contents, int *pStart, int *pEnd, int *pStartColumn)
+{
+  const OMCInterface::getClassInformation_res &classInformation = pLibraryTreeItem->mClassInformation;
+  // a class on a single line is read as a whole line so it is not handled here.
+  if (classInformation.lineNumberStart < 1 || classInformation.lineNumberEnd <= classInformation.lineNumberStart) {
+    return false;
+  }
+  int lineNumber = 1, lineStart = 0, startLine = -1, endLine = -1;
+  while (endLine < 0) {
+    if (lineNumber == classInformation.lineNumberStart) {
+      startLine = lineStart;
+    } else if (lineNumber == classInformation.lineNumberEnd) {
+      endLine = lineStart;
+      break;
+    }
+    int newLine = contents.indexOf('\n', lineStart);
+    if (newLine < 0) {
+      return false;
+    }
+    lineStart = newLine + 1;
+    lineNumber++;
+  }
+  /* If there is no other text on the first line of class then take the whole line. */
+  QString leftStr = contents.mid(startLine, classInformation.columnNumberStart - 1);
+  if (TabSettings::firstNonSpace(leftStr) >= classInformation.columnNumberStart - 1) {
+    *pStart = startLine;
+  } else {
+    *pStart = startLine + classInformation.columnNumberStart - 1;
+  }
+  *pStartColumn = *pStart - startLine;
+  int endLineLength = contents.indexOf('\n', endLine);
+  endLineLength = (endLineLength < 0 ? contents.length() : endLineLength) - endLine;
+  *pEnd = endLine + qMin(classInformation.columnNumberEnd, endLineLength);
+  // make sure the positions are not outdated
+  return QStringRef(&contents, *pStart, *pEnd - *pStart) == pLibraryTreeItem->getClassText(this);
+}
+
+/*!
+ * \brief LibraryTreeModel::shiftLibraryTreeItemClassText
+ * Shifts the positions of the classes of the file that are after the end of the changed class.\n
+ * The classes containing the changed class and the classes with an open editor read their text again from the file text.
+ * \param pLibraryTreeItem
+ * \param pEditedLibraryTreeItem - the changed class. Its nested classes are skipped.
+ * \param lineNumber - the end line of the changed class before the change.
+ * \param columnNumber - the end column of the changed class before the change.
+ * \param lineDelta
+ * \param columnDelta - the column change for the positions on the end line of the changed class.
+ * \param contents - the file text.
+ */
+void LibraryTreeModel::shiftLibraryTreeItemClassText(LibraryTreeItem *pLibraryTreeItem, LibraryTreeItem *pEditedLibraryTreeItem, int lineNumber,
+                                                     int columnNumber, int lineDelta, int columnDelta, const QString &contents)
+{
+  if (pLibraryTreeItem == pEditedLibraryTreeItem) {
+    return;
+  }
+  OMCInterface::getClassInformation_res &classInformation = pLibraryTreeItem->mClassInformation;
+  if (classInformation.lineNumberStart > lineNumber) {
+    classInformation.lineNumberStart += lineDelta;
+  } else if (classInformation.lineNumberStart == lineNumber && classInformation.columnNumberStart > columnNumber) {
+    classInformation.lineNumberStart += lineDelta;
+    classInformation.columnNumberStart += columnDelta;
+  }
+  if (classInformation.lineNumberEnd > lineNumber) {
+    classInformation.lineNumberEnd += lineDelta;
+  } else if (classInformation.lineNumberEnd == lineNumber && classInformation.columnNumberEnd > columnNumber) {
+    classInformation.lineNumberEnd += lineDelta;
+    classInformation.columnNumberEnd += columnDelta;
+  }
+  bool containsEditedClass = pEditedLibraryTreeItem->getNameStructure().startsWith(pLibraryTreeItem->getNameStructure() + ".");
+  if (pLibraryTreeItem->isInPackageOneFile() && (containsEditedClass || pLibraryTreeItem->getModelWidget())) {
+    readLibraryTreeItemClassTextFromText(pLibraryTreeItem, contents);
+    if (containsEditedClass && pLibraryTreeItem->getModelWidget()) {
+      ModelicaEditor *pModelicaEditor = dynamic_cast<ModelicaEditor*>(pLibraryTreeItem->getModelWidget()->getEditor());
+      if (pModelicaEditor) {
+        pModelicaEditor->setPlainText(pLibraryTreeItem->getClassText(this));
+      }
+    }
+  }
+  for (int i = 0; i < pLibraryTreeItem->childrenSize(); i++) {
+    LibraryTreeItem *pChildLibraryTreeItem = pLibraryTreeItem->child(i);
+    if (pChildLibraryTreeItem && pChildLibraryTreeItem->getFileName().compare(pEditedLibraryTreeItem->getFileName()) == 0) {
+      shiftLibraryTreeItemClassText(pChildLibraryTreeItem, pEditedLibraryTreeItem, lineNumber, columnNumber, lineDelta, columnDelta, contents);
+    }
+  }
+}
+
 /*!
  * \brief LibraryTreeModel::updateOMSLibraryTreeItemClassText
  * Updates the OMSimulator model or system contents.
@@ -2495,6 +2773,8 @@ QString LibraryTreeModel::readLibraryTreeItemClassTextFromFile(LibraryTreeItem *
           || (pLibraryTreeItem->getAccess() >= LibraryTreeItem::nonPackageText
               && pLibraryTreeItem->getRestriction() != StringHandler::Package))) {
     contents = MainWindow::instance()->getOMCProxy()->listFile(pLibraryTreeItem->getNameStructure());
+  } else if (pLibraryTreeItem->getLibraryType() == LibraryTreeItem::Text && LargeFileViewer::isLargeFile(pLibraryTreeItem->getFileName())) {
+    // large files are read on demand by LargeFileViewer so they are not read into the class text.
   } else { // else read the file contents
     QFile file(pLibraryTreeItem->getFileName());
     if (!file.open(QIODevice::ReadOnly)) {
@@ -5013,6 +5293,10 @@ bool LibraryWidget::saveModelicaLibraryTreeItemFolder(LibraryTreeItem *pLibraryT
  */
 bool LibraryWidget::saveTextLibraryTreeItem(LibraryTreeItem *pLibraryTreeItem)
 {
+  // LargeFileViewer is read-only and doesn't have the text of the file so there is nothing to save.
+  if (pLibraryTreeItem->getModelWidget() && dynamic_cast<LargeFileViewer*>(pLibraryTreeItem->getModelWidget()->getEditor())) {
+    return true;
+  }
   QString fileName;
   if (pLibraryTreeItem->getFileName().isEmpty()) {
     QString name = pLibraryTreeItem->getName();
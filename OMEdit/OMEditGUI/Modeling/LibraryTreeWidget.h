@@ -89,8 +89,9 @@ public:
   void setSystemLibrary(bool systemLibrary) {mSystemLibrary = systemLibrary;}
   bool isSystemLibrary() {return mSystemLibrary;}
   void setModelWidget(ModelWidget *pModelWidget);
+  void invalidateComponentsIndex() {mComponentsIndexValid = false;}
   ModelWidget* getModelWidget() {return mpModelWidget;}
-  void setName(QString name) {mName = name;}
+  void setName(QString name);
   const QString& getName() const {return mName;}
   void setNameStructure(QString nameStructure) {mNameStructure = nameStructure;}
   const QString& getNameStructure() {return mNameStructure;}
@@ -120,6 +121,7 @@ public:
   QString getClassTextBefore() {return mClassTextBefore;}
   void setClassText(QString classText) {mClassText = classText;}
   QString getClassText(LibraryTreeModel *pLibraryTreeModel);
+  bool hasClassText() const {return !mClassText.isEmpty();}
   void setClassTextAfter(QString classTextAfter) {mClassTextAfter = classTextAfter;}
   QString getClassTextAfter() {return mClassTextAfter;}
   void setExpanded(bool expanded) {mExpanded = expanded;}
@@ -198,7 +200,18 @@ private:
   QList<LibraryTreeItem*> mInheritedClasses;
   QList<ComponentInfo*> mComponents;
   bool mComponentsLoaded;
+  // cached inheritance closure, valid while mInheritedClassesDeepListVersion equals mInheritedClassesVersion
+  QList<LibraryTreeItem*> mInheritedClassesDeepList;
+  int mInheritedClassesDeepListVersion;
+  static int mInheritedClassesVersion;
+  // children and components sorted by name for the code completion
+  QVector<QPair<QString, LibraryTreeItem*> > mChildrenIndex;
+  bool mChildrenIndexValid;
+  QVector<QPair<QString, ComponentInfo*> > mComponentsIndex;
+  bool mComponentsIndexValid;
   const QList<ComponentInfo *> &getComponentsList();
+  const QVector<QPair<QString, LibraryTreeItem*> > &getChildrenIndex();
+  const QVector<QPair<QString, ComponentInfo*> > &getComponentsIndex();
   LibraryType mLibraryType;
   bool mSystemLibrary;
   ModelWidget *mpModelWidget;
@@ -326,6 +339,10 @@ private:
                                          const QModelIndex &parentIndex) const;
   LibraryTreeItem* getLibraryTreeItemFromFileHelper(LibraryTreeItem *pLibraryTreeItem, QString fileName, int lineNumber);
   void updateChildLibraryTreeItemClassText(LibraryTreeItem *pLibraryTreeItem, QString contents, QString fileName);
+  bool updateNestedLibraryTreeItemClassText(LibraryTreeItem *pLibraryTreeItem, LibraryTreeItem *pParentLibraryTreeItem);
+  bool getClassTextRange(LibraryTreeItem *pLibraryTreeItem, const QString &contents, int *pStart, int *pEnd, int *pStartColumn);
+  void shiftLibraryTreeItemClassText(LibraryTreeItem *pLibraryTreeItem, LibraryTreeItem *pEditedLibraryTreeItem, int lineNumber, int columnNumber,
+                                     int lineDelta, int columnDelta, const QString &contents);
   void updateOMSLibraryTreeItemClassText(LibraryTreeItem *pLibraryTreeItem);
   void readLibraryTreeItemClassTextFromText(LibraryTreeItem *pLibraryTreeItem, QString contents);
   QString readLibraryTreeItemClassTextFromFile(LibraryTreeItem *pLibraryTreeItem);
@@ -94,7 +94,12 @@ GraphicsView::GraphicsView(StringHandler::ViewType viewType, ModelWidget *parent
   setFrameShape(QFrame::StyledPanel);
   setDragMode(QGraphicsView::RubberBandDrag);
   setAcceptDrops(true);
-  setViewportUpdateMode(QGraphicsView::FullViewportUpdate);
+  /* Only repaint the dirty regions of the viewport.
+   * The background with the grid lines is cached and only regenerated when the view is scrolled, zoomed or resized.
+   * Call resetCachedContent() when something drawn in drawBackground() changes.
+   */
+  setViewportUpdateMode(QGraphicsView::SmartViewportUpdate);
+  setCacheMode(QGraphicsView::CacheBackground);
   setMouseTracking(true);
   mpModelWidget = parent;
   // set the coOrdinate System
@@ -151,6 +156,7 @@ void GraphicsView::setExtentRectangle(qreal left, qreal bottom, qreal right, qre
   QRectF sceneRectangle(left * 1.5, bottom * 1.5, fabs(left - right) * 1.5, fabs(bottom - top) * 1.5);
   setSceneRect(sceneRectangle);
   centerOn(sceneRectangle.center());
+  resetCachedContent();
 }
 
 void GraphicsView::setIsCreatingConnection(bool enable)
@@ -1109,6 +1115,34 @@ QRectF GraphicsView::itemsBoundingRect()
   return mapFromScene(rect).boundingRect();
 }
 
+/*!
+ * \brief GraphicsView::renderWithoutCache
+ * Renders the view like QGraphicsView::render for printing and exporting.
+ * The items cached in device coordinates are drawn as vectors and not as their cached pixmaps,
+ * so that the SVG output stays vector based and the images are sharp at any scale.
+ * \param pPainter
+ * \param target
+ * \param source
+ * \param skipBackground - if true the background of the view is not drawn.
+ */
+void GraphicsView::renderWithoutCache(QPainter *pPainter, const QRectF &target, const QRect &source, bool skipBackground)
+{
+  bool oldSkipDrawBackground = mSkipBackground;
+  mSkipBackground = skipBackground;
+  QList<QGraphicsItem*> cachedItems;
+  foreach (QGraphicsItem *pGraphicsItem, items()) {
+    if (pGraphicsItem->cacheMode() == QGraphicsItem::DeviceCoordinateCache) {
+      pGraphicsItem->setCacheMode(QGraphicsItem::NoCache);
+      cachedItems.append(pGraphicsItem);
+    }
+  }
+  render(pPainter, target, source);
+  foreach (QGraphicsItem *pGraphicsItem, cachedItems) {
+    pGraphicsItem->setCacheMode(QGraphicsItem::DeviceCoordinateCache);
+  }
+  mSkipBackground = oldSkipDrawBackground;
+}
+
 QPointF GraphicsView::snapPointToGrid(QPointF point)
 {
   qreal stepX = mCoOrdinateSystem.getHorizontalGridStep();
@@ -1392,6 +1426,46 @@ bool GraphicsView::isAnyItemSelectedAndEditable(int key)
   return selectedAndEditable;
 }
 
+/*!
+ * \brief GraphicsView::moveSelectedItemsByKeyPress
+ * Moves the selected components with one MoveComponentsCommand and emits the key press SIGNAL for the selected shapes.\n
+ * The undo macro is only used when shapes are also moved so that the consecutive moves of components are merged.
+ * \param text
+ * \param offset
+ * \param pKeyPressSignal
+ */
+void GraphicsView::moveSelectedItemsByKeyPress(const QString &text, const QPointF &offset, void (GraphicsView::*pKeyPressSignal)())
+{
+  QList<Component*> components;
+  QList<QPointF> offsets;
+  bool shapeSelected = false;
+  QList<QGraphicsItem*> selectedItems = scene()->selectedItems();
+  foreach (QGraphicsItem *pGraphicsItem, selectedItems) {
+    Component *pComponent = dynamic_cast<Component*>(pGraphicsItem);
+    if (pComponent) {
+      if (!pComponent->isInheritedComponent()) {
+        components.append(pComponent);
+        offsets.append(offset);
+      }
+      continue;
+    }
+    LineAnnotation *pLineAnnotation = dynamic_cast<LineAnnotation*>(pGraphicsItem);
+    if (!(pLineAnnotation && pLineAnnotation->getLineType() == LineAnnotation::ConnectionType) && dynamic_cast<ShapeAnnotation*>(pGraphicsItem)) {
+      shapeSelected = true;
+    }
+  }
+  if (shapeSelected) {
+    mpModelWidget->beginMacro(text);
+  }
+  if (!components.isEmpty()) {
+    mpModelWidget->getUndoStack()->push(new MoveComponentsCommand(this, components, offsets));
+  }
+  emit (this->*pKeyPressSignal)();
+  if (shapeSelected) {
+    mpModelWidget->endMacro();
+  }
+}
+
 /*!
  * \brief GraphicsView::connectorComponentAtPosition
  * Returns the connector component at the position.
@@ -2182,36 +2256,32 @@ void GraphicsView::drawBackground(QPainter *painter, const QRectF &rect)
   if (mpModelWidget->getModelWidgetContainer()->isShowGridLines() && !(mpModelWidget->getLibraryTreeItem()->isSystemLibrary() || isVisualizationView())) {
     painter->setBrush(Qt::NoBrush);
     painter->setPen(lightGrayPen);
-    /* Draw left half vertical lines */
+    /* Collect the grid lines inside rect and draw them with a single call.
+     * The first line is aligned to the grid step so we don't walk from the origin to the exposed rectangle.
+     * When zoomed out only every n-th line is drawn so that the lines are at least a few pixels apart.
+     */
+    const qreal levelOfDetail = QStyleOptionGraphicsItem::levelOfDetailFromTransform(painter->worldTransform());
+    const qreal minimumGridStepPixels = 4;
+    QVector<QLineF> gridLines;
     int horizontalGridStep = mCoOrdinateSystem.getHorizontalGridStep() * 10;
-    qreal xAxisStep = 0;
-    qreal yAxisStep = rect.y();
-    xAxisStep -= horizontalGridStep;
-    while (xAxisStep > rect.left()) {
-      painter->drawLine(QPointF(xAxisStep, yAxisStep), QPointF(xAxisStep, rect.bottom()));
-      xAxisStep -= horizontalGridStep;
-    }
-    /* Draw right half vertical lines */
-    xAxisStep = 0;
-    while (xAxisStep < rect.right()) {
-      painter->drawLine(QPointF(xAxisStep, yAxisStep), QPointF(xAxisStep, rect.bottom()));
-      xAxisStep += horizontalGridStep;
-    }
-    /* Draw left half horizontal lines */
+    while (horizontalGridStep > 0 && horizontalGridStep * levelOfDetail < minimumGridStepPixels) {
+      horizontalGridStep *= 2;
+    }
+    if (horizontalGridStep > 0) {
+      for (qreal xAxisStep = qCeil(rect.left() / horizontalGridStep) * horizontalGridStep ; xAxisStep < rect.right() ; xAxisStep += horizontalGridStep) {
+        gridLines.append(QLineF(xAxisStep, rect.top(), xAxisStep, rect.bottom()));
+      }
+    }
     int verticalGridStep = mCoOrdinateSystem.getVerticalGridStep() * 10;
-    xAxisStep = rect.x();
-    yAxisStep = 0;
-    yAxisStep += verticalGridStep;
-    while (yAxisStep < rect.bottom()) {
-      painter->drawLine(QPointF(xAxisStep, yAxisStep), QPointF(rect.right(), yAxisStep));
-      yAxisStep += verticalGridStep;
-    }
-    /* Draw right half horizontal lines */
-    yAxisStep = 0;
-    while (yAxisStep > rect.top()) {
-      painter->drawLine(QPointF(xAxisStep, yAxisStep), QPointF(rect.right(), yAxisStep));
-      yAxisStep -= verticalGridStep;
+    while (verticalGridStep > 0 && verticalGridStep * levelOfDetail < minimumGridStepPixels) {
+      verticalGridStep *= 2;
+    }
+    if (verticalGridStep > 0) {
+      for (qreal yAxisStep = qCeil(rect.top() / verticalGridStep) * verticalGridStep ; yAxisStep < rect.bottom() ; yAxisStep += verticalGridStep) {
+        gridLines.append(QLineF(rect.left(), yAxisStep, rect.right(), yAxisStep));
+      }
     }
+    painter->drawLines(gridLines);
     /* set the middle horizontal and vertical line gray */
     painter->setPen(grayPen);
     painter->drawLine(QPointF(rect.left(), 0), QPointF(rect.right(), 0));
@@ -2284,17 +2354,17 @@ void GraphicsView::mousePressEvent(QMouseEvent *event)
     foreach (ShapeAnnotation *pShapeAnnotation, mShapesList) {
       pShapeAnnotation->setOldScenePosition(pShapeAnnotation->scenePos());
     }
-    // save annotations of all connections
+    // save points of all connections
     foreach (LineAnnotation *pConnectionLineAnnotation, mConnectionsList) {
-      pConnectionLineAnnotation->setOldAnnotation(pConnectionLineAnnotation->getOMCShapeAnnotation());
+      pConnectionLineAnnotation->saveOldPoints();
     }
-    // save annotations of all transitions
+    // save points of all transitions
     foreach (LineAnnotation *pTransitionLineAnnotation, mTransitionsList) {
-      pTransitionLineAnnotation->setOldAnnotation(pTransitionLineAnnotation->getOMCShapeAnnotation());
+      pTransitionLineAnnotation->saveOldPoints();
     }
-    // save annotations of all initial states
+    // save points of all initial states
     foreach (LineAnnotation *pInitialStateLineAnnotation, mInitialStatesList) {
-      pInitialStateLineAnnotation->setOldAnnotation(pInitialStateLineAnnotation->getOMCShapeAnnotation());
+      pInitialStateLineAnnotation->saveOldPoints();
     }
   }
   // if some item is clicked
@@ -2416,30 +2486,38 @@ void GraphicsView::mouseReleaseEvent(QMouseEvent *event)
   mpClickedState = 0;
   if (isMovingComponentsAndShapes()) {
     setIsMovingComponentsAndShapes(false);
-    bool hasComponentMoved = false;
-    bool hasShapeMoved = false;
-    bool beginMacro = false;
-    // if component position is really changed then update component annotation
+    // find the components whose position is really changed
+    QList<Component*> movedComponents;
+    QList<QPointF> offsets;
     foreach (Component *pComponent, mComponentsList) {
       if (pComponent->getOldPosition() != pComponent->pos()) {
-        if (!beginMacro) {
-          mpModelWidget->beginMacro("Move items by mouse");
-          beginMacro = true;
-        }
-        Transformation oldTransformation = pComponent->mTransformation;
-        QPointF positionDifference = pComponent->scenePos() - pComponent->getOldScenePosition();
-        pComponent->mTransformation.adjustPosition(positionDifference.x(), positionDifference.y());
-        pComponent->updateComponentTransformations(oldTransformation);
-        hasComponentMoved = true;
+        movedComponents.append(pComponent);
+        offsets.append(pComponent->scenePos() - pComponent->getOldScenePosition());
+      }
+    }
+    bool hasComponentMoved = !movedComponents.isEmpty();
+    bool hasShapeMoved = false;
+    bool beginMacro = false;
+    /* Only start the undo stack macro when shapes are moved.
+     * When only components are moved the single MoveComponentsCommand can be merged with the previous move of the same components.
+     */
+    foreach (ShapeAnnotation *pShapeAnnotation, mShapesList) {
+      if (pShapeAnnotation->getOldScenePosition() != pShapeAnnotation->scenePos()) {
+        hasShapeMoved = true;
+        break;
       }
     }
+    if (hasShapeMoved) {
+      mpModelWidget->beginMacro("Move items by mouse");
+      beginMacro = true;
+    }
+    // update the annotations of moved components
+    if (hasComponentMoved) {
+      mpModelWidget->getUndoStack()->push(new MoveComponentsCommand(this, movedComponents, offsets));
+    }
     // if shape position is changed then update class annotation
     foreach (ShapeAnnotation *pShapeAnnotation, mShapesList) {
       if (pShapeAnnotation->getOldScenePosition() != pShapeAnnotation->scenePos()) {
-        if (!beginMacro) {
-          mpModelWidget->beginMacro("Move items by mouse");
-          beginMacro = true;
-        }
         QString oldAnnotation = pShapeAnnotation->getOMCShapeAnnotation();
         pShapeAnnotation->mTransformation.setOrigin(pShapeAnnotation->scenePos());
         bool state = pShapeAnnotation->flags().testFlag(QGraphicsItem::ItemSendsGeometryChanges);
@@ -2450,7 +2528,6 @@ void GraphicsView::mouseReleaseEvent(QMouseEvent *event)
         pShapeAnnotation->setOrigin(pShapeAnnotation->mTransformation.getPosition());
         QString newAnnotation = pShapeAnnotation->getOMCShapeAnnotation();
         mpModelWidget->getUndoStack()->push(new UpdateShapeCommand(pShapeAnnotation, oldAnnotation, newAnnotation));
-        hasShapeMoved = true;
       }
     }
     if (hasShapeMoved) {
@@ -2584,17 +2661,17 @@ void GraphicsView::focusOutEvent(QFocusEvent *event)
 
 void GraphicsView::keyPressEvent(QKeyEvent *event)
 {
-  // save annotations of all connections
+  // save points of all connections
   foreach (LineAnnotation *pConnectionLineAnnotation, mConnectionsList) {
-    pConnectionLineAnnotation->setOldAnnotation(pConnectionLineAnnotation->getOMCShapeAnnotation());
+    pConnectionLineAnnotation->saveOldPoints();
   }
-  // save annotations of all transitions
+  // save points of all transitions
   foreach (LineAnnotation *pTransitionLineAnnotation, mTransitionsList) {
-    pTransitionLineAnnotation->setOldAnnotation(pTransitionLineAnnotation->getOMCShapeAnnotation());
+    pTransitionLineAnnotation->saveOldPoints();
   }
-  // save annotations of all initial states
+  // save points of all initial states
   foreach (LineAnnotation *pInitialStateLineAnnotation, mInitialStatesList) {
-    pInitialStateLineAnnotation->setOldAnnotation(pInitialStateLineAnnotation->getOMCShapeAnnotation());
+    pInitialStateLineAnnotation->saveOldPoints();
   }
   bool shiftModifier = event->modifiers().testFlag(Qt::ShiftModifier);
   bool controlModifier = event->modifiers().testFlag(Qt::ControlModifier);
@@ -2605,53 +2682,29 @@ void GraphicsView::keyPressEvent(QKeyEvent *event)
     mpModelWidget->updateModelText();
     mpModelWidget->endMacro();
   } else if (!shiftModifier && !controlModifier && event->key() == Qt::Key_Up && isAnyItemSelectedAndEditable(event->key())) {
-    mpModelWidget->beginMacro("Move up by key press");
-    emit keyPressUp();
-    mpModelWidget->endMacro();
+    moveSelectedItemsByKeyPress("Move up by key press", QPointF(0, mCoOrdinateSystem.getVerticalGridStep()), &GraphicsView::keyPressUp);
   } else if (shiftModifier && !controlModifier && event->key() == Qt::Key_Up && isAnyItemSelectedAndEditable(event->key())) {
-    mpModelWidget->beginMacro("Move shift up by key press");
-    emit keyPressShiftUp();
-    mpModelWidget->endMacro();
+    moveSelectedItemsByKeyPress("Move shift up by key press", QPointF(0, mCoOrdinateSystem.getVerticalGridStep() * 5), &GraphicsView::keyPressShiftUp);
   } else if (!shiftModifier && controlModifier && event->key() == Qt::Key_Up && isAnyItemSelectedAndEditable(event->key())) {
-    mpModelWidget->beginMacro("Move control up by key press");
-    emit keyPressCtrlUp();
-    mpModelWidget->endMacro();
+    moveSelectedItemsByKeyPress("Move control up by key press", QPointF(0, 1), &GraphicsView::keyPressCtrlUp);
   } else if (!shiftModifier && !controlModifier && event->key() == Qt::Key_Down && isAnyItemSelectedAndEditable(event->key())) {
-    mpModelWidget->beginMacro("Move down by key press");
-    emit keyPressDown();
-    mpModelWidget->endMacro();
+    moveSelectedItemsByKeyPress("Move down by key press", QPointF(0, -mCoOrdinateSystem.getVerticalGridStep()), &GraphicsView::keyPressDown);
   } else if (shiftModifier && !controlModifier && event->key() == Qt::Key_Down && isAnyItemSelectedAndEditable(event->key())) {
-    mpModelWidget->beginMacro("Move shift down by key press");
-    emit keyPressShiftDown();
-    mpModelWidget->endMacro();
+    moveSelectedItemsByKeyPress("Move shift down by key press", QPointF(0, -(mCoOrdinateSystem.getVerticalGridStep() * 5)), &GraphicsView::keyPressShiftDown);
   } else if (!shiftModifier && controlModifier && event->key() == Qt::Key_Down && isAnyItemSelectedAndEditable(event->key())) {
-    mpModelWidget->beginMacro("Move control down by key press");
-    emit keyPressCtrlDown();
-    mpModelWidget->endMacro();
+    moveSelectedItemsByKeyPress("Move control down by key press", QPointF(0, -1), &GraphicsView::keyPressCtrlDown);
   } else if (!shiftModifier && !controlModifier && event->key() == Qt::Key_Left && isAnyItemSelectedAndEditable(event->key())) {
-    mpModelWidget->beginMacro("Move left by key press");
-    emit keyPressLeft();
-    mpModelWidget->endMacro();
+    moveSelectedItemsByKeyPress("Move left by key press", QPointF(-mCoOrdinateSystem.getHorizontalGridStep(), 0), &GraphicsView::keyPressLeft);
   } else if (shiftModifier && !controlModifier && event->key() == Qt::Key_Left && isAnyItemSelectedAndEditable(event->key())) {
-    mpModelWidget->beginMacro("Move shift left by key press");
-    emit keyPressShiftLeft();
-    mpModelWidget->endMacro();
+    moveSelectedItemsByKeyPress("Move shift left by key press", QPointF(-(mCoOrdinateSystem.getHorizontalGridStep() * 5), 0), &GraphicsView::keyPressShiftLeft);
   } else if (!shiftModifier && controlModifier && event->key() == Qt::Key_Left && isAnyItemSelectedAndEditable(event->key())) {
-    mpModelWidget->beginMacro("Move control left by key press");
-    emit keyPressCtrlLeft();
-    mpModelWidget->endMacro();
+    moveSelectedItemsByKeyPress("Move control left by key press", QPointF(-1, 0), &GraphicsView::keyPressCtrlLeft);
   } else if (!shiftModifier && !controlModifier && event->key() == Qt::Key_Right && isAnyItemSelectedAndEditable(event->key())) {
-    mpModelWidget->beginMacro("Move right by key press");
-    emit keyPressRight();
-    mpModelWidget->endMacro();
+    moveSelectedItemsByKeyPress("Move right by key press", QPointF(mCoOrdinateSystem.getHorizontalGridStep(), 0), &GraphicsView::keyPressRight);
   } else if (shiftModifier && !controlModifier && event->key() == Qt::Key_Right && isAnyItemSelectedAndEditable(event->key())) {
-    mpModelWidget->beginMacro("Move shift right by key press");
-    emit keyPressShiftRight();
-    mpModelWidget->endMacro();
+    moveSelectedItemsByKeyPress("Move shift right by key press", QPointF(mCoOrdinateSystem.getHorizontalGridStep() * 5, 0), &GraphicsView::keyPressShiftRight);
   } else if (!shiftModifier && controlModifier && event->key() == Qt::Key_Right && isAnyItemSelectedAndEditable(event->key())) {
-    mpModelWidget->beginMacro("Move control right by key press");
-    emit keyPressCtrlRight();
-    mpModelWidget->endMacro();
+    moveSelectedItemsByKeyPress("Move control right by key press", QPointF(1, 0), &GraphicsView::keyPressCtrlRight);
   } else if (controlModifier && event->key() == Qt::Key_A) {
     selectAll();
   } else if (controlModifier && event->key() == Qt::Key_D && isAnyItemSelectedAndEditable(event->key())) {
@@ -3155,6 +3208,8 @@ UndoStack::UndoStack(QObject *parent)
   : QUndoStack(parent)
 {
   mEnabled = true;
+  // bound the memory used by long editing sessions
+  setUndoLimit(Helper::undoLimit);
 }
 
 /*!
@@ -3549,116 +3604,138 @@ void ModelWidget::getModelConnections()
   // detect multiple declarations of a component instance
   detectMultipleDeclarations();
   // get the connections
-  MainWindow *pMainWindow = MainWindow::instance();
-  LibraryTreeModel *pLibraryTreeModel = pMainWindow->getLibraryWidget()->getLibraryTreeModel();
-  int connectionCount = pMainWindow->getOMCProxy()->getConnectionCount(mpLibraryTreeItem->getNameStructure());
+  OMCProxy *pOMCProxy = MainWindow::instance()->getOMCProxy();
+  int connectionCount = pOMCProxy->getConnectionCount(mpLibraryTreeItem->getNameStructure());
   for (int i = 1 ; i <= connectionCount ; i++) {
     // get the connection from OMC
-    QStringList connectionList = pMainWindow->getOMCProxy()->getNthConnection(mpLibraryTreeItem->getNameStructure(), i);
-    QString connectionString = QString("{%1}").arg(connectionList.join(","));
-    // if the connectionString only contains two items then continue the loop,
-    // because connection is not valid then
-    if (connectionList.size() < 3) {
-      continue;
-    }
-    // get start and end components
-    QStringList startComponentList = StringHandler::makeVariableParts(connectionList.at(0));
-    QStringList endComponentList = StringHandler::makeVariableParts(connectionList.at(1));
-    // get start component
-    Component *pStartComponent = 0;
-    if (startComponentList.size() > 0) {
-      QString startComponentName = startComponentList.at(0);
+    drawModelConnection(i, pOMCProxy->getNthConnection(mpLibraryTreeItem->getNameStructure(), i));
+  }
+}
+
+/*!
+ * \brief ModelWidget::drawModelConnection
+ * Draws the nth connection of the model in the diagram GraphicsView.
+ * \param index - the index of the connection.
+ * \param connectionList - the connection as returned by OMCProxy::getNthConnection().
+ */
+void ModelWidget::drawModelConnection(int index, QStringList connectionList)
+{
+  MainWindow *pMainWindow = MainWindow::instance();
+  LibraryTreeModel *pLibraryTreeModel = pMainWindow->getLibraryWidget()->getLibraryTreeModel();
+  QString connectionString = QString("{%1}").arg(connectionList.join(","));
+  // if the connectionString only contains two items then return,
+  // because connection is not valid then
+  if (connectionList.size() < 3) {
+    return;
+  }
+  // get start and end components
+  QStringList startComponentList = StringHandler::makeVariableParts(connectionList.at(0));
+  QStringList endComponentList = StringHandler::makeVariableParts(connectionList.at(1));
+  // get start component
+  Component *pStartComponent = 0;
+  if (startComponentList.size() > 0) {
+    QString startComponentName = startComponentList.at(0);
+    if (startComponentName.contains("[")) {
+      startComponentName = startComponentName.mid(0, startComponentName.indexOf("["));
+    }
+    pStartComponent = mpDiagramGraphicsView->getComponentObject(startComponentName);
+  }
+  // get start connector
+  Component *pStartConnectorComponent = 0;
+  Component *pEndConnectorComponent = 0;
+  if (pStartComponent) {
+    // if a component type is connector then we only get one item in startComponentList
+    // check the startcomponentlist
+    if (startComponentList.size() < 2
+        || (pStartComponent->getLibraryTreeItem()
+            && pStartComponent->getLibraryTreeItem()->getRestriction() == StringHandler::ExpandableConnector)) {
+      pStartConnectorComponent = pStartComponent;
+    } else if (pStartComponent->getLibraryTreeItem()
+               && !pLibraryTreeModel->findLibraryTreeItem(pStartComponent->getLibraryTreeItem()->getNameStructure())) {
+      /* if class doesn't exist then connect with the red cross box */
+      pStartConnectorComponent = pStartComponent;
+    } else {
+      // look for port from the parent component
+      QString startComponentName = startComponentList.at(1);
       if (startComponentName.contains("[")) {
         startComponentName = startComponentName.mid(0, startComponentName.indexOf("["));
       }
-      pStartComponent = mpDiagramGraphicsView->getComponentObject(startComponentName);
-    }
-    // get start connector
-    Component *pStartConnectorComponent = 0;
-    Component *pEndConnectorComponent = 0;
-    if (pStartComponent) {
-      // if a component type is connector then we only get one item in startComponentList
-      // check the startcomponentlist
-      if (startComponentList.size() < 2
-          || (pStartComponent->getLibraryTreeItem()
-              && pStartComponent->getLibraryTreeItem()->getRestriction() == StringHandler::ExpandableConnector)) {
-        pStartConnectorComponent = pStartComponent;
-      } else if (pStartComponent->getLibraryTreeItem()
-                 && !pLibraryTreeModel->findLibraryTreeItem(pStartComponent->getLibraryTreeItem()->getNameStructure())) {
-        /* if class doesn't exist then connect with the red cross box */
-        pStartConnectorComponent = pStartComponent;
-      } else {
-        // look for port from the parent component
-        QString startComponentName = startComponentList.at(1);
-        if (startComponentName.contains("[")) {
-          startComponentName = startComponentName.mid(0, startComponentName.indexOf("["));
-        }
-        pStartConnectorComponent = getConnectorComponent(pStartComponent, startComponentName);
-      }
+      pStartConnectorComponent = getConnectorComponent(pStartComponent, startComponentName);
     }
-    // show error message if start component is not found.
-    if (!pStartConnectorComponent) {
-      MessagesWidget::instance()->addGUIMessage(MessageItem(MessageItem::Modelica, "", false, 0, 0, 0, 0,
-                                                            GUIMessages::getMessage(GUIMessages::UNABLE_FIND_COMPONENT_IN_CONNECTION)
-                                                            .arg(connectionList.at(0)).arg(connectionString),
-                                                            Helper::scriptingKind, Helper::errorLevel));
-      continue;
-    }
-    // get end component
-    Component *pEndComponent = 0;
-    if (endComponentList.size() > 0) {
-      QString endComponentName = endComponentList.at(0);
+  }
+  // show error message if start component is not found.
+  if (!pStartConnectorComponent) {
+    MessagesWidget::instance()->addGUIMessage(MessageItem(MessageItem::Modelica, "", false, 0, 0, 0, 0,
+                                                          GUIMessages::getMessage(GUIMessages::UNABLE_FIND_COMPONENT_IN_CONNECTION)
+                                                          .arg(connectionList.at(0)).arg(connectionString),
+                                                          Helper::scriptingKind, Helper::errorLevel));
+    return;
+  }
+  // get end component
+  Component *pEndComponent = 0;
+  if (endComponentList.size() > 0) {
+    QString endComponentName = endComponentList.at(0);
+    if (endComponentName.contains("[")) {
+      endComponentName = endComponentName.mid(0, endComponentName.indexOf("["));
+    }
+    pEndComponent = mpDiagramGraphicsView->getComponentObject(endComponentName);
+  }
+  // get the end connector
+  if (pEndComponent) {
+    // if a component type is connector then we only get one item in endComponentList
+    // check the endcomponentlist
+    if (endComponentList.size() < 2
+        || (pEndComponent->getLibraryTreeItem()
+            && pEndComponent->getLibraryTreeItem()->getRestriction() == StringHandler::ExpandableConnector)) {
+      pEndConnectorComponent = pEndComponent;
+    } else if (pEndComponent->getLibraryTreeItem()
+               && !pLibraryTreeModel->findLibraryTreeItem(pEndComponent->getLibraryTreeItem()->getNameStructure())) {
+      /* if class doesn't exist then connect with the red cross box */
+      pEndConnectorComponent = pEndComponent;
+    } else {
+      QString endComponentName = endComponentList.at(1);
       if (endComponentName.contains("[")) {
         endComponentName = endComponentName.mid(0, endComponentName.indexOf("["));
       }
-      pEndComponent = mpDiagramGraphicsView->getComponentObject(endComponentName);
-    }
-    // get the end connector
-    if (pEndComponent) {
-      // if a component type is connector then we only get one item in endComponentList
-      // check the endcomponentlist
-      if (endComponentList.size() < 2
-          || (pEndComponent->getLibraryTreeItem()
-              && pEndComponent->getLibraryTreeItem()->getRestriction() == StringHandler::ExpandableConnector)) {
-        pEndConnectorComponent = pEndComponent;
-      } else if (pEndComponent->getLibraryTreeItem()
-                 && !pLibraryTreeModel->findLibraryTreeItem(pEndComponent->getLibraryTreeItem()->getNameStructure())) {
-        /* if class doesn't exist then connect with the red cross box */
-        pEndConnectorComponent = pEndComponent;
-      } else {
-        QString endComponentName = endComponentList.at(1);
-        if (endComponentName.contains("[")) {
-          endComponentName = endComponentName.mid(0, endComponentName.indexOf("["));
-        }
-        pEndConnectorComponent = getConnectorComponent(pEndComponent, endComponentName);
-      }
+      pEndConnectorComponent = getConnectorComponent(pEndComponent, endComponentName);
     }
-    // show error message if end component is not found.
-    if (!pEndConnectorComponent) {
-      MessagesWidget::instance()->addGUIMessage(MessageItem(MessageItem::Modelica, "", false, 0, 0, 0, 0,
-                                                            GUIMessages::getMessage(GUIMessages::UNABLE_FIND_COMPONENT_IN_CONNECTION)
-                                                            .arg(connectionList.at(1)).arg(connectionString),
-                                                            Helper::scriptingKind, Helper::errorLevel));
-      continue;
-    }
-    // get the connector annotations from OMC
-    QString connectionAnnotationString = pMainWindow->getOMCProxy()->getNthConnectionAnnotation(mpLibraryTreeItem->getNameStructure(), i);
-    QStringList shapesList = StringHandler::getStrings(StringHandler::removeFirstLastCurlBrackets(connectionAnnotationString), '(', ')');
-    // Now parse the shapes available in list
-    QString lineShape = "";
-    foreach (QString shape, shapesList) {
-      if (shape.startsWith("Line")) {
-        lineShape = shape.mid(QString("Line").length());
-        lineShape = StringHandler::removeFirstLastParentheses(lineShape);
-        break;  // break the loop once we have got the line annotation.
-      }
+  }
+  // show error message if end component is not found.
+  if (!pEndConnectorComponent) {
+    MessagesWidget::instance()->addGUIMessage(MessageItem(MessageItem::Modelica, "", false, 0, 0, 0, 0,
+                                                          GUIMessages::getMessage(GUIMessages::UNABLE_FIND_COMPONENT_IN_CONNECTION)
+                                                          .arg(connectionList.at(1)).arg(connectionString),
+                                                          Helper::scriptingKind, Helper::errorLevel));
+    return;
+  }
+  // get the connector annotations from OMC
+  QString lineShape = getConnectionLineShape(pMainWindow->getOMCProxy()->getNthConnectionAnnotation(mpLibraryTreeItem->getNameStructure(), index));
+  LineAnnotation *pConnectionLineAnnotation;
+  pConnectionLineAnnotation = new LineAnnotation(lineShape, pStartConnectorComponent, pEndConnectorComponent, mpDiagramGraphicsView);
+  pConnectionLineAnnotation->setStartComponentName(connectionList.at(0));
+  pConnectionLineAnnotation->setEndComponentName(connectionList.at(1));
+  mpUndoStack->push(new AddConnectionCommand(pConnectionLineAnnotation, false));
+}
+
+/*!
+ * \brief ModelWidget::getConnectionLineShape
+ * Returns the Line annotation from the connection annotation.
+ * \param connectionAnnotationString - the connection annotation as returned by OMCProxy::getNthConnectionAnnotation().
+ * \return
+ */
+QString ModelWidget::getConnectionLineShape(QString connectionAnnotationString)
+{
+  QStringList shapesList = StringHandler::getStrings(StringHandler::removeFirstLastCurlBrackets(connectionAnnotationString), '(', ')');
+  // Now parse the shapes available in list
+  QString lineShape = "";
+  foreach (QString shape, shapesList) {
+    if (shape.startsWith("Line")) {
+      lineShape = shape.mid(QString("Line").length());
+      lineShape = StringHandler::removeFirstLastParentheses(lineShape);
+      break;  // break the loop once we have got the line annotation.
     }
-    LineAnnotation *pConnectionLineAnnotation;
-    pConnectionLineAnnotation = new LineAnnotation(lineShape, pStartConnectorComponent, pEndConnectorComponent, mpDiagramGraphicsView);
-    pConnectionLineAnnotation->setStartComponentName(connectionList.at(0));
-    pConnectionLineAnnotation->setEndComponentName(connectionList.at(1));
-    mpUndoStack->push(new AddConnectionCommand(pConnectionLineAnnotation, false));
   }
+  return lineShape;
 }
 
 /*!
@@ -3771,7 +3848,12 @@ void ModelWidget::createModelWidgetComponents()
     } else if (mpLibraryTreeItem->getLibraryType() == LibraryTreeItem::Text) {
       pViewButtonsHorizontalLayout->addWidget(mpTextViewToolButton);
       QFileInfo fileInfo(mpLibraryTreeItem->getFileName());
-      if (Utilities::isCFile(fileInfo.suffix())) {
+      if (LargeFileViewer::isLargeFile(mpLibraryTreeItem->getFileName())) {
+        mpEditor = new LargeFileViewer(this);
+        LargeFileViewer *pLargeFileViewer = dynamic_cast<LargeFileViewer*>(mpEditor);
+        pLargeFileViewer->openFile(mpLibraryTreeItem->getFileName());
+        mpEditor->hide();
+      } else if (Utilities::isCFile(fileInfo.suffix())) {
         mpEditor = new CEditor(this);
         CHighlighter *pCHighlighter = new CHighlighter(OptionsDialog::instance()->getCEditorPage(), mpEditor->getPlainTextEdit());
         CEditor *pCEditor = dynamic_cast<CEditor*>(mpEditor);
@@ -4089,6 +4171,7 @@ void ModelWidget::reDrawModelWidget()
     mComponentsList.clear();
     mComponentsAnnotationsList.clear();
     mComponentsLoaded = false;
+    mpLibraryTreeItem->invalidateComponentsIndex();
     // get the model components
     loadComponents();
     // update the icon
@@ -4117,6 +4200,214 @@ void ModelWidget::reDrawModelWidget()
   QApplication::restoreOverrideCursor();
 }
 
+/*!
+ * \brief ModelWidget::reDrawModelWidgetIncrementally
+ * Redraws the ModelWidget after the class text is changed by only updating what has changed.\n
+ * The class shapes are redrawn. The components and connections are compared with the new class contents
+ * and only the changed ones are removed and recreated. The unchanged Component objects and their cached data are kept.\n
+ * Falls back to ModelWidget::reDrawModelWidget() if the inherited classes are changed.
+ */
+void ModelWidget::reDrawModelWidgetIncrementally()
+{
+  if (mpLibraryTreeItem->getLibraryType() != LibraryTreeItem::Modelica || !mComponentsLoaded
+      || mpLibraryTreeItem->getAccess() < LibraryTreeItem::diagram || inheritedClassesChanged()) {
+    reDrawModelWidget();
+    return;
+  }
+  QApplication::setOverrideCursor(Qt::WaitCursor);
+  bool extendsModifiersLoaded = mExtendsModifiersLoaded;
+  mExtendsModifiersLoaded = false;
+  // Redraw icon and diagram shapes
+  removeClassShapes(StringHandler::Icon);
+  getModelIconDiagramShapes(StringHandler::Icon);
+  if (mDiagramViewLoaded) {
+    removeClassShapes(StringHandler::Diagram);
+    getModelIconDiagramShapes(StringHandler::Diagram);
+  }
+  // update the components and connections
+  updateModelComponentsAndConnections();
+  // the extends modifiers might have changed so update the inherited components
+  if (extendsModifiersLoaded) {
+    foreach (Component *pInheritedComponent, mpIconGraphicsView->getInheritedComponentsList()) {
+      pInheritedComponent->componentParameterHasChanged();
+    }
+    foreach (Component *pInheritedComponent, mpDiagramGraphicsView->getInheritedComponentsList()) {
+      pInheritedComponent->componentParameterHasChanged();
+    }
+  }
+  // update the icon
+  mpLibraryTreeItem->handleIconUpdated();
+  // if documentation view is visible then update it
+  if (MainWindow::instance()->getDocumentationDockWidget()->isVisible()) {
+    MainWindow::instance()->getDocumentationWidget()->showDocumentation(getLibraryTreeItem());
+  }
+  // clear the undo stack
+  mpUndoStack->clear();
+  updateViewButtonsBasedOnAccess();
+  // announce the change.
+  mpLibraryTreeItem->emitLoaded();
+  QApplication::restoreOverrideCursor();
+}
+
+/*!
+ * \brief ModelWidget::inheritedClassesChanged
+ * Checks if the inherited classes of the class are different from the loaded ones.
+ * \return
+ */
+bool ModelWidget::inheritedClassesChanged()
+{
+  OMCProxy *pOMCProxy = MainWindow::instance()->getOMCProxy();
+  QStringList inheritedClasses;
+  foreach (QString inheritedClass, pOMCProxy->getInheritedClasses(mpLibraryTreeItem->getNameStructure())) {
+    // same filter as ModelWidget::getModelInheritedClasses()
+    if (!(pOMCProxy->isBuiltinType(inheritedClass) || inheritedClass.compare(mpLibraryTreeItem->getNameStructure()) == 0)) {
+      inheritedClasses.append(inheritedClass);
+    }
+  }
+  if (inheritedClasses.size() != mInheritedClassesList.size()) {
+    return true;
+  }
+  for (int i = 0 ; i < inheritedClasses.size() ; i++) {
+    if (inheritedClasses.at(i).compare(mInheritedClassesList.at(i)->getNameStructure()) != 0) {
+      return true;
+    }
+  }
+  return false;
+}
+
+/*!
+ * \brief ModelWidget::updateModelComponentsAndConnections
+ * Compares the loaded components and connections with the class contents and updates only the changed ones.\n
+ * A component is kept if its name, class, protection, array index and annotation are unchanged.
+ * Its ComponentInfo is updated in place so that modifiers are fetched again on demand.
+ * A connection is kept if its start and end components are kept and its annotation is reread in place.
+ */
+void ModelWidget::updateModelComponentsAndConnections()
+{
+  OMCProxy *pOMCProxy = MainWindow::instance()->getOMCProxy();
+  QList<ComponentInfo*> componentsList = pOMCProxy->getComponents(mpLibraryTreeItem->getNameStructure());
+  QStringList componentsAnnotationsList;
+  if (!componentsList.isEmpty()) {
+    componentsAnnotationsList = pOMCProxy->getComponentAnnotations(mpLibraryTreeItem->getNameStructure());
+  }
+  // index the loaded components by name
+  QHash<QString, int> oldComponentsIndexes;
+  for (int i = 0 ; i < mComponentsList.size() ; i++) {
+    oldComponentsIndexes.insert(mComponentsList.at(i)->getName(), i);
+  }
+  QList<ComponentInfo*> addedComponentsList;
+  QStringList addedComponentsAnnotationsList;
+  for (int i = 0 ; i < componentsList.size() ; i++) {
+    ComponentInfo *pComponentInfo = componentsList.at(i);
+    QString annotation = componentsAnnotationsList.value(i);
+    int oldIndex = oldComponentsIndexes.value(pComponentInfo->getName(), -1);
+    if (oldIndex > -1) {
+      ComponentInfo *pOldComponentInfo = mComponentsList.at(oldIndex);
+      if (pOldComponentInfo->getClassName().compare(pComponentInfo->getClassName()) == 0
+          && pOldComponentInfo->getProtected() == pComponentInfo->getProtected()
+          && pOldComponentInfo->getArrayIndex().compare(pComponentInfo->getArrayIndex()) == 0
+          && mComponentsAnnotationsList.value(oldIndex).compare(annotation) == 0) {
+        // the text shapes of the component only depend on the modifiers if they were fetched.
+        bool modifiersLoaded = pOldComponentInfo->isModifiersLoaded() || pOldComponentInfo->isParameterValueLoaded();
+        pOldComponentInfo->updateComponentInfo(pComponentInfo);
+        delete pComponentInfo;
+        componentsList.replace(i, pOldComponentInfo);
+        oldComponentsIndexes.remove(pOldComponentInfo->getName());
+        QList<Component*> components;
+        components << mpIconGraphicsView->getComponentObject(pOldComponentInfo->getName())
+                   << mpDiagramGraphicsView->getComponentObject(pOldComponentInfo->getName());
+        foreach (Component *pComponent, components) {
+          if (pComponent) {
+            pComponent->updateToolTip();
+            if (modifiersLoaded) {
+              pComponent->componentParameterHasChanged();
+            }
+          }
+        }
+        continue;
+      }
+    }
+    addedComponentsList.append(pComponentInfo);
+    addedComponentsAnnotationsList.append(annotation);
+  }
+  // the remaining loaded components are either removed or changed.
+  QSet<QString> removedComponents = oldComponentsIndexes.keys().toSet();
+  QMultiHash<QString, LineAnnotation*> connections;
+  if (mConnectionsLoaded) {
+    // transitions and initial states are few so we always redraw them.
+    foreach (LineAnnotation *pTransitionLineAnnotation, mpDiagramGraphicsView->getTransitionsList()) {
+      removeClassLine(pTransitionLineAnnotation);
+    }
+    foreach (LineAnnotation *pInitialStateLineAnnotation, mpDiagramGraphicsView->getInitialStatesList()) {
+      removeClassLine(pInitialStateLineAnnotation);
+    }
+    // remove the connections of the removed components and index the rest.
+    foreach (LineAnnotation *pConnectionLineAnnotation, mpDiagramGraphicsView->getConnectionsList()) {
+      QString startComponentName = StringHandler::makeVariableParts(pConnectionLineAnnotation->getStartComponentName()).value(0);
+      QString endComponentName = StringHandler::makeVariableParts(pConnectionLineAnnotation->getEndComponentName()).value(0);
+      startComponentName = startComponentName.mid(0, startComponentName.indexOf("["));
+      endComponentName = endComponentName.mid(0, endComponentName.indexOf("["));
+      if (removedComponents.contains(startComponentName) || removedComponents.contains(endComponentName)) {
+        removeClassLine(pConnectionLineAnnotation);
+      } else {
+        connections.insert(QString("%1,%2").arg(pConnectionLineAnnotation->getStartComponentName())
+                           .arg(pConnectionLineAnnotation->getEndComponentName()), pConnectionLineAnnotation);
+      }
+    }
+  }
+  // remove the removed and changed components
+  foreach (QString componentName, removedComponents) {
+    if (Component *pComponent = mpIconGraphicsView->getComponentObject(componentName)) {
+      removeClassComponent(mpIconGraphicsView, pComponent);
+    }
+    if (Component *pComponent = mpDiagramGraphicsView->getComponentObject(componentName)) {
+      removeClassComponent(mpDiagramGraphicsView, pComponent);
+    }
+  }
+  // draw the added and changed components
+  mComponentsList = addedComponentsList;
+  mComponentsAnnotationsList = addedComponentsAnnotationsList;
+  drawModelIconComponents();
+  if (mDiagramViewLoaded) {
+    drawModelDiagramComponents();
+  }
+  mComponentsList = componentsList;
+  mComponentsAnnotationsList = componentsAnnotationsList;
+  mpLibraryTreeItem->invalidateComponentsIndex();
+  // update the kept connections in place and draw the new ones.
+  if (mConnectionsLoaded) {
+    detectMultipleDeclarations();
+    int connectionCount = pOMCProxy->getConnectionCount(mpLibraryTreeItem->getNameStructure());
+    for (int i = 1 ; i <= connectionCount ; i++) {
+      QStringList connectionList = pOMCProxy->getNthConnection(mpLibraryTreeItem->getNameStructure(), i);
+      if (connectionList.size() < 3) {
+        continue;
+      }
+      QString key = QString("%1,%2").arg(connectionList.at(0)).arg(connectionList.at(1));
+      LineAnnotation *pConnectionLineAnnotation = connections.value(key, 0);
+      if (pConnectionLineAnnotation) {
+        connections.remove(key, pConnectionLineAnnotation);
+        QString lineShape = getConnectionLineShape(pOMCProxy->getNthConnectionAnnotation(mpLibraryTreeItem->getNameStructure(), i));
+        pConnectionLineAnnotation->parseShapeAnnotation(lineShape);
+        pConnectionLineAnnotation->initializeTransformation();
+        pConnectionLineAnnotation->removeCornerItems();
+        pConnectionLineAnnotation->drawCornerItems();
+        pConnectionLineAnnotation->adjustGeometries();
+        pConnectionLineAnnotation->setCornerItemsActiveOrPassive();
+        pConnectionLineAnnotation->update();
+      } else {
+        drawModelConnection(i, connectionList);
+      }
+    }
+    // remove the connections that are deleted from the class
+    foreach (LineAnnotation *pConnectionLineAnnotation, connections) {
+      removeClassLine(pConnectionLineAnnotation);
+    }
+    getModelTransitions();
+    getModelInitialStates();
+  }
+}
+
 /*!
  * \brief ModelWidget::validateText
  * Validates the text of the editor.
@@ -4196,7 +4487,7 @@ bool ModelWidget::modelicaEditorTextChanged(LibraryTreeItem **pLibraryTreeItem)
   /* if user has changed the class contents then refresh it. */
   if (className.compare(mpLibraryTreeItem->getNameStructure()) == 0) {
     mpLibraryTreeItem->setClassInformation(pOMCProxy->getClassInformation(mpLibraryTreeItem->getNameStructure()));
-    reDrawModelWidget();
+    reDrawModelWidgetIncrementally();
     mpLibraryTreeItem->setClassText(modelicaText);
     if (mpLibraryTreeItem->isInPackageOneFile()) {
       pParentLibraryTreeItem->setClassText(stringToLoad);
@@ -4270,7 +4561,7 @@ void ModelWidget::updateChildClasses(LibraryTreeItem *pLibraryTreeItem)
         pChildLibraryTreeItem->setClassInformation(pMainWindow->getOMCProxy()->getClassInformation(pChildLibraryTreeItem->getNameStructure()));
         if (pLibraryTreeItem->isExpanded()) {
           if (pChildLibraryTreeItem->getModelWidget()) {
-            pChildLibraryTreeItem->getModelWidget()->reDrawModelWidget();
+            pChildLibraryTreeItem->getModelWidget()->reDrawModelWidgetIncrementally();
             pLibraryTreeModel->readLibraryTreeItemClassText(pChildLibraryTreeItem);
             ModelicaEditor *pModelicaEditor = dynamic_cast<ModelicaEditor*>(pChildLibraryTreeItem->getModelWidget()->getEditor());
             if (pModelicaEditor) {
@@ -5490,14 +5781,84 @@ void ModelWidget::removeClassComponents(StringHandler::ViewType viewType)
     pGraphicsView = mpDiagramGraphicsView;
   }
   foreach (Component *pComponent, pGraphicsView->getComponentsList()) {
-    pComponent->removeChildren();
-    pGraphicsView->deleteComponentFromList(pComponent);
-    pGraphicsView->removeItem(pComponent->getOriginItem());
-    delete pComponent->getOriginItem();
-    pGraphicsView->removeItem(pComponent);
-    pComponent->emitDeleted();
-    delete pComponent;
+    removeClassComponent(pGraphicsView, pComponent);
+  }
+}
+
+/*!
+ * \brief ModelWidget::removeClassComponent
+ * Removes the class component from the view and deletes it.
+ * \param pGraphicsView
+ * \param pComponent
+ */
+void ModelWidget::removeClassComponent(GraphicsView *pGraphicsView, Component *pComponent)
+{
+  pComponent->removeChildren();
+  pGraphicsView->deleteComponentFromList(pComponent);
+  pGraphicsView->removeItem(pComponent->getOriginItem());
+  delete pComponent->getOriginItem();
+  pGraphicsView->removeItem(pComponent);
+  pComponent->emitDeleted();
+  delete pComponent;
+}
+
+/*!
+ * \brief ModelWidget::removeClassShapes
+ * Removes all the class shapes from the view and deletes them.
+ * \param viewType
+ */
+void ModelWidget::removeClassShapes(StringHandler::ViewType viewType)
+{
+  GraphicsView *pGraphicsView = 0;
+  if (viewType == StringHandler::Icon) {
+    pGraphicsView = mpIconGraphicsView;
+  } else {
+    pGraphicsView = mpDiagramGraphicsView;
+  }
+  foreach (ShapeAnnotation *pShapeAnnotation, pGraphicsView->getShapesList()) {
+    pGraphicsView->deleteShapeFromList(pShapeAnnotation);
+    pGraphicsView->removeItem(pShapeAnnotation);
+    delete pShapeAnnotation;
+  }
+}
+
+/*!
+ * \brief ModelWidget::removeClassLine
+ * Removes the class connection, transition or initial state from the diagram view and deletes it.
+ * \param pLineAnnotation
+ */
+void ModelWidget::removeClassLine(LineAnnotation *pLineAnnotation)
+{
+  LineAnnotation::LineType lineType = pLineAnnotation->getLineType();
+  QList<Component*> components;
+  components << pLineAnnotation->getStartComponent() << pLineAnnotation->getEndComponent();
+  // Remove the start and end component connection details.
+  foreach (Component *pComponent, components) {
+    if (pComponent && pComponent->getRootParentComponent()) {
+      pComponent = pComponent->getRootParentComponent();
+    }
+    if (!pComponent) {
+      continue;
+    }
+    if (lineType == LineAnnotation::InitialStateType) {
+      pComponent->setIsInitialState(false);
+    } else {
+      pComponent->removeConnectionDetails(pLineAnnotation);
+      if (lineType == LineAnnotation::TransitionType) {
+        pComponent->setHasTransition(false);
+      }
+    }
+  }
+  if (lineType == LineAnnotation::TransitionType) {
+    mpDiagramGraphicsView->deleteTransitionFromList(pLineAnnotation);
+  } else if (lineType == LineAnnotation::InitialStateType) {
+    mpDiagramGraphicsView->deleteInitialStateFromList(pLineAnnotation);
+  } else {
+    mpDiagramGraphicsView->deleteConnectionFromList(pLineAnnotation);
   }
+  mpDiagramGraphicsView->removeItem(pLineAnnotation);
+  pLineAnnotation->emitDeleted();
+  delete pLineAnnotation;
 }
 
 /*!
@@ -5509,6 +5870,7 @@ void ModelWidget::getModelComponents()
   MainWindow *pMainWindow = MainWindow::instance();
   // get the components
   mComponentsList = pMainWindow->getOMCProxy()->getComponents(mpLibraryTreeItem->getNameStructure());
+  mpLibraryTreeItem->invalidateComponentsIndex();
   // get the components annotations
   if (!mComponentsList.isEmpty()) {
     mComponentsAnnotationsList = pMainWindow->getOMCProxy()->getComponentAnnotations(mpLibraryTreeItem->getNameStructure());
@@ -7161,17 +7523,14 @@ void ModelWidgetContainer::printModel()
       } else {
         pGraphicsView = pModelWidget->getDiagramGraphicsView();
       }
-      // hide the background of the view for printing
-      bool oldSkipDrawBackground = pGraphicsView->mSkipBackground;
-      pGraphicsView->mSkipBackground = true;
       // open print dialog
       if (pPrintDialog->exec() == QDialog::Accepted) {
         QPainter painter(&printer);
         painter.setRenderHints(QPainter::Antialiasing);
-        pGraphicsView->render(&painter);
+        // hide the background of the view for printing
+        pGraphicsView->renderWithoutCache(&painter);
         painter.end();
       }
-      pGraphicsView->mSkipBackground = oldSkipDrawBackground;
     }
     delete pPrintDialog;
   }
@@ -45,6 +45,7 @@
 #include "Editors/OMSimulatorEditor.h"
 #include "Editors/CEditor.h"
 #include "Editors/TextEditor.h"
+#include "Editors/LargeFileViewer.h"
 #include "Editors/MetaModelicaEditor.h"
 #include "LibraryTreeWidget.h"
 #include "OMSimulator.h"
@@ -245,6 +246,7 @@ public:
   void createTextShape(QPointF point);
   void createBitmapShape(QPointF point);
   QRectF itemsBoundingRect();
+  void renderWithoutCache(QPainter *pPainter, const QRectF &target = QRectF(), const QRect &source = QRect(), bool skipBackground = true);
   QPointF snapPointToGrid(QPointF point);
   QPointF movePointByGrid(QPointF point, QPointF origin = QPointF(0, 0), bool useShiftModifier = false);
   QPointF roundPoint(QPointF point);
@@ -256,6 +258,7 @@ private:
   void createActions();
   bool isClassDroppedOnItself(LibraryTreeItem *pLibraryTreeItem);
   bool isAnyItemSelectedAndEditable(int key);
+  void moveSelectedItemsByKeyPress(const QString &text, const QPointF &offset, void (GraphicsView::*pKeyPressSignal)());
   Component* connectorComponentAtPosition(QPoint position);
   Component* stateComponentAtPosition(QPoint position);
 signals:
@@ -417,12 +420,17 @@ public:
   void loadComponents();
   void loadDiagramView();
   void loadConnections();
+  void removeClassComponents(StringHandler::ViewType viewType);
+  void drawModelDiagramComponents();
   void getModelConnections();
+  void drawModelConnection(int index, QStringList connectionList);
+  QString getConnectionLineShape(QString connectionAnnotationString);
   void createModelWidgetComponents();
   ShapeAnnotation* drawOMSModelElement();
   Component* getConnectorComponent(Component *pConnectorComponent, QString connectorName);
   void clearGraphicsViews();
   void reDrawModelWidget();
+  void reDrawModelWidgetIncrementally();
   bool validateText(LibraryTreeItem **pLibraryTreeItem);
   bool modelicaEditorTextChanged(LibraryTreeItem **pLibraryTreeItem);
   void updateChildClasses(LibraryTreeItem *pLibraryTreeItem);
@@ -481,10 +489,13 @@ private:
   void getModelIconDiagramShapes(StringHandler::ViewType viewType);
   void drawModelInheritedClassComponents(ModelWidget *pModelWidget, StringHandler::ViewType viewType);
   void removeInheritedClassComponents(StringHandler::ViewType viewType);
-  void removeClassComponents(StringHandler::ViewType viewType);
+  void removeClassComponent(GraphicsView *pGraphicsView, Component *pComponent);
+  void removeClassShapes(StringHandler::ViewType viewType);
+  void removeClassLine(LineAnnotation *pLineAnnotation);
+  bool inheritedClassesChanged();
+  void updateModelComponentsAndConnections();
   void getModelComponents();
   void drawModelIconComponents();
-  void drawModelDiagramComponents();
   void drawModelInheritedClassConnections(ModelWidget *pModelWidget);
   void removeInheritedClassConnections();
   void getModelTransitions();
@@ -36,12 +36,14 @@
 #include "Util/Helper.h"
 #include "MainWindow.h"
 #include "Modeling/LibraryTreeWidget.h"
+#include "Benchmark/Benchmark.h"
 #ifndef WIN32
 #include "omc_config.h"
 #endif
 
 #include <locale.h>
 #include <QMessageBox>
+#include <QTimer>
 
 /*!
  * \class OMEditApplication
@@ -111,6 +113,9 @@ OMEditApplication::OMEditApplication(int &argc, char **argv, threadData_t* threa
   setlocale(LC_NUMERIC, "C");
   // if user has requested to open the file by passing it in argument then,
   bool debug = false;
+  QString benchmarkName = "";
+  QList<int> benchmarkSizes;
+  QString benchmarkOutputFileName = "";
   QString fileName = "";
   QStringList fileNames;
   if (arguments().size() > 1) {
@@ -123,6 +128,24 @@ OMEditApplication::OMEditApplication(int &argc, char **argv, threadData_t* threa
         } else {
           debug = false;
         }
+      } else if (strncmp(arguments().at(i).toStdString().c_str(), "--Benchmark=",12) == 0) {
+        benchmarkName = arguments().at(i);
+        benchmarkName.remove("--Benchmark=");
+      } else if (strncmp(arguments().at(i).toStdString().c_str(), "--BenchmarkSizes=",17) == 0) {
+        QString benchmarkSizesArg = arguments().at(i);
+        benchmarkSizesArg.remove("--BenchmarkSizes=");
+        foreach (QString benchmarkSize, benchmarkSizesArg.split(",", QString::SkipEmptyParts)) {
+          bool ok;
+          int size = benchmarkSize.toInt(&ok);
+          if (ok && size > 0) {
+            benchmarkSizes.append(size);
+          } else {
+            printf("Invalid benchmark size: %s\n", benchmarkSize.toStdString().c_str());
+          }
+        }
+      } else if (strncmp(arguments().at(i).toStdString().c_str(), "--BenchmarkOutput=",18) == 0) {
+        benchmarkOutputFileName = arguments().at(i);
+        benchmarkOutputFileName.remove("--BenchmarkOutput=");
       } else {
         fileName = arguments().at(i);
         if (!fileName.isEmpty()) {
@@ -142,6 +165,15 @@ OMEditApplication::OMEditApplication(int &argc, char **argv, threadData_t* threa
       }
     }
   }
+  // check the benchmark before MainWindow is created. The event loop is not running yet so exit the process.
+  Benchmark *pBenchmark = 0;
+  if (!benchmarkName.isEmpty()) {
+    pBenchmark = Benchmark::create(benchmarkName, benchmarkSizes, benchmarkOutputFileName, this);
+    if (!pBenchmark) {
+      printf("Invalid benchmark: %s\n", benchmarkName.toStdString().c_str());
+      ::exit(1);
+    }
+  }
   // MainWindow Initialization
   MainWindow *pMainwindow = MainWindow::instance(debug);
   pMainwindow->setUpMainWindow(threadData);
@@ -162,6 +194,10 @@ OMEditApplication::OMEditApplication(int &argc, char **argv, threadData_t* threa
   pMainwindow->show();
   // hide the splash screen
   pSplashScreen->finish(pMainwindow);
+  // run the benchmark once the event loop is started. The benchmark exits the application when done.
+  if (pBenchmark) {
+    QTimer::singleShot(0, pBenchmark, SLOT(run()));
+  }
 }
 
 /*!
@@ -76,14 +76,14 @@ win32 {
     } else { # 64-bit
       LIBS += -L$$(OMDEV)/tools/msys/mingw64/lib/binutils -L$$(OMDEV)/tools/msys/mingw64/bin -L$$(OMDEV)/tools/msys/mingw64/lib
     }
-    LIBS += -limagehlp -lbfd -lintl -liberty -llibosg.dll -llibosgViewer.dll -llibOpenThreads.dll -llibosgDB.dll -llibosgGA.dll
+    LIBS += -limagehlp -lbfd -lintl -liberty -llibosg.dll -llibosgViewer.dll -llibOpenThreads.dll -llibosgDB.dll -llibosgGA.dll -llibosgUtil.dll
   } else { # debug
     contains(QT_ARCH, i386) { # 32-bit
       LIBS += -L$$(OMDEV)/tools/msys/mingw32/lib
     } else { # 64-bit
       LIBS += -L$$(OMDEV)/tools/msys/mingw64/lib
     }
-    LIBS += -llibosgd.dll -llibosgViewerd.dll -llibOpenThreadsd.dll -llibosgDBd.dll -llibosgGAd.dll
+    LIBS += -llibosgd.dll -llibosgViewerd.dll -llibOpenThreadsd.dll -llibosgDBd.dll -llibosgGAd.dll -llibosgUtild.dll
   }
   LIBS += -L../OMEditGUI/Debugger/Parser -lGDBMIParser \
     -L$$(OMBUILDDIR)/lib/omc -lomantlr3 -lOMPlot -lomqwt -lomopcua \
@@ -137,8 +137,12 @@ SOURCES += main.cpp \
   Options/OptionsDialog.cpp \
   Editors/BaseEditor.cpp \
   Editors/ModelicaEditor.cpp \
+  Editors/ModelicaLexer.cpp \
+  Editors/ModelicaSyntaxChecker.cpp \
+  Editors/ModelicaOutline.cpp \
   Editors/TransformationsEditor.cpp \
   Editors/TextEditor.cpp \
+  Editors/LargeFileViewer.cpp \
   Editors/CEditor.cpp \
   Editors/CompositeModelEditor.cpp \
   Editors/OMSimulatorEditor.cpp \
@@ -206,7 +210,11 @@ SOURCES += main.cpp \
   OMS/InstantiateDialog.cpp \
   OMS/OMSSimulationDialog.cpp \
   OMS/OMSSimulationOutputWidget.cpp \
-  Animation/TimeManager.cpp
+  Animation/TimeManager.cpp \
+  Benchmark/Benchmark.cpp \
+  Benchmark/DiagramBenchmark.cpp \
+  Benchmark/HighlighterBenchmark.cpp \
+  Benchmark/EditorBenchmark.cpp
 
 HEADERS  += Util/Helper.h \
   Util/Utilities.h \
@@ -226,8 +234,12 @@ HEADERS  += Util/Helper.h \
   Options/OptionsDialog.h \
   Editors/BaseEditor.h \
   Editors/ModelicaEditor.h \
+  Editors/ModelicaLexer.h \
+  Editors/ModelicaSyntaxChecker.h \
+  Editors/ModelicaOutline.h \
   Editors/TransformationsEditor.h \
   Editors/TextEditor.h \
+  Editors/LargeFileViewer.h \
   Editors/CEditor.h \
   Editors/CompositeModelEditor.h \
   Editors/OMSimulatorEditor.h \
@@ -298,7 +310,11 @@ HEADERS  += Util/Helper.h \
   OMS/OMSSimulationOptions.h \
   OMS/OMSSimulationDialog.h \
   OMS/OMSSimulationOutputWidget.h \
-  Animation/TimeManager.h
+  Animation/TimeManager.h \
+  Benchmark/Benchmark.h \
+  Benchmark/DiagramBenchmark.h \
+  Benchmark/HighlighterBenchmark.h \
+  Benchmark/EditorBenchmark.h
 
 CONFIG(osg) {
 
@@ -315,13 +331,19 @@ SOURCES += Animation/AbstractAnimationWindow.cpp \
   Animation/AnimationWindow.cpp \
   Animation/ThreeDViewer.cpp \
   Animation/ExtraShapes.cpp \
+  Animation/MeshCache.cpp \
+  Animation/TextureCache.cpp \
+  Animation/FramePrefetcher.cpp \
+  Animation/ShapeTransforms.cpp \
   Animation/Visualizer.cpp \
   Animation/VisualizerMAT.cpp \
   Animation/VisualizerCSV.cpp \
   Animation/VisualizerFMU.cpp \
   Animation/FMUSettingsDialog.cpp \
   Animation/FMUWrapper.cpp \
-  Animation/Shapes.cpp
+  Animation/Shapes.cpp \
+  Benchmark/TransformBenchmark.cpp \
+  Benchmark/AnimationBenchmark.cpp
 
 greaterThan(QT_MAJOR_VERSION, 4):greaterThan(QT_MINOR_VERSION, 3) { # if Qt 5.4 or greater
   HEADERS += Animation/OpenGLWidget.h
@@ -334,6 +356,10 @@ HEADERS += Animation/AbstractAnimationWindow.h \
   Animation/ThreeDViewer.h \
   Animation/AnimationUtil.h \
   Animation/ExtraShapes.h \
+  Animation/MeshCache.h \
+  Animation/TextureCache.h \
+  Animation/FramePrefetcher.h \
+  Animation/ShapeTransforms.h \
   Animation/Visualizer.h \
   Animation/VisualizerMAT.h \
   Animation/VisualizerCSV.h \
@@ -341,7 +367,9 @@ HEADERS += Animation/AbstractAnimationWindow.h \
   Animation/FMUSettingsDialog.h \
   Animation/FMUWrapper.h \
   Animation/Shapes.h \
-  Animation/rapidxml.hpp
+  Animation/rapidxml.hpp \
+  Benchmark/TransformBenchmark.h \
+  Benchmark/AnimationBenchmark.h
 }
 
 LIBS += -lqjson
@@ -68,6 +68,7 @@ void DiagramWindow::drawDiagram()
 
   ModelWidget *pModelWidget = MainWindow::instance()->getModelWidgetContainer()->getCurrentModelWidget();
   if (pModelWidget && pModelWidget->getDiagramGraphicsView()) {
+    MainWindow::instance()->getVariablesWidget()->clearDynamicSelectComponents();
     if (mpGraphicsView) {
       delete mpGraphicsScene;
       mpGraphicsScene = 0;
@@ -82,7 +83,7 @@ void DiagramWindow::drawDiagram()
     foreach (Component *pReferenceComponent, pModelWidget->getDiagramGraphicsView()->getComponentsList()) {
       Component *pComponent = new Component(pReferenceComponent, mpGraphicsView);
       mpGraphicsView->addComponentToList(pComponent);
-      connect(MainWindow::instance()->getVariablesWidget(), SIGNAL(updateDynamicSelect(double)), pComponent, SLOT(updateDynamicSelect(double)));
+      MainWindow::instance()->getVariablesWidget()->addDynamicSelectComponent(pComponent);
     }
     foreach (LineAnnotation *pConnectionLineAnnotation, pModelWidget->getDiagramGraphicsView()->getConnectionsList()) {
       LineAnnotation *pNewConntionLineAnnotation = new LineAnnotation(pConnectionLineAnnotation, mpGraphicsView);
@@ -42,12 +42,16 @@
 #include "util/read_matlab4.h"
 #include "Plotting/PlotWindowContainer.h"
 #include "Plotting/DiagramWindow.h"
+#include "Component/Component.h"
 #include "Simulation/SimulationDialog.h"
 #include "Simulation/SimulationOutputWidget.h"
 #include "Simulation/SimulationProcessThread.h"
 
 #include <QObject>
 
+#include <algorithm>
+#include <limits>
+
 using namespace OMPlot;
 
 /*!
@@ -325,6 +329,7 @@ VariablesTreeModel::VariablesTreeModel(VariablesTreeView *pVariablesTreeView)
              QStringList() << Helper::description << "" << false;
   mpRootVariablesTreeItem = new VariablesTreeItem(headers, 0, true);
   mpActiveVariablesTreeItem = 0;
+  mVariablesRevision = 0;
 }
 
 int VariablesTreeModel::columnCount(const QModelIndex &parent) const
@@ -563,6 +568,7 @@ void VariablesTreeModel::insertVariablesItems(QString fileName, QString filePath
 
   VariablesTreeItem *pTopVariablesTreeItem = new VariablesTreeItem(Variabledata, mpRootVariablesTreeItem, true);
   pTopVariablesTreeItem->setSimulationOptions(simulationOptions);
+  mVariablesTreeItemsHash.insert(pTopVariablesTreeItem->getVariableName(), pTopVariablesTreeItem);
   int row = rowCount();
   beginInsertRows(index, row, row);
   mpRootVariablesTreeItem->insertChild(row, pTopVariablesTreeItem);
@@ -749,6 +755,7 @@ void VariablesTreeModel::insertVariablesItems(QString fileName, QString filePath
       VariablesTreeItem *pVariablesTreeItem = new VariablesTreeItem(variableData, pParentVariablesTreeItem);
       pVariablesTreeItem->setEditable(changeAble);
       pVariablesTreeItem->setVariability(variability);
+      mVariablesTreeItemsHash.insert(pVariablesTreeItem->getVariableName(), pVariablesTreeItem);
       int row = rowCount(index);
       beginInsertRows(index, row, row);
       pParentVariablesTreeItem->insertChild(row, pVariablesTreeItem);
@@ -773,6 +780,8 @@ void VariablesTreeModel::insertVariablesItems(QString fileName, QString filePath
       omc_free_matlab4_reader(&matReader);
     }
   }
+  // the dynamic values bound to the previous variables must be resolved again
+  mVariablesRevision++;
   mpVariablesTreeView->collapseAll();
   QModelIndex idx = variablesTreeItemIndex(pTopVariablesTreeItem);
   idx = mpVariablesTreeView->getVariablesWidget()->getVariableTreeProxyModel()->mapFromSource(idx);
@@ -797,6 +806,8 @@ bool VariablesTreeModel::removeVariableTreeItem(QString variable)
   VariablesTreeItem *pVariablesTreeItem = findVariablesTreeItem(variable, mpRootVariablesTreeItem);
   if (pVariablesTreeItem) {
     beginRemoveRows(variablesTreeItemIndex(pVariablesTreeItem), 0, pVariablesTreeItem->getChildren().size());
+    removeVariablesTreeItemsFromHash(pVariablesTreeItem);
+    mVariablesRevision++;
     pVariablesTreeItem->removeChildren();
     VariablesTreeItem *pParentVariablesTreeItem = pVariablesTreeItem->parent();
     pParentVariablesTreeItem->removeChild(pVariablesTreeItem);
@@ -820,6 +831,21 @@ bool VariablesTreeModel::removeVariableTreeItem(QString variable)
   return false;
 }
 
+/*!
+ * \brief VariablesTreeModel::removeVariablesTreeItemsFromHash
+ * Removes the VariablesTreeItem and all its children from the name lookup hash.
+ * \param pVariablesTreeItem
+ */
+void VariablesTreeModel::removeVariablesTreeItemsFromHash(VariablesTreeItem *pVariablesTreeItem)
+{
+  foreach (VariablesTreeItem *pChildVariablesTreeItem, pVariablesTreeItem->getChildren()) {
+    removeVariablesTreeItemsFromHash(pChildVariablesTreeItem);
+  }
+  if (mVariablesTreeItemsHash.value(pVariablesTreeItem->getVariableName()) == pVariablesTreeItem) {
+    mVariablesTreeItemsHash.remove(pVariablesTreeItem->getVariableName());
+  }
+}
+
 void VariablesTreeModel::unCheckVariables(VariablesTreeItem *pVariablesTreeItem)
 {
   QList<VariablesTreeItem*> items = pVariablesTreeItem->getChildren();
@@ -1141,6 +1167,7 @@ VariablesWidget::VariablesWidget(QWidget *pParent)
   mpLastActiveSubWindow = 0;
   mModelicaMatReader.file = 0;
   mpCSVData = 0;
+  mpCSVTimeDataSet = 0;
   // create the layout
   QGridLayout *pMainLayout = new QGridLayout;
   pMainLayout->setContentsMargins(0, 0, 0, 0);
@@ -1516,49 +1543,109 @@ void VariablesWidget::initializeVisualization(SimulationOptions simulationOption
  */
 double VariablesWidget::readVariableValue(QString variable, double time)
 {
-  double value = 0.0;
+  return readVariableValue(bindResultVariable(variable), time);
+}
+
+/*!
+ * \brief VariablesWidget::bindResultVariable
+ * Resolves the variable in the opened result file once so that its values can be read without any lookup.
+ * \param variable
+ * \return the index of the resolved variable or -1 if the variable is not found.
+ * \sa VariablesWidget::readVariableValue(int resultVariableIndex, double time)
+ */
+int VariablesWidget::bindResultVariable(const QString &variable)
+{
+  QHash<QString, int>::const_iterator iterator = mResultVariablesHash.constFind(variable);
+  if (iterator != mResultVariablesHash.constEnd()) {
+    return iterator.value();
+  }
+  ResultVariable resultVariable;
+  resultVariable.mpMatVariable = 0;
+  resultVariable.mpCSVDataSet = 0;
+  bool variableFound = false;
   if (mModelicaMatReader.file) {
-    ModelicaMatVariable_t* var = omc_matlab4_find_var(&mModelicaMatReader, variable.toStdString().c_str());
-    if (var) {
-      omc_matlab4_val(&value, &mModelicaMatReader, var, time);
-    }
+    resultVariable.mpMatVariable = omc_matlab4_find_var(&mModelicaMatReader, variable.toStdString().c_str());
+    variableFound = resultVariable.mpMatVariable != 0;
   } else if (mpCSVData) {
-    double *timeDataSet = read_csv_dataset(mpCSVData, "time");
-    if (timeDataSet) {
-      for (int i = 0 ; i < mpCSVData->numsteps ; i++) {
-        if (QString::number(timeDataSet[i]).compare(QString::number(time)) == 0) {
-          double *varDataSet = read_csv_dataset(mpCSVData, variable.toStdString().c_str());
-          if (varDataSet) {
-            value = varDataSet[i];
-            break;
-          }
-        }
-      }
-    }
+    resultVariable.mpCSVDataSet = read_csv_dataset(mpCSVData, variable.toStdString().c_str());
+    variableFound = mpCSVTimeDataSet && resultVariable.mpCSVDataSet;
   } else if (mPlotFileReader.isOpen()) {
     QTextStream textStream(&mPlotFileReader);
     QString currentLine;
-    bool variableFound = false;
+    bool dataSetFound = false;
     while (!textStream.atEnd()) {
       currentLine = textStream.readLine();
       if (currentLine.compare(QString("DataSet: %1").arg(variable)) == 0) {
-        variableFound = true;
-      } else if (variableFound) {
-        if (currentLine.startsWith("DataSet:")) { // new dataset started. Unable to find the value.
+        dataSetFound = true;
+      } else if (dataSetFound) {
+        if (currentLine.startsWith("DataSet:")) { // new dataset started.
           break;
         }
         QStringList values = currentLine.split(",");
-        if (QString::number(time).compare(values[0]) == 0) {
-          value = values[1].toDouble();
-          break;
+        if (values.size() > 1) {
+          resultVariable.mPlotFileTimes.append(values[0].toDouble());
+          resultVariable.mPlotFileValues.append(values[1].toDouble());
         }
       }
     }
     textStream.seek(0);
+    variableFound = !resultVariable.mPlotFileTimes.isEmpty();
+  }
+  int resultVariableIndex = -1;
+  if (variableFound) {
+    resultVariableIndex = mResultVariables.size();
+    mResultVariables.append(resultVariable);
+  }
+  mResultVariablesHash.insert(variable, resultVariableIndex);
+  return resultVariableIndex;
+}
+
+/*!
+ * \brief VariablesWidget::readVariableValue
+ * Reads the value of a variable resolved with VariablesWidget::bindResultVariable at specific time.\n
+ * For csv and plt files the value of the last sample at or before time is used.
+ * \param resultVariableIndex
+ * \param time
+ * \return
+ */
+double VariablesWidget::readVariableValue(int resultVariableIndex, double time)
+{
+  double value = 0.0;
+  if (resultVariableIndex < 0 || resultVariableIndex >= mResultVariables.size()) {
+    return value;
+  }
+  const ResultVariable &resultVariable = mResultVariables.at(resultVariableIndex);
+  if (resultVariable.mpMatVariable) {
+    omc_matlab4_val(&value, &mModelicaMatReader, resultVariable.mpMatVariable, time);
+  } else if (resultVariable.mpCSVDataSet) {
+    const double *pTimeDataSetEnd = mpCSVTimeDataSet + mpCSVData->numsteps;
+    int index = std::upper_bound(mpCSVTimeDataSet, pTimeDataSetEnd, time) - mpCSVTimeDataSet;
+    value = resultVariable.mpCSVDataSet[qMax(index - 1, 0)];
+  } else if (!resultVariable.mPlotFileTimes.isEmpty()) {
+    int index = std::upper_bound(resultVariable.mPlotFileTimes.constBegin(), resultVariable.mPlotFileTimes.constEnd(), time)
+                - resultVariable.mPlotFileTimes.constBegin();
+    value = resultVariable.mPlotFileValues.at(qMax(index - 1, 0));
   }
   return value;
 }
 
+/*!
+ * \brief VariablesWidget::addDynamicSelectComponent
+ * Adds the state component to the list of components updated during the visualization of result file.\n
+ * The active variable of the component is resolved only once per opened result file.
+ * \param pComponent
+ */
+void VariablesWidget::addDynamicSelectComponent(Component *pComponent)
+{
+  if (pComponent->getLibraryTreeItem() && pComponent->getLibraryTreeItem()->isState()) {
+    DynamicSelectBinding dynamicSelectBinding;
+    dynamicSelectBinding.mpComponent = pComponent;
+    dynamicSelectBinding.mResultVariableIndex = -2;
+    dynamicSelectBinding.mValue = std::numeric_limits<double>::quiet_NaN();
+    mDynamicSelectBindings.append(dynamicSelectBinding);
+  }
+}
+
 void VariablesWidget::plotVariables(const QModelIndex &index, qreal curveThickness, int curveStyle, PlotCurve *pPlotCurve,
                                     PlotWindow *pPlotWindow)
 {
@@ -2073,6 +2160,14 @@ void VariablesWidget::closeResultFile()
   if (mPlotFileReader.isOpen()) {
     mPlotFileReader.close();
   }
+  // the resolved variables belong to the closed result file
+  mpCSVTimeDataSet = 0;
+  mResultVariables.clear();
+  mResultVariablesHash.clear();
+  for (int i = 0 ; i < mDynamicSelectBindings.size() ; i++) {
+    mDynamicSelectBindings[i].mResultVariableIndex = -2;
+    mDynamicSelectBindings[i].mValue = std::numeric_limits<double>::quiet_NaN();
+  }
 }
 
 /*!
@@ -2097,6 +2192,8 @@ void VariablesWidget::openResultFile()
       mpCSVData = read_csv(fileName.toStdString().c_str());
       if (!mpCSVData) {
         errorOpeningFile = true;
+      } else {
+        mpCSVTimeDataSet = read_csv_dataset(mpCSVData, "time");
       }
     } else if (mpVariablesTreeModel->getActiveVariablesTreeItem()->getFileName().endsWith(".plt")) {
       mPlotFileReader.setFileName(fileName);
@@ -2122,10 +2219,21 @@ void VariablesWidget::updateVisualization()
 {
   mpTimeManager->updateTick();  //for real-time measurement
   double visTime = mpTimeManager->getRealTime();
-  // Update the DiagramWindow
-  emit updateDynamicSelect(mpTimeManager->getVisTime());
-  if (MainWindow::instance()->getPlotWindowContainer()->getDiagramWindow()) {
-    MainWindow::instance()->getPlotWindowContainer()->getDiagramWindow()->getGraphicsView()->scene()->update();
+  // Update the DiagramWindow. Only the components whose value has changed are repainted.
+  double time = mpTimeManager->getVisTime();
+  for (int i = 0 ; i < mDynamicSelectBindings.size() ; i++) {
+    DynamicSelectBinding &dynamicSelectBinding = mDynamicSelectBindings[i];
+    if (!dynamicSelectBinding.mpComponent) {
+      continue;
+    }
+    if (dynamicSelectBinding.mResultVariableIndex == -2) {
+      dynamicSelectBinding.mResultVariableIndex = bindResultVariable(dynamicSelectBinding.mpComponent->getName() + ".active");
+    }
+    double value = readVariableValue(dynamicSelectBinding.mResultVariableIndex, time);
+    if (value != dynamicSelectBinding.mValue) {
+      dynamicSelectBinding.mValue = value;
+      dynamicSelectBinding.mpComponent->updateDynamicSelect(value);
+    }
   }
   mpTimeManager->updateTick();  //for real-time measurement
   visTime = mpTimeManager->getRealTime() - visTime;
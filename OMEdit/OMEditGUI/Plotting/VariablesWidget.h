@@ -36,6 +36,7 @@
 #define VARIABLESWIDGET_H
 
 #include <QDomDocument>
+#include <QPointer>
 
 #include "Simulation/SimulationOptions.h"
 #include "PlotWindow.h"
@@ -44,6 +45,7 @@
 class OMCProxy;
 class TreeSearchFilters;
 class Label;
+class Component;
 
 class VariablesTreeItem
 {
@@ -127,6 +129,8 @@ public:
   QVariant data(const QModelIndex & index, int role = Qt::DisplayRole) const;
   Qt::ItemFlags flags(const QModelIndex &index) const;
   VariablesTreeItem* findVariablesTreeItem(const QString &name, VariablesTreeItem *root) const;
+  VariablesTreeItem* getVariablesTreeItem(const QString &name) const {return mVariablesTreeItemsHash.value(name, 0);}
+  int getVariablesRevision() const {return mVariablesRevision;}
   QModelIndex variablesTreeItemIndex(const VariablesTreeItem *pVariablesTreeItem) const;
   QModelIndex variablesTreeItemIndexHelper(const VariablesTreeItem *pVariablesTreeItem, const VariablesTreeItem *pParentVariablesTreeItem,
                                            const QModelIndex &parentIndex) const;
@@ -141,6 +145,9 @@ private:
   VariablesTreeItem *mpRootVariablesTreeItem;
   VariablesTreeItem *mpActiveVariablesTreeItem;
   QHash<QString, QHash<QString,QString> > mScalarVariablesList;
+  QHash<QString, VariablesTreeItem*> mVariablesTreeItemsHash;
+  int mVariablesRevision; /* incremented whenever result variables are inserted or removed. */
+  void removeVariablesTreeItemsFromHash(VariablesTreeItem *pVariablesTreeItem);
   void getVariableInformation(ModelicaMatReader *pMatReader, QString variableToFind, QString *value, bool *changeAble, QString *variability,
                               QString *unit, QString *displayUnit, QString *description);
 signals:
@@ -177,6 +184,29 @@ protected:
   virtual void keyPressEvent(QKeyEvent *event);
 };
 
+/*!
+ * \brief The ResultVariable struct
+ * A variable of the opened result file resolved once to its data column.
+ */
+struct ResultVariable
+{
+  ModelicaMatVariable_t *mpMatVariable;
+  double *mpCSVDataSet;
+  QVector<double> mPlotFileTimes;
+  QVector<double> mPlotFileValues;
+};
+
+/*!
+ * \brief The DynamicSelectBinding struct
+ * Binds a state component of the DiagramWindow to its pre-resolved active variable.
+ */
+struct DynamicSelectBinding
+{
+  QPointer<Component> mpComponent;
+  int mResultVariableIndex; /* -1 if not found in the result file, -2 if not resolved yet. */
+  double mValue;
+};
+
 class VariablesWidget : public QWidget
 {
   Q_OBJECT
@@ -199,6 +229,10 @@ public:
   void updateInitXmlFile(SimulationOptions simulationOptions);
   void initializeVisualization(SimulationOptions simulationOptions);
   double readVariableValue(QString variable, double time);
+  int bindResultVariable(const QString &variable);
+  double readVariableValue(int resultVariableIndex, double time);
+  void addDynamicSelectComponent(Component *pComponent);
+  void clearDynamicSelectComponents() {mDynamicSelectBindings.clear();}
 private:
   TreeSearchFilters *mpTreeSearchFilters;
   Label *mpSimulationTimeLabel;
@@ -222,7 +256,11 @@ private:
   QMdiSubWindow *mpLastActiveSubWindow;
   ModelicaMatReader mModelicaMatReader;
   csv_data *mpCSVData;
+  double *mpCSVTimeDataSet;
   QFile mPlotFileReader;
+  QVector<ResultVariable> mResultVariables;
+  QHash<QString, int> mResultVariablesHash;
+  QList<DynamicSelectBinding> mDynamicSelectBindings;
   void selectInteractivePlotWindow(VariablesTreeItem *pVariablesTreeItem);
   void closeResultFile();
   void openResultFile();
@@ -246,8 +284,6 @@ private slots:
   void visulizationTimeChanged();
   void visualizationSpeedChanged();
   void incrementVisualization();
-signals:
-  void updateDynamicSelect(double time);
 };
 
 #endif // VARIABLESWIDGET_H
@@ -6,6 +6,7 @@
 
 #include <QThread>
 #include <QDebug>
+#include <algorithm>
 
 /*!
   Write the value value to the real node with id id.
@@ -288,6 +289,50 @@ int OpcUaClient::readBool(int id)
   return res;
 }
 
+/*!
+  Read the simulation time and the values of the variables with one read request.
+  Bool values are returned as 0 or 1, -1 indicates an error.
+  */
+bool OpcUaClient::readValues(const QList<Variable*> &variables, double *pTime, QVector<double> *pValues)
+{
+  UA_ReadRequest rReq;
+  UA_ReadRequest_init(&rReq);
+  rReq.nodesToReadSize = variables.size() + 1;
+  rReq.nodesToRead = (UA_ReadValueId*)UA_Array_new(rReq.nodesToReadSize, &UA_TYPES[UA_TYPES_READVALUEID]);
+  // UA_NODEID_NUMERIC(0, 10004) should probably be using OMC_OPC_NODEID_TIME.
+  rReq.nodesToRead[0].nodeId = UA_NODEID_NUMERIC(0, 10004);
+  rReq.nodesToRead[0].attributeId = UA_ATTRIBUTEID_VALUE;
+  for (int i = 0; i < variables.size(); ++i) {
+    rReq.nodesToRead[i + 1].nodeId = UA_NODEID_NUMERIC(1, variables.at(i)->getNodeId());
+    rReq.nodesToRead[i + 1].attributeId = UA_ATTRIBUTEID_VALUE;
+  }
+
+  UA_ReadResponse rResp = UA_Client_Service_read(mpClient, rReq);
+  bool result = rResp.responseHeader.serviceResult == UA_STATUSCODE_GOOD && rResp.resultsSize == rReq.nodesToReadSize;
+  if (result) {
+    pValues->resize(variables.size());
+    for (size_t i = 0; i < rResp.resultsSize; ++i) {
+      double value = -1;
+      UA_DataValue *pValue = &rResp.results[i];
+      if (pValue->hasValue && UA_Variant_isScalar(&pValue->value)) {
+        if (pValue->value.type == &UA_TYPES[UA_TYPES_DOUBLE]) {
+          value = *(UA_Double*)pValue->value.data;
+        } else if (pValue->value.type == &UA_TYPES[UA_TYPES_BOOLEAN]) {
+          value = *(UA_Boolean*)pValue->value.data;
+        }
+      }
+      if (i == 0) {
+        *pTime = value;
+      } else {
+        (*pValues)[i - 1] = value;
+      }
+    }
+  }
+  UA_ReadRequest_deleteMembers(&rReq);
+  UA_ReadResponse_deleteMembers(&rResp);
+  return result;
+}
+
 /*!
   Called when a value is entered in the variable tree.
   Write the new value to the corresponding node.
@@ -302,6 +347,18 @@ void OpcUaClient::writeValue(const QVariant &value, const QString &name)
   }
 }
 
+/*!
+  Inserts the values sampled by the OpcUaWorker in the variables.
+  Called in the GUI thread so the data of the curves is never changed while they are painted.
+  */
+void OpcUaClient::insertValues(QList<Variable*> variables, double time, QVector<double> values)
+{
+  for (int i = 0; i < variables.size(); ++i) {
+    variables.at(i)->insertData(time, values.at(i));
+    variables.at(i)->checkBounds(values.at(i));
+  }
+}
+
 /*!
   Read the current simulation time by contacting the remote with help of open62541 high level functionality.
   */
@@ -309,7 +366,9 @@ double OpcUaClient::getCurrentSimulationTime()
 {
   UA_Variant *currentTime = UA_Variant_new();
   UA_Client_readValueAttribute(mpClient, UA_NODEID_NUMERIC(0, 10004), currentTime);
-  return *(double*)currentTime->data;
+  double time = *(double*)currentTime->data;
+  UA_Variant_delete(currentTime);
+  return time;
 }
 
 /*!
@@ -319,6 +378,9 @@ double OpcUaClient::getCurrentSimulationTime()
 OpcUaWorker::OpcUaWorker(OpcUaClient *pClient, bool simulateWithSteps)
  : mpParentClient(pClient), mSimulateWithSteps(simulateWithSteps), mSampleInterval(10), mSpeedValue(1.0), mServerSampleInterval(5)
 {
+  // the sampled values are sent to the GUI thread
+  qRegisterMetaType<QList<Variable*> >("QList<Variable*>");
+  qRegisterMetaType<QVector<double> >("QVector<double>");
   setInterval(mSampleInterval);
   if (!mSimulateWithSteps) {
     createSubscription();
@@ -416,24 +478,26 @@ void OpcUaWorker::setSpeed(QString value)
 }
 
 /*!
-  Simulate with steps. For each checked variable, contact the remote and fetch the data.
+  Simulate with steps. Fetch the time and the data of all the checked variables from the remote with one request.
   */
 void OpcUaWorker::appendVariableValues()
 {
   // fetch checked variables data only
+  QList<Variable*> variables;
   for (auto & p : mpParentClient->getCheckedVariables()) {
-    Variable *pVariable = mpParentClient->getVariables()->value(p->getPlotVariable());
-    int nodeId = pVariable->getNodeId();
-    double variableValue;
-    if (pVariable->isBool()) {
-      variableValue = mpParentClient->readBool(nodeId);
-    } else {
-      variableValue = mpParentClient->readReal(nodeId);
-    }
-
-    pVariable->insertData(mpParentClient->getCurrentSimulationTime(), variableValue);
-    pVariable->checkBounds(variableValue);
-    checkMinMaxValues(variableValue);
+    variables.append(mpParentClient->getVariables()->value(p->getPlotVariable()));
+  }
+  if (variables.isEmpty()) {
+    return;
+  }
+  double time;
+  QVector<double> values;
+  if (!mpParentClient->readValues(variables, &time, &values)) {
+    return;
+  }
+  emit sendValues(variables, time, values);
+  for (int i = 0; i < values.size(); ++i) {
+    checkMinMaxValues(values.at(i));
   }
 }
 
@@ -511,20 +575,26 @@ void OpcUaWorker::timeChanged(UA_UInt32 handle, UA_DataValue *pValue, void *pCli
 }
 
 /*!
-  Inserts the data to the Variable data structure.
+  Sends the cached values of the monitored variables to the GUI thread where they are inserted in the Variable data structure.
   */
 void OpcUaWorker::insertValues()
 {
+  QList<Variable*> variables;
+  QVector<double> values;
   for (const auto &p : mMonitorIds.localData()) {
     double value = mCurrentValues.localData().value(mMonitorIds.localData().key(p));
-    p->insertData(mCurrentTime.localData(), value);
+    variables.append(p);
+    values.append(value);
     checkMinMaxValues(value);
   }
+  if (!variables.isEmpty()) {
+    emit sendValues(variables, mCurrentTime.localData(), values);
+  }
 }
 
 /*!
   A boolean value has been changed.
-  Update the cached value and check bounds for the new value.
+  Update the cached value. The bounds are checked when the value is inserted.
   */
 void OpcUaWorker::boolChanged(UA_UInt32 handle, UA_DataValue *pValue, void *pClient)
 {
@@ -533,13 +603,12 @@ void OpcUaWorker::boolChanged(UA_UInt32 handle, UA_DataValue *pValue, void *pCli
     // remember the value until next time the server notify a change
     double variableValue = *(UA_Boolean*)pValue->value.data;
     mCurrentValues.localData().insert(handle, variableValue);
-    mMonitorIds.localData().value(handle)->checkBounds(variableValue);
   }
 }
 
 /*!
   A real value has been changed.
-  Update the cached value and check bounds for the new value.
+  Update the cached value. The bounds are checked when the value is inserted.
   */
 void OpcUaWorker::realChanged(UA_UInt32 handle, UA_DataValue *pValue, void *pClient)
 {
@@ -548,7 +617,6 @@ void OpcUaWorker::realChanged(UA_UInt32 handle, UA_DataValue *pValue, void *pCli
     // remember the value until next time the server notify a change
     double variableValue = *(UA_Double*)pValue->value.data;
     mCurrentValues.localData().insert(handle, variableValue);
-    mMonitorIds.localData().value(handle)->checkBounds(variableValue);
   }
 }
 
@@ -595,6 +663,7 @@ Variable::Variable(int id, bool isWritable)
   mIsWritable = isWritable;
   mXAxisVector = 0;
   mYAxisVector = 0;
+  mPaintedSize = 0;
 }
 
 Variable::~Variable() {}
@@ -606,20 +675,65 @@ void Variable::setAxisVectors(QPair<QVector<double>*, QVector<double>*> axes)
 {
   mXAxisVector = axes.first;
   mYAxisVector = axes.second;
+  mPaintedSize = 0;
 }
 
 /*!
   Inserts new data in the vectors.
+  The vectors never hold more than capacity points, see decimateData().
+  Only called in the GUI thread where the curves are painted from the data.
   */
 void Variable::insertData(const double& xValue, const double& yValue)
 {
   if (mXAxisVector != 0 && mYAxisVector != 0)
   {
+    if (mXAxisVector->size() >= capacity) {
+      decimateData();
+    }
     mXAxisVector->push_back(xValue);
     mYAxisVector->push_back(yValue);
   }
 }
 
+/*!
+  Reduces the older half of the points to the minimum and maximum of every four points.
+  The envelope of the curve is kept while the memory stays bounded, the recent points keep their full resolution.
+  The curve has to be painted from the start afterwards.
+  */
+void Variable::decimateData()
+{
+  QVector<double> &x = *mXAxisVector;
+  QVector<double> &y = *mYAxisVector;
+  const int older = (x.size() / 2) & ~3;
+  int j = 0;
+  for (int i = 0; i < older; i += 4) {
+    int minIndex = i, maxIndex = i;
+    for (int k = i + 1; k < i + 4; ++k) {
+      if (y.at(k) < y.at(minIndex)) {
+        minIndex = k;
+      }
+      if (y.at(k) > y.at(maxIndex)) {
+        maxIndex = k;
+      }
+    }
+    // keep the time order
+    const int first = qMin(minIndex, maxIndex);
+    const int second = qMax(minIndex, maxIndex);
+    x[j] = x.at(first);
+    y[j] = y.at(first);
+    ++j;
+    x[j] = x.at(second);
+    y[j] = y.at(second);
+    ++j;
+  }
+  // move the recent points after the decimated ones
+  std::copy(x.begin() + older, x.end(), x.begin() + j);
+  std::copy(y.begin() + older, y.end(), y.begin() + j);
+  x.resize(x.size() - (older - j));
+  y.resize(y.size() - (older - j));
+  mPaintedSize = 0;
+}
+
 /*!
   Returns a QPointF of the values at position i.
   */
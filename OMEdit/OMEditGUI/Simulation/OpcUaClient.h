@@ -5,6 +5,8 @@
 #include "open62541.h"
 #include "SimulationOptions.h"
 
+#include <QMetaType>
+
 class VariablesTreeItem;
 class OpcUaWorker;
 class Variable;
@@ -25,6 +27,7 @@ public:
   double readReal(int id);
   bool variableIsBool(int nodeId);
   int readBool(int id);
+  bool readValues(const QList<Variable*> &variables, double *pTime, QVector<double> *pValues);
   void writeValue(const QVariant &value, const QString &name);
   double getCurrentSimulationTime();
   QMap<int, VariablesTreeItem*> getCheckedVariables() {return mCheckedVariables;}
@@ -36,6 +39,8 @@ public:
   void setOpcUaWorker(OpcUaWorker *pOpcUaWorker) {mpOpcUaWorker = pOpcUaWorker;}
   OpcUaWorker* getOpcUaWorker() {return mpOpcUaWorker;}
   QThread* getSampleThread() {return mpSampleThread;}
+public slots:
+  void insertValues(QList<Variable*> variables, double time, QVector<double> values);
 private:
   UA_Client *mpClient;
   QThread *mpSampleThread;
@@ -97,6 +102,7 @@ private:
 signals:
   void sendUpdateCurves();
   void sendUpdateYAxis(double, double);
+  void sendValues(QList<Variable*>, double, QVector<double>);
   void sendAddMonitoredItem(int, QString);
   void sendRemoveMonitoredItem(QString);
 };
@@ -123,7 +129,13 @@ public:
   UA_UInt32 getMonitoredItemId() {return mMonitordItemId;}
   void setIsBool(bool isBool) {mIsBool = isBool;}
   bool isBool() {return mIsBool;}
+  // the data and the painted size are only accessed in the GUI thread, see OpcUaClient::insertValues
+  size_t getPaintedSize() const {return mPaintedSize;}
+  void setPaintedSize(size_t paintedSize) {mPaintedSize = paintedSize;}
+  // the number of points kept per variable, the older points are decimated
+  static const int capacity = 20000;
 private:
+  void decimateData();
   QPair<double, double> minMaxBounds;
   QVector<double> *mXAxisVector;
   QVector<double> *mYAxisVector;
@@ -132,6 +144,9 @@ private:
   UA_UInt32 mMonitordItemId;
   bool mIsWritable;
   bool mIsBool;
+  size_t mPaintedSize;
 };
 
+Q_DECLARE_METATYPE(QList<Variable*>)
+
 #endif // OPCUACLIENT_H
@@ -50,6 +50,7 @@
 
 #include <QDebug>
 #include <limits>
+#include <qwt_plot_directpainter.h>
 
 /*!
  * \class SimulationDialog
@@ -64,6 +65,7 @@ SimulationDialog::SimulationDialog(QWidget *pParent)
 {
   resize(550, 550);
   setUpForm();
+  mpInteractiveCurvesPainter = new QwtPlotDirectPainter(this);
 }
 
 SimulationDialog::~SimulationDialog()
@@ -1687,11 +1689,45 @@ void SimulationDialog::simulationPaused()
   setInteractiveControls(true);
 }
 
+/*!
+ * \brief SimulationDialog::updateInteractiveSimulationCurves
+ * Paints the points appended to the interactive curves since the last update.\n
+ * The whole plot is only updated if a curve has to be painted from the start, e.g. a new curve or a decimated one.
+ */
 void SimulationDialog::updateInteractiveSimulationCurves()
 {
   OMPlot::PlotWindow* window = MainWindow::instance()->getPlotWindowContainer()->getCurrentWindow();
   if (window) {
-    window->updateCurves();
+    QList<QPair<OMPlot::PlotCurve*, Variable*> > curves;
+    bool replot = false;
+    foreach (OMPlot::PlotCurve *pPlotCurve, window->getPlot()->getPlotCurvesList()) {
+      Variable *pVariable = dynamic_cast<Variable*>(pPlotCurve->data());
+      if (pVariable) {
+        curves.append(qMakePair(pPlotCurve, pVariable));
+      } else {
+        replot = true;
+      }
+    }
+    for (int i = 0; i < curves.size(); ++i) {
+      if (curves.at(i).second->getPaintedSize() == 0) {
+        replot = true;
+      }
+    }
+    if (replot) {
+      window->updateCurves();
+    } else {
+      for (int i = 0; i < curves.size(); ++i) {
+        size_t size = curves.at(i).second->size();
+        size_t paintedSize = curves.at(i).second->getPaintedSize();
+        if (size > paintedSize) {
+          // start at the last painted point to connect the new segment
+          mpInteractiveCurvesPainter->drawSeries(curves.at(i).first, static_cast<int>(paintedSize) - 1, static_cast<int>(size) - 1);
+        }
+      }
+    }
+    for (int i = 0; i < curves.size(); ++i) {
+      curves.at(i).second->setPaintedSize(curves.at(i).second->size());
+    }
   }
 }
 
@@ -1786,6 +1822,9 @@ void SimulationDialog::createOpcUaClient(SimulationOptions simulationOptions)
 
     connect(pOpcUaWorker, SIGNAL(sendUpdateCurves()), SLOT(updateInteractiveSimulationCurves()));
     connect(pOpcUaWorker, SIGNAL(sendUpdateYAxis(double, double)), SLOT(updateYAxis(double, double)));
+    // the sampled values are inserted in the GUI thread, before the curves are updated
+    connect(pOpcUaWorker, SIGNAL(sendValues(QList<Variable*>,double,QVector<double>)),
+            pOpcUaClient, SLOT(insertValues(QList<Variable*>,double,QVector<double>)));
     connect(pOpcUaWorker, SIGNAL(sendAddMonitoredItem(int,QString)), pOpcUaWorker, SLOT(addMonitoredItem(int,QString)));
     connect(pOpcUaWorker, SIGNAL(sendRemoveMonitoredItem(QString)), pOpcUaWorker, SLOT(removeMonitoredItem(QString)));
 
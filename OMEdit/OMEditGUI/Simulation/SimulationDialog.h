@@ -57,6 +57,7 @@ class Label;
 class SimulationOutputWidget;
 class LibraryTreeItem;
 class TranslationFlagsWidget;
+class QwtPlotDirectPainter;
 
 class ArchivedSimulationItem : public QTreeWidgetItem
 {
@@ -216,6 +217,7 @@ private:
   bool mIsReSimulate;
   // interactive simulation
   QMap<int, OpcUaClient*> mOpcUaClientsMap;
+  QwtPlotDirectPainter *mpInteractiveCurvesPainter;
 
   void setUpForm();
   bool validate();
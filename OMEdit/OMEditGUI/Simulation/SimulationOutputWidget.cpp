@@ -39,6 +39,7 @@
 #include "SimulationOutputHandler.h"
 #include "Editors/CEditor.h"
 #include "Editors/TextEditor.h"
+#include "Editors/LargeFileViewer.h"
 #include "SimulationProcessThread.h"
 #include "SimulationDialog.h"
 #include "TransformationalDebugger/TransformationsWidget.h"
@@ -398,7 +399,11 @@ void SimulationOutputWidget::addGeneratedFileTab(QString fileName)
 {
   QFile file(fileName);
   QFileInfo fileInfo(fileName);
-  if (file.exists()) {
+  if (LargeFileViewer::isLargeFile(fileName)) {
+    LargeFileViewer *pLargeFileViewer = new LargeFileViewer(MainWindow::instance());
+    pLargeFileViewer->openFile(fileName);
+    mpGeneratedFilesTabWidget->addTab(pLargeFileViewer, fileInfo.fileName());
+  } else if (file.exists()) {
     file.open(QIODevice::ReadOnly);
     BaseEditor *pEditor;
     if (Utilities::isCFile(fileInfo.suffix())) {
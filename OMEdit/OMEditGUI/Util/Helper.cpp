@@ -74,6 +74,7 @@ QString Helper::modelicaFileFormat = "text/uri-list";
 QString Helper::busConnectorFormat = "bus/connector";
 qreal Helper::shapesStrokeWidth = 2.0;
 int Helper::headingFontSize = 18;
+int Helper::undoLimit = 500;
 QString Helper::ModelicaSimulationOutputFormats = "mat,plt,csv";
 QString Helper::clockOptions = ",RT,CYC,CPU";
 QString Helper::notificationLevel = ".OpenModelica.Scripting.ErrorLevel.notification";
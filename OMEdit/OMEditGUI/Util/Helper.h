@@ -80,6 +80,7 @@ public:
   static QString busConnectorFormat;
   static qreal shapesStrokeWidth;
   static int headingFontSize;
+  static int undoLimit;
   static QString ModelicaSimulationOutputFormats;
   static QString clockOptions;
   static QString notificationLevel;
@@ -138,8 +138,11 @@ void signalHandler(int signalNumber)
 
 void printOMEditUsage()
 {
-  printf("Usage: OMEdit --Debug=true|false] [files]\n");
+  printf("Usage: OMEdit --Debug=true|false] [--Benchmark=diagram|highlighter|editor|transforms|animation [--BenchmarkSizes=N1,N2,...] [--BenchmarkOutput=file]] [files]\n");
   printf("    --Debug=[true|false]        Enables the debugging features like QUndoView, diffModelicaFileListings view. Default is false.\n");
+  printf("    --Benchmark=[name]          Runs the benchmark diagram, highlighter, editor, transforms or animation, writes the timings as CSV and exits. Use -platform offscreen to run it headless.\n");
+  printf("    --BenchmarkSizes=N1,N2,...  The model sizes, numbers of lines or numbers of shapes used by the benchmark.\n");
+  printf("    --BenchmarkOutput=file      Writes the benchmark results to the file instead of stdout.\n");
   printf("    files                       List of Modelica files(*.mo) to open.\n");
 }
 